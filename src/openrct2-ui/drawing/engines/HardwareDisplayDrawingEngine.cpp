@@ -14,6 +14,7 @@
 #include <openrct2/Game.h>
 #include <openrct2/common.h>
 #include <openrct2/config/Config.h>
+#include <openrct2/drawing/Drawing.h>
 #include <openrct2/drawing/IDrawingEngine.h>
 #include <openrct2/drawing/LightFX.h>
 #include <openrct2/drawing/X8DrawingEngine.h>
@@ -36,6 +37,8 @@ private:
     SDL_Texture* _screenTexture = nullptr;
     SDL_Texture* _scaledScreenTexture = nullptr;
     SDL_PixelFormat* _screenTextureFormat = nullptr;
+    // Changed regions are converted here before they are uploaded.
+    std::vector<uint32_t> _uploadBuffer;
     uint32_t _paletteHWMapped[256] = { 0 };
 #ifdef __ENABLE_LIGHTFX__
     uint32_t _lightPaletteHWMapped[256] = { 0 };
@@ -176,6 +179,7 @@ public:
             }
 #endif
         }
+        MarkAllChanged();
     }
 
     void EndDraw() override
@@ -217,10 +221,18 @@ private:
                 lightfx_render_to_texture(pixels, pitch, _bits, _width, _height, _paletteHWMapped, _lightPaletteHWMapped);
                 SDL_UnlockTexture(_screenTexture);
             }
+            // The lights move every frame, the whole texture is rendered regardless.
+            TakeChangedRegions();
         }
         else
 #endif
+        if (_screenTextureFormat != nullptr && _screenTextureFormat->BytesPerPixel == 4)
         {
+            CopyChangedRegionsToTexture(_screenTexture, _paletteHWMapped);
+        }
+        else
+        {
+            TakeChangedRegions();
             CopyBitsToTexture(
                 _screenTexture, _bits, static_cast<int32_t>(_width), static_cast<int32_t>(_height), _paletteHWMapped);
         }
@@ -256,6 +268,43 @@ private:
         }
     }
 
+    /**
+     * Converts and uploads only the parts of the screen that changed since the last frame. The texture keeps the
+     * pixels of the previous frame, so a partial update is enough. Many small regions cost more in driver calls than
+     * a single upload of the whole screen, past MaxUploadRegions the whole screen is uploaded instead.
+     */
+    void CopyChangedRegionsToTexture(SDL_Texture* texture, const uint32_t* palette)
+    {
+        constexpr size_t MaxUploadRegions = 32;
+
+        const auto& regions = TakeChangedRegions();
+        if (regions.size() > MaxUploadRegions)
+        {
+            CopyBitsToTexture(texture, _bits, static_cast<int32_t>(_width), static_cast<int32_t>(_height), palette);
+            return;
+        }
+
+        const int32_t stride = static_cast<int32_t>(_pitch);
+        for (const auto& region : regions)
+        {
+            const int32_t width = region.GetWidth();
+            const int32_t height = region.GetHeight();
+            _uploadBuffer.resize(static_cast<size_t>(width) * height);
+
+            const uint8_t* src = _bits + region.GetTop() * stride + region.GetLeft();
+            uint32_t* dst = _uploadBuffer.data();
+            for (int32_t y = 0; y < height; y++)
+            {
+                palette_expand_fn(src, dst, width, palette);
+                src += stride;
+                dst += width;
+            }
+
+            SDL_Rect rect = { region.GetLeft(), region.GetTop(), width, height };
+            SDL_UpdateTexture(texture, &rect, _uploadBuffer.data(), width * 4);
+        }
+    }
+
     void CopyBitsToTexture(SDL_Texture* texture, uint8_t* src, int32_t width, int32_t height, const uint32_t* palette)
     {
         void* pixels;
@@ -265,11 +314,7 @@ private:
             int32_t padding = pitch - (width * 4);
             if (pitch == width * 4)
             {
-                uint32_t* dst = static_cast<uint32_t*>(pixels);
-                for (int32_t i = width * height; i > 0; i--)
-                {
-                    *dst++ = palette[*src++];
-                }
+                palette_expand_fn(src, static_cast<uint32_t*>(pixels), static_cast<size_t>(width) * height, palette);
             }
             else
             {
@@ -16,6 +16,7 @@
 #include <openrct2/localisation/Localisation.h>
 #include <openrct2/localisation/LocalisationService.h>
 #include <openrct2/paint/Paint.h>
+#include <openrct2/paint/PaintTileCache.h>
 #include <openrct2/paint/tile_element/Paint.TileElement.h>
 #include <openrct2/ride/TrackPaint.h>
 
@@ -30,10 +31,12 @@ enum WINDOW_DEBUG_PAINT_WIDGET_IDX
     WIDX_TOGGLE_SHOW_SEGMENT_HEIGHTS,
     WIDX_TOGGLE_SHOW_BOUND_BOXES,
     WIDX_TOGGLE_SHOW_DIRTY_VISUALS,
+    WIDX_TOGGLE_SHOW_SESSION_STATS,
+    WIDX_TOGGLE_VERIFY_TILE_CACHE,
 };
 
 constexpr int32_t WINDOW_WIDTH = 200;
-constexpr int32_t WINDOW_HEIGHT = 8 + 15 + 15 + 15 + 15 + 11 + 8;
+constexpr int32_t WINDOW_HEIGHT = 8 + 15 + 15 + 15 + 15 + 15 + 15 + 11 + 8;
 
 static rct_widget window_debug_paint_widgets[] = {
     MakeWidget({0,          0}, {WINDOW_WIDTH, WINDOW_HEIGHT}, WindowWidgetType::Frame,    WindowColour::Primary                                        ),
@@ -42,6 +45,8 @@ static rct_widget window_debug_paint_widgets[] = {
     MakeWidget({8, 8 + 15 * 2}, {         185,            12}, WindowWidgetType::Checkbox, WindowColour::Secondary, STR_DEBUG_PAINT_SHOW_SEGMENT_HEIGHTS),
     MakeWidget({8, 8 + 15 * 3}, {         185,            12}, WindowWidgetType::Checkbox, WindowColour::Secondary, STR_DEBUG_PAINT_SHOW_BOUND_BOXES    ),
     MakeWidget({8, 8 + 15 * 4}, {         185,            12}, WindowWidgetType::Checkbox, WindowColour::Secondary, STR_DEBUG_PAINT_SHOW_DIRTY_VISUALS  ),
+    MakeWidget({8, 8 + 15 * 5}, {         185,            12}, WindowWidgetType::Checkbox, WindowColour::Secondary, STR_DEBUG_PAINT_SHOW_SESSION_STATS  ),
+    MakeWidget({8, 8 + 15 * 6}, {         185,            12}, WindowWidgetType::Checkbox, WindowColour::Secondary, STR_DEBUG_PAINT_VERIFY_TILE_CACHE   ),
     WIDGETS_END,
 };
 
@@ -73,7 +78,8 @@ rct_window* window_debug_paint_open()
     window->widgets = window_debug_paint_widgets;
     window->enabled_widgets = (1ULL << WIDX_TOGGLE_SHOW_WIDE_PATHS) | (1ULL << WIDX_TOGGLE_SHOW_BLOCKED_TILES)
         | (1ULL << WIDX_TOGGLE_SHOW_BOUND_BOXES) | (1ULL << WIDX_TOGGLE_SHOW_SEGMENT_HEIGHTS)
-        | (1ULL << WIDX_TOGGLE_SHOW_DIRTY_VISUALS);
+        | (1ULL << WIDX_TOGGLE_SHOW_DIRTY_VISUALS) | (1ULL << WIDX_TOGGLE_SHOW_SESSION_STATS)
+        | (1ULL << WIDX_TOGGLE_VERIFY_TILE_CACHE);
     WindowInitScrollWidgets(window);
     window_push_others_below(window);
 
@@ -112,6 +118,16 @@ static void window_debug_paint_mouseup([[maybe_unused]] rct_window* w, rct_widge
             gShowDirtyVisuals = !gShowDirtyVisuals;
             gfx_invalidate_screen();
             break;
+
+        case WIDX_TOGGLE_SHOW_SESSION_STATS:
+            gShowPaintSessionStats = !gShowPaintSessionStats;
+            gfx_invalidate_screen();
+            break;
+
+        case WIDX_TOGGLE_VERIFY_TILE_CACHE:
+            gPaintTileCacheVerify = !gPaintTileCacheVerify;
+            gfx_invalidate_screen();
+            break;
     }
 }
 
@@ -126,7 +142,7 @@ static void window_debug_paint_invalidate(rct_window* w)
 
         // Find the width of the longest string
         int16_t newWidth = 0;
-        for (size_t widgetIndex = WIDX_TOGGLE_SHOW_WIDE_PATHS; widgetIndex <= WIDX_TOGGLE_SHOW_DIRTY_VISUALS; widgetIndex++)
+        for (size_t widgetIndex = WIDX_TOGGLE_SHOW_WIDE_PATHS; widgetIndex <= WIDX_TOGGLE_VERIFY_TILE_CACHE; widgetIndex++)
         {
             auto stringIdx = w->widgets[widgetIndex].text;
             auto string = ls.GetString(stringIdx);
@@ -147,6 +163,8 @@ static void window_debug_paint_invalidate(rct_window* w)
         w->widgets[WIDX_TOGGLE_SHOW_SEGMENT_HEIGHTS].right = newWidth - 8;
         w->widgets[WIDX_TOGGLE_SHOW_BOUND_BOXES].right = newWidth - 8;
         w->widgets[WIDX_TOGGLE_SHOW_DIRTY_VISUALS].right = newWidth - 8;
+        w->widgets[WIDX_TOGGLE_SHOW_SESSION_STATS].right = newWidth - 8;
+        w->widgets[WIDX_TOGGLE_VERIFY_TILE_CACHE].right = newWidth - 8;
 
         w->Invalidate();
     }
@@ -156,6 +174,8 @@ static void window_debug_paint_invalidate(rct_window* w)
     WidgetSetCheckboxValue(w, WIDX_TOGGLE_SHOW_SEGMENT_HEIGHTS, gShowSupportSegmentHeights);
     WidgetSetCheckboxValue(w, WIDX_TOGGLE_SHOW_BOUND_BOXES, gPaintBoundingBoxes);
     WidgetSetCheckboxValue(w, WIDX_TOGGLE_SHOW_DIRTY_VISUALS, gShowDirtyVisuals);
+    WidgetSetCheckboxValue(w, WIDX_TOGGLE_SHOW_SESSION_STATS, gShowPaintSessionStats);
+    WidgetSetCheckboxValue(w, WIDX_TOGGLE_VERIFY_TILE_CACHE, gPaintTileCacheVerify);
 }
 
 static void window_debug_paint_paint(rct_window* w, rct_drawpixelinfo* dpi)
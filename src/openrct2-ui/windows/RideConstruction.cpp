@@ -2415,6 +2415,7 @@ static void sub_6CBCE2(
 
     gMapSize = MAXIMUM_MAP_SIZE_TECHNICAL;
 
+    ScrollingTextPaintScope scrollingTextPaint;
     const auto& ted = GetTrackElementDescriptor(trackType);
     const auto* trackBlock = ted.Block;
     while (trackBlock->index != 255)
@@ -2478,6 +2479,7 @@ static void sub_6CBCE2(
     gMapSize = preserveMapSize;
 
     PaintSessionArrange(session);
+    scrolling_text_flush();
     PaintDrawStructs(session);
     PaintSessionFree(session);
 }
@@ -54,6 +54,7 @@
 #include "platform/Crash.h"
 #include "platform/Platform2.h"
 #include "platform/platform.h"
+#include "ride/RideRatings.h"
 #include "ride/TrackData.h"
 #include "ride/TrackDesignRepository.h"
 #include "scenario/Scenario.h"
@@ -665,6 +666,12 @@ namespace OpenRCT2
                     }
 #endif
                     game_load_init();
+                    // Like new games, saved games that rate a whole ride per tick have their rides rated right away.
+                    // Network clients and replays keep the ratings of the map they load.
+                    if (gParkFlags & PARK_FLAGS_WHOLE_RIDE_RATINGS)
+                    {
+                        ride_ratings_update_all_rides();
+                    }
 #ifndef DISABLE_NETWORK
                     if (_network.GetMode() == NETWORK_MODE_SERVER)
                     {
@@ -264,7 +264,7 @@ void GameState::UpdateLogic(LogicTimings* timings)
 
     if (network_get_mode() == NETWORK_MODE_SERVER)
     {
-        if (network_gamestate_snapshots_enabled())
+        if (network_gamestate_snapshots_enabled() || network_resync_enabled())
         {
             CreateStateSnapshot();
         }
@@ -280,18 +280,34 @@ void GameState::UpdateLogic(LogicTimings* timings)
             return;
         }
 
+        // Nothing to run until the server has patched the game state.
+        if (network_is_resynchronising())
+        {
+            return;
+        }
+
         // Check desync.
         bool desynced = network_check_desynchronisation();
         if (desynced)
         {
             // If desync debugging is enabled and we are still connected request the specific game state from server.
-            if (network_gamestate_snapshots_enabled() && network_get_status() == NETWORK_STATUS_CONNECTED)
+            const bool snapshotsEnabled = network_gamestate_snapshots_enabled();
+            if ((snapshotsEnabled || network_resync_enabled()) && network_get_status() == NETWORK_STATUS_CONNECTED)
             {
                 // Create snapshot from this tick so we can compare it later
                 // as we won't pause the game on this event.
                 CreateStateSnapshot();
 
-                network_request_gamestate_snapshot();
+                if (snapshotsEnabled)
+                {
+                    network_request_gamestate_snapshot();
+                }
+            }
+
+            // Wait for the server's state of this tick rather than running it from our own.
+            if (network_request_resync())
+            {
+                return;
             }
         }
     }
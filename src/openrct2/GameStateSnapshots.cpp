@@ -10,21 +10,143 @@
 #include "GameStateSnapshots.h"
 
 #include "core/CircularBuffer.h"
+#include "management/Finance.h"
 #include "peep/Guest.h"
 #include "peep/Staff.h"
 #include "ride/Vehicle.h"
+#include "scenario/Scenario.h"
 #include "world/Balloon.h"
 #include "world/Duck.h"
 #include "world/EntityList.h"
 #include "world/Fountain.h"
 #include "world/Litter.h"
 #include "world/MoneyEffect.h"
+#include "world/Park.h"
 #include "world/Particle.h"
 #include "world/Sprite.h"
 
 static constexpr size_t MaximumGameStateSnapshots = 32;
 static constexpr uint32_t InvalidTick = 0xFFFFFFFF;
 
+// Number of consecutive entity slots covered by one hash of GetEntityBlockHashes.
+static constexpr size_t EntityBlockSize = 64;
+
+static void SerialiseEntity(rct_sprite& sprite, DataSerialiser& ds)
+{
+    switch (sprite.base.Type)
+    {
+        case EntityType::Vehicle:
+            reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Guest:
+            reinterpret_cast<Guest&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Staff:
+            reinterpret_cast<Staff&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Litter:
+            reinterpret_cast<Litter&>(sprite).Serialise(ds);
+            break;
+        case EntityType::MoneyEffect:
+            reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Balloon:
+            reinterpret_cast<Balloon&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Duck:
+            reinterpret_cast<Duck&>(sprite).Serialise(ds);
+            break;
+        case EntityType::JumpingFountain:
+            reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
+            break;
+        case EntityType::SteamParticle:
+            reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Null:
+            break;
+        default:
+            break;
+    }
+}
+
+// Guests, staff and vehicles need more than the snapshot stores, such as names, patrol areas and the sprite bounds of
+// their ride objects, and are tied into rides and the park counts. A resync can patch them but not create or remove them.
+static bool CanCreateEntityFromSnapshot(EntityType type)
+{
+    switch (type)
+    {
+        case EntityType::Vehicle:
+        case EntityType::Guest:
+        case EntityType::Staff:
+            return false;
+        default:
+            return true;
+    }
+}
+
+static void SetEntitySpriteBounds(EntityBase& entity, uint8_t width, uint8_t heightNegative, uint8_t heightPositive)
+{
+    entity.sprite_width = width;
+    entity.sprite_height_negative = heightNegative;
+    entity.sprite_height_positive = heightPositive;
+}
+
+// The snapshot does not store sprite bounds either, give a created entity the ones it is created with in game.
+static void SetEntitySpriteBounds(EntityBase& entity)
+{
+    switch (entity.Type)
+    {
+        case EntityType::Litter:
+            SetEntitySpriteBounds(entity, 6, 6, 3);
+            break;
+        case EntityType::MoneyEffect:
+            SetEntitySpriteBounds(entity, 64, 20, 30);
+            break;
+        case EntityType::Balloon:
+            SetEntitySpriteBounds(entity, 13, 22, 11);
+            break;
+        case EntityType::Duck:
+            SetEntitySpriteBounds(entity, 9, 12, 9);
+            break;
+        case EntityType::JumpingFountain:
+            SetEntitySpriteBounds(entity, 33, 36, 12);
+            break;
+        case EntityType::SteamParticle:
+            SetEntitySpriteBounds(entity, 20, 18, 16);
+            break;
+        default:
+            break;
+    }
+}
+
+// Park wide state that changes as the game runs, restored along with the entities on a resync.
+static void SerialiseParkParameters(DataSerialiser& ds)
+{
+    auto randState = scenario_rand_state();
+    ds << randState.s0;
+    ds << randState.s1;
+    ds << gCash;
+    ds << gBankLoan;
+    ds << gCurrentExpenditure;
+    ds << gCurrentProfit;
+    ds << gParkValue;
+    ds << gCompanyValue;
+    ds << gParkFlags;
+    ds << gParkRating;
+    ds << gTotalAdmissions;
+    ds << gTotalIncomeFromAdmissions;
+    ds << gNumGuestsInPark;
+    ds << gNumGuestsInParkLastWeek;
+    ds << gNumGuestsHeadingForPark;
+    ds << gGuestChangeModifier;
+    ds << _guestGenerationProbability;
+    ds << _suggestedGuestMaximum;
+    if (ds.IsLoading())
+    {
+        scenario_rand_seed(randState.s0, randState.s1);
+    }
+}
+
 struct GameStateSnapshot_t
 {
     GameStateSnapshot_t& operator=(GameStateSnapshot_t&& mv) noexcept
@@ -108,41 +230,7 @@ struct GameStateSnapshot_t
             auto& sprite = *entity;
 
             ds << sprite.base.Type;
-
-            switch (sprite.base.Type)
-            {
-                case EntityType::Vehicle:
-                    reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Guest:
-                    reinterpret_cast<Guest&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Staff:
-                    reinterpret_cast<Staff&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Litter:
-                    reinterpret_cast<Litter&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::MoneyEffect:
-                    reinterpret_cast<MoneyEffect&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Balloon:
-                    reinterpret_cast<Balloon&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Duck:
-                    reinterpret_cast<Duck&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::JumpingFountain:
-                    reinterpret_cast<JumpingFountain&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::SteamParticle:
-                    reinterpret_cast<SteamParticle&>(sprite).Serialise(ds);
-                    break;
-                case EntityType::Null:
-                    break;
-                default:
-                    break;
-            }
+            SerialiseEntity(sprite, ds);
         }
     }
 };
@@ -173,6 +261,10 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         snapshot.SerialiseSprites(
             [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, MAX_ENTITIES, true);
 
+        snapshot.parkParameters.SetPosition(0);
+        DataSerialiser ds(true, snapshot.parkParameters);
+        SerialiseParkParameters(ds);
+
         // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
     }
 
@@ -194,6 +286,155 @@ struct GameStateSnapshots final : public IGameStateSnapshots
         ds << snapshot.parkParameters;
     }
 
+    virtual std::vector<uint32_t> GetEntityBlockHashes(const GameStateSnapshot_t& snapshot) const override final
+    {
+        std::vector<rct_sprite> spriteList = BuildSpriteList(const_cast<GameStateSnapshot_t&>(snapshot));
+
+        // FNV-1a over what the snapshot stores of each entity, so only state a resync can restore is compared.
+        std::vector<uint32_t> hashes((spriteList.size() + EntityBlockSize - 1) / EntityBlockSize, 2166136261u);
+        OpenRCT2::MemoryStream entityData;
+        for (size_t i = 0; i < spriteList.size(); i++)
+        {
+            entityData.SetPosition(0);
+            DataSerialiser ds(true, entityData);
+            ds << spriteList[i].base.Type;
+            SerialiseEntity(spriteList[i], ds);
+
+            auto& hash = hashes[i / EntityBlockSize];
+            const auto* data = static_cast<const uint8_t*>(entityData.GetData());
+            for (uint64_t j = 0; j < entityData.GetPosition(); j++)
+            {
+                hash = (hash ^ data[j]) * 16777619u;
+            }
+        }
+        return hashes;
+    }
+
+    virtual void SerialiseDelta(
+        const GameStateSnapshot_t& snapshot, const std::vector<uint32_t>& blocks, DataSerialiser& ds) const override final
+    {
+        std::vector<rct_sprite> spriteList = BuildSpriteList(const_cast<GameStateSnapshot_t&>(snapshot));
+
+        ds << const_cast<OpenRCT2::MemoryStream&>(snapshot.parkParameters);
+
+        uint32_t numBlocks = static_cast<uint32_t>(blocks.size());
+        ds << numBlocks;
+        for (auto block : blocks)
+        {
+            ds << block;
+            const size_t end = std::min<size_t>(spriteList.size(), (block + 1) * EntityBlockSize);
+            for (size_t i = block * EntityBlockSize; i < end; i++)
+            {
+                ds << spriteList[i].base.Type;
+                SerialiseEntity(spriteList[i], ds);
+            }
+        }
+    }
+
+    virtual bool ApplyDelta(DataSerialiser& ds) override final
+    {
+        OpenRCT2::MemoryStream parkParameters;
+        ds << parkParameters;
+
+        // Read the entities once without touching the game state, so a delta that can not be applied leaves it as it was.
+        const uint64_t entitiesPosition = ds.GetStream().GetPosition();
+        if (!ApplyDeltaEntities(ds, false))
+        {
+            return false;
+        }
+        ds.GetStream().SetPosition(entitiesPosition);
+        if (!ApplyDeltaEntities(ds, true))
+        {
+            return false;
+        }
+
+        // Last, removing and creating entities above may have touched the guest counts.
+        parkParameters.SetPosition(0);
+        DataSerialiser parkDs(false, parkParameters);
+        SerialiseParkParameters(parkDs);
+        return true;
+    }
+
+    bool ApplyDeltaEntities(DataSerialiser& ds, bool apply) const
+    {
+        uint32_t numBlocks = 0;
+        ds << numBlocks;
+        for (uint32_t n = 0; n < numBlocks; n++)
+        {
+            uint32_t block = 0;
+            ds << block;
+            if (block * EntityBlockSize >= MAX_ENTITIES)
+            {
+                log_error("Entity block %u out of range!", block);
+                return false;
+            }
+
+            const size_t end = std::min<size_t>(MAX_ENTITIES, (block + 1) * EntityBlockSize);
+            for (size_t i = block * EntityBlockSize; i < end; i++)
+            {
+                EntityType type = EntityType::Null;
+                ds << type;
+
+                auto* entity = GetEntity(i);
+                if (entity == nullptr)
+                {
+                    return false;
+                }
+                if (!apply)
+                {
+                    if (entity->Type != type
+                        && (!CanCreateEntityFromSnapshot(type) || !CanCreateEntityFromSnapshot(entity->Type)))
+                    {
+                        log_warning("Entity %u can not be replaced by a resync!", static_cast<uint32_t>(i));
+                        return false;
+                    }
+                    rct_sprite scratch;
+                    scratch.base.Type = type;
+                    SerialiseEntity(scratch, ds);
+                    continue;
+                }
+
+                if (entity->Type != EntityType::Null && entity->Type != type)
+                {
+                    sprite_remove(entity);
+                }
+                if (type == EntityType::Null)
+                {
+                    continue;
+                }
+                if (entity->Type == EntityType::Null)
+                {
+                    entity = CreateEntityAt(static_cast<uint16_t>(i), type);
+                    if (entity == nullptr)
+                    {
+                        log_error("Unable to create entity %u!", static_cast<uint32_t>(i));
+                        return false;
+                    }
+                    SetEntitySpriteBounds(*entity);
+                }
+
+                // The snapshot does not store names, the peep keeps its own.
+                auto* peep = entity->As<Peep>();
+                char* name = peep != nullptr ? peep->Name : nullptr;
+
+                // Let the entity move through the spatial index to its new location rather than jump there.
+                const CoordsXYZ oldLocation = { entity->x, entity->y, entity->z };
+                SerialiseEntity(*reinterpret_cast<rct_sprite*>(entity), ds);
+                const CoordsXYZ newLocation = { entity->x, entity->y, entity->z };
+                entity->x = oldLocation.x;
+                entity->y = oldLocation.y;
+                entity->z = oldLocation.z;
+                entity->MoveTo(newLocation);
+
+                if (peep != nullptr)
+                {
+                    peep->Name = name;
+                }
+            }
+        }
+        return true;
+    }
+
     std::vector<rct_sprite> BuildSpriteList(GameStateSnapshot_t& snapshot) const
     {
         std::vector<rct_sprite> spriteList;
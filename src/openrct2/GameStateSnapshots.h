@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 struct GameStateSnapshot_t;
 
@@ -94,6 +95,22 @@ struct IGameStateSnapshots
      */
     virtual void SerialiseSnapshot(GameStateSnapshot_t& snapshot, DataSerialiser& serialiser) const = 0;
 
+    /*
+     * Returns a hash for each block of entity slots, covering what the snapshot stores of those entities.
+     */
+    virtual std::vector<uint32_t> GetEntityBlockHashes(const GameStateSnapshot_t& snapshot) const = 0;
+
+    /*
+     * Writes the park parameters and the entities of the given blocks, from which ApplyDelta restores the snapshot's state.
+     */
+    virtual void SerialiseDelta(
+        const GameStateSnapshot_t& snapshot, const std::vector<uint32_t>& blocks, DataSerialiser& ds) const = 0;
+
+    /*
+     * Patches the current game state in place with a delta written by SerialiseDelta.
+     */
+    virtual bool ApplyDelta(DataSerialiser& ds) = 0;
+
     /*
      * Compares two states resulting GameStateCompareData_t with all mismatches stored.
      */
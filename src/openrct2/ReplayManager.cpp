@@ -98,7 +98,9 @@ namespace OpenRCT2
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 4;
+        static constexpr uint16_t ReplayVersion = 5;
+        // Last version to record the legacy sprite checksum, otherwise the same format.
+        static constexpr uint16_t LegacyChecksumReplayVersion = 4;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
         static constexpr int NormalRecordingChecksumTicks = 1;
@@ -710,7 +712,7 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            return data.version == ReplayVersion || data.version == LegacyChecksumReplayVersion;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -799,7 +801,9 @@ namespace OpenRCT2
             {
                 _currentReplay->checksumIndex++;
 
-                rct_sprite_checksum checksum = sprite_checksum();
+                rct_sprite_checksum checksum = _currentReplay->version == LegacyChecksumReplayVersion
+                    ? sprite_checksum(SpriteChecksumMode::Legacy)
+                    : sprite_checksum();
                 if (savedChecksum.second.raw != checksum.raw)
                 {
                     uint32_t replayTick = gCurrentTicks - _currentReplay->tickStart;
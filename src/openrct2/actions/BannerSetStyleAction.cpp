@@ -11,6 +11,7 @@
 
 #include "../Context.h"
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../util/Util.h"
 #include "../windows/Intent.h"
 #include "../world/Banner.h"
@@ -144,6 +145,7 @@ GameActions::Result::Ptr BannerSetStyleAction::Execute() const
                 allowedEdges &= ~(1 << bannerElement->GetPosition());
             }
             bannerElement->SetAllowedEdges(allowedEdges);
+            PathfindingCacheInvalidateArea(location, 0);
             break;
         }
         default:
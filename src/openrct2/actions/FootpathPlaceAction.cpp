@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/GuestPathfinding.h"
 #include "../world/ConstructionClearance.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
@@ -117,6 +118,11 @@ GameActions::Result::Ptr FootpathPlaceAction::Execute() const
     res->Expenditure = ExpenditureType::Landscaping;
     res->Position = _loc.ToTileCentre();
 
+    // Guests have to search again once the path network changes. Connecting or disconnecting the path changes its
+    // neighbours, which can reconnect a queue on the tile next to them. Ghosts are left out by GameActions.
+    PathfindingCacheArea pathfindingArea(_loc, 2);
+    PathfindingCacheInvalidate();
+
     if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
     {
         footpath_interrupt_peeps(_loc);
@@ -16,6 +16,7 @@
 #include "../core/MemoryStream.h"
 #include "../localisation/Localisation.h"
 #include "../network/network.h"
+#include "../peep/GuestPathfinding.h"
 #include "../platform/platform.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/Duktape.hpp"
@@ -404,7 +405,10 @@ namespace GameActions
             LogActionBegin(logContext, action);
 
             // Execute the action, changing the game state
-            result = action->Execute();
+            {
+                PathfindingCacheGhostScope ghostScope((flags & GAME_COMMAND_FLAG_GHOST) != 0);
+                result = action->Execute();
+            }
 #ifdef ENABLE_SCRIPTING
             if (result->Error == GameActions::Status::Ok)
             {
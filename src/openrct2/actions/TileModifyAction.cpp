@@ -9,6 +9,7 @@
 
 #include "TileModifyAction.h"
 
+#include "../peep/GuestPathfinding.h"
 #include "../world/TileInspector.h"
 
 using namespace OpenRCT2;
@@ -42,6 +43,8 @@ GameActions::Result::Ptr TileModifyAction::Query() const
 
 GameActions::Result::Ptr TileModifyAction::Execute() const
 {
+    // The tile inspector can change anything the guest pathfinding looks at.
+    PathfindingCacheInvalidate();
     return QueryExecute(true);
 }
 
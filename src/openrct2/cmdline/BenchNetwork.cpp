@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+
+#    include "../network/NetworkConnection.h"
+#    include "../network/NetworkPacket.h"
+#    include "../network/Socket.h"
+
+#    include <algorithm>
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <vector>
+
+/**
+ * A connected socket that takes everything it is given, so only the cost of queueing and gathering is measured.
+ */
+class BenchSocket final : public ITcpSocket
+{
+public:
+    SocketStatus GetStatus() const override
+    {
+        return SocketStatus::Connected;
+    }
+    const char* GetError() const override
+    {
+        return nullptr;
+    }
+    const char* GetHostName() const override
+    {
+        return "localhost";
+    }
+    std::string GetIpAddress() const override
+    {
+        return "127.0.0.1";
+    }
+
+    void Listen(uint16_t port) override
+    {
+    }
+    void Listen(const std::string& address, uint16_t port) override
+    {
+    }
+    std::unique_ptr<ITcpSocket> Accept() override
+    {
+        return nullptr;
+    }
+
+    void Connect(const std::string& address, uint16_t port) override
+    {
+    }
+    void ConnectAsync(const std::string& address, uint16_t port) override
+    {
+    }
+
+    size_t SendData(const void* buffer, size_t size) override
+    {
+        return size;
+    }
+    size_t SendData(const SocketSendBuffer* buffers, size_t count) override
+    {
+        size_t size = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            size += buffers[i].Size;
+        }
+        return size;
+    }
+    NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
+    {
+        *sizeReceived = 0;
+        return NetworkReadPacket::NoData;
+    }
+
+    void SetNoDelay(bool noDelay) override
+    {
+    }
+
+    void Finish() override
+    {
+    }
+    void Disconnect() override
+    {
+    }
+    void Close() override
+    {
+    }
+};
+
+static std::vector<std::unique_ptr<NetworkConnection>> CreateConnections(size_t count)
+{
+    std::vector<std::unique_ptr<NetworkConnection>> connections;
+    for (size_t i = 0; i < count; i++)
+    {
+        auto& connection = connections.emplace_back(std::make_unique<NetworkConnection>());
+        connection->Socket = std::make_unique<BenchSocket>();
+        connection->AuthStatus = NetworkAuth::Ok;
+    }
+    return connections;
+}
+
+static NetworkPacket CreateTickPacket(size_t payloadSize)
+{
+    NetworkPacket packet(NetworkCommand::Tick);
+    for (size_t i = 0; i < payloadSize; i++)
+    {
+        packet << static_cast<uint8_t>(i);
+    }
+    return packet;
+}
+
+/**
+ * Sends a packet to every client per iteration as the server does for each tick, with range(0) clients and a payload
+ * of range(1) bytes. Shared queues one buffer to every connection, copied gives each its own.
+ */
+static void BM_broadcast(benchmark::State& state, bool shared)
+{
+    auto connections = CreateConnections(static_cast<size_t>(state.range(0)));
+    const auto payloadSize = static_cast<size_t>(state.range(1));
+
+    uint64_t numBuffers = 0;
+    uint64_t numBytesCopied = 0;
+    for (auto _ : state)
+    {
+        auto packet = CreateTickPacket(payloadSize);
+
+        const auto statsBefore = NetworkPacketGetBufferStats();
+        if (shared)
+        {
+            auto buffer = std::move(packet).ToBuffer();
+            for (auto& connection : connections)
+            {
+                connection->QueuePacket(buffer);
+            }
+        }
+        else
+        {
+            for (auto& connection : connections)
+            {
+                connection->QueuePacket(packet);
+            }
+        }
+        for (auto& connection : connections)
+        {
+            connection->SendQueuedPackets();
+        }
+        const auto statsAfter = NetworkPacketGetBufferStats();
+        numBuffers += statsAfter.Buffers - statsBefore.Buffers;
+        numBytesCopied += statsAfter.BytesCopied - statsBefore.BytesCopied;
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * (sizeof(PacketHeader) + payloadSize));
+    const auto ticks = static_cast<double>(std::max<benchmark::IterationCount>(1, state.iterations()));
+    state.counters["buffers_per_tick"] = benchmark::Counter(static_cast<double>(numBuffers) / ticks);
+    state.counters["bytes_copied_per_tick"] = benchmark::Counter(static_cast<double>(numBytesCopied) / ticks);
+}
+
+static int CmdlineForBenchNetwork(int argc, const char* const* argv)
+{
+    for (auto* bench : {
+             benchmark::RegisterBenchmark("broadcast/shared", BM_broadcast, true),
+             benchmark::RegisterBenchmark("broadcast/copied", BM_broadcast, false),
+         })
+    {
+        // Players, then a small tick packet and a large game action or map chunk.
+        bench->Args({ 8, 32 })->Args({ 32, 32 })->Args({ 32, 4096 })->Args({ 256, 4096 });
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchNetwork(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchNetwork(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark or networking not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+
+const CommandLineCommand CommandLine::BenchNetworkCommands[]{
+#if defined(USE_BENCHMARK) && !defined(DISABLE_NETWORK)
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchNetwork),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchNetwork), CommandTableEnd
+#endif // USE_BENCHMARK && !DISABLE_NETWORK
+};
@@ -0,0 +1,162 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../drawing/Drawing.h"
+#    include "../util/Util.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <random>
+#    include <vector>
+
+// Screen sized frames, converted from 8bpp to the 32bpp texture format as on every frame of the hardware display.
+struct BenchFrame
+{
+    std::vector<uint8_t> Bits;
+    std::vector<uint8_t> LightIntensity;
+    std::vector<uint32_t> Output;
+    uint32_t Palette[256];
+    uint32_t LightPalette[256];
+
+    explicit BenchFrame(size_t count)
+        : Bits(count)
+        , LightIntensity(count)
+        , Output(count)
+    {
+        std::mt19937 random(42);
+        for (auto& pixel : Bits)
+        {
+            pixel = static_cast<uint8_t>(random());
+        }
+        // Mostly dark with lit patches, as in a night scene.
+        for (auto& intensity : LightIntensity)
+        {
+            intensity = random() % 4 == 0 ? static_cast<uint8_t>(random()) : 0;
+        }
+        for (int32_t i = 0; i < 256; i++)
+        {
+            Palette[i] = static_cast<uint32_t>(random());
+            LightPalette[i] = static_cast<uint32_t>(random());
+        }
+    }
+};
+
+static bool IsSupported(benchmark::State& state, bool (*isAvailable)())
+{
+    if (isAvailable != nullptr && !isAvailable())
+    {
+        state.SkipWithError("Not supported by this CPU.");
+        return false;
+    }
+    return true;
+}
+
+static void BM_palette_expand(benchmark::State& state, PaletteExpandFunc expand, bool (*isAvailable)())
+{
+    if (!IsSupported(state, isAvailable))
+        return;
+
+    const auto count = static_cast<size_t>(state.range(0) * state.range(1));
+    BenchFrame frame(count);
+    for (auto _ : state)
+    {
+        expand(frame.Bits.data(), frame.Output.data(), count, frame.Palette);
+        benchmark::DoNotOptimize(frame.Output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(uint32_t));
+}
+
+static void BM_light_blend(benchmark::State& state, LightBlendFunc blend, bool (*isAvailable)())
+{
+    if (!IsSupported(state, isAvailable))
+        return;
+
+    const auto count = static_cast<size_t>(state.range(0) * state.range(1));
+    BenchFrame frame(count);
+    for (auto _ : state)
+    {
+        blend(frame.Bits.data(), frame.LightIntensity.data(), frame.Output.data(), count, frame.Palette, frame.LightPalette);
+        benchmark::DoNotOptimize(frame.Output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * count * sizeof(uint32_t));
+}
+
+static int CmdlineForBenchPaletteExpand(int argc, const char* const* argv)
+{
+    // Arguments are the screen width and height.
+    for (auto* bench : {
+             benchmark::RegisterBenchmark("palette_expand/scalar", BM_palette_expand, palette_expand_scalar, nullptr),
+             benchmark::RegisterBenchmark("palette_expand/avx2", BM_palette_expand, palette_expand_avx2, avx2_available),
+             benchmark::RegisterBenchmark("light_blend/scalar", BM_light_blend, light_blend_scalar, nullptr),
+             benchmark::RegisterBenchmark("light_blend/sse4_1", BM_light_blend, light_blend_sse4_1, sse41_available),
+             benchmark::RegisterBenchmark("light_blend/avx2", BM_light_blend, light_blend_avx2, avx2_available),
+         })
+    {
+        bench->Args({ 1920, 1080 })->Args({ 3840, 2160 });
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchPaletteExpand(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchPaletteExpand(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchPaletteExpand(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchPaletteExpandCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchPaletteExpand),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchPaletteExpand), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -0,0 +1,168 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../OpenRCT2.h"
+#    include "../peep/Guest.h"
+#    include "../platform/Platform2.h"
+#    include "../platform/platform.h"
+#    include "../ride/RideProximityIndex.h"
+#    include "../util/Util.h"
+#    include "../world/EntityList.h"
+#    include "../world/Map.h"
+#    include "../world/TileElementsView.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// Same square guests look at when picking a ride.
+static constexpr int32_t BenchSearchRadius = 10 * COORDS_XY_STEP;
+
+static std::bitset<MAX_RIDES> ScanRidesNearLocation(const CoordsXY& centre)
+{
+    std::bitset<MAX_RIDES> rides;
+    for (int32_t x = centre.x - BenchSearchRadius; x <= centre.x + BenchSearchRadius; x += COORDS_XY_STEP)
+    {
+        for (int32_t y = centre.y - BenchSearchRadius; y <= centre.y + BenchSearchRadius; y += COORDS_XY_STEP)
+        {
+            auto location = CoordsXY{ x, y };
+            if (!map_is_location_valid(location))
+                continue;
+
+            for (auto* trackElement : TileElementsView<TrackElement>(location))
+            {
+                const auto rideIndex = EnumValue(trackElement->GetRideIndex());
+                if (rideIndex < MAX_RIDES)
+                {
+                    rides[rideIndex] = true;
+                }
+            }
+        }
+    }
+    return rides;
+}
+
+static void BM_ride_proximity(benchmark::State& state, const std::string& filename, bool useIndex)
+{
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        state.SkipWithError("Context initialization failed.");
+        return;
+    }
+    if (!context->LoadParkFromFile(filename))
+    {
+        state.SkipWithError("Failed to load file!");
+        return;
+    }
+
+    std::vector<CoordsXY> guestLocations;
+    for (auto* guest : EntityList<Guest>())
+    {
+        if (guest->x == LOCATION_NULL)
+            continue;
+
+        const CoordsXY centre = { floor2(guest->x, COORDS_XY_STEP), floor2(guest->y, COORDS_XY_STEP) };
+        if (GetRidesNearLocation(centre, BenchSearchRadius) != ScanRidesNearLocation(centre))
+        {
+            state.SkipWithError("Index does not match the tile scan!");
+            return;
+        }
+        guestLocations.push_back(centre);
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto& centre : guestLocations)
+        {
+            auto rides = useIndex ? GetRidesNearLocation(centre, BenchSearchRadius) : ScanRidesNearLocation(centre);
+            benchmark::DoNotOptimize(rides);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * guestLocations.size());
+    state.counters["Guests"] = static_cast<double>(guestLocations.size());
+}
+
+static int CmdlineForBenchRideProximity(int argc, const char* const* argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // Extract file names from argument list. If there is no such file, consider it benchmark option.
+    for (int i = 0; i < argc; i++)
+    {
+        if (Platform::FileExists(argv[i]))
+        {
+            std::string name = argv[i];
+            benchmark::RegisterBenchmark((name + "/scan").c_str(), BM_ride_proximity, name, false);
+            benchmark::RegisterBenchmark((name + "/index").c_str(), BM_ride_proximity, name, true);
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+
+    core_init();
+    gOpenRCT2Headless = true;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchRideProximity(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchRideProximity(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchRideProximity(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchRideProximityCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file>... [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchRideProximity),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchRideProximity), CommandTableEnd
+#endif // USE_BENCHMARK
+};
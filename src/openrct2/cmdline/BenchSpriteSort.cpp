@@ -135,8 +135,36 @@ static std::vector<RecordedPaintSession> extract_paint_session(std::string_view
     return sessions;
 }
 
+static std::vector<size_t> get_draw_order(const RecordedPaintSession& session)
+{
+    std::vector<size_t> result;
+    for (auto* ps = session.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        result.push_back(reinterpret_cast<const paint_entry*>(ps) - session.Entries.data());
+    }
+    return result;
+}
+
+// Both arrange implementations have to draw the recorded sessions in the same order, otherwise comparing them is moot.
+static bool check_arrange_order(const std::vector<RecordedPaintSession>& inputSessions)
+{
+    auto sessions = inputSessions;
+    auto legacySessions = inputSessions;
+    fixup_pointers(sessions);
+    fixup_pointers(legacySessions);
+    for (size_t i = 0; i < sessions.size(); i++)
+    {
+        PaintSessionArrange(&sessions[i].Session);
+        PaintSessionArrangeLegacy(&legacySessions[i].Session);
+        if (get_draw_order(sessions[i]) != get_draw_order(legacySessions[i]))
+            return false;
+    }
+    return true;
+}
+
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions)
+static void BM_paint_session_arrange(
+    benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions, bool useLegacy)
 {
     auto sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
@@ -150,7 +178,14 @@ static void BM_paint_session_arrange(benchmark::State& state, const std::vector<
         state.PauseTiming();
         std::copy_n(local_s, std::size(sessions), sessions.begin());
         state.ResumeTiming();
-        PaintSessionArrange(&sessions[0].Session);
+        if (useLegacy)
+        {
+            PaintSessionArrangeLegacy(&sessions[0].Session);
+        }
+        else
+        {
+            PaintSessionArrange(&sessions[0].Session);
+        }
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
@@ -170,7 +205,7 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         {
             quad = reinterpret_cast<paint_struct*>(-1);
         }
-        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
+        benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions, false);
     }
 
     // Google benchmark does stuff to argv. It doesn't modify the pointees,
@@ -187,8 +222,16 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         {
             // Register benchmark for sv6 if valid
             std::vector<RecordedPaintSession> sessions = extract_paint_session(argv[i]);
-            if (!sessions.empty())
-                benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
+            if (sessions.empty())
+                continue;
+
+            if (!check_arrange_order(sessions))
+            {
+                log_error("Paint session arrange order differs from the legacy implementation for %s", argv[i]);
+            }
+            std::string name = argv[i];
+            benchmark::RegisterBenchmark((name + "/legacy").c_str(), BM_paint_session_arrange, sessions, true);
+            benchmark::RegisterBenchmark(name.c_str(), BM_paint_session_arrange, sessions, false);
         }
         else
         {
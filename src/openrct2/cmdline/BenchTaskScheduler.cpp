@@ -0,0 +1,145 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../core/JobPool.h"
+#    include "../core/TaskScheduler.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+// A 3840px wide window is painted in 120 columns of 32px, mimic that with small independent tasks.
+static constexpr int64_t BenchColumnCount = 120;
+
+static void SimulateColumnWork(std::vector<uint32_t>& results, size_t index, int64_t workSize)
+{
+    uint32_t value = static_cast<uint32_t>(index);
+    for (int64_t i = 0; i < workSize; i++)
+    {
+        value = value * 1664525u + 1013904223u;
+    }
+    results[index] = value;
+}
+
+static void BM_jobpool_columns(benchmark::State& state)
+{
+    JobPool jobPool;
+    std::vector<uint32_t> results(BenchColumnCount);
+    const auto workSize = state.range(0);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            jobPool.AddTask([&results, i, workSize]() { SimulateColumnWork(results, i, workSize); });
+        }
+        jobPool.Join();
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * BenchColumnCount);
+}
+
+static void BM_taskscheduler_columns(benchmark::State& state)
+{
+    std::vector<uint32_t> results(BenchColumnCount);
+    const auto workSize = state.range(0);
+    for (auto _ : state)
+    {
+        TaskGroup group;
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            group.Run([&results, i, workSize]() { SimulateColumnWork(results, i, workSize); });
+        }
+        group.Wait();
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * BenchColumnCount);
+}
+
+static void BM_taskscheduler_parallel_for(benchmark::State& state)
+{
+    std::vector<uint32_t> results(BenchColumnCount);
+    const auto workSize = state.range(0);
+    for (auto _ : state)
+    {
+        GetTaskScheduler().ParallelFor(
+            results.size(), [&results, workSize](size_t i) { SimulateColumnWork(results, i, workSize); }, 1);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * BenchColumnCount);
+}
+
+static int CmdlineForBenchTaskScheduler(int argc, const char* const* argv)
+{
+    // Argument is the amount of work per task, from scheduling overhead dominated to compute dominated.
+    for (auto* bench : { benchmark::RegisterBenchmark("jobpool_columns", BM_jobpool_columns),
+                         benchmark::RegisterBenchmark("taskscheduler_columns", BM_taskscheduler_columns),
+                         benchmark::RegisterBenchmark("taskscheduler_parallel_for", BM_taskscheduler_parallel_for) })
+    {
+        bench->Arg(64)->Arg(4096)->Arg(65536)->UseRealTime();
+    }
+
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+    for (int i = 0; i < argc; i++)
+    {
+        argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+    }
+
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchTaskScheduler(CommandLineArgEnumerator* argEnumerator)
+{
+    const char* const* argv = static_cast<const char* const*>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = CmdlineForBenchTaskScheduler(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchTaskScheduler(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchTaskSchedulerCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "[--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchTaskScheduler),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchTaskScheduler), CommandTableEnd
+#endif // USE_BENCHMARK
+};
@@ -16,6 +16,7 @@
 #    include "../OpenRCT2.h"
 #    include "../platform/Platform2.h"
 #    include "../platform/platform.h"
+#    include "../world/EntityList.h"
 
 #    include <benchmark/benchmark.h>
 #    include <cstdint>
@@ -80,6 +81,10 @@ static void BM_update(benchmark::State& state, const std::string& filename)
         state.counters["GameActionsAcc_ms"] = accumulator(LogicTimePart::GameActions);
         state.counters["NetworkFlushAcc_ms"] = accumulator(LogicTimePart::NetworkFlush);
         state.counters["ScriptsAcc_ms"] = accumulator(LogicTimePart::Scripts);
+        // Park size, to relate the Peep and Vehicle buckets to the amount of entities updated.
+        state.counters["Guests"] = GetEntityListCount(EntityType::Guest);
+        state.counters["Staff"] = GetEntityListCount(EntityType::Staff);
+        state.counters["Vehicles"] = GetEntityListCount(EntityType::Vehicle);
     }
     else
     {
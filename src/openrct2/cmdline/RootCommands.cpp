@@ -140,6 +140,10 @@ const CommandLineCommand CommandLine::RootCommands[]
     DefineSubCommand("benchgfx",        CommandLine::BenchGfxCommands         ),
     DefineSubCommand("benchspritesort", CommandLine::BenchSpriteSortCommands  ),
     DefineSubCommand("benchsimulate",   CommandLine::BenchUpdateCommands      ),
+    DefineSubCommand("benchrides",      CommandLine::BenchRideProximityCommands),
+    DefineSubCommand("benchtasks",      CommandLine::BenchTaskSchedulerCommands),
+    DefineSubCommand("benchpalette",    CommandLine::BenchPaletteExpandCommands),
+    DefineSubCommand("benchnetwork",    CommandLine::BenchNetworkCommands      ),
     DefineSubCommand("simulate",        CommandLine::SimulateCommands         ),
     CommandTableEnd
 };
@@ -209,6 +209,8 @@ namespace Config
             model->multithreading = reader->GetBoolean("multi_threading", false);
             model->trap_cursor = reader->GetBoolean("trap_cursor", false);
             model->auto_open_shops = reader->GetBoolean("auto_open_shops", false);
+            model->flow_field_pathfinding = reader->GetBoolean("flow_field_pathfinding", false);
+            model->whole_ride_ratings = reader->GetBoolean("whole_ride_ratings", false);
             model->scenario_select_mode = reader->GetInt32("scenario_select_mode", SCENARIO_SELECT_MODE_ORIGIN);
             model->scenario_unlocking_enabled = reader->GetBoolean("scenario_unlocking_enabled", true);
             model->scenario_hide_mega_park = reader->GetBoolean("scenario_hide_mega_park", true);
@@ -226,6 +228,8 @@ namespace Config
             model->allow_early_completion = reader->GetBoolean("allow_early_completion", false);
             model->transparent_screenshot = reader->GetBoolean("transparent_screenshot", true);
             model->transparent_water = reader->GetBoolean("transparent_water", true);
+            model->sprite_mip_cache_size = reader->GetInt32("sprite_mip_cache_size", 64);
+            model->paint_tile_cache_size = reader->GetInt32("paint_tile_cache_size", 32);
             model->last_version_check_time = reader->GetInt64("last_version_check_time", 0);
         }
     }
@@ -286,6 +290,8 @@ namespace Config
         writer->WriteBoolean("multi_threading", model->multithreading);
         writer->WriteBoolean("trap_cursor", model->trap_cursor);
         writer->WriteBoolean("auto_open_shops", model->auto_open_shops);
+        writer->WriteBoolean("flow_field_pathfinding", model->flow_field_pathfinding);
+        writer->WriteBoolean("whole_ride_ratings", model->whole_ride_ratings);
         writer->WriteInt32("scenario_select_mode", model->scenario_select_mode);
         writer->WriteBoolean("scenario_unlocking_enabled", model->scenario_unlocking_enabled);
         writer->WriteBoolean("scenario_hide_mega_park", model->scenario_hide_mega_park);
@@ -304,6 +310,8 @@ namespace Config
         writer->WriteEnum<VirtualFloorStyles>("virtual_floor_style", model->virtual_floor_style, Enum_VirtualFloorStyle);
         writer->WriteBoolean("transparent_screenshot", model->transparent_screenshot);
         writer->WriteBoolean("transparent_water", model->transparent_water);
+        writer->WriteInt32("sprite_mip_cache_size", model->sprite_mip_cache_size);
+        writer->WriteInt32("paint_tile_cache_size", model->paint_tile_cache_size);
         writer->WriteInt64("last_version_check_time", model->last_version_check_time);
     }
 
@@ -419,7 +427,10 @@ namespace Config
             model->log_chat = reader->GetBoolean("log_chat", false);
             model->log_server_actions = reader->GetBoolean("log_server_actions", false);
             model->pause_server_if_no_clients = reader->GetBoolean("pause_server_if_no_clients", false);
+            model->server_io_thread = reader->GetBoolean("server_io_thread", false);
             model->desync_debugging = reader->GetBoolean("desync_debugging", false);
+            model->resync_on_desync = reader->GetBoolean("resync_on_desync", false);
+            model->verify_sprite_checksums = reader->GetBoolean("verify_sprite_checksums", false);
         }
     }
 
@@ -446,7 +457,10 @@ namespace Config
         writer->WriteBoolean("log_chat", model->log_chat);
         writer->WriteBoolean("log_server_actions", model->log_server_actions);
         writer->WriteBoolean("pause_server_if_no_clients", model->pause_server_if_no_clients);
+        writer->WriteBoolean("server_io_thread", model->server_io_thread);
         writer->WriteBoolean("desync_debugging", model->desync_debugging);
+        writer->WriteBoolean("resync_on_desync", model->resync_on_desync);
+        writer->WriteBoolean("verify_sprite_checksums", model->verify_sprite_checksums);
     }
 
     static void ReadNotifications(IIniReader* reader)
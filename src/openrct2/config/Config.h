@@ -59,6 +59,8 @@ struct GeneralConfiguration
     bool show_guest_purchases;
     bool transparent_screenshot;
     bool transparent_water;
+    int32_t sprite_mip_cache_size;
+    int32_t paint_tile_cache_size;
 
     // Localisation
     int32_t language;
@@ -89,6 +91,8 @@ struct GeneralConfiguration
     bool auto_staff_placement;
     bool handymen_mow_default;
     bool auto_open_shops;
+    bool flow_field_pathfinding;
+    bool whole_ride_ratings;
     int32_t default_inspection_interval;
     int32_t window_limit;
     int32_t scenario_select_mode;
@@ -161,7 +165,10 @@ struct NetworkConfiguration
     bool log_chat;
     bool log_server_actions;
     bool pause_server_if_no_clients;
+    bool server_io_thread;
     bool desync_debugging;
+    bool resync_on_desync;
+    bool verify_sprite_checksums;
 };
 
 struct NotificationConfiguration
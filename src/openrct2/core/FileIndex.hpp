@@ -15,9 +15,9 @@
 #include "File.h"
 #include "FileScanner.h"
 #include "FileStream.h"
-#include "JobPool.h"
 #include "Numerics.hpp"
 #include "Path.hpp"
+#include "TaskScheduler.h"
 
 #include <chrono>
 #include <list>
@@ -201,7 +201,7 @@ private:
         const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
-            JobPool jobPool;
+            OpenRCT2::TaskGroup buildTasks;
             std::mutex printLock; // For verbose prints.
 
             std::list<std::vector<TItem>> containers;
@@ -224,14 +224,15 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                const size_t rangeEnd = rangeStart + stepSize;
+                buildTasks.Run([&, rangeStart, rangeEnd]() {
+                    BuildRange(language, scanResult, rangeStart, rangeEnd, items, processed, printLock);
+                });
 
                 reportProgress();
             }
 
-            jobPool.Join(reportProgress);
+            buildTasks.Wait(reportProgress);
 
             for (const auto& itr : containers)
             {
@@ -162,95 +162,189 @@ namespace Imaging
         }
     }
 
-    static void WritePng(std::ostream& ostream, const Image& image)
+    struct PngWriteState
     {
-        png_structp png_ptr = nullptr;
-        png_colorp png_palette = nullptr;
-        try
-        {
-            png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
-            if (png_ptr == nullptr)
-            {
-                throw std::runtime_error("png_create_write_struct failed.");
-            }
+        png_structp Png = nullptr;
+        png_infop Info = nullptr;
+        png_colorp Palette = nullptr;
+    };
 
-            png_text text_ptr[1];
-            text_ptr[0].key = const_cast<char*>("Software");
-            text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
-            text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
+    static void PngWriteDestroy(PngWriteState& state)
+    {
+        if (state.Png != nullptr)
+        {
+            png_free(state.Png, state.Palette);
+            png_destroy_write_struct(&state.Png, &state.Info);
+        }
+        state = {};
+    }
 
-            auto info_ptr = png_create_info_struct(png_ptr);
-            if (info_ptr == nullptr)
-            {
-                throw std::runtime_error("png_create_info_struct failed.");
-            }
+    static void PngWriteBegin(
+        PngWriteState& state, std::ostream& ostream, uint32_t width, uint32_t height, uint32_t depth,
+        const GamePalette* palette)
+    {
+        state.Png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, PngError, PngWarning);
+        if (state.Png == nullptr)
+        {
+            throw std::runtime_error("png_create_write_struct failed.");
+        }
 
-            if (image.Depth == 8)
-            {
-                if (image.Palette == nullptr)
-                {
-                    throw std::runtime_error("Expected a palette for 8-bit image.");
-                }
+        png_text text_ptr[1];
+        text_ptr[0].key = const_cast<char*>("Software");
+        text_ptr[0].text = const_cast<char*>(gVersionInfoFull);
+        text_ptr[0].compression = PNG_TEXT_COMPRESSION_zTXt;
 
-                // Set the palette
-                png_palette = static_cast<png_colorp>(png_malloc(png_ptr, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
-                if (png_palette == nullptr)
-                {
-                    throw std::runtime_error("png_malloc failed.");
-                }
-                for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
-                {
-                    const auto& entry = (*image.Palette)[static_cast<uint16_t>(i)];
-                    png_palette[i].blue = entry.Blue;
-                    png_palette[i].green = entry.Green;
-                    png_palette[i].red = entry.Red;
-                }
-                png_set_PLTE(png_ptr, info_ptr, png_palette, PNG_MAX_PALETTE_LENGTH);
-            }
-
-            png_set_write_fn(png_ptr, &ostream, PngWriteData, PngFlush);
+        state.Info = png_create_info_struct(state.Png);
+        if (state.Info == nullptr)
+        {
+            throw std::runtime_error("png_create_info_struct failed.");
+        }
 
-            // Set error handler
-            if (setjmp(png_jmpbuf(png_ptr)))
+        if (depth == 8)
+        {
+            if (palette == nullptr)
             {
-                throw std::runtime_error("PNG ERROR");
+                throw std::runtime_error("Expected a palette for 8-bit image.");
             }
 
-            // Write header
-            auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
-            if (image.Depth == 8)
+            // Set the palette
+            state.Palette = static_cast<png_colorp>(png_malloc(state.Png, PNG_MAX_PALETTE_LENGTH * sizeof(png_color)));
+            if (state.Palette == nullptr)
             {
-                png_byte transparentIndex = 0;
-                png_set_tRNS(png_ptr, info_ptr, &transparentIndex, 1, nullptr);
-                colourType = PNG_COLOR_TYPE_PALETTE;
+                throw std::runtime_error("png_malloc failed.");
             }
-            png_set_text(png_ptr, info_ptr, text_ptr, 1);
-            png_set_IHDR(
-                png_ptr, info_ptr, image.Width, image.Height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-            png_write_info(png_ptr, info_ptr);
-
-            // Write pixels
-            auto pixels = image.Pixels.data();
-            for (uint32_t y = 0; y < image.Height; y++)
+            for (size_t i = 0; i < PNG_MAX_PALETTE_LENGTH; i++)
             {
-                png_write_row(png_ptr, const_cast<png_byte*>(pixels));
-                pixels += image.Stride;
+                const auto& entry = (*palette)[static_cast<uint16_t>(i)];
+                state.Palette[i].blue = entry.Blue;
+                state.Palette[i].green = entry.Green;
+                state.Palette[i].red = entry.Red;
             }
+            png_set_PLTE(state.Png, state.Info, state.Palette, PNG_MAX_PALETTE_LENGTH);
+        }
+
+        png_set_write_fn(state.Png, &ostream, PngWriteData, PngFlush);
+
+        // Set error handler
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
 
-            png_write_end(png_ptr, nullptr);
-            png_destroy_info_struct(png_ptr, &info_ptr);
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+        // Write header
+        auto colourType = PNG_COLOR_TYPE_RGB_ALPHA;
+        if (depth == 8)
+        {
+            png_byte transparentIndex = 0;
+            png_set_tRNS(state.Png, state.Info, &transparentIndex, 1, nullptr);
+            colourType = PNG_COLOR_TYPE_PALETTE;
+        }
+        png_set_text(state.Png, state.Info, text_ptr, 1);
+        png_set_IHDR(
+            state.Png, state.Info, width, height, 8, colourType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+            PNG_FILTER_TYPE_DEFAULT);
+        png_write_info(state.Png, state.Info);
+    }
+
+    static void PngWriteRows(PngWriteState& state, const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+    {
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        for (uint32_t y = 0; y < numRows; y++)
+        {
+            png_write_row(state.Png, const_cast<png_byte*>(pixels));
+            pixels += stride;
+        }
+    }
+
+    static void PngWriteEnd(PngWriteState& state)
+    {
+        if (setjmp(png_jmpbuf(state.Png)))
+        {
+            throw std::runtime_error("PNG ERROR");
+        }
+
+        png_write_end(state.Png, nullptr);
+    }
+
+    static void WritePng(std::ostream& ostream, const Image& image)
+    {
+        PngWriteState state;
+        try
+        {
+            PngWriteBegin(state, ostream, image.Width, image.Height, image.Depth, image.Palette.get());
+            PngWriteRows(state, image.Pixels.data(), image.Height, image.Stride);
+            PngWriteEnd(state);
+            PngWriteDestroy(state);
+        }
+        catch (const std::exception&)
+        {
+            PngWriteDestroy(state);
+            throw;
+        }
+    }
+
+    static std::ofstream OpenOutputFile(std::string_view path)
+    {
+#if defined(_WIN32) && !defined(__MINGW32__)
+        auto pathW = String::ToWideChar(path);
+        return std::ofstream(pathW, std::ios::binary);
+#else
+        return std::ofstream(std::string(path), std::ios::binary);
+#endif
+    }
+
+    struct PngFileWriter::Impl
+    {
+        std::ofstream Stream;
+        PngWriteState State;
+        uint32_t RowsLeft{};
+    };
+
+    PngFileWriter::PngFileWriter(
+        std::string_view path, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette)
+        : _impl(std::make_unique<Impl>())
+    {
+        _impl->Stream = OpenOutputFile(path);
+        if (!_impl->Stream.is_open())
+        {
+            throw std::runtime_error("Unable to open " + std::string(path) + " for writing.");
+        }
+        _impl->RowsLeft = height;
+        try
+        {
+            PngWriteBegin(_impl->State, _impl->Stream, width, height, depth, palette);
         }
         catch (const std::exception&)
         {
-            png_free(png_ptr, png_palette);
-            png_destroy_write_struct(&png_ptr, nullptr);
+            PngWriteDestroy(_impl->State);
             throw;
         }
     }
 
+    PngFileWriter::~PngFileWriter()
+    {
+        PngWriteDestroy(_impl->State);
+    }
+
+    void PngFileWriter::WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride)
+    {
+        Guard::Assert(numRows <= _impl->RowsLeft, "More rows written than the image has.");
+        PngWriteRows(_impl->State, pixels, numRows, stride);
+        _impl->RowsLeft -= numRows;
+    }
+
+    void PngFileWriter::Finish()
+    {
+        Guard::Assert(_impl->RowsLeft == 0, "Image finished before all of its rows were written.");
+        PngWriteEnd(_impl->State);
+        PngWriteDestroy(_impl->State);
+        _impl->Stream.close();
+    }
+
     IMAGE_FORMAT GetImageFormatFromPath(std::string_view path)
     {
         if (String::EndsWith(path, ".png", true))
@@ -337,12 +431,7 @@ namespace Imaging
                 break;
             case IMAGE_FORMAT::PNG:
             {
-#if defined(_WIN32) && !defined(__MINGW32__)
-                auto pathW = String::ToWideChar(path);
-                std::ofstream fs(pathW, std::ios::binary);
-#else
-                std::ofstream fs(std::string(path), std::ios::binary);
-#endif
+                auto fs = OpenOutputFile(path);
                 WritePng(fs, image);
                 break;
             }
@@ -52,4 +52,25 @@ namespace Imaging
     void WriteToFile(std::string_view path, const Image& image, IMAGE_FORMAT format = IMAGE_FORMAT::AUTOMATIC);
 
     void SetReader(IMAGE_FORMAT format, ImageReaderFunc impl);
+
+    /**
+     * Encodes a PNG file band by band, so only the rows passed to WriteRows need to be held in memory.
+     * Finish must be called once all rows have been written, destroying the writer before that leaves a truncated file.
+     */
+    class PngFileWriter
+    {
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+
+    public:
+        PngFileWriter(std::string_view path, uint32_t width, uint32_t height, uint32_t depth, const GamePalette* palette);
+        ~PngFileWriter();
+
+        PngFileWriter(const PngFileWriter&) = delete;
+        PngFileWriter& operator=(const PngFileWriter&) = delete;
+
+        void WriteRows(const uint8_t* pixels, uint32_t numRows, uint32_t stride);
+        void Finish();
+    };
 } // namespace Imaging
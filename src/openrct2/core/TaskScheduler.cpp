@@ -0,0 +1,259 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include <cassert>
+
+using namespace OpenRCT2;
+
+// Index of the queue owned by the current thread, only valid for workers of _currentScheduler.
+static thread_local TaskScheduler* _currentScheduler = nullptr;
+static thread_local size_t _currentQueueIndex = 0;
+
+void TaskScheduler::WorkQueue::Push(Task&& task)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Count == Tasks.size())
+    {
+        // Grow and unwrap the ring.
+        std::vector<Task> newTasks(std::max<size_t>(16, Tasks.size() * 2));
+        for (size_t i = 0; i < Count; i++)
+        {
+            newTasks[i] = std::move(Tasks[(Head + i) % Tasks.size()]);
+        }
+        Tasks = std::move(newTasks);
+        Head = 0;
+    }
+    Tasks[(Head + Count) % Tasks.size()] = std::move(task);
+    Count++;
+}
+
+bool TaskScheduler::WorkQueue::PopBack(Task& task)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Count == 0)
+        return false;
+
+    Count--;
+    task = std::move(Tasks[(Head + Count) % Tasks.size()]);
+    return true;
+}
+
+bool TaskScheduler::WorkQueue::PopFront(Task& task)
+{
+    std::lock_guard<std::mutex> lock(Mutex);
+    if (Count == 0)
+        return false;
+
+    task = std::move(Tasks[Head]);
+    Head = (Head + 1) % Tasks.size();
+    Count--;
+    return true;
+}
+
+TaskScheduler::TaskScheduler(size_t numWorkers)
+{
+    _queues.reserve(numWorkers);
+    for (size_t n = 0; n < numWorkers; n++)
+    {
+        _queues.push_back(std::make_unique<WorkQueue>());
+    }
+    _threads.reserve(numWorkers);
+    for (size_t n = 0; n < numWorkers; n++)
+    {
+        _threads.emplace_back(&TaskScheduler::ProcessQueue, this, n);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+        _condWork.notify_all();
+    }
+
+    for (auto& th : _threads)
+    {
+        assert(th.joinable() != false);
+        th.join();
+    }
+}
+
+void TaskScheduler::Submit(Task&& task)
+{
+    size_t queueIndex;
+    if (_currentScheduler == this)
+    {
+        queueIndex = _currentQueueIndex;
+    }
+    else
+    {
+        queueIndex = _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    }
+    // Count first so the counter never drops below the number of queued tasks.
+    _queued.fetch_add(1);
+    _queues[queueIndex]->Push(std::move(task));
+
+    // Only pay for the lock when somebody is actually asleep, see ProcessQueue for the other half.
+    if (_sleeping.load() > 0)
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _condWork.notify_one();
+    }
+}
+
+bool TaskScheduler::TryAcquire(Task& task)
+{
+    if (_queued.load(std::memory_order_relaxed) == 0)
+        return false;
+
+    const bool isWorker = _currentScheduler == this;
+    const size_t numQueues = _queues.size();
+    const size_t first = isWorker ? _currentQueueIndex : _nextQueue.load(std::memory_order_relaxed) % numQueues;
+
+    if (isWorker && _queues[first]->PopBack(task))
+    {
+        _queued.fetch_sub(1);
+        return true;
+    }
+
+    for (size_t i = isWorker ? 1 : 0; i < numQueues; i++)
+    {
+        if (_queues[(first + i) % numQueues]->PopFront(task))
+        {
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::Execute(Task& task)
+{
+    auto* group = task.GetGroup();
+    std::exception_ptr exception;
+    if (!group->IsCancelled())
+    {
+        try
+        {
+            task.Invoke();
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+        }
+    }
+    task.Reset();
+    group->OnTaskComplete(exception);
+}
+
+void TaskScheduler::ProcessQueue(size_t index)
+{
+    _currentScheduler = this;
+    _currentQueueIndex = index;
+
+    Task task;
+    while (!_shouldStop)
+    {
+        if (TryAcquire(task))
+        {
+            Execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleeping.fetch_add(1);
+        _condWork.wait(lock, [this]() { return _shouldStop || _queued.load() > 0; });
+        _sleeping.fetch_sub(1);
+    }
+}
+
+TaskGroup::TaskGroup()
+    : TaskGroup(GetTaskScheduler())
+{
+}
+
+TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : _scheduler(scheduler)
+{
+}
+
+TaskGroup::~TaskGroup()
+{
+    // Tasks reference the group, never let it go away underneath them.
+    if (_pending != 0)
+    {
+        Cancel();
+        try
+        {
+            Wait();
+        }
+        catch (...)
+        {
+        }
+    }
+}
+
+void TaskGroup::Wait(const std::function<void()>& reportFn)
+{
+    using namespace std::chrono_literals;
+
+    Task task;
+    while (_pending.load() != 0)
+    {
+        if (_scheduler.TryAcquire(task))
+        {
+            _scheduler.Execute(task);
+        }
+        else
+        {
+            // Wake up now and then, new tasks may have been queued that nobody else is free to pick up.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condComplete.wait_for(lock, reportFn ? 100ms : 1ms, [this]() { return _pending.load() == 0; });
+        }
+
+        if (reportFn)
+        {
+            reportFn();
+        }
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(exception, _exception);
+    }
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskGroup::OnTaskComplete(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (exception && !_exception)
+    {
+        _exception = exception;
+    }
+
+    // Decrement under the lock, Wait() takes it before returning so the group outlives this call.
+    if (_pending.fetch_sub(1) == 1)
+    {
+        _condComplete.notify_all();
+    }
+}
+
+TaskScheduler& OpenRCT2::GetTaskScheduler()
+{
+    static TaskScheduler scheduler(std::max<size_t>(1, std::thread::hardware_concurrency()) - 1);
+    return scheduler;
+}
@@ -0,0 +1,313 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace OpenRCT2
+{
+    class TaskGroup;
+    class TaskScheduler;
+
+    /**
+     * Type erased callable with fixed inline storage. Tasks are queued and moved around a lot, keeping the
+     * captures inline means submitting a task never touches the allocator.
+     */
+    class Task
+    {
+    public:
+        static constexpr size_t StorageSize = 64;
+
+    private:
+        struct Ops
+        {
+            void (*Invoke)(void* storage);
+            void (*Move)(void* dst, void* src);
+            void (*Destroy)(void* storage);
+        };
+
+        template<typename TFunc> static const Ops* GetOps()
+        {
+            static constexpr Ops ops = {
+                [](void* storage) { (*static_cast<TFunc*>(storage))(); },
+                [](void* dst, void* src) {
+                    new (dst) TFunc(std::move(*static_cast<TFunc*>(src)));
+                    static_cast<TFunc*>(src)->~TFunc();
+                },
+                [](void* storage) { static_cast<TFunc*>(storage)->~TFunc(); },
+            };
+            return &ops;
+        }
+
+        alignas(std::max_align_t) std::byte _storage[StorageSize];
+        const Ops* _ops = nullptr;
+        TaskGroup* _group = nullptr;
+
+    public:
+        Task() = default;
+
+        template<typename TFunc, typename = std::enable_if_t<!std::is_same_v<std::decay_t<TFunc>, Task>>>
+        Task(TaskGroup* group, TFunc&& func)
+            : _group(group)
+        {
+            using TStored = std::decay_t<TFunc>;
+            static_assert(sizeof(TStored) <= StorageSize, "Task captures too large, capture by reference instead.");
+            static_assert(alignof(TStored) <= alignof(std::max_align_t), "Task captures are over-aligned.");
+            new (_storage) TStored(std::forward<TFunc>(func));
+            _ops = GetOps<TStored>();
+        }
+
+        Task(Task&& other) noexcept
+            : _ops(other._ops)
+            , _group(other._group)
+        {
+            if (_ops != nullptr)
+            {
+                _ops->Move(_storage, other._storage);
+                other._ops = nullptr;
+            }
+        }
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                _ops = other._ops;
+                _group = other._group;
+                if (_ops != nullptr)
+                {
+                    _ops->Move(_storage, other._storage);
+                    other._ops = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task()
+        {
+            Reset();
+        }
+
+        bool IsValid() const
+        {
+            return _ops != nullptr;
+        }
+
+        TaskGroup* GetGroup() const
+        {
+            return _group;
+        }
+
+        void Invoke()
+        {
+            _ops->Invoke(_storage);
+        }
+
+        void Reset()
+        {
+            if (_ops != nullptr)
+            {
+                _ops->Destroy(_storage);
+                _ops = nullptr;
+            }
+        }
+    };
+
+    /**
+     * Work-stealing thread pool. Each worker owns a queue, it pushes and pops from the back of its own queue
+     * and steals from the front of the other queues when it runs dry. Threads outside of the pool distribute
+     * their tasks round-robin and help executing tasks while they wait on a TaskGroup.
+     */
+    class TaskScheduler
+    {
+        friend class TaskGroup;
+
+    private:
+        /**
+         * Ring buffer of tasks guarded by its own lock, only the owner and the occasional thief contend on it.
+         * Storage grows on demand and is kept, so a warmed up queue does not allocate.
+         */
+        struct WorkQueue
+        {
+            std::mutex Mutex;
+            std::vector<Task> Tasks;
+            size_t Head = 0;
+            size_t Count = 0;
+
+            void Push(Task&& task);
+            bool PopBack(Task& task);
+            bool PopFront(Task& task);
+        };
+
+        std::vector<std::thread> _threads;
+        std::vector<std::unique_ptr<WorkQueue>> _queues;
+        std::atomic<size_t> _queued = { 0 };
+        std::atomic<size_t> _sleeping = { 0 };
+        std::atomic<size_t> _nextQueue = { 0 };
+        std::atomic_bool _shouldStop = { false };
+        std::condition_variable _condWork;
+        std::mutex _sleepMutex;
+
+    public:
+        explicit TaskScheduler(size_t numWorkers);
+        ~TaskScheduler();
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        size_t GetNumWorkers() const
+        {
+            return _threads.size();
+        }
+
+        /**
+         * Runs func(begin, end) over chunks of [0, count) and waits for all of them. The calling thread takes part
+         * in the work. A grain size of 0 picks a chunk size based on the number of workers.
+         */
+        template<typename TFunc> void ParallelForRange(size_t count, TFunc&& func, size_t grainSize = 0);
+
+        /**
+         * Runs func(i) for every i in [0, count) and waits for all of them.
+         */
+        template<typename TFunc> void ParallelFor(size_t count, TFunc&& func, size_t grainSize = 0)
+        {
+            ParallelForRange(
+                count,
+                [&func](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                    {
+                        func(i);
+                    }
+                },
+                grainSize);
+        }
+
+    private:
+        void Submit(Task&& task);
+        bool TryAcquire(Task& task);
+        void Execute(Task& task);
+        void ProcessQueue(size_t index);
+    };
+
+    /**
+     * Set of tasks that can be waited on or cancelled together. Cancelling skips all tasks of the group that have
+     * not started yet, running tasks can poll IsCancelled() to stop early. The first exception thrown by a task is
+     * rethrown by Wait().
+     */
+    class TaskGroup
+    {
+        friend class TaskScheduler;
+
+    private:
+        TaskScheduler& _scheduler;
+        std::atomic<size_t> _pending = { 0 };
+        std::atomic_bool _cancelled = { false };
+        std::exception_ptr _exception;
+        std::condition_variable _condComplete;
+        std::mutex _mutex;
+
+    public:
+        TaskGroup();
+        explicit TaskGroup(TaskScheduler& scheduler);
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template<typename TFunc> void Run(TFunc&& func)
+        {
+            if (_scheduler.GetNumWorkers() == 0)
+            {
+                // Nothing to hand the work to, run it right away.
+                if (!IsCancelled())
+                {
+                    func();
+                }
+                return;
+            }
+            _pending.fetch_add(1, std::memory_order_relaxed);
+            _scheduler.Submit(Task(this, std::forward<TFunc>(func)));
+        }
+
+        /**
+         * Blocks until all tasks of the group have finished, executing queued tasks in the meantime.
+         * reportFn, if given, is invoked periodically while waiting.
+         */
+        void Wait(const std::function<void()>& reportFn = nullptr);
+
+        void Cancel()
+        {
+            _cancelled = true;
+        }
+
+        bool IsCancelled() const
+        {
+            return _cancelled;
+        }
+
+        size_t CountPending() const
+        {
+            return _pending;
+        }
+
+    private:
+        void OnTaskComplete(std::exception_ptr exception);
+    };
+
+    template<typename TFunc> void TaskScheduler::ParallelForRange(size_t count, TFunc&& func, size_t grainSize)
+    {
+        if (count == 0)
+            return;
+
+        if (grainSize == 0)
+        {
+            // A few chunks per thread gives stealing something to balance with.
+            const size_t numChunks = (GetNumWorkers() + 1) * 4;
+            grainSize = std::max<size_t>(1, (count + numChunks - 1) / numChunks);
+        }
+
+        if (GetNumWorkers() == 0 || grainSize >= count)
+        {
+            func(size_t{ 0 }, count);
+            return;
+        }
+
+        TaskGroup group(*this);
+        for (size_t begin = 0; begin < count; begin += grainSize)
+        {
+            const size_t end = std::min(count, begin + grainSize);
+            group.Run([&func, begin, end]() { func(begin, end); });
+        }
+        group.Wait();
+    }
+
+    /**
+     * Returns the scheduler shared by the whole process, started on first use with one worker less than the number
+     * of hardware threads as the waiting thread helps out.
+     */
+    TaskScheduler& GetTaskScheduler();
+} // namespace OpenRCT2
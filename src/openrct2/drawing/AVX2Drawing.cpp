@@ -42,6 +42,123 @@ void mask_avx2(
     }
 }
 
+// Same lookup as the SSE4.1 version, vpshufb works within 128 bit lanes so each block is loaded into both lanes.
+static __m256i LookupPaletteAVX2(const uint8_t* lut, __m256i indices)
+{
+    const __m256i blockSize = _mm256_set1_epi8(16);
+    const __m256i bias = _mm256_set1_epi8(0x70);
+    __m256i result = _mm256_setzero_si256();
+    for (int32_t block = 0; block < 16; block++)
+    {
+        const __m256i table = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(lut + block * 16)));
+        result = _mm256_or_si256(result, _mm256_shuffle_epi8(table, _mm256_adds_epu8(indices, bias)));
+        indices = _mm256_sub_epi8(indices, blockSize);
+    }
+    return result;
+}
+
+template<DrawBlendOp TBlendOp>
+static void BlitRunAVX2(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, size_t count, const PaletteMap& paletteMap)
+{
+    static_assert((TBlendOp & BLEND_SRC) == 0 || (TBlendOp & BLEND_DST) == 0, "Blending two pixels has no vector version");
+
+    const uint8_t* lut = nullptr;
+    if constexpr ((TBlendOp & (BLEND_SRC | BLEND_DST)) != 0)
+    {
+        lut = paletteMap.GetLookupTable();
+        if (lut == nullptr)
+        {
+            BlitPixelRun<TBlendOp>(src, dst, count, paletteMap);
+            return;
+        }
+    }
+
+    const __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        const __m256i source = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        [[maybe_unused]] const __m256i dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i pixel;
+        if constexpr ((TBlendOp & BLEND_SRC) != 0)
+            pixel = LookupPaletteAVX2(lut, source);
+        else if constexpr ((TBlendOp & BLEND_DST) != 0)
+            pixel = LookupPaletteAVX2(lut, dest);
+        else
+            pixel = source;
+
+        if constexpr ((TBlendOp & BLEND_TRANSPARENT) != 0)
+        {
+            // Keep the destination where the source is transparent or the palette maps to transparent
+            __m256i keep = _mm256_cmpeq_epi8(source, zero);
+            if constexpr ((TBlendOp & (BLEND_SRC | BLEND_DST)) != 0)
+                keep = _mm256_or_si256(keep, _mm256_cmpeq_epi8(pixel, zero));
+            pixel = _mm256_blendv_epi8(pixel, dest, keep);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), pixel);
+    }
+    BlitPixelRun<TBlendOp>(src + i, dst + i, count - i, paletteMap);
+}
+
+void blit_run_init_avx2(BlitRunTable& table)
+{
+    table[BLEND_TRANSPARENT] = BlitRunAVX2<BLEND_TRANSPARENT>;
+    table[BLEND_SRC] = BlitRunAVX2<BLEND_SRC>;
+    table[BLEND_TRANSPARENT | BLEND_SRC] = BlitRunAVX2<BLEND_TRANSPARENT | BLEND_SRC>;
+    table[BLEND_DST] = BlitRunAVX2<BLEND_DST>;
+    table[BLEND_TRANSPARENT | BLEND_DST] = BlitRunAVX2<BLEND_TRANSPARENT | BLEND_DST>;
+}
+
+static __m256i LoadIndicesAVX2(const uint8_t* src)
+{
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+}
+
+void palette_expand_avx2(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette)
+{
+    const auto* table = reinterpret_cast<const int32_t*>(palette);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i colours = _mm256_i32gather_epi32(table, LoadIndicesAVX2(src + i), 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), colours);
+    }
+    palette_expand_scalar(src + i, dst + i, count - i, palette);
+}
+
+// Same as the SSE4.1 version for eight pixels, the unpacks and the pack stay within 128 bit lanes so the order holds.
+static __m256i LightBlendAVX2(__m256i dark, __m256i light, __m256i intensity)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i intensity16 = _mm256_or_si256(intensity, _mm256_slli_epi32(intensity, 16));
+    const __m256i intensityLo = _mm256_unpacklo_epi32(intensity16, intensity16);
+    const __m256i intensityHi = _mm256_unpackhi_epi32(intensity16, intensity16);
+    const __m256i lo = _mm256_add_epi16(
+        _mm256_unpacklo_epi8(dark, zero), _mm256_mulhi_epu16(_mm256_unpacklo_epi8(zero, light), intensityLo));
+    const __m256i hi = _mm256_add_epi16(
+        _mm256_unpackhi_epi8(dark, zero), _mm256_mulhi_epu16(_mm256_unpackhi_epi8(zero, light), intensityHi));
+    return _mm256_packus_epi16(lo, hi);
+}
+
+void light_blend_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    const auto* darkTable = reinterpret_cast<const int32_t*>(palette);
+    const auto* lightTable = reinterpret_cast<const int32_t*>(lightPalette);
+    const __m256i scale = _mm256_set1_epi32(6);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256i indices = LoadIndicesAVX2(src + i);
+        const __m256i dark = _mm256_i32gather_epi32(darkTable, indices, 4);
+        const __m256i light = _mm256_i32gather_epi32(lightTable, indices, 4);
+        const __m256i intensity = _mm256_mullo_epi16(LoadIndicesAVX2(lightIntensity + i), scale);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), LightBlendAVX2(dark, light, intensity));
+    }
+    light_blend_scalar(src + i, lightIntensity + i, dst + i, count - i, palette, lightPalette);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -55,4 +172,21 @@ void mask_avx2(
     openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
 }
 
+void blit_run_init_avx2(BlitRunTable& table)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void palette_expand_avx2(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
+void light_blend_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    openrct2_assert(false, "AVX2 function called on a CPU that doesn't support AVX2");
+}
+
 #endif // __AVX2__
@@ -47,6 +47,17 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawBMPSpriteMinify(rct_draw
     size_t srcLineWidth = g1.width * zoomLevel;
     size_t dstLineWidth = (static_cast<size_t>(dpi.width) / zoomLevel) + dpi.pitch;
     uint8_t zoom = 1 * zoomLevel;
+    if (zoom == 1)
+    {
+        // Every pixel of a row is sampled, so the rows can be blitted as whole runs
+        for (; height > 0 && width > 0; height--)
+        {
+            BlitRun<TBlendOp>(src, dst, width, paletteMap);
+            src += srcLineWidth;
+            dst += dstLineWidth;
+        }
+        return;
+    }
     for (; height > 0; height -= zoom)
     {
         auto nextSrc = src + srcLineWidth;
@@ -8,6 +8,7 @@
  *****************************************************************************/
 
 #include "Drawing.h"
+#include "SpriteMipCache.h"
 
 #include <algorithm>
 #include <cstring>
@@ -163,6 +164,13 @@ static void FASTCALL DrawRLESpriteMinify(rct_drawpixelinfo& dpi, const DrawSprit
                     std::memcpy(dst, src, numPixels);
                 }
             }
+            else if constexpr (TZoom == 0)
+            {
+                if (numPixels > 0)
+                {
+                    BlitRun<TBlendOp>(src, dst, numPixels, args.PalMap);
+                }
+            }
             else
             {
                 auto& paletteMap = args.PalMap;
@@ -178,6 +186,60 @@ static void FASTCALL DrawRLESpriteMinify(rct_drawpixelinfo& dpi, const DrawSprit
     }
 }
 
+/**
+ * Draws a zoomed out sprite from its reduced copy in the mip cache at zoom 0, which gives the same pixels as
+ * DrawRLESpriteMinify without decoding the rows and pixels that are skipped. Returns false if there is no copy.
+ */
+template<DrawBlendOp TBlendOp, size_t TZoom>
+static bool FASTCALL DrawRLESpriteFromMip(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
+{
+    auto dst0 = args.DestinationBits;
+    auto srcX = args.SrcX;
+    auto srcY = args.SrcY;
+    auto width = args.Width;
+    auto height = args.Height;
+    auto zoom = 1 << TZoom;
+    auto dstLineWidth = (static_cast<size_t>(dpi.width) >> TZoom) + dpi.pitch;
+
+    // Same adjustment as DrawRLESpriteMinify
+    if (srcY < 0)
+    {
+        srcY += zoom;
+        height -= zoom;
+        dst0 += dstLineWidth;
+    }
+    if (srcY < 0)
+        return false;
+
+    // Only the columns and rows in the phase of the source start are sampled.
+    const int32_t phaseX = srcX & (zoom - 1);
+    const int32_t phaseY = srcY & (zoom - 1);
+    auto mip = SpriteMipCacheGet(args.Image.GetIndex(), args.SourceImage, TZoom, phaseX, phaseY);
+    if (mip == nullptr)
+        return false;
+
+    if (width > 0 && height > 0)
+    {
+        auto mipDpi = dpi;
+        mipDpi.width = dpi.width >> TZoom;
+        mipDpi.zoom_level = 0;
+        DrawSpriteArgs mipArgs(
+            args.Image, args.PalMap, mip->Element, (srcX - phaseX) / zoom, (srcY - phaseY) / zoom, (width + zoom - 1) / zoom,
+            (height + zoom - 1) / zoom, dst0);
+        DrawRLESpriteMinify<TBlendOp, 0>(mipDpi, mipArgs);
+    }
+    return true;
+}
+
+template<DrawBlendOp TBlendOp, size_t TZoom>
+static void FASTCALL DrawRLESpriteZoomedOut(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
+{
+    if (!DrawRLESpriteFromMip<TBlendOp, TZoom>(dpi, args))
+    {
+        DrawRLESpriteMinify<TBlendOp, TZoom>(dpi, args);
+    }
+}
+
 template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(rct_drawpixelinfo& dpi, const DrawSpriteArgs& args)
 {
     auto zoom_level = static_cast<int8_t>(dpi.zoom_level);
@@ -193,13 +255,13 @@ template<DrawBlendOp TBlendOp> static void FASTCALL DrawRLESprite(rct_drawpixeli
             DrawRLESpriteMinify<TBlendOp, 0>(dpi, args);
             break;
         case 1:
-            DrawRLESpriteMinify<TBlendOp, 1>(dpi, args);
+            DrawRLESpriteZoomedOut<TBlendOp, 1>(dpi, args);
             break;
         case 2:
-            DrawRLESpriteMinify<TBlendOp, 2>(dpi, args);
+            DrawRLESpriteZoomedOut<TBlendOp, 2>(dpi, args);
             break;
         case 3:
-            DrawRLESpriteMinify<TBlendOp, 3>(dpi, args);
+            DrawRLESpriteZoomedOut<TBlendOp, 3>(dpi, args);
             break;
         default:
             assert(false);
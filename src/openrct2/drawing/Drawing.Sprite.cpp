@@ -19,6 +19,7 @@
 #include "../util/Util.h"
 #include "Drawing.h"
 #include "ScrollingText.h"
+#include "SpriteMipCache.h"
 
 #include <algorithm>
 #include <memory>
@@ -241,6 +242,7 @@ bool gfx_load_g1(const IPlatformEnvironment& env)
 
 void gfx_unload_g1()
 {
+    SpriteMipCacheClear();
     _g1.data.reset();
     _g1.elements.clear();
     _g1.elements.shrink_to_fit();
@@ -248,6 +250,7 @@ void gfx_unload_g1()
 
 void gfx_unload_g2()
 {
+    SpriteMipCacheClear();
     _g2.data.reset();
     _g2.elements.clear();
     _g2.elements.shrink_to_fit();
@@ -255,6 +258,7 @@ void gfx_unload_g2()
 
 void gfx_unload_csg()
 {
+    SpriteMipCacheClear();
     _csg.data.reset();
     _csg.elements.clear();
     _csg.elements.shrink_to_fit();
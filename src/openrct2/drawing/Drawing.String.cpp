@@ -545,12 +545,12 @@ static void ttf_draw_string_raw_ttf(rct_drawpixelinfo* dpi, std::string_view tex
 
     if (info->flags & TEXT_DRAW_FLAG_NO_DRAW)
     {
-        info->x += ttf_getwidth_cache_get_or_add(fontDesc->font, text);
+        info->x += ttf_get_string_width(fontDesc->font, text);
         return;
     }
 
     uint8_t colour = info->palette[1];
-    TTFSurface* surface = ttf_surface_cache_get_or_add(fontDesc->font, text);
+    TTFSurface* surface = ttf_render_string(fontDesc->font, text);
     if (surface == nullptr)
         return;
 
@@ -21,6 +21,7 @@
 #include "../world/Water.h"
 
 #include <cstring>
+#include <utility>
 
 const PaletteMap& PaletteMap::GetDefault()
 {
@@ -571,6 +572,107 @@ void mask_init()
     }
 }
 
+template<size_t... TBlendOps> static void FillBlitRunTable(BlitRunTable& table, std::index_sequence<TBlendOps...>)
+{
+    ((table[TBlendOps] = BlitPixelRun<static_cast<DrawBlendOp>(TBlendOps)>), ...);
+}
+
+void blit_run_init_scalar(BlitRunTable& table)
+{
+    FillBlitRunTable(table, std::make_index_sequence<std::tuple_size_v<BlitRunTable>>());
+}
+
+static BlitRunTable CreateScalarBlitRunTable()
+{
+    BlitRunTable table;
+    blit_run_init_scalar(table);
+    return table;
+}
+
+BlitRunTable blit_run_fns = CreateScalarBlitRunTable();
+
+void blit_run_init()
+{
+    blit_run_init_scalar(blit_run_fns);
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 sprite run functions");
+        blit_run_init_avx2(blit_run_fns);
+    }
+    else if (sse41_available())
+    {
+        log_verbose("registering SSE4.1 sprite run functions");
+        blit_run_init_sse4_1(blit_run_fns);
+    }
+    else
+    {
+        log_verbose("registering scalar sprite run functions");
+    }
+}
+
+void palette_expand_scalar(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = palette[src[i]];
+    }
+}
+
+static uint32_t LightBlendChannel(uint32_t dark, uint32_t light, uint32_t intensity)
+{
+    return std::min<uint32_t>(255, dark + ((light * intensity * 6) >> 8));
+}
+
+void light_blend_scalar(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t darkColour = palette[src[i]];
+        const uint32_t intensity = lightIntensity[i];
+        if (intensity == 0)
+        {
+            dst[i] = darkColour;
+            continue;
+        }
+
+        const uint32_t lightColour = lightPalette[src[i]];
+        uint32_t colour = 0;
+        for (int32_t shift = 0; shift < 32; shift += 8)
+        {
+            colour |= LightBlendChannel((darkColour >> shift) & 0xFF, (lightColour >> shift) & 0xFF, intensity) << shift;
+        }
+        dst[i] = colour;
+    }
+}
+
+PaletteExpandFunc palette_expand_fn = palette_expand_scalar;
+LightBlendFunc light_blend_fn = light_blend_scalar;
+
+void palette_expand_init()
+{
+    if (avx2_available())
+    {
+        log_verbose("registering AVX2 palette expansion functions");
+        palette_expand_fn = palette_expand_avx2;
+        light_blend_fn = light_blend_avx2;
+    }
+    else if (sse41_available())
+    {
+        // Without a gather instruction the plain lookup is as fast as it gets, only the light blend gains.
+        log_verbose("registering SSE4.1 palette expansion functions");
+        palette_expand_fn = palette_expand_scalar;
+        light_blend_fn = light_blend_sse4_1;
+    }
+    else
+    {
+        log_verbose("registering scalar palette expansion functions");
+        palette_expand_fn = palette_expand_scalar;
+        light_blend_fn = light_blend_scalar;
+    }
+}
+
 void gfx_filter_pixel(rct_drawpixelinfo* dpi, const ScreenCoordsXY& coords, FilterPaletteID palette)
 {
     gfx_filter_rect(dpi, { coords, coords }, palette);
@@ -782,3 +884,38 @@ rct_drawpixelinfo rct_drawpixelinfo::Crop(const ScreenCoordsXY& pos, const Scree
     result.pitch = static_cast<int16_t>(width + pitch - size.width);
     return result;
 }
+
+static thread_local WindowDrawingLock* _windowDrawingLock;
+
+WindowDrawingLock::WindowDrawingLock(std::mutex& mutex)
+    : _lock(mutex)
+    , _previous(_windowDrawingLock)
+{
+    _windowDrawingLock = this;
+}
+
+WindowDrawingLock::~WindowDrawingLock()
+{
+    _windowDrawingLock = _previous;
+}
+
+WindowDrawingUnlock::WindowDrawingUnlock()
+    : _lock(_windowDrawingLock)
+{
+    if (_lock != nullptr && _lock->_lock.owns_lock())
+    {
+        _lock->_lock.unlock();
+    }
+    else
+    {
+        _lock = nullptr;
+    }
+}
+
+WindowDrawingUnlock::~WindowDrawingUnlock()
+{
+    if (_lock != nullptr)
+    {
+        _lock->_lock.lock();
+    }
+}
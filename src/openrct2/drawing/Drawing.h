@@ -16,7 +16,9 @@
 #include "Font.h"
 #include "Text.h"
 
+#include <array>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -539,6 +541,14 @@ public:
     uint8_t operator[](size_t index) const;
     uint8_t Blend(uint8_t src, uint8_t dst) const;
     void Copy(size_t dstIndex, const PaletteMap& src, size_t srcIndex, size_t length);
+
+    /**
+     * Returns the first 256 entries for lookups of whole palette indices at once, or nullptr if the map is shorter.
+     */
+    const uint8_t* GetLookupTable() const
+    {
+        return _dataLength >= 256 ? _data : nullptr;
+    }
 };
 
 struct DrawSpriteArgs
@@ -639,6 +649,24 @@ void FASTCALL BlitPixels(const uint8_t* src, uint8_t* dst, const PaletteMap& pal
     }
 }
 
+/**
+ * Blits a run of pixels where source and destination both advance by one pixel, the reference for the vectorised
+ * versions in blit_run_fns.
+ */
+template<DrawBlendOp TBlendOp>
+void BlitPixelRun(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, size_t count, const PaletteMap& paletteMap)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        BlitPixel<TBlendOp>(src + i, dst + i, paletteMap);
+    }
+}
+
+using BlitRunFunc = void (*)(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, size_t count, const PaletteMap& paletteMap);
+
+// Indexed by blend op.
+using BlitRunTable = std::array<BlitRunFunc, 16>;
+
 #define SPRITE_ID_PALETTE_COLOUR_1(colourId) (IMAGE_TYPE_REMAP | ((colourId) << 19))
 #define SPRITE_ID_PALETTE_COLOUR_2(primaryId, secondaryId)                                                                     \
     (IMAGE_TYPE_REMAP_2_PLUS | IMAGE_TYPE_REMAP | (((primaryId) << 19) | ((secondaryId) << 24)))
@@ -763,6 +791,39 @@ class Formatter;
 int32_t scrolling_text_setup(
     struct paint_session* session, rct_string_id stringId, Formatter& ft, uint16_t scroll, uint16_t scrollingMode,
     colour_t colour);
+// Draws the bitmaps of the scrolling text set up since the last flush, needed before the paint structs are drawn.
+void scrolling_text_flush();
+
+/**
+ * Held while setting up, flushing and drawing scrolling text. Slots used by a paint are kept until every paint running
+ * alongside it has finished, so a flush of one screen band can not redraw a slot another band is drawing. Ends the
+ * paint even if painting throws, such as a task rethrown by TaskGroup::Wait.
+ */
+class ScrollingTextPaintScope
+{
+public:
+    ScrollingTextPaintScope();
+    ~ScrollingTextPaintScope();
+
+    ScrollingTextPaintScope(const ScrollingTextPaintScope&) = delete;
+    ScrollingTextPaintScope& operator=(const ScrollingTextPaintScope&) = delete;
+};
+
+struct ScrollingTextCacheStats
+{
+    uint64_t SlotHits;
+    uint64_t SlotMisses;
+    // Slots given to other text while their own text was still on screen in the same frame, or text left out as
+    // every slot was in use.
+    uint64_t SlotThrashes;
+    uint64_t StripHits;
+    uint64_t StripMisses;
+    size_t Strips;
+    size_t StripBytes;
+};
+
+ScrollingTextCacheStats scrolling_text_cache_get_stats();
+void scrolling_text_cache_reset_stats();
 
 rct_size16 FASTCALL gfx_get_sprite_size(uint32_t image_id);
 size_t g1_calculate_data_size(const rct_g1_element* g1);
@@ -782,7 +843,103 @@ extern void (*mask_fn)(
     int32_t width, int32_t height, const uint8_t* RESTRICT maskSrc, const uint8_t* RESTRICT colourSrc, uint8_t* RESTRICT dst,
     int32_t maskWrap, int32_t colourWrap, int32_t dstWrap);
 
+void blit_run_init_scalar(BlitRunTable& table);
+void blit_run_init_sse4_1(BlitRunTable& table);
+void blit_run_init_avx2(BlitRunTable& table);
+void blit_run_init();
+
+extern BlitRunTable blit_run_fns;
+
+/**
+ * Converts 8bpp pixels to 32bpp through a palette of 32bpp colours, the format of the colours does not matter.
+ */
+using PaletteExpandFunc = void (*)(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette);
+
+/**
+ * Converts 8bpp pixels to 32bpp and adds the light colour of each pixel scaled by its intensity, every channel
+ * saturates at 255. A pixel without light gets its palette colour.
+ */
+using LightBlendFunc = void (*)(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette);
+
+void palette_expand_scalar(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette);
+void palette_expand_avx2(const uint8_t* RESTRICT src, uint32_t* RESTRICT dst, size_t count, const uint32_t* palette);
+void light_blend_scalar(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette);
+void light_blend_sse4_1(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette);
+void light_blend_avx2(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette);
+void palette_expand_init();
+
+extern PaletteExpandFunc palette_expand_fn;
+extern LightBlendFunc light_blend_fn;
+
+/**
+ * Runs shorter than this are not worth the indirect call, they stay on the inlined scalar loop. So do the blend ops
+ * that combine source and destination, they have no vector version.
+ */
+constexpr size_t BLIT_RUN_MIN_VECTOR_LENGTH = 16;
+
+template<DrawBlendOp TBlendOp>
+void BlitRun(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, size_t count, const PaletteMap& paletteMap)
+{
+    if constexpr ((TBlendOp & BLEND_SRC) != 0 && (TBlendOp & BLEND_DST) != 0)
+    {
+        BlitPixelRun<TBlendOp>(src, dst, count, paletteMap);
+    }
+    else if (count >= BLIT_RUN_MIN_VECTOR_LENGTH)
+    {
+        blit_run_fns[TBlendOp](src, dst, count, paletteMap);
+    }
+    else
+    {
+        BlitPixelRun<TBlendOp>(src, dst, count, paletteMap);
+    }
+}
+
 std::optional<uint32_t> GetPaletteG1Index(colour_t paletteId);
 std::optional<PaletteMap> GetPaletteMapForColour(colour_t paletteId);
 
+/**
+ * Held by a thread while it draws windows for one of the screen bands the software engine draws in parallel, drawing
+ * windows is not thread safe. Nests if the thread picks up another band while it waits on its viewport.
+ */
+class WindowDrawingLock
+{
+    friend class WindowDrawingUnlock;
+
+private:
+    std::unique_lock<std::mutex> _lock;
+    WindowDrawingLock* _previous;
+
+public:
+    explicit WindowDrawingLock(std::mutex& mutex);
+    ~WindowDrawingLock();
+
+    WindowDrawingLock(const WindowDrawingLock&) = delete;
+    WindowDrawingLock& operator=(const WindowDrawingLock&) = delete;
+};
+
+/**
+ * Releases the window drawing lock of the calling thread, if it holds one, so other bands can draw their windows
+ * while this one paints a viewport. The viewport must not touch window state until the lock is taken back.
+ */
+class WindowDrawingUnlock
+{
+private:
+    WindowDrawingLock* _lock;
+
+public:
+    WindowDrawingUnlock();
+    ~WindowDrawingUnlock();
+
+    WindowDrawingUnlock(const WindowDrawingUnlock&) = delete;
+    WindowDrawingUnlock& operator=(const WindowDrawingUnlock&) = delete;
+};
+
 #include "NewDrawing.h"
@@ -10,8 +10,10 @@
 #include "../OpenRCT2.h"
 #include "../core/Console.hpp"
 #include "../core/Guard.hpp"
+#include "../paint/PaintTileCache.h"
 #include "../sprites.h"
 #include "Drawing.h"
+#include "SpriteMipCache.h"
 
 #include <algorithm>
 #include <list>
@@ -228,6 +230,8 @@ void gfx_object_free_images(uint32_t baseImageId, uint32_t count)
             gfx_set_g1_element(imageId, &g1);
             drawing_engine_invalidate_image(imageId);
         }
+        SpriteMipCacheFreeImages(baseImageId, count);
+        PaintTileCacheReset();
 
         FreeImageList(baseImageId, count);
     }
@@ -14,6 +14,7 @@
 #    include "../Game.h"
 #    include "../common.h"
 #    include "../config/Config.h"
+#    include "../core/TaskScheduler.h"
 #    include "../interface/Viewport.h"
 #    include "../interface/Window.h"
 #    include "../interface/Window_internal.h"
@@ -29,6 +30,11 @@
 #    include <algorithm>
 #    include <cmath>
 #    include <cstring>
+#    include <mutex>
+#    include <unordered_map>
+#    include <vector>
+
+using namespace OpenRCT2;
 
 static uint8_t _bakedLightTexture_lantern_0[32 * 32];
 static uint8_t _bakedLightTexture_lantern_1[64 * 64];
@@ -74,6 +80,28 @@ static LightListEntry* _LightListFront;
 static uint32_t LightListCurrentCountBack;
 static uint32_t LightListCurrentCountFront;
 
+// Index of the lights added to the back list by their identity, lights are added while painting the columns of the
+// viewport in parallel and the same light is added by every column that paints its tile.
+static std::unordered_map<uint64_t, uint32_t> _lightIndexBack;
+static std::mutex _lightIndexMutex;
+
+// A light clipped to the light buffer, ready to be added.
+struct LightRenderJob
+{
+    const uint8_t* ReadBase;
+    int32_t ReadWidth;
+    int32_t WriteX;
+    int32_t WriteY;
+    int32_t Width;
+    int32_t Height;
+    uint8_t Intensity;
+};
+
+static std::vector<LightRenderJob> _lightRenderJobs;
+
+// Rows of the light buffer per band rendered in parallel, below that a band is not worth a task.
+static constexpr int32_t LightRenderBandHeight = 64;
+
 static int16_t _current_view_x_front = 0;
 static int16_t _current_view_y_front = 0;
 static uint8_t _current_view_rotation_front = 0;
@@ -190,6 +218,41 @@ void lightfx_update_buffers(rct_drawpixelinfo* info)
 
 extern void viewport_paint_setup();
 
+/**
+ * Finds what is drawn at the view position, the same as a one pixel paint session would. The pick buffer of the main
+ * viewport holds this for every pixel drawn in the frame, only pixels it does not know are painted again.
+ */
+static InteractionInfo lightfx_get_occluder(rct_window* w, const ScreenCoordsXY& viewCoords, ZoomLevel zoom)
+{
+    const auto* viewport = w->viewport;
+    if (viewport->zoom == zoom)
+    {
+        const ScreenCoordsXY screenCoords = {
+            viewport->pos.x + (viewCoords.x - viewport->viewPos.x) / zoom,
+            viewport->pos.y + (viewCoords.y - viewport->viewPos.y) / zoom,
+        };
+        auto info = viewport_pick_buffer_lookup(viewport, screenCoords, ViewportInteractionItemAll);
+        if (info.has_value())
+        {
+            return *info;
+        }
+    }
+
+    rct_drawpixelinfo dpi;
+    dpi.x = viewCoords.x;
+    dpi.y = viewCoords.y;
+    dpi.height = 1;
+    dpi.zoom_level = zoom;
+    dpi.width = 1;
+
+    paint_session* session = PaintSessionAlloc(&dpi, viewport->flags);
+    PaintSessionGenerate(session);
+    PaintSessionArrange(session);
+    auto info = set_interaction_info_from_paint_session(session, ViewportInteractionItemAll);
+    PaintSessionFree(session);
+    return info;
+}
+
 void lightfx_prepare_light_list()
 {
     for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
@@ -301,20 +364,11 @@ void lightfx_prepare_light_list()
                 if (w != nullptr)
                 {
                     // based on get_map_coordinates_from_pos_window
-                    rct_drawpixelinfo dpi;
-                    dpi.x = entry->ViewCoords.x + offsetPattern[0 + pat * 2] / mapFrontDiv;
-                    dpi.y = entry->ViewCoords.y + offsetPattern[1 + pat * 2] / mapFrontDiv;
-                    dpi.height = 1;
-                    dpi.zoom_level = _current_view_zoom_front;
-                    dpi.width = 1;
-
-                    paint_session* session = PaintSessionAlloc(&dpi, w->viewport->flags);
-                    PaintSessionGenerate(session);
-                    PaintSessionArrange(session);
-                    auto info = set_interaction_info_from_paint_session(session, ViewportInteractionItemAll);
-                    PaintSessionFree(session);
-
-                    //  log_warning("[%i, %i]", dpi->x, dpi->y);
+                    const ScreenCoordsXY sampleCoords = {
+                        entry->ViewCoords.x + offsetPattern[0 + pat * 2] / mapFrontDiv,
+                        entry->ViewCoords.y + offsetPattern[1 + pat * 2] / mapFrontDiv,
+                    };
+                    auto info = lightfx_get_occluder(w, sampleCoords, _current_view_zoom_front);
 
                     mapCoord = info.Loc;
                     mapCoord.x += tileOffsetX;
@@ -420,6 +474,7 @@ void lightfx_swap_buffers()
 
     LightListCurrentCountFront = LightListCurrentCountBack;
     LightListCurrentCountBack = 0x0;
+    _lightIndexBack.clear();
 
     uint32_t uTmp = _lightPolution_back;
     _lightPolution_back = _lightPolution_front;
@@ -445,6 +500,39 @@ void lightfx_update_viewport_settings()
     }
 }
 
+/**
+ * Adds the lights to the rows from top to bottom of the light buffer. Saturating adds give the same result in any
+ * order, so the buffer can be split into bands that are rendered at the same time.
+ */
+static void lightfx_render_light_jobs(int32_t top, int32_t bottom)
+{
+    uint8_t* lightBuffer = static_cast<uint8_t*>(_light_rendered_buffer_front);
+    for (const auto& job : _lightRenderJobs)
+    {
+        const int32_t rowBegin = std::max(top, job.WriteY);
+        const int32_t rowEnd = std::min(bottom, job.WriteY + job.Height);
+        for (int32_t y = rowBegin; y < rowEnd; y++)
+        {
+            const uint8_t* bufReadBase = job.ReadBase + (y - job.WriteY) * job.ReadWidth;
+            uint8_t* bufWriteBase = lightBuffer + y * _pixelInfo.width + job.WriteX;
+            if (job.Intensity == 0xFF)
+            {
+                for (int32_t x = 0; x < job.Width; x++)
+                {
+                    bufWriteBase[x] = std::min(0xFF, bufWriteBase[x] + bufReadBase[x]);
+                }
+            }
+            else
+            {
+                for (int32_t x = 0; x < job.Width; x++)
+                {
+                    bufWriteBase[x] = std::min(0xFF, bufWriteBase[x] + ((bufReadBase[x] * (1 + job.Intensity)) >> 8));
+                }
+            }
+        }
+    }
+}
+
 void lightfx_render_lights_to_frontbuffer()
 {
     if (_light_rendered_buffer_front == nullptr)
@@ -455,17 +543,12 @@ void lightfx_render_lights_to_frontbuffer()
     std::memset(_light_rendered_buffer_front, 0, _pixelInfo.width * _pixelInfo.height);
 
     _lightPolution_back = 0;
-
-    //  log_warning("%i lights", LightListCurrentCountFront);
+    _lightRenderJobs.clear();
 
     for (uint32_t light = 0; light < LightListCurrentCountFront; light++)
     {
         const uint8_t* bufReadBase = nullptr;
-        uint8_t* bufWriteBase = static_cast<uint8_t*>(_light_rendered_buffer_front);
-        uint32_t bufReadWidth, bufReadHeight;
-        int32_t bufWriteX, bufWriteY;
-        int32_t bufWriteWidth, bufWriteHeight;
-        uint32_t bufReadSkip, bufWriteSkip;
+        int32_t bufReadWidth, bufReadHeight;
 
         LightListEntry* entry = &_LightListFront[light];
 
@@ -526,90 +609,45 @@ void lightfx_render_lights_to_frontbuffer()
                 continue;
         }
 
-        bufWriteX = inRectCentreX - bufReadWidth / 2;
-        bufWriteY = inRectCentreY - bufReadHeight / 2;
-
-        bufWriteWidth = bufReadWidth;
-        bufWriteHeight = bufReadHeight;
-
-        if (bufWriteX < 0)
-        {
-            bufReadBase += -bufWriteX;
-            bufWriteWidth += bufWriteX;
-        }
-        else
-        {
-            bufWriteBase += bufWriteX;
-        }
-
-        if (bufWriteWidth <= 0)
-            continue;
-
-        if (bufWriteY < 0)
-        {
-            bufReadBase += -bufWriteY * bufReadWidth;
-            bufWriteHeight += bufWriteY;
-        }
-        else
-        {
-            bufWriteBase += bufWriteY * _pixelInfo.width;
-        }
-
-        if (bufWriteHeight <= 0)
-            continue;
-
-        int32_t rightEdge = bufWriteX + bufWriteWidth;
-        int32_t bottomEdge = bufWriteY + bufWriteHeight;
-
-        if (rightEdge > _pixelInfo.width)
+        // Clip to the light buffer
+        int32_t left = inRectCentreX - bufReadWidth / 2;
+        int32_t top = inRectCentreY - bufReadHeight / 2;
+        const int32_t right = std::min<int32_t>(left + bufReadWidth, _pixelInfo.width);
+        const int32_t bottom = std::min<int32_t>(top + bufReadHeight, _pixelInfo.height);
+        if (left < 0)
         {
-            bufWriteWidth -= rightEdge - _pixelInfo.width;
+            bufReadBase += -left;
+            left = 0;
         }
-        if (bottomEdge > _pixelInfo.height)
+        if (top < 0)
         {
-            bufWriteHeight -= bottomEdge - _pixelInfo.height;
+            bufReadBase += -top * bufReadWidth;
+            top = 0;
         }
-
-        if (bufWriteWidth <= 0)
+        if (right <= left || bottom <= top)
             continue;
-        if (bufWriteHeight <= 0)
-            continue;
-
-        _lightPolution_back += (bufWriteWidth * bufWriteHeight) / 256;
-
-        bufReadSkip = bufReadWidth - bufWriteWidth;
-        bufWriteSkip = _pixelInfo.width - bufWriteWidth;
 
-        if (entry->LightIntensity == 0xFF)
-        {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
-            {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + *bufReadBase);
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
-
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
-            }
-        }
-        else
-        {
-            for (int32_t y = 0; y < bufWriteHeight; y++)
-            {
-                for (int32_t x = 0; x < bufWriteWidth; x++)
-                {
-                    *bufWriteBase = std::min(0xFF, *bufWriteBase + (((*bufReadBase) * (1 + entry->LightIntensity)) >> 8));
-                    bufWriteBase++;
-                    bufReadBase++;
-                }
+        const int32_t width = right - left;
+        const int32_t height = bottom - top;
+        _lightPolution_back += (width * height) / 256;
+        _lightRenderJobs.push_back({ bufReadBase, bufReadWidth, left, top, width, height, entry->LightIntensity });
+    }
 
-                bufWriteBase += bufWriteSkip;
-                bufReadBase += bufReadSkip;
-            }
-        }
+    const int32_t numBands = std::max(1, _pixelInfo.height / LightRenderBandHeight);
+    if (gConfigGeneral.multithreading && numBands > 1 && _lightRenderJobs.size() > 1)
+    {
+        const int32_t bandHeight = (_pixelInfo.height + numBands - 1) / numBands;
+        GetTaskScheduler().ParallelFor(
+            numBands,
+            [bandHeight](size_t band) {
+                const int32_t top = static_cast<int32_t>(band) * bandHeight;
+                lightfx_render_light_jobs(top, std::min<int32_t>(top + bandHeight, _pixelInfo.height));
+            },
+            1);
+    }
+    else
+    {
+        lightfx_render_light_jobs(0, _pixelInfo.height);
     }
 }
 
@@ -627,37 +665,25 @@ static void LightfxAdd3DLight(
     const uint32_t lightHash, const LightFXQualifier qualifier, const uint8_t id, const CoordsXYZ& loc,
     const LightType lightType)
 {
-    if (LightListCurrentCountBack == 15999)
+    const uint64_t key = (static_cast<uint64_t>(lightHash) << 16) | (static_cast<uint64_t>(qualifier) << 8) | id;
+
+    std::lock_guard<std::mutex> lock(_lightIndexMutex);
+    LightListEntry* entry;
+    auto it = _lightIndexBack.find(key);
+    if (it != _lightIndexBack.end())
     {
-        return;
+        entry = &_LightListBack[it->second];
     }
-
-    //  log_warning("%i lights in back", LightListCurrentCountBack);
-
-    for (uint32_t i = 0; i < LightListCurrentCountBack; i++)
+    else
     {
-        LightListEntry* entry = &_LightListBack[i];
-        if (entry->LightHash != lightHash)
-            continue;
-        if (entry->Qualifier != qualifier)
-            continue;
-        if (entry->LightID != id)
-            continue;
-
-        entry->Position = loc;
-        entry->ViewCoords = translate_3d_to_2d_with_z(get_current_rotation(), loc);
-        entry->Type = lightType;
-        entry->LightIntensity = 0xFF;
-        entry->LightHash = lightHash;
-        entry->Qualifier = qualifier;
-        entry->LightID = id;
-        entry->LightLinger = 1;
-
-        return;
+        if (LightListCurrentCountBack == 15999)
+        {
+            return;
+        }
+        _lightIndexBack.emplace(key, LightListCurrentCountBack);
+        entry = &_LightListBack[LightListCurrentCountBack++];
     }
 
-    LightListEntry* entry = &_LightListBack[LightListCurrentCountBack++];
-
     entry->Position = loc;
     entry->ViewCoords = translate_3d_to_2d_with_z(get_current_rotation(), loc);
     entry->Type = lightType;
@@ -666,8 +692,6 @@ static void LightfxAdd3DLight(
     entry->Qualifier = qualifier;
     entry->LightID = id;
     entry->LightLinger = 1;
-
-    //  log_warning("new 3d light");
 }
 
 static void LightfxAdd3DLight(const CoordsXYZ& loc, const LightType lightType)
@@ -1014,15 +1038,6 @@ void lightfx_apply_palette_filter(uint8_t i, uint8_t* r, uint8_t* g, uint8_t* b)
     }
 }
 
-static uint8_t mix_light(uint32_t a, uint32_t b, uint32_t intensity)
-{
-    intensity = intensity * 6;
-    uint32_t bMul = (b * intensity) >> 8;
-    uint32_t ab = a + bMul;
-    uint8_t result = std::min<uint32_t>(255, ab);
-    return result;
-}
-
 void lightfx_render_to_texture(
     void* dstPixels, uint32_t dstPitch, uint8_t* bits, uint32_t width, uint32_t height, const uint32_t* palette,
     const uint32_t* lightPalette)
@@ -1042,27 +1057,7 @@ void lightfx_render_to_texture(
     {
         uintptr_t dstOffset = static_cast<uintptr_t>(y * dstPitch);
         uint32_t* dst = reinterpret_cast<uint32_t*>(reinterpret_cast<uintptr_t>(dstPixels) + dstOffset);
-        for (uint32_t x = 0; x < width; x++)
-        {
-            uint8_t* src = &bits[y * width + x];
-            uint32_t darkColour = palette[*src];
-            uint32_t lightColour = lightPalette[*src];
-            uint8_t lightIntensity = lightBits[y * width + x];
-
-            uint32_t colour = 0;
-            if (lightIntensity == 0)
-            {
-                colour = darkColour;
-            }
-            else
-            {
-                colour |= mix_light((darkColour >> 0) & 0xFF, (lightColour >> 0) & 0xFF, lightIntensity);
-                colour |= mix_light((darkColour >> 8) & 0xFF, (lightColour >> 8) & 0xFF, lightIntensity) << 8;
-                colour |= mix_light((darkColour >> 16) & 0xFF, (lightColour >> 16) & 0xFF, lightIntensity) << 16;
-                colour |= mix_light((darkColour >> 24) & 0xFF, (lightColour >> 24) & 0xFF, lightIntensity) << 24;
-            }
-            *dst++ = colour;
-        }
+        light_blend_fn(&bits[y * width], &lightBits[y * width], dst, width, palette, lightPalette);
     }
 }
 
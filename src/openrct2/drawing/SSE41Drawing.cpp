@@ -13,6 +13,7 @@
 
 #ifdef __SSE4_1__
 
+#    include <cstring>
 #    include <immintrin.h>
 
 void mask_sse4_1(
@@ -56,6 +57,111 @@ void mask_sse4_1(
     }
 }
 
+// Looks up 16 palette indices in a 256 entry table, one pshufb per block of 16 entries. Subtracting the base of each
+// block and adding 0x70 with saturation leaves only the indices of that block below 0x80, pshufb zeroes all others.
+static __m128i LookupPaletteSSE41(const uint8_t* lut, __m128i indices)
+{
+    const __m128i blockSize = _mm_set1_epi8(16);
+    const __m128i bias = _mm_set1_epi8(0x70);
+    __m128i result = _mm_setzero_si128();
+    for (int32_t block = 0; block < 16; block++)
+    {
+        const __m128i table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lut + block * 16));
+        result = _mm_or_si128(result, _mm_shuffle_epi8(table, _mm_adds_epu8(indices, bias)));
+        indices = _mm_sub_epi8(indices, blockSize);
+    }
+    return result;
+}
+
+template<DrawBlendOp TBlendOp>
+static void BlitRunSSE41(const uint8_t* RESTRICT src, uint8_t* RESTRICT dst, size_t count, const PaletteMap& paletteMap)
+{
+    static_assert((TBlendOp & BLEND_SRC) == 0 || (TBlendOp & BLEND_DST) == 0, "Blending two pixels has no vector version");
+
+    const uint8_t* lut = nullptr;
+    if constexpr ((TBlendOp & (BLEND_SRC | BLEND_DST)) != 0)
+    {
+        lut = paletteMap.GetLookupTable();
+        if (lut == nullptr)
+        {
+            BlitPixelRun<TBlendOp>(src, dst, count, paletteMap);
+            return;
+        }
+    }
+
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        const __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        [[maybe_unused]] const __m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i pixel;
+        if constexpr ((TBlendOp & BLEND_SRC) != 0)
+            pixel = LookupPaletteSSE41(lut, source);
+        else if constexpr ((TBlendOp & BLEND_DST) != 0)
+            pixel = LookupPaletteSSE41(lut, dest);
+        else
+            pixel = source;
+
+        if constexpr ((TBlendOp & BLEND_TRANSPARENT) != 0)
+        {
+            // Keep the destination where the source is transparent or the palette maps to transparent
+            __m128i keep = _mm_cmpeq_epi8(source, zero);
+            if constexpr ((TBlendOp & (BLEND_SRC | BLEND_DST)) != 0)
+                keep = _mm_or_si128(keep, _mm_cmpeq_epi8(pixel, zero));
+            pixel = _mm_blendv_epi8(pixel, dest, keep);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), pixel);
+    }
+    BlitPixelRun<TBlendOp>(src + i, dst + i, count - i, paletteMap);
+}
+
+void blit_run_init_sse4_1(BlitRunTable& table)
+{
+    table[BLEND_TRANSPARENT] = BlitRunSSE41<BLEND_TRANSPARENT>;
+    table[BLEND_SRC] = BlitRunSSE41<BLEND_SRC>;
+    table[BLEND_TRANSPARENT | BLEND_SRC] = BlitRunSSE41<BLEND_TRANSPARENT | BLEND_SRC>;
+    table[BLEND_DST] = BlitRunSSE41<BLEND_DST>;
+    table[BLEND_TRANSPARENT | BLEND_DST] = BlitRunSSE41<BLEND_TRANSPARENT | BLEND_DST>;
+}
+
+// Adds (light * intensity) >> 8 to every channel of four pixels, intensity holds one 32 bit lane per pixel. With the
+// light in the upper byte of a 16 bit lane the upper half of the product is exactly that, packing saturates at 255.
+static __m128i LightBlendSSE41(__m128i dark, __m128i light, __m128i intensity)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i intensity16 = _mm_or_si128(intensity, _mm_slli_epi32(intensity, 16));
+    const __m128i intensityLo = _mm_unpacklo_epi32(intensity16, intensity16);
+    const __m128i intensityHi = _mm_unpackhi_epi32(intensity16, intensity16);
+    const __m128i lo = _mm_add_epi16(
+        _mm_unpacklo_epi8(dark, zero), _mm_mulhi_epu16(_mm_unpacklo_epi8(zero, light), intensityLo));
+    const __m128i hi = _mm_add_epi16(
+        _mm_unpackhi_epi8(dark, zero), _mm_mulhi_epu16(_mm_unpackhi_epi8(zero, light), intensityHi));
+    return _mm_packus_epi16(lo, hi);
+}
+
+void light_blend_sse4_1(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    const __m128i scale = _mm_set1_epi32(6);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i dark = _mm_setr_epi32(
+            static_cast<int32_t>(palette[src[i]]), static_cast<int32_t>(palette[src[i + 1]]),
+            static_cast<int32_t>(palette[src[i + 2]]), static_cast<int32_t>(palette[src[i + 3]]));
+        const __m128i light = _mm_setr_epi32(
+            static_cast<int32_t>(lightPalette[src[i]]), static_cast<int32_t>(lightPalette[src[i + 1]]),
+            static_cast<int32_t>(lightPalette[src[i + 2]]), static_cast<int32_t>(lightPalette[src[i + 3]]));
+        int32_t intensities;
+        std::memcpy(&intensities, lightIntensity + i, sizeof(intensities));
+        const __m128i intensity = _mm_mullo_epi16(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(intensities)), scale);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), LightBlendSSE41(dark, light, intensity));
+    }
+    light_blend_scalar(src + i, lightIntensity + i, dst + i, count - i, palette, lightPalette);
+}
+
 #else
 
 #    ifdef OPENRCT2_X86
@@ -69,4 +175,16 @@ void mask_sse4_1(
     openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
 }
 
+void blit_run_init_sse4_1(BlitRunTable& table)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
+void light_blend_sse4_1(
+    const uint8_t* RESTRICT src, const uint8_t* RESTRICT lightIntensity, uint32_t* RESTRICT dst, size_t count,
+    const uint32_t* palette, const uint32_t* lightPalette)
+{
+    openrct2_assert(false, "SSE 4.1 function called on a CPU that doesn't support SSE 4.1");
+}
+
 #endif // __SSE4_1__
@@ -9,8 +9,10 @@
 
 #include "ScrollingText.h"
 
+#include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/String.hpp"
+#include "../core/TaskScheduler.h"
 #include "../interface/Colour.h"
 #include "../localisation/Formatting.h"
 #include "../localisation/Localisation.h"
@@ -21,18 +23,99 @@
 #include "TTF.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 using namespace OpenRCT2;
 
+// Rasterised strips kept around for the text that is not on screen right now, shared by all scroll positions and modes.
+static constexpr size_t MaxScrollingTextStrips = 1024;
+
+struct ScrollingTextKey
+{
+    rct_string_id StringId;
+    uint8_t StringArgs[32];
+    colour_t Colour;
+    uint16_t Position;
+    uint16_t Mode;
+    // Only set for the strips, the font and settings they were rasterised with.
+    uintptr_t Font;
+    bool UpperCase;
+    bool Hinting;
+
+    bool operator==(const ScrollingTextKey& other) const
+    {
+        return StringId == other.StringId && std::memcmp(StringArgs, other.StringArgs, sizeof(StringArgs)) == 0
+            && Colour == other.Colour && Position == other.Position && Mode == other.Mode && Font == other.Font
+            && UpperCase == other.UpperCase && Hinting == other.Hinting;
+    }
+};
+
+struct ScrollingTextKeyHash
+{
+    size_t operator()(const ScrollingTextKey& key) const
+    {
+        size_t hash = std::hash<std::string_view>()(
+            std::string_view(reinterpret_cast<const char*>(key.StringArgs), sizeof(key.StringArgs)));
+        for (uint64_t value : { static_cast<uint64_t>(key.StringId), static_cast<uint64_t>(key.Colour),
+                                static_cast<uint64_t>(key.Position), static_cast<uint64_t>(key.Mode),
+                                static_cast<uint64_t>(key.Font), static_cast<uint64_t>(key.UpperCase),
+                                static_cast<uint64_t>(key.Hinting) })
+        {
+            hash ^= std::hash<uint64_t>()(value) + 0x9E3779B97F4A7C15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+/**
+ * One column of a rasterised string, bit n of the masks is row n of the bitmap. Full pixels are set to the colour,
+ * blended pixels shade what is already there as the TrueType hinting does.
+ */
+struct ScrollingTextColumn
+{
+    uint8_t Colour;
+    uint8_t Full;
+    uint8_t Blend;
+};
+
+/**
+ * A string rasterised once from its start, any scroll position is a window into it.
+ */
+struct ScrollingTextStrip
+{
+    std::once_flag Built;
+    std::vector<ScrollingTextColumn> Columns;
+    // TrueType strips repeat the string forever, sprite font strips are the string repeated four times.
+    bool Wraps = false;
+    // Set once built, read by the cache statistics.
+    std::atomic<size_t> Bytes = { 0 };
+    uint32_t LastUsed = 0;
+};
+
+struct ScrollingTextFlushJob
+{
+    size_t Slot;
+    uint32_t Generation;
+    ScrollingTextKey Key;
+    ScrollingTextKey StripKey;
+    std::shared_ptr<ScrollingTextStrip> Strip;
+};
+
 struct rct_draw_scroll_text
 {
-    rct_string_id string_id;
-    uint8_t string_args[32];
-    colour_t colour;
-    uint16_t position;
-    uint16_t mode;
+    ScrollingTextKey key;
     uint32_t id;
+    uint32_t frame;
+    // The paint pass that last used the slot, it is not given to other text while that pass is still painting.
+    uint32_t paintPass;
+    bool pending;
+    // Bumped whenever the slot is given to other text, a flush still working on the old text leaves the bitmap alone.
+    std::atomic<uint32_t> generation;
     uint8_t bitmap[64 * 40];
 };
 
@@ -41,10 +124,26 @@ static uint8_t _characterBitmaps[FONT_SPRITE_GLYPH_COUNT + SPR_G2_GLYPH_COUNT][8
 static uint32_t _drawSCrollNextIndex = 0;
 static std::mutex _scrollingTextMutex;
 
-static void scrolling_text_set_bitmap_for_sprite(
-    std::string_view text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
-static void scrolling_text_set_bitmap_for_ttf(
-    std::string_view text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour);
+// All guarded by _scrollingTextMutex.
+static std::unordered_map<ScrollingTextKey, size_t, ScrollingTextKeyHash> _scrollTextSlots;
+static std::unordered_map<ScrollingTextKey, std::shared_ptr<ScrollingTextStrip>, ScrollingTextKeyHash> _scrollTextStrips;
+static std::vector<size_t> _scrollTextPending;
+// Viewport paints running at once share a pass, a new pass starts when none is running.
+static uint32_t _scrollTextPaintPass = 1;
+static size_t _scrollTextPaintsRunning = 0;
+static std::vector<ScrollingTextFlushJob> _scrollTextJobs;
+static size_t _scrollTextJobsRunning = 0;
+static std::condition_variable _scrollTextJobsDone;
+static uint32_t _scrollTextFlushCount = 0;
+static ScrollingTextCacheStats _scrollTextStats;
+// Slots set up but not drawn yet, whether still pending or being drawn by a flush.
+static std::atomic<size_t> _scrollTextOutstanding = { 0 };
+
+// Held while a flush writes a slot bitmap, so two flushes never write the same slot at once.
+static std::mutex _scrollTextSlotMutexes[OpenRCT2::MaxScrollingTextEntries];
+
+static void scrolling_text_build_strip_for_sprite(std::string_view text, colour_t colour, ScrollingTextStrip& strip);
+static void scrolling_text_build_strip_for_ttf(std::string_view text, colour_t colour, ScrollingTextStrip& strip);
 
 void scrolling_text_initialise_bitmaps()
 {
@@ -119,6 +218,9 @@ void scrolling_text_initialise_bitmaps()
 
         gfx_set_g1_element(imageId, &g1);
     }
+
+    // The glyphs may have changed, rasterise everything again.
+    scrolling_text_invalidate();
 }
 
 static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
@@ -132,41 +234,155 @@ static uint8_t* font_sprite_get_codepoint_bitmap(int32_t codepoint)
     return _characterBitmaps[offset];
 }
 
-static int32_t scrolling_text_get_matching_or_oldest(
-    rct_string_id stringId, Formatter& ft, uint16_t scroll, uint16_t scrollingMode, colour_t colour)
+static int32_t scrolling_text_get_matching_or_oldest(const ScrollingTextKey& key)
 {
+    // If exact match return the matching index
+    auto it = _scrollTextSlots.find(key);
+    if (it != _scrollTextSlots.end())
+    {
+        auto scrollText = &_drawScrollTextList[it->second];
+        scrollText->id = _drawSCrollNextIndex;
+        scrollText->frame = gCurrentDrawCount;
+        scrollText->paintPass = _scrollTextPaintPass;
+        _scrollTextStats.SlotHits++;
+        return static_cast<int32_t>(it->second + SPR_SCROLLING_TEXT_START);
+    }
+
+    // Slots of the current pass may still be drawn by another viewport, their bitmaps can not change until it is done.
     uint32_t oldestId = 0xFFFFFFFF;
     int32_t scrollIndex = -1;
     for (size_t i = 0; i < std::size(_drawScrollTextList); i++)
     {
-        rct_draw_scroll_text* scrollText = &_drawScrollTextList[i];
-        if (oldestId >= scrollText->id)
+        if (_drawScrollTextList[i].paintPass == _scrollTextPaintPass)
+            continue;
+        if (oldestId >= _drawScrollTextList[i].id)
         {
-            oldestId = scrollText->id;
+            oldestId = _drawScrollTextList[i].id;
             scrollIndex = static_cast<int32_t>(i);
         }
+    }
+    return scrollIndex;
+}
+
+static void scrolling_text_format(utf8* dst, size_t size, const ScrollingTextKey& key)
+{
+    if (key.UpperCase)
+    {
+        format_string_to_upper(dst, size, key.StringId, key.StringArgs);
+    }
+    else
+    {
+        format_string(dst, size, key.StringId, key.StringArgs);
+    }
+}
+
+/**
+ * The font strips are rasterised with, 0 for the sprite font.
+ */
+static uintptr_t scrolling_text_get_font()
+{
+#ifndef NO_TTF
+    if (LocalisationService_UseTrueTypeFont())
+    {
+        auto fontDesc = ttf_get_font_from_sprite_base(FontSpriteBase::TINY);
+        return reinterpret_cast<uintptr_t>(fontDesc->font);
+    }
+#endif // NO_TTF
+    return 0;
+}
+
+static void scrolling_text_build_strip(const ScrollingTextKey& key, ScrollingTextStrip* strip)
+{
+    // Create the string to draw
+    utf8 scrollString[256];
+    scrolling_text_format(scrollString, sizeof(scrollString), key);
+
+    if (key.Font != 0)
+    {
+        scrolling_text_build_strip_for_ttf(scrollString, key.Colour, *strip);
+    }
+    else
+    {
+        scrolling_text_build_strip_for_sprite(scrollString, key.Colour, *strip);
+    }
+}
+
+static void scrolling_text_draw_strip(
+    const ScrollingTextStrip& strip, size_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets)
+{
+    const size_t numColumns = strip.Columns.size();
+    if (numColumns == 0)
+        return;
+
+    // Skip any non-displayed columns
+    size_t column = strip.Wraps ? scroll % numColumns : scroll;
+    for (;; column++, scrollPositionOffsets++)
+    {
+        if (column >= numColumns)
+        {
+            if (!strip.Wraps)
+                return;
+            column = 0;
+        }
 
-        // If exact match return the matching index
-        if (scrollText->string_id == stringId
-            && std::memcmp(scrollText->string_args, ft.Buf(), sizeof(scrollText->string_args)) == 0
-            && scrollText->colour == colour && scrollText->position == scroll && scrollText->mode == scrollingMode)
+        int16_t scrollPosition = *scrollPositionOffsets;
+        if (scrollPosition == -1)
+            return;
+
+        if (scrollPosition > -1)
         {
-            scrollText->id = _drawSCrollNextIndex;
-            return static_cast<int32_t>(i + SPR_SCROLLING_TEXT_START);
+            const auto& src = strip.Columns[column];
+            uint8_t* dst = &bitmap[scrollPosition];
+            for (int32_t y = 0; y < 8; y++)
+            {
+                const uint8_t bit = 1 << y;
+                if (src.Full & bit)
+                {
+                    *dst = src.Colour;
+                }
+#ifndef NO_TTF
+                else if (src.Blend & bit)
+                {
+                    *dst = blendColours(src.Colour, *dst);
+                }
+#endif // NO_TTF
+
+                // Jump to next row
+                dst += 64;
+            }
         }
     }
-    return scrollIndex;
 }
 
-static void scrolling_text_format(utf8* dst, size_t size, rct_draw_scroll_text* scrollText)
+/**
+ * Drops the least recently used strips once there are too many, never the ones the current flush is using.
+ */
+static void scrolling_text_trim_strips()
 {
-    if (gConfigGeneral.upper_case_banners)
+    if (_scrollTextStrips.size() <= MaxScrollingTextStrips)
+        return;
+
+    std::vector<uint32_t> lastUsed;
+    lastUsed.reserve(_scrollTextStrips.size());
+    for (const auto& [key, strip] : _scrollTextStrips)
     {
-        format_string_to_upper(dst, size, scrollText->string_id, scrollText->string_args);
+        lastUsed.push_back(strip->LastUsed);
     }
-    else
+
+    // Make room for a good number of new strips so this does not run on every flush.
+    const size_t toRemove = _scrollTextStrips.size() - (MaxScrollingTextStrips * 3 / 4);
+    std::nth_element(lastUsed.begin(), lastUsed.begin() + (toRemove - 1), lastUsed.end());
+    const uint32_t threshold = std::min(lastUsed[toRemove - 1], _scrollTextFlushCount - 1);
+    for (auto it = _scrollTextStrips.begin(); it != _scrollTextStrips.end();)
     {
-        format_string(dst, size, scrollText->string_id, scrollText->string_args);
+        if (it->second->LastUsed <= threshold)
+        {
+            it = _scrollTextStrips.erase(it);
+        }
+        else
+        {
+            it++;
+        }
     }
 }
 
@@ -1438,11 +1654,22 @@ static constexpr const int16_t* _scrollPositions[MAX_SCROLLING_TEXT_MODES] = {
 
 void scrolling_text_invalidate()
 {
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
     for (auto& scrollText : _drawScrollTextList)
     {
-        scrollText.string_id = 0;
-        std::memset(scrollText.string_args, 0, sizeof(scrollText.string_args));
+        scrollText.key.StringId = 0;
+        std::memset(scrollText.key.StringArgs, 0, sizeof(scrollText.key.StringArgs));
+        scrollText.generation++;
+    }
+    for (auto scrollIndex : _scrollTextPending)
+    {
+        _drawScrollTextList[scrollIndex].pending = false;
     }
+    _scrollTextOutstanding -= _scrollTextPending.size();
+    _scrollTextPending.clear();
+    _scrollTextSlots.clear();
+    _scrollTextStrips.clear();
 }
 
 int32_t scrolling_text_setup(
@@ -1459,42 +1686,211 @@ int32_t scrolling_text_setup(
 
     _drawSCrollNextIndex++;
     ft.Rewind();
-    int32_t scrollIndex = scrolling_text_get_matching_or_oldest(stringId, ft, scroll, scrollingMode, colour);
+
+    ScrollingTextKey key{};
+    key.StringId = stringId;
+    std::memcpy(key.StringArgs, ft.Buf(), sizeof(key.StringArgs));
+    key.Colour = colour;
+    key.Position = scroll;
+    key.Mode = scrollingMode;
+
+    int32_t scrollIndex = scrolling_text_get_matching_or_oldest(key);
     if (scrollIndex >= SPR_SCROLLING_TEXT_START)
         return scrollIndex;
+    if (scrollIndex < 0)
+    {
+        // Every slot is in use by text on screen.
+        _scrollTextStats.SlotThrashes++;
+        return SPR_SCROLLING_TEXT_DEFAULT;
+    }
 
-    // Setup scrolling text
+    // Setup scrolling text, the bitmap is drawn by the next scrolling_text_flush.
+    _scrollTextStats.SlotMisses++;
     auto scrollText = &_drawScrollTextList[scrollIndex];
-    scrollText->string_id = stringId;
-    std::memcpy(scrollText->string_args, ft.Buf(), sizeof(scrollText->string_args));
-    scrollText->colour = colour;
-    scrollText->position = scroll;
-    scrollText->mode = scrollingMode;
+    if (auto it = _scrollTextSlots.find(scrollText->key);
+        it != _scrollTextSlots.end() && it->second == static_cast<size_t>(scrollIndex))
+    {
+        _scrollTextSlots.erase(it);
+        if (scrollText->frame == gCurrentDrawCount)
+        {
+            // The old text is still wanted this frame, there are more texts on screen than slots.
+            _scrollTextStats.SlotThrashes++;
+        }
+    }
+    scrollText->key = key;
     scrollText->id = _drawSCrollNextIndex;
+    scrollText->frame = gCurrentDrawCount;
+    scrollText->paintPass = _scrollTextPaintPass;
+    scrollText->generation++;
+    _scrollTextSlots[key] = scrollIndex;
 
-    // Create the string to draw
-    utf8 scrollString[256];
-    scrolling_text_format(scrollString, 256, scrollText);
+    if (!scrollText->pending)
+    {
+        scrollText->pending = true;
+        _scrollTextPending.push_back(scrollIndex);
+        _scrollTextOutstanding++;
+    }
 
-    const int16_t* scrollingModePositions = _scrollPositions[scrollingMode];
+    return SPR_SCROLLING_TEXT_START + scrollIndex;
+}
 
-    std::fill_n(scrollText->bitmap, 320 * 8, 0x00);
-    if (LocalisationService_UseTrueTypeFont())
+ScrollingTextPaintScope::ScrollingTextPaintScope()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+    if (_scrollTextPaintsRunning == 0)
     {
-        scrolling_text_set_bitmap_for_ttf(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
+        _scrollTextPaintPass++;
     }
-    else
+    _scrollTextPaintsRunning++;
+}
+
+ScrollingTextPaintScope::~ScrollingTextPaintScope()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+    _scrollTextPaintsRunning--;
+}
+
+/**
+ * Draws queued slot bitmaps until there are none left. Jobs are taken one at a time so several flushes, or a flush and
+ * its helpers, share the work.
+ */
+static void scrolling_text_run_jobs()
+{
+    std::unique_lock<std::mutex> lock(_scrollingTextMutex);
+    while (!_scrollTextJobs.empty())
+    {
+        auto job = std::move(_scrollTextJobs.back());
+        _scrollTextJobs.pop_back();
+        _scrollTextJobsRunning++;
+        lock.unlock();
+
+        std::call_once(job.Strip->Built, scrolling_text_build_strip, job.StripKey, job.Strip.get());
+        {
+            std::scoped_lock<std::mutex> slotLock(_scrollTextSlotMutexes[job.Slot]);
+            auto& scrollText = _drawScrollTextList[job.Slot];
+            if (scrollText.generation == job.Generation)
+            {
+                std::fill_n(scrollText.bitmap, sizeof(scrollText.bitmap), 0x00);
+                scrolling_text_draw_strip(*job.Strip, job.Key.Position, scrollText.bitmap, _scrollPositions[job.Key.Mode]);
+            }
+        }
+
+        lock.lock();
+        drawing_engine_invalidate_image(SPR_SCROLLING_TEXT_START + static_cast<uint32_t>(job.Slot));
+        _scrollTextJobsRunning--;
+        _scrollTextOutstanding--;
+        if (_scrollTextJobsRunning == 0)
+        {
+            _scrollTextJobsDone.notify_all();
+        }
+    }
+}
+
+void scrolling_text_flush()
+{
+    if (_scrollTextOutstanding == 0)
+        return;
+
+    size_t numJobs = 0;
+    {
+        std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
+        _scrollTextFlushCount++;
+        const auto font = scrolling_text_get_font();
+        for (auto scrollIndex : _scrollTextPending)
+        {
+            auto& scrollText = _drawScrollTextList[scrollIndex];
+            scrollText.pending = false;
+
+            auto& job = _scrollTextJobs.emplace_back();
+            job.Slot = scrollIndex;
+            job.Generation = scrollText.generation;
+            job.Key = scrollText.key;
+
+            // Strips do not depend on the position or mode, only on the text and how it is rasterised.
+            job.StripKey = scrollText.key;
+            job.StripKey.Position = 0;
+            job.StripKey.Mode = 0;
+            job.StripKey.Font = font;
+            job.StripKey.UpperCase = gConfigGeneral.upper_case_banners;
+            job.StripKey.Hinting = gConfigFonts.enable_hinting;
+
+            auto& strip = _scrollTextStrips[job.StripKey];
+            if (strip == nullptr)
+            {
+                strip = std::make_shared<ScrollingTextStrip>();
+                _scrollTextStats.StripMisses++;
+            }
+            else
+            {
+                _scrollTextStats.StripHits++;
+            }
+            strip->LastUsed = _scrollTextFlushCount;
+            job.Strip = strip;
+        }
+        _scrollTextPending.clear();
+        numJobs = _scrollTextJobs.size();
+
+        scrolling_text_trim_strips();
+    }
+
+    // Rasterise and draw outside the lock, painting can carry on setting up scrolling text meanwhile.
+    auto& scheduler = GetTaskScheduler();
+    size_t numHelpers = 0;
+    if (gConfigGeneral.multithreading && numJobs > 1)
+    {
+        numHelpers = std::min(scheduler.GetNumWorkers(), numJobs - 1);
+    }
+    if (numHelpers > 0)
+    {
+        TaskGroup helpers(scheduler);
+        for (size_t i = 0; i < numHelpers; i++)
+        {
+            helpers.Run(scrolling_text_run_jobs);
+        }
+        scrolling_text_run_jobs();
+        helpers.Wait();
+    }
+
+    // Another flush may have taken some of the text set up for this one, the bitmaps have to be done before drawing.
+    std::unique_lock<std::mutex> lock(_scrollingTextMutex);
+    while (!_scrollTextJobs.empty() || _scrollTextJobsRunning != 0)
+    {
+        if (!_scrollTextJobs.empty())
+        {
+            lock.unlock();
+            scrolling_text_run_jobs();
+            lock.lock();
+        }
+        else
+        {
+            // Only jobs running on other threads are left, they never wait on anything that could be this thread.
+            _scrollTextJobsDone.wait(lock);
+        }
+    }
+}
+
+ScrollingTextCacheStats scrolling_text_cache_get_stats()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+
+    auto stats = _scrollTextStats;
+    stats.Strips = _scrollTextStrips.size();
+    stats.StripBytes = 0;
+    for (const auto& [key, strip] : _scrollTextStrips)
     {
-        scrolling_text_set_bitmap_for_sprite(scrollString, scroll, scrollText->bitmap, scrollingModePositions, colour);
+        stats.StripBytes += sizeof(ScrollingTextStrip) + strip->Bytes;
     }
+    return stats;
+}
 
-    uint32_t imageId = SPR_SCROLLING_TEXT_START + scrollIndex;
-    drawing_engine_invalidate_image(imageId);
-    return imageId;
+void scrolling_text_cache_reset_stats()
+{
+    std::scoped_lock<std::mutex> lock(_scrollingTextMutex);
+    _scrollTextStats = {};
 }
 
-static void scrolling_text_set_bitmap_for_sprite(
-    std::string_view text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_build_strip_for_sprite(std::string_view text, colour_t colour, ScrollingTextStrip& strip)
 {
     auto characterColour = colour;
     auto fmt = FmtString(text);
@@ -1513,30 +1909,7 @@ static void scrolling_text_set_bitmap_for_sprite(
                     auto characterBitmap = font_sprite_get_codepoint_bitmap(codepoint);
                     for (; characterWidth != 0; characterWidth--, characterBitmap++)
                     {
-                        // Skip any non-displayed columns
-                        if (scroll != 0)
-                        {
-                            scroll--;
-                            continue;
-                        }
-
-                        int16_t scrollPosition = *scrollPositionOffsets;
-                        if (scrollPosition == -1)
-                            return;
-
-                        if (scrollPosition > -1)
-                        {
-                            auto dst = &bitmap[scrollPosition];
-                            for (uint8_t char_bitmap = *characterBitmap; char_bitmap != 0; char_bitmap >>= 1)
-                            {
-                                if (char_bitmap & 1)
-                                    *dst = characterColour;
-
-                                // Jump to next row
-                                dst += 64;
-                            }
-                        }
-                        scrollPositionOffsets++;
+                        strip.Columns.push_back({ characterColour, *characterBitmap, 0 });
                     }
                 }
             }
@@ -1551,16 +1924,16 @@ static void scrolling_text_set_bitmap_for_sprite(
             }
         }
     }
+    strip.Bytes = strip.Columns.capacity() * sizeof(ScrollingTextColumn);
 }
 
-static void scrolling_text_set_bitmap_for_ttf(
-    std::string_view text, int32_t scroll, uint8_t* bitmap, const int16_t* scrollPositionOffsets, colour_t colour)
+static void scrolling_text_build_strip_for_ttf(std::string_view text, colour_t colour, ScrollingTextStrip& strip)
 {
 #ifndef NO_TTF
     auto fontDesc = ttf_get_font_from_sprite_base(FontSpriteBase::TINY);
     if (fontDesc->font == nullptr)
     {
-        scrolling_text_set_bitmap_for_sprite(text, scroll, bitmap, scrollPositionOffsets, colour);
+        scrolling_text_build_strip_for_sprite(text, colour, strip);
         return;
     }
 
@@ -1585,7 +1958,7 @@ static void scrolling_text_set_bitmap_for_ttf(
         }
     }
 
-    auto surface = ttf_surface_cache_get_or_add(fontDesc->font, ttfBuffer.c_str());
+    auto surface = ttf_render_string(fontDesc->font, ttfBuffer.c_str());
     if (surface == nullptr)
     {
         return;
@@ -1604,46 +1977,31 @@ static void scrolling_text_set_bitmap_for_ttf(
 
     bool use_hinting = gConfigFonts.enable_hinting && fontDesc->hinting_threshold > 0;
 
-    for (int32_t x = 0;; x++)
+    // The string scrolls round forever.
+    strip.Wraps = true;
+    strip.Columns.resize(width);
+    for (int32_t x = 0; x < width; x++)
     {
-        if (x >= width)
-            x = 0;
-
-        // Skip any non-displayed columns
-        if (scroll == 0)
+        auto& column = strip.Columns[x];
+        column.Colour = colour;
+        column.Full = 0;
+        column.Blend = 0;
+        for (int32_t y = min_vpos; y < max_vpos; y++)
         {
-            int16_t scrollPosition = *scrollPositionOffsets;
-            if (scrollPosition == -1)
-                return;
-
-            if (scrollPosition > -1)
+            const uint8_t bit = 1 << (y - min_vpos);
+            uint8_t src_pixel = src[y * pitch + x];
+            if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
             {
-                uint8_t* dst = &bitmap[scrollPosition];
-
-                for (int32_t y = min_vpos; y < max_vpos; y++)
-                {
-                    uint8_t src_pixel = src[y * pitch + x];
-                    if ((!use_hinting && src_pixel != 0) || src_pixel > 140)
-                    {
-                        // Centre of the glyph: use full colour.
-                        *dst = colour;
-                    }
-                    else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
-                    {
-                        // Simulate font hinting by shading the background colour instead.
-                        *dst = blendColours(colour, *dst);
-                    }
-
-                    // Jump to next row
-                    dst += 64;
-                }
+                // Centre of the glyph: use full colour.
+                column.Full |= bit;
+            }
+            else if (use_hinting && src_pixel > fontDesc->hinting_threshold)
+            {
+                // Simulate font hinting by shading the background colour instead.
+                column.Blend |= bit;
             }
-            scrollPositionOffsets++;
-        }
-        else
-        {
-            scroll--;
         }
     }
+    strip.Bytes = strip.Columns.capacity() * sizeof(ScrollingTextColumn);
 #endif // NO_TTF
 }
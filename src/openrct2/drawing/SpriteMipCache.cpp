@@ -0,0 +1,226 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "SpriteMipCache.h"
+
+#include "../config/Config.h"
+#include "../sprites.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Bytes per cached sprite on top of its data, for the list and map nodes.
+static constexpr size_t EntryOverhead = sizeof(SpriteMip) + 96;
+
+struct SpriteMipCacheEntry
+{
+    std::shared_ptr<const SpriteMip> Mip;
+    // The element the mip was built from, a mismatch means the image has been replaced.
+    const uint8_t* SourceData;
+    int16_t SourceWidth;
+    int16_t SourceHeight;
+    std::list<uint64_t>::iterator LruPosition;
+};
+
+static std::mutex _mutex;
+static std::unordered_map<uint64_t, SpriteMipCacheEntry> _entries;
+// Most recently used first.
+static std::list<uint64_t> _lru;
+static size_t _usedBytes;
+
+static uint64_t GetKey(uint32_t imageIndex, int32_t zoomShift, int32_t phaseX, int32_t phaseY)
+{
+    return (static_cast<uint64_t>(imageIndex) << 16) | (zoomShift << 8) | (phaseX << 4) | phaseY;
+}
+
+static uint32_t GetKeyImageIndex(uint64_t key)
+{
+    return static_cast<uint32_t>(key >> 16);
+}
+
+static size_t GetEntrySize(const SpriteMip& mip)
+{
+    return mip.Data.size() + EntryOverhead;
+}
+
+static void RemoveEntry(std::unordered_map<uint64_t, SpriteMipCacheEntry>::iterator it)
+{
+    _usedBytes -= GetEntrySize(*it->second.Mip);
+    _lru.erase(it->second.LruPosition);
+    _entries.erase(it);
+}
+
+static void Trim(size_t budget)
+{
+    while (_usedBytes > budget && !_lru.empty())
+    {
+        RemoveEntry(_entries.find(_lru.back()));
+    }
+}
+
+static size_t GetBudget()
+{
+    return static_cast<size_t>(std::max(0, gConfigGeneral.sprite_mip_cache_size)) * 1024 * 1024;
+}
+
+static bool IsCacheable(uint32_t imageIndex)
+{
+    // Scrolling text and the temporary image are redrawn with new content all the time.
+    if (imageIndex >= SPR_SCROLLING_TEXT_START && imageIndex < SPR_SCROLLING_TEXT_END)
+        return false;
+    return imageIndex < SPR_IMAGE_LIST_END;
+}
+
+std::shared_ptr<SpriteMip> SpriteMipBuild(const rct_g1_element& source, int32_t zoomShift, int32_t phaseX, int32_t phaseY)
+{
+    const int32_t zoom = 1 << zoomShift;
+    const int32_t width = std::max(0, (source.width - phaseX + zoom - 1) / zoom);
+    const int32_t height = std::max(0, (source.height - phaseY + zoom - 1) / zoom);
+
+    auto mip = std::make_shared<SpriteMip>();
+    auto& data = mip->Data;
+    data.resize(static_cast<size_t>(height) * 2);
+    for (int32_t row = 0; row < height; row++)
+    {
+        if (data.size() > UINT16_MAX)
+            return nullptr;
+        data[row * 2] = static_cast<uint8_t>(data.size() & 0xFF);
+        data[row * 2 + 1] = static_cast<uint8_t>(data.size() >> 8);
+
+        const int32_t y = phaseY + row * zoom;
+        const uint8_t* src0 = source.offset;
+        uint16_t lineOffset = src0[y * 2] | (src0[y * 2 + 1] << 8);
+        auto nextRun = src0 + lineOffset;
+
+        // Pixels that end up next to each other are merged into one run, even if they come from different runs.
+        size_t runHeader = SIZE_MAX;
+        int32_t runEnd = -1;
+        bool isEndOfLine = false;
+        while (!isEndOfLine)
+        {
+            auto src = nextRun;
+            auto dataSize = *src++;
+            int32_t firstPixelX = *src++;
+            isEndOfLine = (dataSize & 0x80) != 0;
+            dataSize &= 0x7F;
+            nextRun = src + dataSize;
+
+            // First pixel of the run in the sampled phase
+            int32_t column = firstPixelX + (((phaseX - firstPixelX) % zoom) + zoom) % zoom;
+            for (; column < firstPixelX + dataSize; column += zoom)
+            {
+                // All RLE draws skip transparent pixels when zoomed out, but the straight copy at zoom 0 would not.
+                const auto pixel = src[column - firstPixelX];
+                if (pixel == 0)
+                    continue;
+
+                const int32_t x = (column - phaseX) / zoom;
+                if (x != runEnd || data[runHeader] == 0x7F)
+                {
+                    if (x > 255)
+                        return nullptr;
+                    runHeader = data.size();
+                    data.push_back(0);
+                    data.push_back(static_cast<uint8_t>(x));
+                }
+                data.push_back(pixel);
+                data[runHeader]++;
+                runEnd = x + 1;
+            }
+        }
+
+        if (runHeader == SIZE_MAX)
+        {
+            data.push_back(0x80);
+            data.push_back(0);
+        }
+        else
+        {
+            data[runHeader] |= 0x80;
+        }
+    }
+
+    mip->Element.offset = data.data();
+    mip->Element.width = static_cast<int16_t>(width);
+    mip->Element.height = static_cast<int16_t>(height);
+    mip->Element.flags = G1_FLAG_RLE_COMPRESSION;
+    return mip;
+}
+
+std::shared_ptr<const SpriteMip> SpriteMipCacheGet(
+    uint32_t imageIndex, const rct_g1_element& source, int32_t zoomShift, int32_t phaseX, int32_t phaseY)
+{
+    const auto budget = GetBudget();
+    if (budget == 0 || !IsCacheable(imageIndex))
+        return nullptr;
+
+    const auto key = GetKey(imageIndex, zoomShift, phaseX, phaseY);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end())
+        {
+            auto& entry = it->second;
+            if (entry.SourceData == source.offset && entry.SourceWidth == source.width
+                && entry.SourceHeight == source.height)
+            {
+                _lru.splice(_lru.begin(), _lru, entry.LruPosition);
+                return entry.Mip;
+            }
+            RemoveEntry(it);
+        }
+    }
+
+    // Build without holding the lock, another thread may get there first in which case its copy is kept.
+    std::shared_ptr<const SpriteMip> mip = SpriteMipBuild(source, zoomShift, phaseX, phaseY);
+    if (mip == nullptr)
+        return nullptr;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto [it, inserted] = _entries.try_emplace(key);
+    if (!inserted)
+    {
+        return it->second.Mip;
+    }
+    _lru.push_front(key);
+    it->second = { mip, source.offset, source.width, source.height, _lru.begin() };
+    _usedBytes += GetEntrySize(*mip);
+    Trim(budget);
+    return mip;
+}
+
+void SpriteMipCacheFreeImages(uint32_t baseImageId, uint32_t count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (auto it = _entries.begin(); it != _entries.end();)
+    {
+        auto imageIndex = GetKeyImageIndex(it->first);
+        auto next = std::next(it);
+        if (imageIndex >= baseImageId && imageIndex - baseImageId < count)
+        {
+            RemoveEntry(it);
+        }
+        it = next;
+    }
+}
+
+void SpriteMipCacheClear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+    _lru.clear();
+    _usedBytes = 0;
+}
+
+size_t SpriteMipCacheGetUsedBytes()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usedBytes;
+}
@@ -0,0 +1,42 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "Drawing.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * An RLE sprite reduced for a zoom level. It holds every zoom-th pixel of every zoom-th row of the source, starting
+ * at the phase of the draw, which is all DrawRLESpriteMinify samples. Drawing it at zoom 0 gives the same pixels.
+ * Transparent pixels are left out as zoomed out draws skip them anyway.
+ */
+struct SpriteMip
+{
+    rct_g1_element Element{};
+    std::vector<uint8_t> Data;
+};
+
+/**
+ * Builds the reduced copy of an RLE sprite, or returns nullptr if it does not fit the RLE format.
+ */
+std::shared_ptr<SpriteMip> SpriteMipBuild(const rct_g1_element& source, int32_t zoomShift, int32_t phaseX, int32_t phaseY);
+
+/**
+ * Returns the reduced copy of the image from the cache, building it if needed. Returns nullptr if the cache is
+ * disabled or the image is rewritten too often to be cached, e.g. scrolling text. Safe to call from multiple threads.
+ */
+std::shared_ptr<const SpriteMip> SpriteMipCacheGet(
+    uint32_t imageIndex, const rct_g1_element& source, int32_t zoomShift, int32_t phaseX, int32_t phaseY);
+
+void SpriteMipCacheFreeImages(uint32_t baseImageId, uint32_t count);
+void SpriteMipCacheClear();
+size_t SpriteMipCacheGetUsedBytes();
@@ -26,44 +26,86 @@
 #    include "../platform/platform.h"
 #    include "TTF.h"
 
-static bool _ttfInitialised = false;
-
-#    define TTF_SURFACE_CACHE_SIZE 256
-#    define TTF_GETWIDTH_CACHE_SIZE 1024
-
-struct ttf_cache_entry
+#    include <array>
+#    include <deque>
+#    include <memory>
+#    include <vector>
+
+static std::atomic<bool> _ttfInitialised = false;
+
+// Open addressed, a power of two and never filled beyond TTF_GLYPH_CACHE_MAX_GLYPHS so lookups always end.
+#    define TTF_GLYPH_CACHE_SLOTS 8192
+#    define TTF_GLYPH_CACHE_MAX_GLYPHS (TTF_GLYPH_CACHE_SLOTS * 3 / 4)
+#    define TTF_KERNING_CACHE_SLOTS 16384
+#    define TTF_KERNING_CACHE_MAX_PROBES 16
+#    define TTF_ATLAS_PAGE_SIZE 512
+
+// Kerning pairs are packed into one word: valid bit, 20 bits for each glyph index and the kerning in the low 16 bits.
+#    define TTF_KERNING_VALID (1ULL << 63)
+#    define TTF_KERNING_MAX_INDEX (1U << 20)
+#    define TTF_KERNING_KEY_MASK (~0x7FFFFFULL)
+
+struct ttf_cached_glyph
 {
-    TTFSurface* surface;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
+    uint32_t codepoint;
+    uint32_t index;
+    int32_t minx;
+    int32_t maxx;
+    int32_t miny;
+    int32_t maxy;
+    int32_t yoffset;
+    int32_t advance;
+    int32_t width;
+    int32_t rows;
+    int32_t pitch;
+    const uint8_t* pixels;
 };
 
-struct ttf_getwidth_cache_entry
+/**
+ * Rendered glyphs and kerning of one font. Glyphs are looked up without a lock, entries are only ever added while
+ * holding _mutex and are published once complete, so a reader sees either nothing or the whole glyph. The glyph
+ * bitmaps are packed into atlas pages. Entries are only removed by ttf_glyph_cache_clear, which must not run while
+ * text is drawn.
+ */
+struct ttf_glyph_cache
 {
-    uint32_t width;
-    TTF_Font* font;
-    utf8* text;
-    uint32_t lastUseTick;
+    TTF_Font* font = nullptr;
+    int32_t ascent = 0;
+    int32_t height = 0;
+    bool hasKerning = false;
+    std::array<std::atomic<const ttf_cached_glyph*>, TTF_GLYPH_CACHE_SLOTS> glyphSlots{};
+    std::array<std::atomic<uint64_t>, TTF_KERNING_CACHE_SLOTS> kerningSlots{};
+
+    // Only accessed while holding _mutex.
+    std::deque<ttf_cached_glyph> glyphs;
+    std::vector<std::unique_ptr<uint8_t[]>> atlasPages;
+    uint8_t* atlasPage = nullptr;
+    int32_t shelfX = 0;
+    int32_t shelfY = 0;
+    int32_t shelfHeight = 0;
+    size_t atlasBytes = 0;
 };
 
-static ttf_cache_entry _ttfSurfaceCache[TTF_SURFACE_CACHE_SIZE] = {};
-static int32_t _ttfSurfaceCacheCount = 0;
-static int32_t _ttfSurfaceCacheHitCount = 0;
-static int32_t _ttfSurfaceCacheMissCount = 0;
+// Lookups of one string, added to the totals once per string.
+struct ttf_cache_counters
+{
+    uint64_t glyphHits = 0;
+    uint64_t glyphMisses = 0;
+    uint64_t kerningHits = 0;
+    uint64_t kerningMisses = 0;
+};
 
-static ttf_getwidth_cache_entry _ttfGetWidthCache[TTF_GETWIDTH_CACHE_SIZE] = {};
-static int32_t _ttfGetWidthCacheCount = 0;
-static int32_t _ttfGetWidthCacheHitCount = 0;
-static int32_t _ttfGetWidthCacheMissCount = 0;
+static std::array<std::unique_ptr<ttf_glyph_cache>, FONT_SIZE_COUNT> _ttfGlyphCaches;
+static std::atomic<uint64_t> _ttfGlyphCacheHitCount = 0;
+static std::atomic<uint64_t> _ttfGlyphCacheMissCount = 0;
+static std::atomic<uint64_t> _ttfKerningCacheHitCount = 0;
+static std::atomic<uint64_t> _ttfKerningCacheMissCount = 0;
 
 static std::mutex _mutex;
 
 static TTF_Font* ttf_open_font(const utf8* fontPath, int32_t ptSize);
 static void ttf_close_font(TTF_Font* font);
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry);
-static void ttf_surface_cache_dispose_all();
-static void ttf_getwidth_cache_dispose_all();
+static void ttf_glyph_cache_clear(ttf_glyph_cache* cache);
 static bool ttf_get_size(TTF_Font* font, std::string_view text, int32_t* outWidth, int32_t* outHeight);
 static void ttf_toggle_hinting(bool);
 static TTFSurface* ttf_render(TTF_Font* font, std::string_view text);
@@ -102,14 +144,22 @@ static void ttf_toggle_hinting(bool)
         TTF_SetFontHinting(fontDesc->font, use_hinting ? 1 : 0);
     }
 
-    if (_ttfSurfaceCacheCount)
+    // Hinting changes the shape of the glyphs and whether they are rendered shaded.
+    for (auto& cache : _ttfGlyphCaches)
     {
-        ttf_surface_cache_dispose_all();
+        if (cache != nullptr)
+        {
+            ttf_glyph_cache_clear(cache.get());
+        }
     }
 }
 
 bool ttf_initialise()
 {
+    // Called for every string drawn, skip the lock once done.
+    if (_ttfInitialised)
+        return true;
+
     FontLockHelper<std::mutex> lock(_mutex);
 
     if (_ttfInitialised)
@@ -138,6 +188,13 @@ bool ttf_initialise()
             log_verbose("Unable to load '%s'", fontPath);
             return false;
         }
+
+        auto cache = std::make_unique<ttf_glyph_cache>();
+        cache->font = fontDesc->font;
+        cache->ascent = TTF_FontAscent(fontDesc->font);
+        cache->height = TTF_FontHeight(fontDesc->font);
+        cache->hasKerning = TTF_HasKerning(fontDesc->font);
+        _ttfGlyphCaches[i] = std::move(cache);
     }
 
     ttf_toggle_hinting(true);
@@ -154,8 +211,10 @@ void ttf_dispose()
     if (!_ttfInitialised)
         return;
 
-    ttf_surface_cache_dispose_all();
-    ttf_getwidth_cache_dispose_all();
+    for (auto& cache : _ttfGlyphCaches)
+    {
+        cache = nullptr;
+    }
 
     for (int32_t i = 0; i < FONT_SIZE_COUNT; i++)
     {
@@ -182,174 +241,400 @@ static void ttf_close_font(TTF_Font* font)
     TTF_CloseFont(font);
 }
 
-static uint32_t ttf_surface_cache_hash(TTF_Font* font, std::string_view text)
+static uint32_t ttf_hash(uint64_t key)
 {
-    uint32_t hash = static_cast<uint32_t>(((reinterpret_cast<uintptr_t>(font) * 23) ^ 0xAAAAAAAA) & 0xFFFFFFFF);
-    for (auto c : text)
-    {
-        hash = Numerics::ror32(hash, 3) ^ (c * 13);
-    }
-    return hash;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(key >> 32);
 }
 
-static void ttf_surface_cache_dispose(ttf_cache_entry* entry)
+static ttf_glyph_cache* ttf_glyph_cache_get(const TTF_Font* font)
 {
-    if (entry->surface != nullptr)
+    for (auto& cache : _ttfGlyphCaches)
     {
-        ttf_free_surface(entry->surface);
-        free(entry->text);
-
-        entry->surface = nullptr;
-        entry->font = nullptr;
-        entry->text = nullptr;
+        if (cache != nullptr && cache->font == font)
+        {
+            return cache.get();
+        }
     }
+    return nullptr;
 }
 
-static void ttf_surface_cache_dispose_all()
+static void ttf_glyph_cache_clear(ttf_glyph_cache* cache)
 {
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
+    for (auto& slot : cache->glyphSlots)
+    {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    for (auto& slot : cache->kerningSlots)
     {
-        ttf_surface_cache_dispose(&_ttfSurfaceCache[i]);
-        _ttfSurfaceCacheCount--;
+        slot.store(0, std::memory_order_relaxed);
     }
+    cache->glyphs.clear();
+    cache->atlasPages.clear();
+    cache->atlasPage = nullptr;
+    cache->shelfX = 0;
+    cache->shelfY = 0;
+    cache->shelfHeight = 0;
+    cache->atlasBytes = 0;
 }
 
-void ttf_toggle_hinting()
+static const ttf_cached_glyph* ttf_glyph_cache_find(const ttf_glyph_cache* cache, uint32_t codepoint)
 {
-    FontLockHelper<std::mutex> lock(_mutex);
-    ttf_toggle_hinting(true);
+    for (uint32_t i = ttf_hash(codepoint);; i++)
+    {
+        auto glyph = cache->glyphSlots[i % TTF_GLYPH_CACHE_SLOTS].load(std::memory_order_acquire);
+        if (glyph == nullptr || glyph->codepoint == codepoint)
+        {
+            return glyph;
+        }
+    }
 }
 
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, std::string_view text)
+/**
+ * Finds room for a glyph bitmap on the current atlas page, rows of glyphs are stacked on shelves as high as the
+ * tallest glyph of the row. Returns the pitch of the page.
+ */
+static int32_t ttf_atlas_allocate(ttf_glyph_cache* cache, int32_t width, int32_t rows, uint8_t** pixels)
 {
-    ttf_cache_entry* entry;
+    if (width > TTF_ATLAS_PAGE_SIZE || rows > TTF_ATLAS_PAGE_SIZE)
+    {
+        auto& page = cache->atlasPages.emplace_back(std::make_unique<uint8_t[]>(static_cast<size_t>(width) * rows));
+        cache->atlasBytes += static_cast<size_t>(width) * rows;
+        *pixels = page.get();
+        return width;
+    }
+
+    if (cache->shelfX + width > TTF_ATLAS_PAGE_SIZE)
+    {
+        cache->shelfX = 0;
+        cache->shelfY += cache->shelfHeight;
+        cache->shelfHeight = 0;
+    }
+    if (cache->atlasPage == nullptr || cache->shelfY + rows > TTF_ATLAS_PAGE_SIZE)
+    {
+        auto& page = cache->atlasPages.emplace_back(
+            std::make_unique<uint8_t[]>(TTF_ATLAS_PAGE_SIZE * TTF_ATLAS_PAGE_SIZE));
+        cache->atlasBytes += TTF_ATLAS_PAGE_SIZE * TTF_ATLAS_PAGE_SIZE;
+        cache->atlasPage = page.get();
+        cache->shelfX = 0;
+        cache->shelfY = 0;
+        cache->shelfHeight = 0;
+    }
 
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_SURFACE_CACHE_SIZE;
+    *pixels = cache->atlasPage + cache->shelfY * TTF_ATLAS_PAGE_SIZE + cache->shelfX;
+    cache->shelfX += width;
+    cache->shelfHeight = std::max(cache->shelfHeight, rows);
+    return TTF_ATLAS_PAGE_SIZE;
+}
 
-    FontLockHelper<std::mutex> lock(_mutex);
+/**
+ * Renders the glyph and adds it to the cache, or returns nullptr if the glyph can not be rendered or the cache is
+ * full. Must be called while holding _mutex.
+ */
+static const ttf_cached_glyph* ttf_glyph_cache_add(ttf_glyph_cache* cache, uint32_t codepoint)
+{
+    // Another thread may have added it while waiting for the lock.
+    auto existing = ttf_glyph_cache_find(cache, codepoint);
+    if (existing != nullptr)
+    {
+        return existing;
+    }
+    if (cache->glyphs.size() >= TTF_GLYPH_CACHE_MAX_GLYPHS)
+    {
+        return nullptr;
+    }
 
-    for (int32_t i = 0; i < TTF_SURFACE_CACHE_SIZE; i++)
+    TTFGlyph rendered;
+    const bool shaded = TTF_GetFontHinting(cache->font) != 0;
+    if (!TTF_GetGlyph(cache->font, static_cast<uint16_t>(codepoint), shaded, &rendered))
     {
-        entry = &_ttfSurfaceCache[index];
+        return nullptr;
+    }
 
-        // Check if entry is a hit
-        if (entry->surface == nullptr)
-            break;
-        if (entry->font == font && String::Equals(entry->text, text))
+    auto& glyph = cache->glyphs.emplace_back();
+    glyph.codepoint = codepoint;
+    glyph.index = rendered.index;
+    glyph.minx = rendered.minx;
+    glyph.maxx = rendered.maxx;
+    glyph.miny = rendered.miny;
+    glyph.maxy = rendered.maxy;
+    glyph.yoffset = rendered.yoffset;
+    glyph.advance = rendered.advance;
+    glyph.width = rendered.width;
+    glyph.rows = rendered.rows;
+    glyph.pitch = 0;
+    glyph.pixels = nullptr;
+    if (rendered.width > 0 && rendered.rows > 0)
+    {
+        uint8_t* pixels;
+        glyph.pitch = ttf_atlas_allocate(cache, rendered.width, rendered.rows, &pixels);
+        glyph.pixels = pixels;
+        for (int32_t row = 0; row < rendered.rows; row++)
         {
-            _ttfSurfaceCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->surface;
+            std::copy_n(rendered.pixels + row * rendered.pitch, rendered.width, pixels + row * glyph.pitch);
         }
+    }
 
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
+    for (uint32_t i = ttf_hash(codepoint);; i++)
+    {
+        auto& slot = cache->glyphSlots[i % TTF_GLYPH_CACHE_SLOTS];
+        if (slot.load(std::memory_order_relaxed) == nullptr)
         {
+            slot.store(&glyph, std::memory_order_release);
             break;
         }
-
-        // Check if next entry is a hit
-        if (++index >= TTF_SURFACE_CACHE_SIZE)
-            index = 0;
     }
+    return &glyph;
+}
 
-    // Cache miss, replace entry with new surface
-    entry = &_ttfSurfaceCache[index];
-    ttf_surface_cache_dispose(entry);
+static int32_t ttf_kerning_cache_get(ttf_glyph_cache* cache, uint32_t prevIndex, uint32_t index, ttf_cache_counters& counters)
+{
+    if (!cache->hasKerning || prevIndex == 0 || index == 0)
+    {
+        return 0;
+    }
+    if (prevIndex >= TTF_KERNING_MAX_INDEX || index >= TTF_KERNING_MAX_INDEX)
+    {
+        FontLockHelper<std::mutex> lock(_mutex);
+        return TTF_GetKerning(cache->font, prevIndex, index);
+    }
 
-    TTFSurface* surface = ttf_render(font, text);
-    if (surface == nullptr)
+    const uint64_t key = TTF_KERNING_VALID | (static_cast<uint64_t>(prevIndex) << 43) | (static_cast<uint64_t>(index) << 23);
+    const uint32_t hash = ttf_hash(key);
+    for (uint32_t i = 0; i < TTF_KERNING_CACHE_MAX_PROBES; i++)
     {
-        return nullptr;
+        const auto entry = cache->kerningSlots[(hash + i) % TTF_KERNING_CACHE_SLOTS].load(std::memory_order_relaxed);
+        if (entry == 0)
+        {
+            break;
+        }
+        if ((entry & TTF_KERNING_KEY_MASK) == key)
+        {
+            counters.kerningHits++;
+            return static_cast<int16_t>(entry & 0xFFFF);
+        }
     }
 
-    _ttfSurfaceCacheMissCount++;
-    // printf("CACHE HITS: %d   MISSES: %d)\n", _ttfSurfaceCacheHitCount, _ttfSurfaceCacheMissCount);
+    counters.kerningMisses++;
+    FontLockHelper<std::mutex> lock(_mutex);
+    const auto kerning = std::clamp(TTF_GetKerning(cache->font, prevIndex, index), INT16_MIN, INT16_MAX);
+    for (uint32_t i = 0; i < TTF_KERNING_CACHE_MAX_PROBES; i++)
+    {
+        auto& slot = cache->kerningSlots[(hash + i) % TTF_KERNING_CACHE_SLOTS];
+        uint64_t expected = 0;
+        const auto entry = key | static_cast<uint16_t>(kerning);
+        if (slot.compare_exchange_strong(expected, entry, std::memory_order_relaxed)
+            || (expected & TTF_KERNING_KEY_MASK) == key)
+        {
+            break;
+        }
+    }
+    return kerning;
+}
 
-    _ttfSurfaceCacheCount++;
-    entry->surface = surface;
-    entry->font = font;
-    entry->text = strndup(text.data(), text.size());
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->surface;
+static void ttf_cache_add_counters(const ttf_cache_counters& counters)
+{
+    _ttfGlyphCacheHitCount.fetch_add(counters.glyphHits, std::memory_order_relaxed);
+    _ttfGlyphCacheMissCount.fetch_add(counters.glyphMisses, std::memory_order_relaxed);
+    _ttfKerningCacheHitCount.fetch_add(counters.kerningHits, std::memory_order_relaxed);
+    _ttfKerningCacheMissCount.fetch_add(counters.kerningMisses, std::memory_order_relaxed);
 }
 
-static void ttf_getwidth_cache_dispose(ttf_getwidth_cache_entry* entry)
+/**
+ * Looks up the glyphs of the text and the kerning between them, loading any that are missing. Returns false if a
+ * glyph is neither cached nor can be added, the text then has to be measured or rendered without the cache.
+ */
+static bool ttf_get_glyphs(
+    ttf_glyph_cache* cache, std::string_view text, std::vector<const ttf_cached_glyph*>& glyphs, std::vector<int32_t>& kerning)
 {
-    if (entry->text != nullptr)
+    ttf_cache_counters counters;
+    glyphs.clear();
+    kerning.clear();
+
+    const char* src = text.data();
+    size_t srcLen = text.size();
+    uint32_t prevIndex = 0;
+    bool result = true;
+    while (srcLen > 0)
     {
-        free(entry->text);
+        // The port handles glyphs as 16 bit.
+        const uint16_t codepoint = static_cast<uint16_t>(TTF_UTF8_getch(&src, &srcLen));
+        if (codepoint == 0xFEFF || codepoint == 0xFFFE)
+        {
+            continue;
+        }
 
-        entry->width = 0;
-        entry->font = nullptr;
-        entry->text = nullptr;
+        auto glyph = ttf_glyph_cache_find(cache, codepoint);
+        if (glyph != nullptr)
+        {
+            counters.glyphHits++;
+        }
+        else
+        {
+            counters.glyphMisses++;
+            FontLockHelper<std::mutex> lock(_mutex);
+            glyph = ttf_glyph_cache_add(cache, codepoint);
+            if (glyph == nullptr)
+            {
+                result = false;
+                break;
+            }
+        }
+
+        kerning.push_back(ttf_kerning_cache_get(cache, prevIndex, glyph->index, counters));
+        glyphs.push_back(glyph);
+        prevIndex = glyph->index;
     }
+
+    ttf_cache_add_counters(counters);
+    return result;
 }
 
-static void ttf_getwidth_cache_dispose_all()
+// Same bounds as TTF_SizeUTF8.
+static void ttf_measure_glyphs(
+    const ttf_glyph_cache* cache, const std::vector<const ttf_cached_glyph*>& glyphs, const std::vector<int32_t>& kerning,
+    int32_t* outWidth, int32_t* outHeight)
 {
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
+    int32_t x = 0;
+    int32_t minx = 0;
+    int32_t maxx = 0;
+    int32_t miny = 0;
+    for (size_t i = 0; i < glyphs.size(); i++)
     {
-        ttf_getwidth_cache_dispose(&_ttfGetWidthCache[i]);
-        _ttfGetWidthCacheCount--;
+        const auto* glyph = glyphs[i];
+        x += kerning[i];
+        minx = std::min(minx, x + glyph->minx);
+        maxx = std::max(maxx, x + std::max(glyph->advance, glyph->maxx));
+        x += glyph->advance;
+        miny = std::min(miny, glyph->miny);
     }
+    *outWidth = maxx - minx;
+    *outHeight = std::max(cache->ascent - miny, cache->height);
 }
 
-uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, std::string_view text)
+TTFSurface* ttf_render_string(TTF_Font* font, std::string_view text)
 {
-    ttf_getwidth_cache_entry* entry;
-
-    uint32_t hash = ttf_surface_cache_hash(font, text);
-    int32_t index = hash % TTF_GETWIDTH_CACHE_SIZE;
+    thread_local std::vector<const ttf_cached_glyph*> glyphs;
+    thread_local std::vector<int32_t> kerning;
+    thread_local std::vector<uint8_t> pixels;
+    thread_local TTFSurface surface;
 
-    FontLockHelper<std::mutex> lock(_mutex);
+    auto cache = ttf_glyph_cache_get(font);
+    if (cache == nullptr || !ttf_get_glyphs(cache, text, glyphs, kerning))
+    {
+        TTFSurface* rendered;
+        {
+            FontLockHelper<std::mutex> lock(_mutex);
+            rendered = ttf_render(font, text);
+        }
+        if (rendered == nullptr)
+        {
+            return nullptr;
+        }
+        auto renderedPixels = static_cast<const uint8_t*>(rendered->pixels);
+        pixels.assign(renderedPixels, renderedPixels + rendered->pitch * rendered->h);
+        surface = { pixels.data(), rendered->w, rendered->h, rendered->pitch };
+        ttf_free_surface(rendered);
+        return &surface;
+    }
 
-    for (int32_t i = 0; i < TTF_GETWIDTH_CACHE_SIZE; i++)
+    int32_t width, height;
+    ttf_measure_glyphs(cache, glyphs, kerning, &width, &height);
+    if (width == 0)
     {
-        entry = &_ttfGetWidthCache[index];
+        return nullptr;
+    }
 
-        // Check if entry is a hit
-        if (entry->text == nullptr)
-            break;
-        if (entry->font == font && String::Equals(entry->text, text))
+    // Composed the same way as TTF_RenderUTF8_Solid and TTF_RenderUTF8_Shaded.
+    pixels.assign(static_cast<size_t>(width) * height, 0);
+    const uint8_t* dstCheck = pixels.data() + pixels.size();
+    int32_t xstart = 0;
+    for (size_t i = 0; i < glyphs.size(); i++)
+    {
+        const auto* glyph = glyphs[i];
+        xstart += kerning[i];
+        // Compensate for the wrap around with negative minx's
+        if (i == 0 && glyph->minx < 0)
         {
-            _ttfGetWidthCacheHitCount++;
-            entry->lastUseTick = gCurrentDrawCount;
-            return entry->width;
+            xstart -= glyph->minx;
         }
 
-        // If entry hasn't been used for a while, replace it
-        if (entry->lastUseTick < gCurrentDrawCount - 64)
+        for (int32_t row = 0; row < glyph->rows; row++)
         {
-            break;
+            if (row + glyph->yoffset < 0 || row + glyph->yoffset >= height)
+            {
+                continue;
+            }
+            uint8_t* dst = pixels.data() + (row + glyph->yoffset) * width + xstart + glyph->minx;
+            const uint8_t* src = glyph->pixels + row * glyph->pitch;
+            for (int32_t col = glyph->width; col > 0 && dst < dstCheck; col--)
+            {
+                *dst++ |= *src++;
+            }
         }
-
-        // Check if next entry is a hit
-        if (++index >= TTF_GETWIDTH_CACHE_SIZE)
-            index = 0;
+        xstart += glyph->advance;
     }
 
-    // Cache miss, replace entry with new width
-    entry = &_ttfGetWidthCache[index];
-    ttf_getwidth_cache_dispose(entry);
+    surface = { pixels.data(), width, height, width };
+    return &surface;
+}
 
-    int32_t width, height;
-    ttf_get_size(font, text, &width, &height);
+void ttf_toggle_hinting()
+{
+    FontLockHelper<std::mutex> lock(_mutex);
+    ttf_toggle_hinting(true);
+}
 
-    _ttfGetWidthCacheMissCount++;
+uint32_t ttf_get_string_width(TTF_Font* font, std::string_view text)
+{
+    thread_local std::vector<const ttf_cached_glyph*> glyphs;
+    thread_local std::vector<int32_t> kerning;
 
-    _ttfGetWidthCacheCount++;
-    entry->width = width;
-    entry->font = font;
-    entry->text = strndup(text.data(), text.size());
-    entry->lastUseTick = gCurrentDrawCount;
-    return entry->width;
+    int32_t width = 0;
+    int32_t height = 0;
+    auto cache = ttf_glyph_cache_get(font);
+    if (cache != nullptr && ttf_get_glyphs(cache, text, glyphs, kerning))
+    {
+        ttf_measure_glyphs(cache, glyphs, kerning, &width, &height);
+    }
+    else
+    {
+        FontLockHelper<std::mutex> lock(_mutex);
+        ttf_get_size(font, text, &width, &height);
+    }
+    return width;
 }
 
-TTFFontDescriptor* ttf_get_font_from_sprite_base(FontSpriteBase spriteBase)
+TTFCacheStats ttf_cache_get_stats()
 {
+    TTFCacheStats stats{};
+    stats.GlyphHits = _ttfGlyphCacheHitCount;
+    stats.GlyphMisses = _ttfGlyphCacheMissCount;
+    stats.KerningHits = _ttfKerningCacheHitCount;
+    stats.KerningMisses = _ttfKerningCacheMissCount;
+
     FontLockHelper<std::mutex> lock(_mutex);
+    for (const auto& cache : _ttfGlyphCaches)
+    {
+        if (cache != nullptr)
+        {
+            stats.Glyphs += cache->glyphs.size();
+            stats.AtlasBytes += cache->atlasBytes;
+        }
+    }
+    return stats;
+}
+
+void ttf_cache_reset_stats()
+{
+    _ttfGlyphCacheHitCount = 0;
+    _ttfGlyphCacheMissCount = 0;
+    _ttfKerningCacheHitCount = 0;
+    _ttfKerningCacheMissCount = 0;
+}
+
+TTFFontDescriptor* ttf_get_font_from_sprite_base(FontSpriteBase spriteBase)
+{
     return &gCurrentTTFFontSet->size[font_get_size_from_sprite_base(spriteBase)];
 }
 
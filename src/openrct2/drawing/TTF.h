@@ -26,12 +26,45 @@ struct TTFSurface
     int32_t pitch;
 };
 
+// A glyph as rendered by the port, the pixels are only valid until the next glyph of the font is loaded.
+struct TTFGlyph
+{
+    uint32_t index;
+    int32_t minx;
+    int32_t maxx;
+    int32_t miny;
+    int32_t maxy;
+    int32_t yoffset;
+    int32_t advance;
+    int32_t width;
+    int32_t rows;
+    int32_t pitch;
+    const uint8_t* pixels;
+};
+
+struct TTFCacheStats
+{
+    uint64_t GlyphHits;
+    uint64_t GlyphMisses;
+    uint64_t KerningHits;
+    uint64_t KerningMisses;
+    size_t Glyphs;
+    size_t AtlasBytes;
+};
+
 TTFFontDescriptor* ttf_get_font_from_sprite_base(FontSpriteBase spriteBase);
 void ttf_toggle_hinting();
-TTFSurface* ttf_surface_cache_get_or_add(TTF_Font* font, std::string_view text);
-uint32_t ttf_getwidth_cache_get_or_add(TTF_Font* font, std::string_view text);
+
+/**
+ * Renders the text from the glyph cache. The surface belongs to the calling thread and is reused by its next call.
+ * Returns nullptr for text without width.
+ */
+TTFSurface* ttf_render_string(TTF_Font* font, std::string_view text);
+uint32_t ttf_get_string_width(TTF_Font* font, std::string_view text);
 bool ttf_provides_glyph(const TTF_Font* font, codepoint_t codepoint);
 void ttf_free_surface(TTFSurface* surface);
+TTFCacheStats ttf_cache_get_stats();
+void ttf_cache_reset_stats();
 
 // TTF_SDLPORT
 int TTF_Init(void);
@@ -41,6 +74,12 @@ int TTF_SizeUTF8(TTF_Font* font, const char* text, int* w, int* h);
 TTFSurface* TTF_RenderUTF8_Solid(TTF_Font* font, const char* text, uint32_t colour);
 TTFSurface* TTF_RenderUTF8_Shaded(TTF_Font* font, const char* text, uint32_t fg, uint32_t bg);
 void TTF_CloseFont(TTF_Font* font);
+uint32_t TTF_UTF8_getch(const char** src, size_t* srclen);
+bool TTF_GetGlyph(TTF_Font* font, uint16_t ch, bool shaded, TTFGlyph* out);
+int TTF_GetKerning(TTF_Font* font, uint32_t prev_index, uint32_t index);
+bool TTF_HasKerning(const TTF_Font* font);
+int TTF_FontAscent(const TTF_Font* font);
+int TTF_FontHeight(const TTF_Font* font);
 void TTF_SetFontHinting(TTF_Font* font, int hinting);
 int TTF_GetFontHinting(const TTF_Font* font);
 void TTF_Quit(void);
@@ -1560,6 +1560,69 @@ int TTF_GetFontHinting(const TTF_Font* font)
     return 0;
 }
 
+uint32_t TTF_UTF8_getch(const char** src, size_t* srclen)
+{
+    return UTF8_getch(src, srclen);
+}
+
+bool TTF_GetGlyph(TTF_Font* font, uint16_t ch, bool shaded, TTFGlyph* out)
+{
+    FT_Error error = Find_Glyph(font, ch, CACHED_METRICS | (shaded ? CACHED_PIXMAP : CACHED_BITMAP));
+    if (error)
+    {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return false;
+    }
+
+    const c_glyph* glyph = font->current;
+    const FT_Bitmap& bitmap = shaded ? glyph->pixmap : glyph->bitmap;
+    out->index = glyph->index;
+    out->minx = glyph->minx;
+    out->maxx = glyph->maxx;
+    out->miny = glyph->miny;
+    out->maxy = glyph->maxy;
+    out->yoffset = glyph->yoffset;
+    out->advance = glyph->advance;
+
+    /* Same width correction as the render functions */
+    int width = bitmap.width;
+    if (font->outline <= 0 && width > glyph->maxx - glyph->minx)
+    {
+        width = glyph->maxx - glyph->minx;
+    }
+    out->width = std::max(width, 0);
+    out->rows = bitmap.rows;
+    out->pitch = bitmap.pitch;
+    out->pixels = bitmap.buffer;
+    return true;
+}
+
+int TTF_GetKerning(TTF_Font* font, uint32_t prev_index, uint32_t index)
+{
+    if (!TTF_HasKerning(font) || !prev_index || !index)
+    {
+        return 0;
+    }
+    FT_Vector delta;
+    FT_Get_Kerning(font->face, prev_index, index, ft_kerning_default, &delta);
+    return delta.x >> 6;
+}
+
+bool TTF_HasKerning(const TTF_Font* font)
+{
+    return FT_HAS_KERNING(font->face) && font->kerning;
+}
+
+int TTF_FontAscent(const TTF_Font* font)
+{
+    return font->ascent;
+}
+
+int TTF_FontHeight(const TTF_Font* font)
+{
+    return font->height;
+}
+
 void TTF_Quit(void)
 {
     if (TTF_initialized)
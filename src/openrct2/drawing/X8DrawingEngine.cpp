@@ -14,6 +14,7 @@
 #include "../Intro.h"
 #include "../config/Config.h"
 #include "../core/Numerics.hpp"
+#include "../core/TaskScheduler.h"
 #include "../interface/Screenshot.h"
 #include "../interface/Viewport.h"
 #include "../interface/Window.h"
@@ -182,13 +183,19 @@ void X8DrawingEngine::Invalidate(int32_t left, int32_t top, int32_t right, int32
         for (int16_t x = left; x <= right; x++)
         {
             screenDirtyBlocks[yOffset + x] = 0xFF;
+            _changedBlocks[yOffset + x] = 0xFF;
         }
     }
 }
 
 void X8DrawingEngine::BeginDraw()
 {
-    if (gIntroState == IntroState::None)
+    if (gIntroState != IntroState::None)
+    {
+        // The intro draws straight to the screen.
+        MarkAllChanged();
+    }
+    else
     {
 #ifdef __ENABLE_LIGHTFX__
         // HACK we need to re-configure the bits if light fx has been enabled / disabled
@@ -197,6 +204,10 @@ void X8DrawingEngine::BeginDraw()
             Resize(_width, _height);
         }
 #endif
+        if (_weatherDrawer.HasPixels())
+        {
+            MarkAllChanged();
+        }
         _weatherDrawer.Restore(&_bitsDPI);
     }
 }
@@ -219,6 +230,10 @@ void X8DrawingEngine::PaintWindows()
 void X8DrawingEngine::PaintWeather()
 {
     DrawWeather(&_bitsDPI, &_weatherDrawer);
+    if (_weatherDrawer.HasPixels())
+    {
+        MarkAllChanged();
+    }
 }
 
 void X8DrawingEngine::CopyRect(int32_t x, int32_t y, int32_t width, int32_t height, int32_t dx, int32_t dy)
@@ -239,6 +254,7 @@ void X8DrawingEngine::CopyRect(int32_t x, int32_t y, int32_t width, int32_t heig
     y -= tmargin;
     width += lmargin + rmargin;
     height += tmargin + bmargin;
+    MarkChangedPixels(x, y, x + width, y + height);
 
     int32_t stride = _bitsDPI.width + _bitsDPI.pitch;
     uint8_t* to = _bitsDPI.bits + y * stride + x;
@@ -366,71 +382,123 @@ void X8DrawingEngine::ConfigureDirtyGrid()
 
     delete[] _dirtyGrid.Blocks;
     _dirtyGrid.Blocks = new uint8_t[_dirtyGrid.BlockColumns * _dirtyGrid.BlockRows];
+
+    _changedBlocks.assign(_dirtyGrid.BlockColumns * _dirtyGrid.BlockRows, 0);
+    _allChanged = true;
 }
 
-void X8DrawingEngine::DrawAllDirtyBlocks()
+/**
+ * Finds the runs of set blocks, each as wide as possible and then as tall as the blocks below allow, clears them and
+ * passes them on. Blocks set while func runs are picked up if the scan has not passed them yet.
+ */
+template<typename TFunc> static void ForEachBlockRun(const DirtyGrid& grid, uint8_t* blocks, TFunc&& func)
 {
-    for (uint32_t x = 0; x < _dirtyGrid.BlockColumns; x++)
+    for (uint32_t x = 0; x < grid.BlockColumns; x++)
     {
-        for (uint32_t y = 0; y < _dirtyGrid.BlockRows; y++)
+        for (uint32_t y = 0; y < grid.BlockRows; y++)
         {
-            uint32_t yOffset = y * _dirtyGrid.BlockColumns;
-            if (_dirtyGrid.Blocks[yOffset + x] == 0)
+            uint32_t yOffset = y * grid.BlockColumns;
+            if (blocks[yOffset + x] == 0)
             {
                 continue;
             }
 
             // Determine columns
             uint32_t xx;
-            for (xx = x; xx < _dirtyGrid.BlockColumns; xx++)
+            for (xx = x; xx < grid.BlockColumns; xx++)
             {
-                if (_dirtyGrid.Blocks[yOffset + xx] == 0)
+                if (blocks[yOffset + xx] == 0)
                 {
                     break;
                 }
             }
+            uint32_t columns = xx - x;
 
             // Check rows
-            uint32_t columns = xx - x;
-            auto rows = GetNumDirtyRows(x, y, columns);
-            DrawDirtyBlocks(x, y, columns, rows);
+            uint32_t yy;
+            for (yy = y + 1; yy < grid.BlockRows; yy++)
+            {
+                const uint8_t* row = blocks + yy * grid.BlockColumns;
+                if (std::any_of(row + x, row + x + columns, [](uint8_t block) { return block == 0; }))
+                {
+                    break;
+                }
+            }
+            uint32_t rows = yy - y;
+
+            // Unset blocks
+            for (uint32_t top = y; top < y + rows; top++)
+            {
+                std::fill_n(blocks + top * grid.BlockColumns + x, columns, 0);
+            }
+
+            func(x, y, columns, rows);
         }
     }
 }
 
-uint32_t X8DrawingEngine::GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns)
+void X8DrawingEngine::DrawAllDirtyBlocks()
 {
-    uint32_t yy = y;
-
-    for (yy = y; yy < _dirtyGrid.BlockRows; yy++)
+    if (gConfigGeneral.multithreading)
     {
-        uint32_t yyOffset = yy * _dirtyGrid.BlockColumns;
-        for (uint32_t xx = x; xx < x + columns; xx++)
+        const auto numBands = std::min<size_t>(_dirtyGrid.BlockRows, GetTaskScheduler().GetNumWorkers() + 1);
+        if (numBands > 1)
         {
-            if (_dirtyGrid.Blocks[yyOffset + xx] == 0)
-            {
-                return yy - y;
-            }
+            DrawAllDirtyBlocksInBands(numBands);
+            return;
         }
     }
-    return yy - y;
+
+    ForEachBlockRun(_dirtyGrid, _dirtyGrid.Blocks, [this](uint32_t x, uint32_t y, uint32_t columns, uint32_t rows) {
+        DrawDirtyRegion(x, y, columns, rows);
+    });
 }
 
-void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+/**
+ * Splits the screen into horizontal bands of block rows and draws them in parallel. The runs of dirty blocks are
+ * gathered first and cut at the band edges, so every band clips windows and viewports to its own part of the screen.
+ * Windows are drawn one band at a time, only the viewport painting of the bands overlaps, see WindowDrawingUnlock.
+ */
+void X8DrawingEngine::DrawAllDirtyBlocksInBands(size_t numBands)
 {
-    uint32_t dirtyBlockColumns = _dirtyGrid.BlockColumns;
-    uint8_t* screenDirtyBlocks = _dirtyGrid.Blocks;
+    const uint32_t bandRows = static_cast<uint32_t>((_dirtyGrid.BlockRows + numBands - 1) / numBands);
+    _dirtyBands.resize(numBands);
+    for (auto& band : _dirtyBands)
+    {
+        band.clear();
+    }
 
-    // Unset dirty blocks
-    for (uint32_t top = y; top < y + rows; top++)
+    ForEachBlockRun(
+        _dirtyGrid, _dirtyGrid.Blocks, [this, bandRows](uint32_t x, uint32_t y, uint32_t columns, uint32_t rows) {
+            for (uint32_t top = y; top < y + rows;)
+            {
+                const uint32_t band = top / bandRows;
+                const uint32_t bottom = std::min(y + rows, (band + 1) * bandRows);
+                _dirtyBands[band].push_back({ x, top, columns, bottom - top });
+                top = bottom;
+            }
+        });
+
+    std::mutex windowDrawingMutex;
+    TaskGroup bandTasks;
+    for (const auto& band : _dirtyBands)
     {
-        uint32_t topOffset = top * dirtyBlockColumns;
-        for (uint32_t left = x; left < x + columns; left++)
-        {
-            screenDirtyBlocks[topOffset + left] = 0;
-        }
+        if (band.empty())
+            continue;
+
+        bandTasks.Run([this, &band, &windowDrawingMutex]() -> void {
+            WindowDrawingLock lock(windowDrawingMutex);
+            for (const auto& run : band)
+            {
+                DrawDirtyRegion(run.X, run.Y, run.Columns, run.Rows);
+            }
+        });
     }
+    bandTasks.Wait();
+}
 
+void X8DrawingEngine::DrawDirtyRegion(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+{
     // Determine region in pixels
     uint32_t left = std::max<uint32_t>(0, x * _dirtyGrid.BlockWidth);
     uint32_t top = std::max<uint32_t>(0, y * _dirtyGrid.BlockHeight);
@@ -443,9 +511,64 @@ void X8DrawingEngine::DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns,
 
     // Draw region
     OnDrawDirtyBlock(x, y, columns, rows);
+    MarkChangedBlocks(x, y, columns, rows);
     window_draw_all(&_bitsDPI, left, top, right, bottom);
 }
 
+void X8DrawingEngine::MarkChangedBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows)
+{
+    for (uint32_t top = y; top < y + rows; top++)
+    {
+        std::fill_n(_changedBlocks.begin() + top * _dirtyGrid.BlockColumns + x, columns, 0xFF);
+    }
+}
+
+void X8DrawingEngine::MarkChangedPixels(int32_t left, int32_t top, int32_t right, int32_t bottom)
+{
+    left = std::max(left, 0);
+    top = std::max(top, 0);
+    right = std::min(right, static_cast<int32_t>(_width));
+    bottom = std::min(bottom, static_cast<int32_t>(_height));
+    if (left >= right || top >= bottom)
+        return;
+
+    const uint32_t x = left >> _dirtyGrid.BlockShiftX;
+    const uint32_t y = top >> _dirtyGrid.BlockShiftY;
+    MarkChangedBlocks(x, y, ((right - 1) >> _dirtyGrid.BlockShiftX) - x + 1, ((bottom - 1) >> _dirtyGrid.BlockShiftY) - y + 1);
+}
+
+void X8DrawingEngine::MarkAllChanged()
+{
+    _allChanged = true;
+}
+
+const std::vector<ScreenRect>& X8DrawingEngine::TakeChangedRegions()
+{
+    _changedRegions.clear();
+    if (_allChanged)
+    {
+        std::fill(_changedBlocks.begin(), _changedBlocks.end(), 0);
+        _allChanged = false;
+        if (_width > 0 && _height > 0)
+        {
+            _changedRegions.push_back({ { 0, 0 }, { static_cast<int32_t>(_width), static_cast<int32_t>(_height) } });
+        }
+        return _changedRegions;
+    }
+
+    ForEachBlockRun(_dirtyGrid, _changedBlocks.data(), [this](uint32_t x, uint32_t y, uint32_t columns, uint32_t rows) {
+        const int32_t left = x * _dirtyGrid.BlockWidth;
+        const int32_t top = y * _dirtyGrid.BlockHeight;
+        const int32_t right = std::min(_width, (x + columns) * _dirtyGrid.BlockWidth);
+        const int32_t bottom = std::min(_height, (y + rows) * _dirtyGrid.BlockHeight);
+        if (left < right && top < bottom)
+        {
+            _changedRegions.push_back({ { left, top }, { right, bottom } });
+        }
+    });
+    return _changedRegions;
+}
+
 #ifdef __WARN_SUGGEST_FINAL_METHODS__
 #    pragma GCC diagnostic pop
 #endif
@@ -10,9 +10,12 @@
 #pragma once
 
 #include "../common.h"
+#include "../world/Location.hpp"
 #include "IDrawingContext.h"
 #include "IDrawingEngine.h"
 
+#include <vector>
+
 namespace OpenRCT2
 {
     namespace Ui
@@ -35,6 +38,14 @@ namespace OpenRCT2
             uint8_t* Blocks;
         };
 
+        struct DirtyBlockRun
+        {
+            uint32_t X;
+            uint32_t Y;
+            uint32_t Columns;
+            uint32_t Rows;
+        };
+
         class X8WeatherDrawer final : public IWeatherDrawer
         {
         private:
@@ -57,6 +68,11 @@ namespace OpenRCT2
                 rct_drawpixelinfo* dpi, int32_t x, int32_t y, int32_t width, int32_t height, int32_t xStart, int32_t yStart,
                 const uint8_t* weatherpattern) override;
             void Restore(rct_drawpixelinfo* dpi);
+
+            bool HasPixels() const
+            {
+                return _weatherPixelsCount > 0;
+            }
         };
 
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
@@ -73,6 +89,14 @@ namespace OpenRCT2
             uint8_t* _bits = nullptr;
 
             DirtyGrid _dirtyGrid = {};
+            // Runs of dirty blocks per screen band, kept to reuse their storage.
+            std::vector<std::vector<DirtyBlockRun>> _dirtyBands;
+            // Blocks of the dirty grid whose pixels changed since the last TakeChangedRegions, for engines that copy the
+            // frame elsewhere. Besides redrawn blocks these are blocks that are invalidated, which is what anything
+            // drawing outside of the windows does to have its pixels cleared up the next frame.
+            std::vector<uint8_t> _changedBlocks;
+            std::vector<ScreenRect> _changedRegions;
+            bool _allChanged = true;
 
             rct_drawpixelinfo _bitsDPI = {};
 
@@ -117,13 +141,18 @@ namespace OpenRCT2
         protected:
             void ConfigureBits(uint32_t width, uint32_t height, uint32_t pitch);
             virtual void OnDrawDirtyBlock(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void MarkAllChanged();
+            // Returns the changed parts of the screen merged into rectangles, or the whole screen, and starts over.
+            const std::vector<ScreenRect>& TakeChangedRegions();
 
         private:
             void ConfigureDirtyGrid();
             static void ResetWindowVisbilities();
             void DrawAllDirtyBlocks();
-            uint32_t GetNumDirtyRows(const uint32_t x, const uint32_t y, const uint32_t columns);
-            void DrawDirtyBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void DrawAllDirtyBlocksInBands(size_t numBands);
+            void DrawDirtyRegion(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void MarkChangedBlocks(uint32_t x, uint32_t y, uint32_t columns, uint32_t rows);
+            void MarkChangedPixels(int32_t left, int32_t top, int32_t right, int32_t bottom);
         };
 #ifdef __WARN_SUGGEST_FINAL_TYPES__
 #    pragma GCC diagnostic pop
@@ -40,6 +40,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../peep/GuestPathfinding.h"
 #include "../peep/Staff.h"
 #include "../platform/platform.h"
 #include "../ride/Ride.h"
@@ -637,6 +638,10 @@ static int32_t cc_get(InteractiveConsole& console, const arguments_t& argv)
         {
             console.WriteFormatLine("park_open %d", (gParkFlags & PARK_FLAGS_PARK_OPEN) != 0);
         }
+        else if (argv[0] == "guest_flow_field_pathfinding")
+        {
+            console.WriteFormatLine("guest_flow_field_pathfinding %d", (gParkFlags & PARK_FLAGS_FLOW_FIELD_PATHFINDING) != 0);
+        }
         else if (argv[0] == "land_rights_cost")
         {
             console.WriteFormatLine("land_rights_cost %d.%d0", gLandPrice / 10, gLandPrice % 10);
@@ -859,6 +864,11 @@ static int32_t cc_set(InteractiveConsole& console, const arguments_t& argv)
             SET_FLAG(gParkFlags, PARK_FLAGS_PARK_OPEN, int_val[0]);
             console.Execute("get park_open");
         }
+        else if (argv[0] == "guest_flow_field_pathfinding" && invalidArguments(&invalidArgs, int_valid[0]))
+        {
+            SET_FLAG(gParkFlags, PARK_FLAGS_FLOW_FIELD_PATHFINDING, int_val[0]);
+            console.Execute("get guest_flow_field_pathfinding");
+        }
         else if (argv[0] == "land_rights_cost" && invalidArguments(&invalidArgs, double_valid[0]))
         {
             gLandPrice = std::clamp(
@@ -1041,6 +1051,8 @@ static int32_t cc_set(InteractiveConsole& console, const arguments_t& argv)
             config_save_default();
             console.Execute("get enable_hinting");
             ttf_toggle_hinting();
+            // Scrolling text is drawn into its slots once, redraw it with the new hinting.
+            scrolling_text_invalidate();
         }
 #endif
         else if (invalidArgs)
@@ -1291,6 +1303,75 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_pathfinding_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        PathfindingCacheResetStats();
+        console.WriteLine("Pathfinding cache counters reset.");
+        return 0;
+    }
+
+    const auto stats = PathfindingCacheGetStats();
+    const auto lookups = stats.Hits + stats.Misses;
+    const double hitRate = lookups > 0 ? 100.0 * stats.Hits / lookups : 0.0;
+    console.WriteFormatLine("Hits: %llu", static_cast<unsigned long long>(stats.Hits));
+    console.WriteFormatLine("Misses: %llu", static_cast<unsigned long long>(stats.Misses));
+    console.WriteFormatLine("Hit rate: %.1f%%", hitRate);
+    console.WriteFormatLine("Entries: %zu", stats.Entries);
+    return 0;
+}
+
+static int32_t cc_scrolling_text_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        scrolling_text_cache_reset_stats();
+        console.WriteLine("Scrolling text cache counters reset.");
+        return 0;
+    }
+
+    const auto stats = scrolling_text_cache_get_stats();
+    const auto slotLookups = stats.SlotHits + stats.SlotMisses;
+    const auto stripLookups = stats.StripHits + stats.StripMisses;
+    console.WriteFormatLine("Slot hits: %llu", static_cast<unsigned long long>(stats.SlotHits));
+    console.WriteFormatLine("Slot misses: %llu", static_cast<unsigned long long>(stats.SlotMisses));
+    console.WriteFormatLine("Slot hit rate: %.1f%%", slotLookups > 0 ? 100.0 * stats.SlotHits / slotLookups : 0.0);
+    console.WriteFormatLine("Slot thrashes: %llu", static_cast<unsigned long long>(stats.SlotThrashes));
+    console.WriteFormatLine("Strip hits: %llu", static_cast<unsigned long long>(stats.StripHits));
+    console.WriteFormatLine("Strip misses: %llu", static_cast<unsigned long long>(stats.StripMisses));
+    console.WriteFormatLine("Strip hit rate: %.1f%%", stripLookups > 0 ? 100.0 * stats.StripHits / stripLookups : 0.0);
+    console.WriteFormatLine("Strips: %zu", stats.Strips);
+    console.WriteFormatLine("Strip size: %zu KiB", stats.StripBytes / 1024);
+    return 0;
+}
+
+#ifndef NO_TTF
+static int32_t cc_ttf_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        ttf_cache_reset_stats();
+        console.WriteLine("TrueType glyph cache counters reset.");
+        return 0;
+    }
+
+    const auto stats = ttf_cache_get_stats();
+    const auto glyphLookups = stats.GlyphHits + stats.GlyphMisses;
+    const auto kerningLookups = stats.KerningHits + stats.KerningMisses;
+    console.WriteFormatLine("Glyph hits: %llu", static_cast<unsigned long long>(stats.GlyphHits));
+    console.WriteFormatLine("Glyph misses: %llu", static_cast<unsigned long long>(stats.GlyphMisses));
+    console.WriteFormatLine("Glyph hit rate: %.1f%%", glyphLookups > 0 ? 100.0 * stats.GlyphHits / glyphLookups : 0.0);
+    console.WriteFormatLine("Kerning hits: %llu", static_cast<unsigned long long>(stats.KerningHits));
+    console.WriteFormatLine("Kerning misses: %llu", static_cast<unsigned long long>(stats.KerningMisses));
+    console.WriteFormatLine(
+        "Kerning hit rate: %.1f%%", kerningLookups > 0 ? 100.0 * stats.KerningHits / kerningLookups : 0.0);
+    console.WriteFormatLine("Glyphs: %zu", stats.Glyphs);
+    console.WriteFormatLine("Atlas size: %zu KiB", stats.AtlasBytes / 1024);
+    return 0;
+}
+#endif
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1761,6 +1842,7 @@ static constexpr const utf8* console_variable_table[] = {
     "land_rights_cost",
     "construction_rights_cost",
     "park_open",
+    "guest_flow_field_pathfinding",
     "climate",
     "game_speed",
     "console_small_font",
@@ -1807,6 +1889,8 @@ static constexpr const console_command console_command_table[] = {
     { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
+    { "pathfinding_cache", cc_pathfinding_cache, "Shows or resets the guest pathfinding cache counters.",
+      "pathfinding_cache [reset]" },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
     { "remove_unused_objects", cc_remove_unused_objects, "Removes all the unused objects from the object selection.",
@@ -1816,10 +1900,15 @@ static constexpr const console_command console_command_table[] = {
     { "save_park", cc_save_park, "Save current state of park. If no name specified default path will be used.",
       "save_park [name]" },
     { "say", cc_say, "Say to other players.", "say <message>" },
+    { "scrolling_text_cache", cc_scrolling_text_cache, "Shows or resets the scrolling text cache counters.",
+      "scrolling_text_cache [reset]" },
     { "set", cc_set, "Sets the variable to the specified value.", "set <variable> <value>" },
     { "show_limits", cc_show_limits, "Shows the map data counts and limits.", "show_limits" },
     { "staff", cc_staff, "Staff management.", "staff <subcommand>" },
     { "terminate", cc_terminate, "Calls std::terminate(), for testing purposes only.", "terminate" },
+#ifndef NO_TTF
+    { "ttf_cache", cc_ttf_cache, "Shows or resets the TrueType glyph cache counters.", "ttf_cache [reset]" },
+#endif
     { "variables", cc_variables, "Lists all the variables that can be used with get and sometimes set.", "variables" },
     { "windows", cc_windows, "Lists all the windows that can be opened.", "windows" },
     { "replay_startrecord", cc_replay_startrecord, "Starts recording a new replay.", "replay_startrecord <name> [max_ticks]" },
@@ -18,6 +18,7 @@
 #include "../audio/audio.h"
 #include "../core/Console.hpp"
 #include "../core/Imaging.h"
+#include "../core/TaskScheduler.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
@@ -35,6 +36,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 using namespace std::literals::string_literals;
 using namespace OpenRCT2;
@@ -376,9 +378,71 @@ static void RenderViewport(IDrawingEngine* drawingEngine, const rct_viewport& vi
     viewport_render(&dpi, &viewport, { { 0, 0 }, { viewport.width, viewport.height } });
 }
 
+// Rows painted and encoded at a time by RenderViewportToFile, the pixels of two bands are all that is held in memory
+// however large the viewport is.
+static constexpr int32_t RenderBandHeight = 256;
+
+/**
+ * Paints the viewport in bands of full width rows and streams them into a PNG file. Each band is rendered the same
+ * way a dirty block of the screen is, so the result matches painting the whole viewport into one buffer.
+ */
+static void RenderViewportToFile(std::string_view path, const rct_viewport& viewport)
+{
+    if (viewport.width <= 0 || viewport.height <= 0)
+    {
+        throw std::runtime_error("Screenshot failed, the view is empty.");
+    }
+
+    // Ensure sprites appear regardless of rotation
+    reset_all_sprite_quadrant_placements();
+
+    X8DrawingEngine drawingEngine(GetContext()->GetUiContext());
+    Imaging::PngFileWriter writer(path, viewport.width, viewport.height, 8, &gPalette);
+
+    const auto bandSize = static_cast<size_t>(viewport.width) * std::min(viewport.height, RenderBandHeight);
+    std::vector<uint8_t> bands[2];
+    for (auto& band : bands)
+    {
+        band.reserve(bandSize);
+    }
+
+    // The next band is painted while the previous one is being encoded.
+    const bool useMultithreading = gConfigGeneral.multithreading;
+    TaskGroup encodeTasks;
+    size_t bandIndex = 0;
+    for (int32_t top = 0; top < viewport.height; top += RenderBandHeight, bandIndex++)
+    {
+        const int32_t height = std::min(RenderBandHeight, viewport.height - top);
+        auto& pixels = bands[bandIndex % 2];
+        pixels.assign(static_cast<size_t>(viewport.width) * height, PALETTE_INDEX_0);
+
+        rct_drawpixelinfo dpi;
+        dpi.bits = pixels.data();
+        dpi.x = 0;
+        dpi.y = top;
+        dpi.width = viewport.width;
+        dpi.height = height;
+        dpi.DrawingEngine = &drawingEngine;
+        viewport_render(&dpi, &viewport, { { 0, top }, { viewport.width, top + height } });
+
+        const auto* rows = pixels.data();
+        const auto width = static_cast<uint32_t>(viewport.width);
+        if (useMultithreading)
+        {
+            encodeTasks.Wait();
+            encodeTasks.Run([&writer, rows, height, width]() { writer.WriteRows(rows, height, width); });
+        }
+        else
+        {
+            writer.WriteRows(rows, height, width);
+        }
+    }
+    encodeTasks.Wait();
+    writer.Finish();
+}
+
 void screenshot_giant()
 {
-    rct_drawpixelinfo dpi{};
     try
     {
         auto path = screenshot_get_next_path();
@@ -407,10 +471,7 @@ void screenshot_giant()
             viewport.flags |= VIEWPORT_FLAG_TRANSPARENT_BACKGROUND;
         }
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(path.value(), &dpi, gPalette);
+        RenderViewportToFile(path.value(), viewport);
 
         // Show user that screenshot saved successfully
         Formatter ft;
@@ -423,8 +484,6 @@ void screenshot_giant()
         log_error("%s", e.what());
         context_show_error(STR_SCREENSHOT_FAILED, STR_NONE, {});
     }
-
-    ReleaseDPI(dpi);
 }
 
 // TODO: Move this at some point into a more appropriate place.
@@ -617,7 +676,6 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
     }
 
     int32_t exitCode = 1;
-    rct_drawpixelinfo dpi;
     try
     {
         core_init();
@@ -719,17 +777,13 @@ int32_t cmdline_for_screenshot(const char** argv, int32_t argc, ScreenshotOption
 
         ApplyOptions(options, viewport);
 
-        dpi = CreateDPI(viewport);
-
-        RenderViewport(nullptr, viewport, dpi);
-        WriteDpiToFile(outputPath, &dpi, gPalette);
+        RenderViewportToFile(outputPath, viewport);
     }
     catch (const std::exception& e)
     {
         std::printf("%s\n", e.what());
         exitCode = -1;
     }
-    ReleaseDPI(dpi);
 
     drawing_engine_dispose();
 
@@ -816,10 +870,7 @@ void CaptureImage(const CaptureOptions& options)
     }
 
     auto outputPath = ResolveFilenameForCapture(options.Filename);
-    auto dpi = CreateDPI(viewport);
-    RenderViewport(nullptr, viewport, dpi);
-    WriteDpiToFile(outputPath, &dpi, gPalette);
-    ReleaseDPI(dpi);
+    RenderViewportToFile(outputPath, viewport);
 
     gCurrentRotation = backupRotation;
 }
@@ -15,7 +15,7 @@
 #include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
-#include "../core/JobPool.h"
+#include "../core/TaskScheduler.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
 #include "../paint/Paint.h"
@@ -36,8 +36,11 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 #include <list>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -47,10 +50,22 @@ uint8_t gShowLandRightsRefCount;
 uint8_t gShowConstuctionRightsRefCount;
 
 static std::list<rct_viewport> _viewports;
-rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
-static std::vector<paint_session*> _paintColumns;
+struct ViewportPickBuffer
+{
+    ScreenCoordsXY Pos;
+    ScreenCoordsXY ViewPos;
+    int32_t Width{};
+    int32_t Height{};
+    ZoomLevel Zoom;
+    uint32_t Flags{};
+    uint8_t Rotation{};
+    // Set when a band could not be drawn into the buffer, the records are reset by the next sync.
+    bool Stale{};
+    std::vector<uint64_t> Records;
+};
+static std::unordered_map<const rct_viewport*, ViewportPickBuffer> _pickBuffers;
+rct_viewport* g_music_tracking_viewport;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -67,6 +82,10 @@ InteractionInfo::InteractionInfo(const paint_struct* ps)
 {
 }
 static void viewport_paint_weather_gloom(rct_drawpixelinfo* dpi);
+static void viewport_pick_buffer_sync(const rct_viewport* viewport);
+static uint64_t* viewport_pick_buffer_get_bits(
+    const rct_viewport* viewport, const ScreenCoordsXY& screenPos, int32_t width, int32_t height, int32_t& pitch);
+static void viewport_pick_buffer_clear(paint_session* session);
 
 /**
  * This is not a viewport function. It is used to setup many variables for
@@ -216,6 +235,7 @@ void viewport_remove(rct_viewport* viewport)
         return;
     }
     _viewports.erase(it);
+    _pickBuffers.erase(viewport);
 }
 
 void viewports_invalidate(const ScreenRect& screenRect, int32_t maxZoom)
@@ -450,6 +470,7 @@ static void viewport_move(const ScreenCoordsXY& coords, rct_window* w, rct_viewp
     auto y_diff = (viewport->viewPos.y / viewport->zoom) - (coords.y / viewport->zoom);
 
     viewport->viewPos = coords;
+    viewport_pick_buffer_sync(viewport);
 
     // If no change in viewing area
     if ((!x_diff) && (!y_diff))
@@ -855,9 +876,9 @@ static void record_session(
         for (size_t i = 0; i < chain->Count; i++)
         {
             auto& src = chain->PaintStructs[i];
+            entryRemap[&src.basic] = reinterpret_cast<paint_struct*>(paintIndex * sizeof(paint_entry));
             auto& dst = recordedSession.Entries[paintIndex++];
             dst = src;
-            entryRemap[&src.basic] = reinterpret_cast<paint_struct*>(i * sizeof(paint_entry));
         }
         chain = chain->Next;
     }
@@ -906,6 +927,11 @@ static void viewport_fill_column(
 
 static void viewport_paint_column(paint_session* session)
 {
+    if (session->PickBits != nullptr)
+    {
+        viewport_pick_buffer_clear(session);
+    }
+
     if (session->ViewFlags
             & (VIEWPORT_FLAG_HIDE_VERTICAL | VIEWPORT_FLAG_HIDE_BASE | VIEWPORT_FLAG_UNDERGROUND_INSIDE
                | VIEWPORT_FLAG_CLIP_VIEW)
@@ -966,6 +992,12 @@ void viewport_paint(
     y = y / viewport->zoom;
     y += viewport->pos.y;
 
+    // Where the pixels land in the pick buffer of the viewport, recorded sessions are only used for benchmarks.
+    int32_t pickPitch = 0;
+    uint64_t* pickBits = recorded_sessions == nullptr
+        ? viewport_pick_buffer_get_bits(viewport, { x, y }, width / viewport->zoom, height / viewport->zoom, pickPitch)
+        : nullptr;
+
     rct_drawpixelinfo dpi1;
     dpi1.DrawingEngine = dpi->DrawingEngine;
     dpi1.bits = dpi->bits + (x - dpi->x) + ((y - dpi->y) * (dpi->width + dpi->pitch));
@@ -983,16 +1015,16 @@ void viewport_paint(
     auto rightBorder = dpi1.x + dpi1.width;
     auto alignedX = floor2(dpi1.x, 32);
 
-    _paintColumns.clear();
+    // Local as the software engine paints the viewports of several screen bands at once.
+    std::vector<paint_session*> paintColumns;
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
+
+    // Only created when needed, creating a task group starts the worker threads.
+    std::optional<TaskGroup> paintTasks;
+    if (useMultithreading)
     {
-        _paintJobs.reset();
+        paintTasks.emplace();
     }
 
     bool useParallelDrawing = false;
@@ -1010,11 +1042,11 @@ void viewport_paint(
         recorded_sessions->resize(columnCount);
     }
 
-    // Generate and sort columns.
-    for (x = alignedX; x < rightBorder; x += 32, index++)
+    // Set up columns, the sessions come from the painter which is only safe to use under the window drawing lock.
+    for (x = alignedX; x < rightBorder; x += 32)
     {
         paint_session* session = PaintSessionAlloc(&dpi1, viewFlags);
-        _paintColumns.push_back(session);
+        paintColumns.push_back(session);
 
         rct_drawpixelinfo& dpi2 = session->DPI;
         if (x >= dpi2.x)
@@ -1035,41 +1067,59 @@ void viewport_paint(
         }
         dpi2.width = paintRight - dpi2.x;
 
-        if (useMultithreading)
+        if (pickBits != nullptr)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
-        }
-        else
-        {
-            viewport_fill_column(session, recorded_sessions, index);
+            session->PickBits = pickBits + (dpi2.x - dpi1.x) / dpi2.zoom_level;
+            session->PickPitch = pickPitch;
         }
     }
 
-    if (useMultithreading)
     {
-        _paintJobs->Join();
-    }
+        WindowDrawingUnlock unlock;
+        ScrollingTextPaintScope scrollingTextPaint;
 
-    // Paint columns.
-    for (auto* session : _paintColumns)
-    {
-        if (useParallelDrawing)
+        // Generate and sort columns.
+        for (auto* session : paintColumns)
         {
-            _paintJobs->AddTask([session]() -> void { viewport_paint_column(session); });
+            if (useMultithreading)
+            {
+                paintTasks->Run(
+                    [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
+            }
+            else
+            {
+                viewport_fill_column(session, recorded_sessions, index);
+            }
+            index++;
         }
-        else
+
+        if (useMultithreading)
         {
-            viewport_paint_column(session);
+            paintTasks->Wait();
+        }
+
+        scrolling_text_flush();
+
+        // Paint columns.
+        for (auto* session : paintColumns)
+        {
+            if (useParallelDrawing)
+            {
+                paintTasks->Run([session]() -> void { viewport_paint_column(session); });
+            }
+            else
+            {
+                viewport_paint_column(session);
+            }
+        }
+        if (useParallelDrawing)
+        {
+            paintTasks->Wait();
         }
-    }
-    if (useParallelDrawing)
-    {
-        _paintJobs->Join();
     }
 
     // Release resources.
-    for (auto* session : _paintColumns)
+    for (auto* session : paintColumns)
     {
         PaintSessionFree(session);
     }
@@ -1339,12 +1389,12 @@ void viewport_set_visibility(uint8_t mode)
 /**
  * Checks if a paint_struct sprite type is in the filter mask.
  */
-static bool PSSpriteTypeIsInFilter(paint_struct* ps, uint16_t filter)
+static bool SpriteTypeIsInFilter(ViewportInteractionItem spriteType, uint16_t filter)
 {
-    if (ps->sprite_type != ViewportInteractionItem::None && ps->sprite_type != ViewportInteractionItem::Label
-        && ps->sprite_type <= ViewportInteractionItem::Banner)
+    if (spriteType != ViewportInteractionItem::None && spriteType != ViewportInteractionItem::Label
+        && spriteType <= ViewportInteractionItem::Banner)
     {
-        auto mask = EnumToFlag(ps->sprite_type);
+        auto mask = EnumToFlag(spriteType);
         if (filter & mask)
         {
             return true;
@@ -1353,6 +1403,11 @@ static bool PSSpriteTypeIsInFilter(paint_struct* ps, uint16_t filter)
     return false;
 }
 
+static bool PSSpriteTypeIsInFilter(paint_struct* ps, uint16_t filter)
+{
+    return SpriteTypeIsInFilter(ps->sprite_type, filter);
+}
+
 /**
  * rct2: 0x00679236, 0x00679662, 0x00679B0D, 0x00679FF1
  */
@@ -1685,6 +1740,452 @@ InteractionInfo set_interaction_info_from_paint_session(paint_session* session,
     return info;
 }
 
+// Pick records identify what the hit test found, they hold no pointers so stale ones can never dangle:
+// bits 0-15 index of the tile element within its tile or the entity index, bits 16-31 and 32-47 map y and x,
+// bits 48-53 tile element type, bits 54-61 sprite type.
+static constexpr uint64_t PickRecordEmpty = 0;
+static constexpr uint64_t PickRecordUnknown = std::numeric_limits<uint64_t>::max();
+static constexpr uint64_t PickRecordResolvable = 1ULL << 62;
+static constexpr uint64_t PickRecordPresent = 1ULL << 63;
+
+static ScreenCoordsXY viewport_pick_view_pos(const rct_viewport* viewport)
+{
+    const int32_t bitmask = static_cast<int32_t>(0xFFFFFFFF & (0xFFFFFFFF * viewport->zoom));
+    return { viewport->viewPos.x & bitmask, viewport->viewPos.y & bitmask };
+}
+
+static void viewport_pick_buffer_shift(ViewportPickBuffer& buffer, int32_t dx, int32_t dy)
+{
+    const int32_t width = buffer.Width;
+    const int32_t height = buffer.Height;
+    auto* records = buffer.Records.data();
+    if (std::abs(dx) >= width || std::abs(dy) >= height)
+    {
+        std::fill(buffer.Records.begin(), buffer.Records.end(), PickRecordUnknown);
+        return;
+    }
+
+    // Moves the records the same way drawing_engine_copy_rect moves the pixels, the uncovered parts are unknown
+    // until they are drawn.
+    const int32_t copyWidth = width - std::abs(dx);
+    const auto moveRow = [&](int32_t dstY) {
+        auto* dst = records + static_cast<size_t>(dstY) * width;
+        const auto* src = records + static_cast<size_t>(dstY - dy) * width;
+        std::memmove(dst + std::max(0, dx), src + std::max(0, -dx), copyWidth * sizeof(uint64_t));
+        if (dx > 0)
+            std::fill(dst, dst + dx, PickRecordUnknown);
+        else
+            std::fill(dst + copyWidth, dst + width, PickRecordUnknown);
+    };
+    if (dy > 0)
+    {
+        for (int32_t y = height - 1; y >= dy; y--)
+            moveRow(y);
+        std::fill(records, records + static_cast<size_t>(dy) * width, PickRecordUnknown);
+    }
+    else
+    {
+        for (int32_t y = 0; y < height + dy; y++)
+            moveRow(y);
+        std::fill(records + static_cast<size_t>(height + dy) * width, records + buffer.Records.size(), PickRecordUnknown);
+    }
+}
+
+/**
+ * Brings the pick buffer in line with the viewport before it is drawn, never while bands are painted. Scrolling shifts
+ * the records along with the pixels, any other change of the view or a stale buffer starts over with unknown records.
+ */
+static void viewport_pick_buffer_sync(const rct_viewport* viewport)
+{
+    if (viewport->zoom < 0)
+    {
+        _pickBuffers.erase(viewport);
+        return;
+    }
+
+    auto& buffer = _pickBuffers[viewport];
+    const auto viewPos = viewport_pick_view_pos(viewport);
+    const auto rotation = get_current_rotation();
+    if (buffer.Pos != viewport->pos || buffer.Width != viewport->width || buffer.Height != viewport->height
+        || buffer.Zoom != viewport->zoom || buffer.Flags != viewport->flags || buffer.Rotation != rotation)
+    {
+        buffer.Pos = viewport->pos;
+        buffer.ViewPos = viewPos;
+        buffer.Width = std::max(0, viewport->width);
+        buffer.Height = std::max(0, viewport->height);
+        buffer.Zoom = viewport->zoom;
+        buffer.Flags = viewport->flags;
+        buffer.Rotation = rotation;
+        buffer.Stale = false;
+        buffer.Records.assign(static_cast<size_t>(buffer.Width) * buffer.Height, PickRecordUnknown);
+        return;
+    }
+
+    if (buffer.Stale)
+    {
+        buffer.Stale = false;
+        std::fill(buffer.Records.begin(), buffer.Records.end(), PickRecordUnknown);
+    }
+    if (buffer.ViewPos != viewPos)
+    {
+        viewport_pick_buffer_shift(
+            buffer, (buffer.ViewPos.x - viewPos.x) / viewport->zoom, (buffer.ViewPos.y - viewPos.y) / viewport->zoom);
+        buffer.ViewPos = viewPos;
+    }
+}
+
+static uint64_t* viewport_pick_buffer_get_bits(
+    const rct_viewport* viewport, const ScreenCoordsXY& screenPos, int32_t width, int32_t height, int32_t& pitch)
+{
+    auto it = _pickBuffers.find(viewport);
+    if (it == _pickBuffers.end())
+        return nullptr;
+
+    // Redrawing after a shift crops the viewport for a moment, moving its screen and view position together. That
+    // still maps onto the buffer, anything else means the view changed without a sync.
+    auto& buffer = it->second;
+    const auto viewPos = viewport_pick_view_pos(viewport);
+    const bool isSameView = buffer.Zoom == viewport->zoom && buffer.Flags == viewport->flags
+        && buffer.Rotation == get_current_rotation()
+        && viewPos.x - buffer.ViewPos.x == (viewport->pos.x - buffer.Pos.x) * viewport->zoom
+        && viewPos.y - buffer.ViewPos.y == (viewport->pos.y - buffer.Pos.y) * viewport->zoom;
+    const int32_t left = screenPos.x - buffer.Pos.x;
+    const int32_t top = screenPos.y - buffer.Pos.y;
+    if (!isSameView || left < 0 || top < 0 || left + width > buffer.Width || top + height > buffer.Height)
+    {
+        // Other bands may still be painting into the records, they are only reset once painting is done.
+        buffer.Stale = true;
+        return nullptr;
+    }
+
+    pitch = buffer.Width;
+    return buffer.Records.data() + static_cast<size_t>(top) * buffer.Width + left;
+}
+
+static void viewport_pick_buffer_clear(paint_session* session)
+{
+    const auto& dpi = session->DPI;
+    const int32_t width = dpi.width / dpi.zoom_level;
+    const int32_t height = dpi.height / dpi.zoom_level;
+    for (int32_t y = 0; y < height; y++)
+    {
+        auto* row = session->PickBits + static_cast<size_t>(y) * session->PickPitch;
+        std::fill(row, row + width, PickRecordEmpty);
+    }
+}
+
+static uint64_t viewport_pick_record(const paint_struct* ps)
+{
+    uint64_t record = PickRecordPresent | (static_cast<uint64_t>(EnumValue(ps->sprite_type)) << 54);
+    if (ps->tileElement == nullptr)
+        return record;
+
+    uint32_t index = 0;
+    uint32_t elementType = 0;
+    if (ps->sprite_type == ViewportInteractionItem::Entity)
+    {
+        index = reinterpret_cast<const EntityBase*>(ps->tileElement)->sprite_index;
+    }
+    else
+    {
+        // Tile elements are identified by their position on the tile, which survives the element storage moving.
+        const TileElement* element = map_get_first_element_at(CoordsXY{ ps->map_x, ps->map_y });
+        if (element == nullptr)
+            return record;
+
+        while (element != ps->tileElement)
+        {
+            if (element->IsLastForTile() || index == std::numeric_limits<uint16_t>::max())
+                return record;
+
+            element++;
+            index++;
+        }
+        elementType = element->GetType();
+    }
+
+    return record | PickRecordResolvable | (static_cast<uint64_t>(elementType) << 48)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(ps->map_x)) << 32)
+        | (static_cast<uint64_t>(static_cast<uint16_t>(ps->map_y)) << 16) | index;
+}
+
+static std::optional<InteractionInfo> viewport_pick_resolve(uint64_t record)
+{
+    if (!(record & PickRecordResolvable))
+        return std::nullopt;
+
+    InteractionInfo info;
+    info.Loc = { static_cast<int16_t>(record >> 32), static_cast<int16_t>(record >> 16) };
+    info.SpriteType = static_cast<ViewportInteractionItem>((record >> 54) & 0xFF);
+    const auto index = static_cast<uint16_t>(record);
+    if (info.SpriteType == ViewportInteractionItem::Entity)
+    {
+        auto* entity = TryGetEntity(index);
+        if (entity == nullptr || entity->Type == EntityType::Null)
+            return std::nullopt;
+
+        info.Entity = entity;
+        return info;
+    }
+
+    // The tile may have changed since it was drawn, never hand out anything but an element of the same type.
+    TileElement* element = map_get_first_element_at(info.Loc);
+    if (element == nullptr)
+        return std::nullopt;
+
+    for (uint16_t i = 0; i < index; i++)
+    {
+        if (element->IsLastForTile())
+            return std::nullopt;
+        element++;
+    }
+    if (element->GetType() != ((record >> 48) & 0x3F))
+        return std::nullopt;
+
+    info.Element = element;
+    return info;
+}
+
+std::optional<InteractionInfo> viewport_pick_buffer_lookup(
+    const rct_viewport* viewport, const ScreenCoordsXY& screenCoords, uint16_t filter)
+{
+    auto it = _pickBuffers.find(viewport);
+    if (it == _pickBuffers.end())
+        return std::nullopt;
+
+    const auto& buffer = it->second;
+    if (buffer.Stale || buffer.Pos != viewport->pos || buffer.Width != viewport->width || buffer.Height != viewport->height
+        || buffer.ViewPos != viewport_pick_view_pos(viewport) || buffer.Zoom != viewport->zoom
+        || buffer.Flags != viewport->flags || buffer.Rotation != get_current_rotation())
+    {
+        return std::nullopt;
+    }
+
+    const auto pixel = screenCoords - buffer.Pos;
+    if (pixel.x < 0 || pixel.y < 0 || pixel.x >= buffer.Width || pixel.y >= buffer.Height)
+        return std::nullopt;
+
+    const auto record = buffer.Records[static_cast<size_t>(pixel.y) * buffer.Width + pixel.x];
+    if (record == PickRecordUnknown)
+        return std::nullopt;
+    if (record == PickRecordEmpty)
+        return InteractionInfo{};
+
+    // Only the topmost sprite is known, the hit test would look further down for one that is not in the filter.
+    if (!SpriteTypeIsInFilter(static_cast<ViewportInteractionItem>((record >> 54) & 0xFF), filter))
+        return std::nullopt;
+
+    return viewport_pick_resolve(record);
+}
+
+static int32_t viewport_pick_ceil_div(int32_t value, int32_t divisor)
+{
+    return value > 0 ? (value + divisor - 1) / divisor : -(-value / divisor);
+}
+
+struct ViewportPickTarget
+{
+    uint64_t* Bits;
+    int32_t Pitch;
+    int32_t Width;
+    int32_t Height;
+    const paint_struct* PS;
+    uint64_t Record;
+
+    void Mark(uint64_t* row, int32_t begin, int32_t end)
+    {
+        if (begin >= end)
+            return;
+        if (Record == PickRecordEmpty)
+            Record = viewport_pick_record(PS);
+        std::fill(row + begin, row + end, Record);
+    }
+};
+
+/**
+ * Marks the columns of a row the hit test would find a pixel of the RLE sprite row at, the runs are trimmed the same
+ * way is_pixel_present_rle trims them. xsFirst is the sprite x of the first column.
+ */
+static void viewport_pick_buffer_add_rle_row(
+    ViewportPickTarget& target, uint64_t* row, const uint8_t* data, int32_t ys, int32_t xsFirst, int32_t round,
+    int32_t colBegin, int32_t colEnd)
+{
+    const uint32_t startOffset = data[ys * 2] | (data[ys * 2 + 1] << 8);
+    const uint8_t* run = data + startOffset;
+
+    bool isLastRun = false;
+    while (!isLastRun)
+    {
+        int32_t numPixels = *run++;
+        uint8_t gapSize = *run++;
+
+        isLastRun = numPixels & 0x80;
+        numPixels &= 0x7F;
+        run += numPixels;
+
+        if (round > 1)
+        {
+            if (gapSize % 2)
+            {
+                gapSize++;
+                numPixels--;
+                if (numPixels == 0)
+                    continue;
+            }
+        }
+
+        if (round == 4)
+        {
+            if (gapSize % 4)
+            {
+                gapSize += 2;
+                numPixels -= 2;
+                if (numPixels <= 0)
+                    continue;
+            }
+        }
+
+        int32_t first = gapSize;
+        int32_t last = gapSize + numPixels;
+        if (numPixels <= 0)
+        {
+            // An empty run reports the pixel in front of it on zoom 0.
+            if (round != 1 || numPixels != 0)
+                continue;
+
+            first = gapSize - 1;
+            last = gapSize;
+        }
+
+        target.Mark(
+            row, std::max(colBegin, viewport_pick_ceil_div(first - xsFirst, round)),
+            std::min(colEnd, viewport_pick_ceil_div(last - xsFirst, round)));
+    }
+}
+
+/**
+ * Marks every pixel of the target is_sprite_interacted_with_palette_set would report the sprite at. Pixel (i, j)
+ * of the target is at viewOrigin + (i, j) * zoom in view coordinates.
+ */
+static void viewport_pick_buffer_add_sprite_palette_set(
+    ViewportPickTarget& target, const ScreenCoordsXY& viewOrigin, ZoomLevel zoom, uint32_t imageId,
+    const ScreenCoordsXY& coords, const PaletteMap& paletteMap, uint32_t imageType)
+{
+    const rct_g1_element* g1 = gfx_get_g1_element(imageId & 0x7FFFF);
+    if (g1 == nullptr)
+        return;
+
+    if (zoom > 0)
+    {
+        if (g1->flags & G1_FLAG_NO_ZOOM_DRAW)
+            return;
+
+        if (g1->flags & G1_FLAG_HAS_ZOOM_SPRITE)
+        {
+            viewport_pick_buffer_add_sprite_palette_set(
+                target, { viewOrigin.x >> 1, viewOrigin.y >> 1 }, zoom - 1, imageId - g1->zoomed_offset,
+                { coords.x / 2, coords.y / 2 }, paletteMap, imageType);
+            return;
+        }
+    }
+
+    const int32_t round = std::max(1, 1 * zoom);
+
+    int32_t originY = coords.y;
+    if (g1->flags & G1_FLAG_RLE_COMPRESSION)
+    {
+        originY -= (round - 1);
+    }
+    originY += g1->y_offset;
+
+    int32_t yStartPoint = 0;
+    int32_t height = g1->height;
+    if (zoom != 0)
+    {
+        if (height % 2)
+        {
+            height--;
+            yStartPoint++;
+        }
+
+        if (zoom == 2)
+        {
+            if (height % 4)
+            {
+                height -= 2;
+                yStartPoint += 2;
+            }
+        }
+
+        if (height == 0)
+            return;
+    }
+    originY = floor2(originY, round);
+    const int32_t originX = floor2(coords.x + g1->x_offset, round);
+
+    const int32_t rowBegin = std::max(0, viewport_pick_ceil_div(originY - viewOrigin.y, round));
+    const int32_t rowEnd = std::min(target.Height, viewport_pick_ceil_div(originY + height - viewOrigin.y, round));
+    const int32_t colBegin = std::max(0, viewport_pick_ceil_div(originX - viewOrigin.x, round));
+    const int32_t colEnd = std::min(target.Width, viewport_pick_ceil_div(originX + g1->width - viewOrigin.x, round));
+    if (rowBegin >= rowEnd || colBegin >= colEnd)
+        return;
+
+    const int32_t xsFirst = viewOrigin.x - originX;
+    for (int32_t j = rowBegin; j < rowEnd; j++)
+    {
+        const int32_t ys = yStartPoint + viewOrigin.y + j * round - originY;
+        auto* row = target.Bits + static_cast<size_t>(j) * target.Pitch;
+        if (g1->flags & G1_FLAG_RLE_COMPRESSION)
+        {
+            viewport_pick_buffer_add_rle_row(target, row, g1->offset, ys, xsFirst, round, colBegin, colEnd);
+        }
+        else if (!(g1->flags & G1_FLAG_1) && (g1->flags & G1_FLAG_BMP))
+        {
+            const uint8_t* src = g1->offset + ys * g1->width + xsFirst;
+            for (int32_t i = colBegin; i < colEnd; i++)
+            {
+                const uint8_t index = src[i * round];
+                if ((imageType & IMAGE_TYPE_REMAP) ? paletteMap[index] != 0 : index != 0)
+                {
+                    target.Mark(row, i, i + 1);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Writes the sprite of ps into the pick buffer of the session, the counterpart of is_sprite_interacted_with.
+ */
+void viewport_pick_buffer_add_sprite(
+    paint_session* session, uint32_t imageId, const ScreenCoordsXY& coords, const paint_struct* ps)
+{
+    auto paletteMap = PaletteMap::GetDefault();
+    uint32_t imageType = 0;
+    imageId &= ~IMAGE_TYPE_TRANSPARENT;
+    if (imageId & IMAGE_TYPE_REMAP)
+    {
+        imageType = IMAGE_TYPE_REMAP;
+        int32_t index = (imageId >> 19) & 0x7F;
+        if (imageId & IMAGE_TYPE_REMAP_2_PLUS)
+        {
+            index &= 0x1F;
+        }
+        if (auto pm = GetPaletteMapForColour(index); pm.has_value())
+        {
+            paletteMap = pm.value();
+        }
+    }
+
+    const auto& dpi = session->DPI;
+    ViewportPickTarget target = {
+        session->PickBits, session->PickPitch, dpi.width / dpi.zoom_level, dpi.height / dpi.zoom_level, ps,
+        PickRecordEmpty,
+    };
+    viewport_pick_buffer_add_sprite_palette_set(
+        target, { dpi.x, dpi.y }, dpi.zoom_level, imageId, coords, paletteMap, imageType);
+}
+
 /**
  *
  *  rct2: 0x00685ADC
@@ -1725,6 +2226,11 @@ InteractionInfo get_map_coordinates_from_pos_window(rct_window* window, const Sc
             viewLoc.x &= (0xFFFFFFFF * myviewport->zoom) & 0xFFFFFFFF;
             viewLoc.y &= (0xFFFFFFFF * myviewport->zoom) & 0xFFFFFFFF;
         }
+        if (auto picked = viewport_pick_buffer_lookup(myviewport, screenCoords, flags & 0xFFFF); picked.has_value())
+        {
+            return *picked;
+        }
+
         rct_drawpixelinfo dpi;
         dpi.x = viewLoc.x;
         dpi.y = viewLoc.y;
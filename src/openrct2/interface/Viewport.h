@@ -137,6 +137,17 @@ InteractionInfo get_map_coordinates_from_pos(const ScreenCoordsXY& screenCoords,
 InteractionInfo get_map_coordinates_from_pos_window(rct_window* window, const ScreenCoordsXY& screenCoords, int32_t flags);
 
 InteractionInfo set_interaction_info_from_paint_session(paint_session* session, uint16_t filter);
+
+/**
+ * Window viewports keep a pick buffer holding, for every pixel, the interaction the hit test would find for the
+ * topmost sprite there. It is written while the viewport is drawn, so hovering and clicking can look up the last
+ * frame instead of generating a paint session of their own. Returns nothing when the buffer can not answer, for
+ * example when the topmost sprite is not in the filter or the pixel has not been drawn since the view changed.
+ */
+std::optional<InteractionInfo> viewport_pick_buffer_lookup(
+    const rct_viewport* viewport, const ScreenCoordsXY& screenCoords, uint16_t filter);
+void viewport_pick_buffer_add_sprite(
+    paint_session* session, uint32_t imageId, const ScreenCoordsXY& coords, const paint_struct* ps);
 InteractionInfo ViewportInteractionGetItemLeft(const ScreenCoordsXY& screenCoords);
 bool ViewportInteractionLeftOver(const ScreenCoordsXY& screenCoords);
 bool ViewportInteractionLeftClick(const ScreenCoordsXY& screenCoords);
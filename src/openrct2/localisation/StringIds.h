@@ -3915,6 +3915,9 @@ enum : uint16_t
 
     STR_UNSUPPORTED_OBJECT_FORMAT = 6459,
 
+    STR_DEBUG_PAINT_SHOW_SESSION_STATS = 6460,
+    STR_DEBUG_PAINT_VERIFY_TILE_CACHE = 6461,
+
     // Have to include resource strings (from scenarios and objects) for the time being now that language is partially working
     /* MAX_STR_COUNT = 32768 */ // MAX_STR_COUNT - upper limit for number of strings, not the current count strings
 };
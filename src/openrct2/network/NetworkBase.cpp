@@ -38,7 +38,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "0"
+#define NETWORK_STREAM_VERSION "2"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -54,6 +54,12 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 // This limit is per connection, the current value was determined by tests with fuzzing.
 static constexpr uint32_t MaxPacketsPerUpdate = 100;
 
+// A resync delta larger than this is replaced by the map, which is compressed and likely smaller by then.
+static constexpr uint32_t MaxResyncDeltaSize = 256 * 1024;
+
+// Desyncing again within this many ticks of a resync means the delta missed what diverged, the map is sent instead.
+static constexpr uint32_t ResyncRetryTicks = 200;
+
 #    include "../Cheats.h"
 #    include "../ParkImporter.h"
 #    include "../Version.h"
@@ -132,6 +138,7 @@ NetworkBase::NetworkBase(OpenRCT2::IContext& context)
     client_command_handlers[NetworkCommand::ObjectsList] = &NetworkBase::Client_Handle_OBJECTS_LIST;
     client_command_handlers[NetworkCommand::Scripts] = &NetworkBase::Client_Handle_SCRIPTS;
     client_command_handlers[NetworkCommand::GameState] = &NetworkBase::Client_Handle_GAMESTATE;
+    client_command_handlers[NetworkCommand::Resync] = &NetworkBase::Client_Handle_RESYNC;
 
     server_command_handlers[NetworkCommand::Auth] = &NetworkBase::Server_Handle_AUTH;
     server_command_handlers[NetworkCommand::Chat] = &NetworkBase::Server_Handle_CHAT;
@@ -142,6 +149,7 @@ NetworkBase::NetworkBase(OpenRCT2::IContext& context)
     server_command_handlers[NetworkCommand::MapRequest] = &NetworkBase::Server_Handle_MAPREQUEST;
     server_command_handlers[NetworkCommand::RequestGameState] = &NetworkBase::Server_Handle_REQUEST_GAMESTATE;
     server_command_handlers[NetworkCommand::Heartbeat] = &NetworkBase::Server_Handle_HEARTBEAT;
+    server_command_handlers[NetworkCommand::RequestResync] = &NetworkBase::Server_Handle_REQUEST_RESYNC;
 
     _chat_log_fs << std::unitbuf;
     _server_log_fs << std::unitbuf;
@@ -229,6 +237,7 @@ void NetworkBase::CloseConnection()
     }
     else if (mode == NETWORK_MODE_SERVER)
     {
+        _ioThread.reset();
         _listenSocket.reset();
         _advertiser.reset();
     }
@@ -259,6 +268,7 @@ bool NetworkBase::BeginClient(const std::string& host, uint16_t port)
     _serverConnection->Socket = CreateTcpSocket();
     _serverConnection->Socket->ConnectAsync(host, port);
     _serverState.gamestateSnapshotsEnabled = false;
+    _serverState.resyncEnabled = false;
 
     status = NETWORK_STATUS_CONNECTING;
     _lastConnectStatus = SocketStatus::Closed;
@@ -365,6 +375,12 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
         return false;
     }
 
+    if (gConfigNetwork.server_io_thread)
+    {
+        // Not available on every platform, clients are then served on each tick instead.
+        _ioThread = NetworkIoThread::Create(*_listenSocket);
+    }
+
     ServerName = gConfigNetwork.server_name;
     ServerDescription = gConfigNetwork.server_description;
     ServerGreeting = gConfigNetwork.server_greeting;
@@ -399,6 +415,7 @@ bool NetworkBase::BeginServer(uint16_t port, const std::string& address)
     status = NETWORK_STATUS_CONNECTED;
     listening_port = port;
     _serverState.gamestateSnapshotsEnabled = gConfigNetwork.desync_debugging;
+    _serverState.resyncEnabled = gConfigNetwork.resync_on_desync;
     _advertiser = CreateServerAdvertiser(listening_port);
 
     game_load_scripts();
@@ -495,11 +512,19 @@ void NetworkBase::Flush()
         {
             it->SendQueuedPackets();
         }
+        if (_ioThread != nullptr)
+        {
+            _ioThread->Wake();
+        }
     }
 }
 
 void NetworkBase::UpdateServer()
 {
+    // The map may change from here on.
+    _mapChunksObjects.clear();
+    _mapChunks.clear();
+
     for (auto& connection : client_connection_list)
     {
         // This can be called multiple times before the connection is removed.
@@ -528,10 +553,20 @@ void NetworkBase::UpdateServer()
         _advertiser->Update();
     }
 
-    std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
-    if (tcpSocket != nullptr)
+    if (_ioThread != nullptr)
     {
-        AddClient(std::move(tcpSocket));
+        while (auto tcpSocket = _ioThread->Accept())
+        {
+            AddClient(std::move(tcpSocket));
+        }
+    }
+    else
+    {
+        std::unique_ptr<ITcpSocket> tcpSocket = _listenSocket->Accept();
+        if (tcpSocket != nullptr)
+        {
+            AddClient(std::move(tcpSocket));
+        }
     }
 }
 
@@ -712,6 +747,12 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 }
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
+{
+    // Serialised once, every connection queues the same buffer.
+    SendPacketToClients(packet.ToBuffer(), front, gameCmd);
+}
+
+void NetworkBase::SendPacketToClients(const NetworkPacketBufferPtr& buffer, bool front, bool gameCmd)
 {
     for (auto& client_connection : client_connection_list)
     {
@@ -726,8 +767,7 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(buffer, front);
     }
 }
 
@@ -766,18 +806,25 @@ bool NetworkBase::CheckSRAND(uint32_t tick, uint32_t srand0)
 
 bool NetworkBase::IsDesynchronised()
 {
-    return _serverState.state == NetworkServerState::Desynced;
+    return _serverState.state != NetworkServerState::Ok;
 }
 
 bool NetworkBase::CheckDesynchronizaton()
 {
     // Check synchronisation
-    if (GetMode() == NETWORK_MODE_CLIENT && _serverState.state != NetworkServerState::Desynced
+    if (GetMode() == NETWORK_MODE_CLIENT && _serverState.state == NetworkServerState::Ok
         && !CheckSRAND(gCurrentTicks, scenario_rand_state().s0))
     {
         _serverState.state = NetworkServerState::Desynced;
         _serverState.desyncTick = gCurrentTicks;
 
+        if (_serverState.resyncEnabled)
+        {
+            // The server will get us back in sync, no need to bother the player.
+            log_info("Desynchronised at tick %u", _serverState.desyncTick);
+            return true;
+        }
+
         char str_desync[256];
         format_string(str_desync, 256, STR_MULTIPLAYER_DESYNC, nullptr);
 
@@ -803,6 +850,33 @@ void NetworkBase::RequestStateSnapshot()
     Client_Send_RequestGameState(_serverState.desyncTick);
 }
 
+bool NetworkBase::RequestResync()
+{
+    if (!_serverState.resyncEnabled || GetMode() != NETWORK_MODE_CLIENT || GetStatus() != NETWORK_STATUS_CONNECTED)
+    {
+        return false;
+    }
+
+    const uint32_t tick = _serverState.desyncTick;
+
+    IGameStateSnapshots* snapshots = GetContext().GetGameStateSnapshots();
+    const GameStateSnapshot_t* snapshot = snapshots->GetLinkedSnapshot(tick);
+    const bool resyncedRecently = _serverState.resyncTick != 0 && tick - _serverState.resyncTick < ResyncRetryTicks;
+
+    // Without entity hashes the server sends the map.
+    std::vector<uint32_t> hashes;
+    if (snapshot != nullptr && !resyncedRecently)
+    {
+        hashes = snapshots->GetEntityBlockHashes(*snapshot);
+    }
+
+    log_info("Requesting resync for tick %u", tick);
+    Client_Send_RequestResync(tick, hashes);
+
+    _serverState.state = NetworkServerState::Resyncing;
+    return true;
+}
+
 NetworkServerState_t NetworkBase::GetServerState() const
 {
     return _serverState;
@@ -1196,6 +1270,17 @@ void NetworkBase::Client_Send_RequestGameState(uint32_t tick)
     _serverConnection->QueuePacket(std::move(packet));
 }
 
+void NetworkBase::Client_Send_RequestResync(uint32_t tick, const std::vector<uint32_t>& hashes)
+{
+    NetworkPacket packet(NetworkCommand::RequestResync);
+    packet << tick << static_cast<uint32_t>(hashes.size());
+    for (auto hash : hashes)
+    {
+        packet << hash;
+    }
+    _serverConnection->QueuePacket(std::move(packet));
+}
+
 void NetworkBase::Client_Send_TOKEN()
 {
     log_verbose("requesting token");
@@ -1371,37 +1456,51 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         objects = objManager.GetPackableObjects();
     }
 
-    auto header = save_for_network(objects);
-    if (header.empty())
-    {
+    auto sendChunk = [this, connection](const NetworkPacketBufferPtr& chunk) {
         if (connection != nullptr)
         {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Disconnect();
+            connection->QueuePacket(chunk);
+        }
+        else
+        {
+            SendPacketToClients(chunk);
+        }
+    };
+
+    // Clients joining at the same time get the same map, unless they are missing different objects.
+    if (!_mapChunks.empty() && objects == _mapChunksObjects)
+    {
+        for (const auto& chunk : _mapChunks)
+        {
+            sendChunk(chunk);
         }
         return;
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < header.size(); i += chunksize)
+
+    std::vector<NetworkPacketBufferPtr> chunks;
+    bool saved = save_for_network(objects, [this, &chunks, &sendChunk](const NetworkPacketBufferPtr& chunk) {
+        chunks.push_back(chunk);
+        sendChunk(chunk);
+        // Start sending while the rest of the map is still being compressed.
+        Flush();
+    });
+    if (!saved)
     {
-        size_t datasize = std::min(chunksize, header.size() - i);
-        NetworkPacket packet(NetworkCommand::Map);
-        packet << static_cast<uint32_t>(header.size()) << static_cast<uint32_t>(i);
-        packet.Write(&header[i], datasize);
         if (connection != nullptr)
         {
-            connection->QueuePacket(std::move(packet));
-        }
-        else
-        {
-            SendPacketToClients(packet);
+            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+            connection->Disconnect();
         }
+        return;
     }
+    _mapChunksObjects = objects;
+    _mapChunks = std::move(chunks);
 }
 
-std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
+bool NetworkBase::save_for_network(
+    const std::vector<const ObjectRepositoryItem*>& objects,
+    const std::function<void(const NetworkPacketBufferPtr&)>& sendChunk) const
 {
-    std::vector<uint8_t> header;
     bool RLEState = gUseRLE;
     gUseRLE = false;
 
@@ -1409,29 +1508,58 @@ std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const Objec
     if (!SaveMap(&ms, objects))
     {
         log_warning("Failed to export map.");
-        return header;
+        return false;
     }
     gUseRLE = RLEState;
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
+    const uint8_t* data = static_cast<const uint8_t*>(ms.GetData());
+    size_t size = ms.GetLength();
+
+    std::string_view headerString = "open2_sv6_zlib";
+    std::vector<uint8_t> pending(headerString.begin(), headerString.end());
+    pending.push_back(0);
+    const size_t sizeBound = pending.size() + util_zlib_deflate_parallel_bound(size);
+
+    size_t offset = 0;
+    auto sendPending = [&](size_t chunkSize, size_t totalSize) {
+        NetworkPacket packet(NetworkCommand::Map);
+        packet << static_cast<uint32_t>(totalSize) << static_cast<uint32_t>(offset);
+        packet.Write(pending.data(), chunkSize);
+        sendChunk(std::move(packet).ToBuffer());
+        pending.erase(pending.begin(), pending.begin() + chunkSize);
+        offset += chunkSize;
+    };
 
-    auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
-    if (compressed.has_value())
+    bool compressed = util_zlib_deflate_parallel(data, size, [&](const uint8_t* output, size_t outputSize) {
+        pending.insert(pending.end(), output, output + outputSize);
+        // The final size is not known yet, send an upper bound instead. The client takes the map as complete once a
+        // chunk ends at the size it carries, which only the last chunk, held back until the end, may do.
+        while (pending.size() > CHUNK_SIZE)
+        {
+            sendPending(CHUNK_SIZE, std::max(sizeBound, offset + pending.size()));
+        }
+    });
+    if (!compressed)
     {
-        std::string headerString = "open2_sv6_zlib";
-        header.resize(headerString.size() + 1 + compressed->size());
-        std::memcpy(&header[0], headerString.c_str(), headerString.size() + 1);
-        std::memcpy(&header[headerString.size() + 1], compressed->data(), compressed->size());
-        log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, headerString.size() + 1 + compressed->size());
+        if (offset != 0)
+        {
+            log_warning("Failed to compress the data.");
+            return false;
+        }
+        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
+        pending.assign(data, data + size);
     }
     else
     {
-        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
-        header.resize(size);
-        std::memcpy(header.data(), data, size);
+        log_verbose("Sending map of size %zu bytes, compressed to %zu bytes", size, offset + pending.size());
+    }
+
+    const size_t totalSize = offset + pending.size();
+    while (!pending.empty())
+    {
+        sendPending(std::min<size_t>(CHUNK_SIZE, pending.size()), totalSize);
     }
-    return header;
+    return true;
 }
 
 void NetworkBase::Client_Send_CHAT(const char* text)
@@ -1453,12 +1581,13 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
     }
     else
     {
+        auto buffer = std::move(packet).ToBuffer();
         for (auto playerId : playerIds)
         {
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr)
             {
-                conn->QueuePacket(packet);
+                conn->QueuePacket(buffer);
             }
         }
     }
@@ -1611,6 +1740,7 @@ void NetworkBase::Server_Send_GAMEINFO(NetworkConnection& connection)
 
     packet.WriteString(jsonObj.dump().c_str());
     packet << _serverState.gamestateSnapshotsEnabled;
+    packet << _serverState.resyncEnabled;
 
 #    endif
     connection.QueuePacket(std::move(packet));
@@ -1932,6 +2062,11 @@ void NetworkBase::ProcessDisconnectedClients()
         }
 
         // Make sure to send all remaining packets out before disconnecting.
+        if (connection->IoChannel != nullptr)
+        {
+            _ioThread->Detach(connection->IoChannel);
+            connection->IoChannel = nullptr;
+        }
         connection->SendQueuedPackets();
         connection->Socket->Disconnect();
 
@@ -1952,6 +2087,10 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    if (_ioThread != nullptr)
+    {
+        connection->IoChannel = _ioThread->Attach(*connection->Socket);
+    }
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2211,6 +2350,78 @@ void NetworkBase::Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection,
     }
 }
 
+void NetworkBase::Server_Handle_REQUEST_RESYNC(NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t tick;
+    uint32_t numHashes;
+    packet >> tick >> numHashes;
+
+    if (_serverState.resyncEnabled == false)
+    {
+        return;
+    }
+
+    const char* playerName = connection.Player != nullptr ? connection.Player->Name.c_str() : "(unknown)";
+
+    IGameStateSnapshots* snapshots = GetContext().GetGameStateSnapshots();
+    const GameStateSnapshot_t* snapshot = snapshots->GetLinkedSnapshot(tick);
+
+    // Only the last 32 ticks are kept, a client whose request arrives more than about 0.8 seconds late gets the map.
+    std::vector<uint32_t> hashes;
+    if (snapshot != nullptr && numHashes != 0)
+    {
+        hashes = snapshots->GetEntityBlockHashes(*snapshot);
+    }
+    if (hashes.empty() || hashes.size() != numHashes)
+    {
+        log_info("Resynchronising %s at tick %u with the map", playerName, tick);
+        Server_Send_MAP(&connection);
+        return;
+    }
+
+    // Only the blocks of entities that diverged go into the delta.
+    std::vector<uint32_t> blocks;
+    for (uint32_t i = 0; i < numHashes; i++)
+    {
+        uint32_t clientHash;
+        packet >> clientHash;
+        if (clientHash != hashes[i])
+        {
+            blocks.push_back(i);
+        }
+    }
+
+    MemoryStream deltaMemory;
+    DataSerialiser ds(true, deltaMemory);
+    snapshots->SerialiseDelta(*snapshot, blocks, ds);
+
+    const uint32_t length = static_cast<uint32_t>(deltaMemory.GetLength());
+    if (length > MaxResyncDeltaSize)
+    {
+        log_info("Resynchronising %s at tick %u with the map, delta is %u bytes", playerName, tick, length);
+        Server_Send_MAP(&connection);
+        return;
+    }
+
+    log_info(
+        "Resynchronising %s at tick %u with %u entity blocks, %u bytes", playerName, tick,
+        static_cast<uint32_t>(blocks.size()), length);
+
+    uint32_t bytesSent = 0;
+    while (bytesSent < length)
+    {
+        const uint32_t dataSize = std::min(CHUNK_SIZE, length - bytesSent);
+
+        NetworkPacket packetResyncChunk(NetworkCommand::Resync);
+        packetResyncChunk << tick << length << bytesSent << dataSize;
+        packetResyncChunk.Write(static_cast<const uint8_t*>(deltaMemory.GetData()) + bytesSent, dataSize);
+
+        connection.QueuePacket(std::move(packetResyncChunk));
+
+        bytesSent += dataSize;
+    }
+}
+
 void NetworkBase::Server_Handle_HEARTBEAT(NetworkConnection& connection, NetworkPacket& packet)
 {
     log_verbose("Client %s heartbeat", connection.Socket->GetHostName());
@@ -2461,6 +2672,71 @@ void NetworkBase::Client_Handle_GAMESTATE(NetworkConnection& connection, Network
     }
 }
 
+void NetworkBase::Client_Handle_RESYNC(NetworkConnection& connection, NetworkPacket& packet)
+{
+    uint32_t tick;
+    uint32_t totalSize;
+    uint32_t offset;
+    uint32_t dataSize;
+
+    packet >> tick >> totalSize >> offset >> dataSize;
+
+    if (_serverState.state != NetworkServerState::Resyncing || tick != _serverState.desyncTick)
+    {
+        return;
+    }
+
+    const uint8_t* data = packet.Read(dataSize);
+    if (data == nullptr)
+    {
+        return;
+    }
+
+    if (offset == 0)
+    {
+        // Reset
+        _serverResync = MemoryStream();
+    }
+
+    _serverResync.SetPosition(offset);
+    _serverResync.Write(data, dataSize);
+
+    if (_serverResync.GetLength() != totalSize)
+    {
+        return;
+    }
+
+    IGameStateSnapshots* snapshots = GetContext().GetGameStateSnapshots();
+
+    bool applied = false;
+    try
+    {
+        _serverResync.SetPosition(0);
+        DataSerialiser ds(false, _serverResync);
+        applied = snapshots->ApplyDelta(ds);
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to read resync data: %s", e.what());
+    }
+    _serverResync = MemoryStream();
+
+    if (!applied)
+    {
+        // The game state may be partially patched by now, only the map can fix it.
+        log_warning("Unable to apply resync for tick %u, requesting the map", tick);
+        Client_Send_RequestResync(tick, {});
+        return;
+    }
+
+    EntityTweener::Get().Reset();
+
+    _serverState.state = NetworkServerState::Ok;
+    _serverState.resyncTick = tick;
+
+    log_info("Resynchronised at tick %u with %u bytes", tick, totalSize);
+}
+
 void NetworkBase::Server_Handle_MAPREQUEST(NetworkConnection& connection, NetworkPacket& packet)
 {
     uint32_t size;
@@ -3189,6 +3465,7 @@ void NetworkBase::Client_Handle_GAMEINFO([[maybe_unused]] NetworkConnection& con
 {
     auto jsonString = packet.ReadString();
     packet >> _serverState.gamestateSnapshotsEnabled;
+    packet >> _serverState.resyncEnabled;
 
     json_t jsonData = Json::FromString(jsonString);
 
@@ -3270,6 +3547,16 @@ void network_request_gamestate_snapshot()
     return OpenRCT2::GetContext()->GetNetwork().RequestStateSnapshot();
 }
 
+bool network_request_resync()
+{
+    return OpenRCT2::GetContext()->GetNetwork().RequestResync();
+}
+
+bool network_is_resynchronising()
+{
+    return network_get_server_state().state == NetworkServerState::Resyncing;
+}
+
 void network_send_tick()
 {
     OpenRCT2::GetContext()->GetNetwork().Server_Send_TICK();
@@ -4003,6 +4290,11 @@ bool network_gamestate_snapshots_enabled()
     return network_get_server_state().gamestateSnapshotsEnabled;
 }
 
+bool network_resync_enabled()
+{
+    return network_get_server_state().resyncEnabled;
+}
+
 json_t network_get_server_info_as_json()
 {
     auto& network = OpenRCT2::GetContext()->GetNetwork();
@@ -4046,6 +4338,18 @@ bool network_check_desynchronisation()
 void network_request_gamestate_snapshot()
 {
 }
+bool network_resync_enabled()
+{
+    return false;
+}
+bool network_request_resync()
+{
+    return false;
+}
+bool network_is_resynchronising()
+{
+    return false;
+}
 void network_send_game_action(const GameAction* action)
 {
 }
@@ -4,6 +4,7 @@
 #include "../actions/GameAction.h"
 #include "NetworkConnection.h"
 #include "NetworkGroup.h"
+#include "NetworkIoThread.h"
 #include "NetworkPlayer.h"
 #include "NetworkServerAdvertiser.h"
 #include "NetworkTypes.h"
@@ -75,7 +76,9 @@ public: // Server
     void UpdateServer();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
     bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    bool save_for_network(
+        const std::vector<const ObjectRepositoryItem*>& objects,
+        const std::function<void(const NetworkPacketBufferPtr&)>& sendChunk) const;
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
@@ -100,6 +103,7 @@ public: // Server
 
     // Handlers
     void Server_Handle_REQUEST_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet);
+    void Server_Handle_REQUEST_RESYNC(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_HEARTBEAT(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Handle_AUTH(NetworkConnection& connection, NetworkPacket& packet);
     void Server_Client_Joined(std::string_view name, const std::string& keyhash, NetworkConnection& connection);
@@ -120,9 +124,11 @@ public: // Client
     void ProcessDisconnectedClients();
     static const char* FormatChat(NetworkPlayer* fromplayer, const char* text);
     void SendPacketToClients(const NetworkPacket& packet, bool front = false, bool gameCmd = false);
+    void SendPacketToClients(const NetworkPacketBufferPtr& buffer, bool front = false, bool gameCmd = false);
     bool CheckSRAND(uint32_t tick, uint32_t srand0);
     bool CheckDesynchronizaton();
     void RequestStateSnapshot();
+    bool RequestResync();
     bool IsDesynchronised();
     NetworkServerState_t GetServerState() const;
     void ServerClientDisconnected();
@@ -131,6 +137,7 @@ public: // Client
 
     // Packet dispatchers.
     void Client_Send_RequestGameState(uint32_t tick);
+    void Client_Send_RequestResync(uint32_t tick, const std::vector<uint32_t>& hashes);
     void Client_Send_TOKEN();
     void Client_Send_AUTH(
         const std::string& name, const std::string& password, const std::string& pubkey, const std::vector<uint8_t>& signature);
@@ -160,6 +167,7 @@ public: // Client
     void Client_Handle_OBJECTS_LIST(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_SCRIPTS(NetworkConnection& connection, NetworkPacket& packet);
     void Client_Handle_GAMESTATE(NetworkConnection& connection, NetworkPacket& packet);
+    void Client_Handle_RESYNC(NetworkConnection& connection, NetworkPacket& packet);
 
     std::vector<uint8_t> _challenge;
     std::map<uint32_t, GameAction::Callback_t> _gameActionCallbacks;
@@ -192,6 +200,10 @@ private: // Common Data
 private: // Server Data
     std::unordered_map<NetworkCommand, CommandHandler> server_command_handlers;
     std::unique_ptr<ITcpSocket> _listenSocket;
+    std::unique_ptr<NetworkIoThread> _ioThread;
+    // Map chunks sent during this update, shared by every client joining with the same objects.
+    std::vector<const ObjectRepositoryItem*> _mapChunksObjects;
+    std::vector<NetworkPacketBufferPtr> _mapChunks;
     std::unique_ptr<INetworkServerAdvertiser> _advertiser;
     std::list<std::unique_ptr<NetworkConnection>> client_connection_list;
     std::string _serverLogPath;
@@ -224,6 +236,7 @@ private: // Client Data
     std::string _chatLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::string _password;
     OpenRCT2::MemoryStream _serverGameState;
+    OpenRCT2::MemoryStream _serverResync;
     NetworkServerState_t _serverState;
     uint32_t _lastSentHeartbeat = 0;
     uint32_t last_ping_sent_time = 0;
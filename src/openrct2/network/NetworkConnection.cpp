@@ -14,11 +14,13 @@
 #    include "../core/String.hpp"
 #    include "../localisation/Localisation.h"
 #    include "../platform/platform.h"
+#    include "NetworkIoThread.h"
 #    include "Socket.h"
 #    include "network.h"
 
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
+constexpr size_t NetworkMaxSendBuffers = 64;     // Buffers per vectored write, two per packet.
 
 NetworkConnection::NetworkConnection()
 {
@@ -30,25 +32,53 @@ NetworkConnection::~NetworkConnection()
 }
 
 NetworkReadPacket NetworkConnection::ReadPacket()
+{
+    if (IoChannel != nullptr)
+    {
+        // The network I/O thread has done the reading already, check for closing first so no last packet is missed.
+        const bool closed = IoChannel->Closed;
+        if (!IoChannel->Inbound.Pop(InboundPacket))
+        {
+            return closed ? NetworkReadPacket::Disconnected : NetworkReadPacket::NoData;
+        }
+    }
+    else
+    {
+        auto status = ReceivePacket(*Socket, InboundPacket);
+        if (status != NetworkReadPacket::Success)
+        {
+            return status;
+        }
+    }
+
+    // Received complete packet.
+    _lastPacketTime = platform_get_ticks();
+
+    RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, false);
+
+    return NetworkReadPacket::Success;
+}
+
+NetworkReadPacket NetworkConnection::ReceivePacket(ITcpSocket& socket, NetworkPacket& packet)
 {
     size_t bytesRead = 0;
 
     // Read packet header.
-    auto& header = InboundPacket.Header;
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    auto& header = packet.Header;
+    if (packet.BytesTransferred < sizeof(packet.Header))
     {
-        const size_t missingLength = sizeof(header) - InboundPacket.BytesTransferred;
+        const size_t missingLength = sizeof(header) - packet.BytesTransferred;
 
-        uint8_t* buffer = reinterpret_cast<uint8_t*>(&InboundPacket.Header);
+        uint8_t* buffer = reinterpret_cast<uint8_t*>(&packet.Header);
 
-        NetworkReadPacket status = Socket->ReceiveData(buffer, missingLength, &bytesRead);
+        NetworkReadPacket status = socket.ReceiveData(buffer + packet.BytesTransferred, missingLength, &bytesRead);
         if (status != NetworkReadPacket::Success)
         {
             return status;
         }
 
-        InboundPacket.BytesTransferred += bytesRead;
-        if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+        packet.BytesTransferred += bytesRead;
+        if (packet.BytesTransferred < sizeof(packet.Header))
         {
             // If still not enough data for header, keep waiting.
             return NetworkReadPacket::MoreData;
@@ -68,29 +98,24 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     // Read packet body.
     {
         // NOTE: BytesTransfered includes the header length, this will not underflow.
-        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(header));
+        const size_t missingLength = header.Size - (packet.BytesTransferred - sizeof(header));
 
         uint8_t buffer[NetworkBufferSize];
 
         if (missingLength > 0)
         {
-            NetworkReadPacket status = Socket->ReceiveData(buffer, std::min(missingLength, NetworkBufferSize), &bytesRead);
+            NetworkReadPacket status = socket.ReceiveData(buffer, std::min(missingLength, NetworkBufferSize), &bytesRead);
             if (status != NetworkReadPacket::Success)
             {
                 return status;
             }
 
-            InboundPacket.BytesTransferred += bytesRead;
-            InboundPacket.Write(buffer, bytesRead);
+            packet.BytesTransferred += bytesRead;
+            packet.Write(buffer, bytesRead);
         }
 
-        if (InboundPacket.Data.size() == header.Size)
+        if (packet.Data.size() == header.Size)
         {
-            // Received complete packet.
-            _lastPacketTime = platform_get_ticks();
-
-            RecordPacketStats(InboundPacket, false);
-
             return NetworkReadPacket::Success;
         }
     }
@@ -98,61 +123,53 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
-
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
+    QueuePacket(std::move(packet).ToBuffer(), front);
+}
 
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
+void NetworkConnection::QueuePacket(const NetworkPacket& packet, bool front)
+{
+    QueuePacket(packet.ToBuffer(), front);
+}
 
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
+void NetworkConnection::QueuePacket(const NetworkPacketBufferPtr& buffer, bool front)
+{
+    if (AuthStatus == NetworkAuth::Ok || !NetworkPacket::CommandRequiresAuth(buffer->Id))
     {
-        RecordPacketStats(packet, true);
+        if (IoChannel != nullptr)
+        {
+            // Sent by the network I/O thread once woken up by NetworkBase::Flush.
+            IoChannel->Outbound.Push({ buffer, front });
+        }
+        else
+        {
+            InsertOutboundPacket(_outboundPackets, buffer, front);
+        }
     }
-    return sendComplete;
 }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
+void NetworkConnection::InsertOutboundPacket(
+    std::deque<NetworkOutboundPacket>& packets, const NetworkPacketBufferPtr& buffer, bool front)
 {
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
+    if (front)
     {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
-        if (front)
+        // If the first packet was already partially sent add new packet to second position
+        if (!packets.empty() && packets.front().BytesTransferred > 0)
         {
-            // If the first packet was already partially sent add new packet to second position
-            if (!_outboundPackets.empty() && _outboundPackets.front().BytesTransferred > 0)
-            {
-                auto it = _outboundPackets.begin();
-                it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
-            }
-            else
-            {
-                _outboundPackets.push_front(std::move(packet));
-            }
+            auto it = packets.begin();
+            it++; // Second position
+            packets.insert(it, { buffer });
         }
         else
         {
-            _outboundPackets.push_back(std::move(packet));
+            packets.push_front({ buffer });
         }
     }
+    else
+    {
+        packets.push_back({ buffer });
+    }
 }
 
 void NetworkConnection::Disconnect()
@@ -167,9 +184,77 @@ bool NetworkConnection::IsValid() const
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    if (IoChannel != nullptr)
+    {
+        // Only pick up what the network I/O thread has sent since.
+        for (size_t i = 0; i < std::size(Stats.bytesSent); i++)
+        {
+            Stats.bytesSent[i] = IoChannel->BytesSent[i];
+        }
+        return;
+    }
+
+    SendPackets(*Socket, _outboundPackets, [this](const NetworkPacketBuffer& buffer) {
+        RecordPacketStats(buffer.Id, buffer.GetSize(), true);
+    });
+}
+
+void NetworkConnection::SendPackets(
+    ITcpSocket& socket, std::deque<NetworkOutboundPacket>& packets,
+    const std::function<void(const NetworkPacketBuffer&)>& onSent)
+{
+    while (!packets.empty())
     {
-        _outboundPackets.pop_front();
+        // Hand the socket as much of the queue as fits in one vectored write, header and data of each packet.
+        SocketSendBuffer buffers[NetworkMaxSendBuffers];
+        size_t numBuffers = 0;
+        size_t bytesQueued = 0;
+        for (const auto& outbound : packets)
+        {
+            if (numBuffers + 2 > std::size(buffers))
+                break;
+
+            const auto& buffer = *outbound.Buffer;
+            size_t offset = outbound.BytesTransferred;
+            if (offset < sizeof(buffer.Header))
+            {
+                buffers[numBuffers++] = { buffer.Header + offset, sizeof(buffer.Header) - offset };
+                offset = 0;
+            }
+            else
+            {
+                offset -= sizeof(buffer.Header);
+            }
+            if (offset < buffer.Data.size())
+            {
+                buffers[numBuffers++] = { buffer.Data.data() + offset, buffer.Data.size() - offset };
+            }
+            bytesQueued += buffer.GetSize() - outbound.BytesTransferred;
+        }
+
+        size_t sent = socket.SendData(buffers, numBuffers);
+
+        // Retire the packets that went out completely, the socket may have stopped part way into one.
+        for (size_t remaining = sent; remaining > 0;)
+        {
+            auto& outbound = packets.front();
+            const size_t packetRemaining = outbound.Buffer->GetSize() - outbound.BytesTransferred;
+            if (remaining < packetRemaining)
+            {
+                outbound.BytesTransferred += remaining;
+                break;
+            }
+
+            onSent(*outbound.Buffer);
+            packets.pop_front();
+            remaining -= packetRemaining;
+        }
+
+        if (sent < bytesQueued)
+        {
+            // The socket is full, try again next time.
+            break;
+        }
     }
 }
 
@@ -206,23 +291,24 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+NetworkStatisticsGroup NetworkConnection::GetStatisticsGroup(NetworkCommand command)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
-    NetworkStatisticsGroup trafficGroup;
-
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
-            trafficGroup = NetworkStatisticsGroup::Commands;
-            break;
+            return NetworkStatisticsGroup::Commands;
         case NetworkCommand::Map:
-            trafficGroup = NetworkStatisticsGroup::MapData;
-            break;
+        case NetworkCommand::Resync:
+            return NetworkStatisticsGroup::MapData;
         default:
-            trafficGroup = NetworkStatisticsGroup::Base;
-            break;
+            return NetworkStatisticsGroup::Base;
     }
+}
+
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, bool sending)
+{
+    uint32_t packetSize = static_cast<uint32_t>(size);
+    NetworkStatisticsGroup trafficGroup = GetStatisticsGroup(command);
 
     if (sending)
     {
@@ -17,11 +17,13 @@
 #    include "Socket.h"
 
 #    include <deque>
+#    include <functional>
 #    include <memory>
 #    include <string_view>
 #    include <vector>
 
 class NetworkPlayer;
+struct NetworkIoChannel;
 struct ObjectRepositoryItem;
 
 class NetworkConnection final
@@ -37,17 +39,17 @@ public:
     std::vector<uint8_t> Challenge;
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
     bool ShouldDisconnect = false;
+    // Set while the network I/O thread does the reading and writing for this connection.
+    std::shared_ptr<NetworkIoChannel> IoChannel;
 
     NetworkConnection();
     ~NetworkConnection();
 
     NetworkReadPacket ReadPacket();
     void QueuePacket(NetworkPacket&& packet, bool front = false);
-    void QueuePacket(const NetworkPacket& packet, bool front = false)
-    {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
-    }
+    void QueuePacket(const NetworkPacket& packet, bool front = false);
+    // For packets that go to several connections, the buffer is shared rather than copied.
+    void QueuePacket(const NetworkPacketBufferPtr& buffer, bool front = false);
 
     // This will not immediately disconnect the client. The disconnect
     // will happen post-tick.
@@ -62,13 +64,21 @@ public:
     void SetLastDisconnectReason(std::string_view src);
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
+    // Socket framing shared with the network I/O thread.
+    static NetworkReadPacket ReceivePacket(ITcpSocket& socket, NetworkPacket& packet);
+    static void InsertOutboundPacket(
+        std::deque<NetworkOutboundPacket>& packets, const NetworkPacketBufferPtr& buffer, bool front);
+    static void SendPackets(
+        ITcpSocket& socket, std::deque<NetworkOutboundPacket>& packets,
+        const std::function<void(const NetworkPacketBuffer&)>& onSent);
+    static NetworkStatisticsGroup GetStatisticsGroup(NetworkCommand command);
+
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    std::deque<NetworkOutboundPacket> _outboundPackets;
     uint32_t _lastPacketTime = 0;
     std::string _lastDisconnectReason;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(NetworkCommand command, size_t size, bool sending);
 };
 
 #endif // DISABLE_NETWORK
@@ -0,0 +1,284 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkIoThread.h"
+
+#    include "NetworkConnection.h"
+
+#    include <algorithm>
+#    include <exception>
+
+// Limits how long one connection flooding the server can keep the others waiting.
+constexpr size_t NetworkIoMaxReadsPerEvent = 64;
+
+std::unique_ptr<NetworkIoThread> NetworkIoThread::Create(ITcpSocket& listenSocket)
+{
+    try
+    {
+        auto poller = CreateSocketPoller();
+        if (poller == nullptr)
+        {
+            return nullptr;
+        }
+        return std::make_unique<NetworkIoThread>(std::move(poller), listenSocket);
+    }
+    catch (const std::exception& e)
+    {
+        log_error("Unable to start the network I/O thread: %s", e.what());
+        return nullptr;
+    }
+}
+
+NetworkIoThread::NetworkIoThread(std::unique_ptr<ISocketPoller> poller, ITcpSocket& listenSocket)
+    : _poller(std::move(poller))
+    , _listenSocket(listenSocket)
+{
+    // The thread itself is the tag for the listen socket.
+    _poller->Add(_listenSocket, this, false);
+    _thread = std::thread([this]() { Run(); });
+}
+
+NetworkIoThread::~NetworkIoThread()
+{
+    _stopping = true;
+    _poller->Wake();
+    _thread.join();
+}
+
+std::unique_ptr<ITcpSocket> NetworkIoThread::Accept()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_acceptedSockets.empty())
+    {
+        return nullptr;
+    }
+    auto socket = std::move(_acceptedSockets.front());
+    _acceptedSockets.erase(_acceptedSockets.begin());
+    return socket;
+}
+
+std::shared_ptr<NetworkIoChannel> NetworkIoThread::Attach(ITcpSocket& socket)
+{
+    auto connection = std::make_unique<Connection>();
+    connection->Socket = &socket;
+    connection->Channel = std::make_shared<NetworkIoChannel>();
+    auto channel = connection->Channel;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _attaching.push_back(std::move(connection));
+    }
+    _poller->Wake();
+    return channel;
+}
+
+void NetworkIoThread::Detach(const std::shared_ptr<NetworkIoChannel>& channel)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _detaching.push_back(channel);
+    const auto request = ++_numDetachRequests;
+    _poller->Wake();
+    _detached.wait(lock, [this, request]() { return _numDetachesDone >= request; });
+}
+
+void NetworkIoThread::Wake()
+{
+    _poller->Wake();
+}
+
+void NetworkIoThread::Run()
+{
+    SocketPollEvent events[64];
+    while (!_stopping)
+    {
+        const size_t numEvents = _poller->Wait(events, std::size(events), 1000);
+
+        bool woken = false;
+        for (size_t i = 0; i < numEvents; i++)
+        {
+            const auto& event = events[i];
+            if (event.Tag == nullptr)
+            {
+                woken = true;
+            }
+            else if (event.Tag == this)
+            {
+                AcceptClients();
+            }
+            else
+            {
+                auto& connection = *static_cast<Connection*>(event.Tag);
+                if (event.Readable || event.Error)
+                {
+                    Receive(connection);
+                }
+                if (event.Writable)
+                {
+                    Send(connection);
+                }
+            }
+        }
+
+        if (woken)
+        {
+            // The game thread has queued packets.
+            for (auto& connection : _connections)
+            {
+                Send(*connection);
+            }
+        }
+
+        // Only after the events, those may refer to connections that are about to be detached.
+        ProcessCommands();
+    }
+}
+
+void NetworkIoThread::ProcessCommands()
+{
+    std::vector<std::unique_ptr<Connection>> attaching;
+    std::vector<std::shared_ptr<NetworkIoChannel>> detaching;
+    uint64_t numDetachRequests;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        attaching.swap(_attaching);
+        detaching.swap(_detaching);
+        numDetachRequests = _numDetachRequests;
+    }
+
+    for (auto& connection : attaching)
+    {
+        try
+        {
+            _poller->Add(*connection->Socket, connection.get(), false);
+        }
+        catch (const std::exception& e)
+        {
+            log_error("Unable to poll client socket: %s", e.what());
+            connection->Channel->Closed = true;
+            connection->Closed = true;
+        }
+        _connections.push_back(std::move(connection));
+    }
+
+    if (detaching.empty())
+    {
+        return;
+    }
+
+    for (const auto& channel : detaching)
+    {
+        auto it = std::find_if(_connections.begin(), _connections.end(), [&channel](const auto& connection) {
+            return connection->Channel == channel;
+        });
+        if (it != _connections.end())
+        {
+            auto& connection = **it;
+            // Last chance for a disconnect reason to reach the client.
+            Send(connection);
+            Close(connection);
+            _connections.erase(it);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _numDetachesDone = numDetachRequests;
+    }
+    _detached.notify_all();
+}
+
+void NetworkIoThread::AcceptClients()
+{
+    while (auto socket = _listenSocket.Accept())
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _acceptedSockets.push_back(std::move(socket));
+    }
+}
+
+void NetworkIoThread::Receive(Connection& connection)
+{
+    if (connection.Closed)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < NetworkIoMaxReadsPerEvent; i++)
+    {
+        auto status = NetworkConnection::ReceivePacket(*connection.Socket, connection.InboundPacket);
+        if (status == NetworkReadPacket::Success)
+        {
+            connection.Channel->Inbound.Push(std::move(connection.InboundPacket));
+            connection.InboundPacket = {};
+        }
+        else if (status == NetworkReadPacket::Disconnected)
+        {
+            Close(connection);
+            break;
+        }
+        else if (status == NetworkReadPacket::NoData)
+        {
+            break;
+        }
+    }
+}
+
+void NetworkIoThread::Send(Connection& connection)
+{
+    if (connection.Closed)
+    {
+        return;
+    }
+
+    auto& channel = *connection.Channel;
+    NetworkIoOutbound outbound;
+    while (channel.Outbound.Pop(outbound))
+    {
+        NetworkConnection::InsertOutboundPacket(connection.OutboundPackets, outbound.Buffer, outbound.Front);
+    }
+    if (connection.OutboundPackets.empty() && !connection.WaitingForWritable)
+    {
+        return;
+    }
+
+    try
+    {
+        NetworkConnection::SendPackets(*connection.Socket, connection.OutboundPackets, [&channel](const auto& buffer) {
+            const auto group = NetworkConnection::GetStatisticsGroup(buffer.Id);
+            channel.BytesSent[EnumValue(group)] += buffer.GetSize();
+            channel.BytesSent[EnumValue(NetworkStatisticsGroup::Total)] += buffer.GetSize();
+        });
+
+        // Whatever the socket did not take goes out once it is writable again, rather than on the next tick.
+        const bool waitForWritable = !connection.OutboundPackets.empty();
+        if (waitForWritable != connection.WaitingForWritable)
+        {
+            _poller->Modify(*connection.Socket, &connection, waitForWritable);
+            connection.WaitingForWritable = waitForWritable;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log_verbose("Unable to send to client: %s", e.what());
+        Close(connection);
+    }
+}
+
+void NetworkIoThread::Close(Connection& connection)
+{
+    if (!connection.Closed)
+    {
+        _poller->Remove(*connection.Socket);
+        connection.Closed = true;
+        connection.Channel->Closed = true;
+    }
+}
+
+#endif // DISABLE_NETWORK
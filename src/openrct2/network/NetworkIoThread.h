@@ -0,0 +1,170 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+#    include "../common.h"
+#    include "NetworkPacket.h"
+#    include "NetworkTypes.h"
+#    include "Socket.h"
+
+#    include <atomic>
+#    include <condition_variable>
+#    include <deque>
+#    include <memory>
+#    include <mutex>
+#    include <thread>
+#    include <vector>
+
+/**
+ * Unbounded queue between exactly one producer and one consumer thread, neither of which ever blocks.
+ */
+template<typename T> class NetworkSpscQueue final
+{
+private:
+    struct Node
+    {
+        std::atomic<Node*> Next = { nullptr };
+        T Value{};
+    };
+
+    // Consumer end, always points at an already consumed node.
+    Node* _head;
+    // Producer end.
+    Node* _tail;
+
+public:
+    NetworkSpscQueue()
+        : _head(new Node())
+        , _tail(_head)
+    {
+    }
+
+    NetworkSpscQueue(const NetworkSpscQueue&) = delete;
+    NetworkSpscQueue& operator=(const NetworkSpscQueue&) = delete;
+
+    ~NetworkSpscQueue()
+    {
+        while (_head != nullptr)
+        {
+            auto next = _head->Next.load(std::memory_order_relaxed);
+            delete _head;
+            _head = next;
+        }
+    }
+
+    void Push(T&& value)
+    {
+        auto node = new Node();
+        node->Value = std::move(value);
+        _tail->Next.store(node, std::memory_order_release);
+        _tail = node;
+    }
+
+    bool Pop(T& value)
+    {
+        auto next = _head->Next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+        value = std::move(next->Value);
+        delete _head;
+        _head = next;
+        return true;
+    }
+};
+
+struct NetworkIoOutbound
+{
+    NetworkPacketBufferPtr Buffer;
+    bool Front = false;
+};
+
+/**
+ * Everything the game thread and the network I/O thread share for one connection. Only the I/O thread touches the
+ * socket while the channel is attached.
+ */
+struct NetworkIoChannel
+{
+    // Complete packets, pushed by the I/O thread.
+    NetworkSpscQueue<NetworkPacket> Inbound;
+    // Packets to send, pushed by the game thread.
+    NetworkSpscQueue<NetworkIoOutbound> Outbound;
+    // Set by the I/O thread once the peer has gone, after the last inbound packet.
+    std::atomic_bool Closed = { false };
+    // Bytes the I/O thread has sent since attaching, by statistics group.
+    std::atomic<uint64_t> BytesSent[EnumValue(NetworkStatisticsGroup::Max)] = {};
+};
+
+/**
+ * Accepts, reads and writes the sockets of a server on its own thread, so clients are served as soon as their sockets
+ * are ready rather than once per game tick. Packets are only framed here, they are still processed by the game thread.
+ */
+class NetworkIoThread final
+{
+private:
+    struct Connection
+    {
+        ITcpSocket* Socket = nullptr;
+        std::shared_ptr<NetworkIoChannel> Channel;
+        NetworkPacket InboundPacket;
+        std::deque<NetworkOutboundPacket> OutboundPackets;
+        bool WaitingForWritable = false;
+        bool Closed = false;
+    };
+
+    std::unique_ptr<ISocketPoller> _poller;
+    ITcpSocket& _listenSocket;
+    std::thread _thread;
+    std::atomic_bool _stopping = { false };
+
+    // Owned by the I/O thread.
+    std::vector<std::unique_ptr<Connection>> _connections;
+
+    std::mutex _mutex;
+    std::condition_variable _detached;
+    std::vector<std::unique_ptr<ITcpSocket>> _acceptedSockets;
+    std::vector<std::unique_ptr<Connection>> _attaching;
+    std::vector<std::shared_ptr<NetworkIoChannel>> _detaching;
+    uint64_t _numDetachRequests = 0;
+    uint64_t _numDetachesDone = 0;
+
+public:
+    // Returns nullptr when sockets can not be polled on this platform.
+    static std::unique_ptr<NetworkIoThread> Create(ITcpSocket& listenSocket);
+
+    NetworkIoThread(std::unique_ptr<ISocketPoller> poller, ITcpSocket& listenSocket);
+    ~NetworkIoThread();
+
+    NetworkIoThread(const NetworkIoThread&) = delete;
+    NetworkIoThread& operator=(const NetworkIoThread&) = delete;
+
+    // Returns the next client accepted on the listen socket, nullptr if there is none.
+    std::unique_ptr<ITcpSocket> Accept();
+
+    // Hands the socket over to the I/O thread until detached.
+    std::shared_ptr<NetworkIoChannel> Attach(ITcpSocket& socket);
+    // Sends what is still queued as far as the socket takes it and returns the socket to the caller.
+    void Detach(const std::shared_ptr<NetworkIoChannel>& channel);
+
+    // Makes the I/O thread pick up newly queued packets.
+    void Wake();
+
+private:
+    void Run();
+    void ProcessCommands();
+    void AcceptClients();
+    void Receive(Connection& connection);
+    void Send(Connection& connection);
+    void Close(Connection& connection);
+};
+
+#endif // DISABLE_NETWORK
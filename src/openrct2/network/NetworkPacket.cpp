@@ -12,9 +12,15 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
+#    include <atomic>
+#    include <cstring>
 #    include <memory>
 
+static std::atomic<uint64_t> _numBuffers;
+static std::atomic<uint64_t> _numBytesCopied;
+
 NetworkPacket::NetworkPacket(NetworkCommand id)
     : Header{ 0, id }
 {
@@ -44,7 +50,12 @@ void NetworkPacket::Clear()
 
 bool NetworkPacket::CommandRequiresAuth()
 {
-    switch (GetCommand())
+    return CommandRequiresAuth(GetCommand());
+}
+
+bool NetworkPacket::CommandRequiresAuth(NetworkCommand command)
+{
+    switch (command)
     {
         case NetworkCommand::Ping:
         case NetworkCommand::Auth:
@@ -60,6 +71,49 @@ bool NetworkPacket::CommandRequiresAuth()
     }
 }
 
+static void SerialiseHeader(NetworkPacketBuffer& buffer)
+{
+    PacketHeader header{};
+    header.Size = static_cast<uint16_t>(buffer.Data.size());
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    header.Size += sizeof(header.Id);
+    header.Size = Convert::HostToNetwork(header.Size);
+    header.Id = ByteSwapBE(buffer.Id);
+
+    std::memcpy(buffer.Header, &header, sizeof(header));
+}
+
+NetworkPacketBufferPtr NetworkPacket::ToBuffer() const&
+{
+    _numBuffers.fetch_add(1, std::memory_order_relaxed);
+    _numBytesCopied.fetch_add(Data.size(), std::memory_order_relaxed);
+
+    auto buffer = std::make_shared<NetworkPacketBuffer>();
+    buffer->Id = Header.Id;
+    buffer->Data = Data;
+    SerialiseHeader(*buffer);
+    return buffer;
+}
+
+NetworkPacketBufferPtr NetworkPacket::ToBuffer() &&
+{
+    _numBuffers.fetch_add(1, std::memory_order_relaxed);
+
+    auto buffer = std::make_shared<NetworkPacketBuffer>();
+    buffer->Id = Header.Id;
+    buffer->Data = std::move(Data);
+    SerialiseHeader(*buffer);
+    Clear();
+    return buffer;
+}
+
+NetworkPacketBufferStats NetworkPacketGetBufferStats()
+{
+    return { _numBuffers.load(std::memory_order_relaxed), _numBytesCopied.load(std::memory_order_relaxed) };
+}
+
 void NetworkPacket::Write(const void* bytes, size_t size)
 {
     const uint8_t* src = reinterpret_cast<const uint8_t*>(bytes);
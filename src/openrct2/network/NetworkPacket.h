@@ -25,6 +25,38 @@ struct PacketHeader
 static_assert(sizeof(PacketHeader) == 6);
 #pragma pack(pop)
 
+/**
+ * The bytes of a packet as they go out on the wire, header included. Made once and shared by the outbound queues of all
+ * the connections the packet goes to, so it must not change after that.
+ */
+struct NetworkPacketBuffer final
+{
+    NetworkCommand Id = NetworkCommand::Invalid;
+    uint8_t Header[sizeof(PacketHeader)]{};
+    std::vector<uint8_t> Data;
+
+    size_t GetSize() const
+    {
+        return sizeof(Header) + Data.size();
+    }
+};
+
+using NetworkPacketBufferPtr = std::shared_ptr<const NetworkPacketBuffer>;
+
+// Packet buffers made and payload bytes copied into them so far, the network benchmark reports them per tick.
+struct NetworkPacketBufferStats
+{
+    uint64_t Buffers;
+    uint64_t BytesCopied;
+};
+NetworkPacketBufferStats NetworkPacketGetBufferStats();
+
+struct NetworkOutboundPacket
+{
+    NetworkPacketBufferPtr Buffer;
+    size_t BytesTransferred = 0;
+};
+
 struct NetworkPacket final
 {
     NetworkPacket() = default;
@@ -37,6 +69,11 @@ struct NetworkPacket final
 
     void Clear();
     bool CommandRequiresAuth();
+    static bool CommandRequiresAuth(NetworkCommand command);
+
+    // The packet as it is sent, the second overload takes over the data instead of copying it.
+    NetworkPacketBufferPtr ToBuffer() const&;
+    NetworkPacketBufferPtr ToBuffer() &&;
 
     const uint8_t* Read(size_t size);
     std::string_view ReadString();
@@ -83,6 +83,8 @@ enum class NetworkCommand : uint32_t
     GameState,
     Scripts,
     Heartbeat,
+    RequestResync,
+    Resync,
     Max,
     Invalid = static_cast<uint32_t>(-1),
 };
@@ -92,7 +94,8 @@ static_assert(NetworkCommand::GameInfo == static_cast<NetworkCommand>(9), "Maste
 enum class NetworkServerState
 {
     Ok,
-    Desynced
+    Desynced,
+    Resyncing
 };
 
 struct NetworkServerState_t
@@ -102,6 +105,8 @@ struct NetworkServerState_t
     uint32_t tick = 0;
     uint32_t srand0 = 0;
     bool gamestateSnapshotsEnabled = false;
+    bool resyncEnabled = false;
+    uint32_t resyncTick = 0;
 };
 
 // Structure is used for networking specific fields with meaning,
@@ -51,7 +51,13 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
     #include "../common.h"
+    #if defined(__linux__)
+        #include <sys/epoll.h>
+        #include <sys/eventfd.h>
+    #endif // defined(__linux__)
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
     #define INVALID_SOCKET -1
@@ -563,6 +569,70 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const SocketSendBuffer* buffers, size_t count) override
+    {
+        if (_status != SocketStatus::Connected)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        size_t totalSent = 0;
+        size_t index = 0;
+        size_t offset = 0;
+        while (index < count)
+        {
+            // Gather what is left, starting part way into the buffer a previous call stopped in.
+#    ifdef _WIN32
+            WSABUF vectors[64];
+#    else
+            iovec vectors[64];
+#    endif
+            size_t numVectors = 0;
+            for (size_t i = index; i < count && numVectors < std::size(vectors); i++)
+            {
+                const size_t skip = i == index ? offset : 0;
+                auto data = static_cast<const char*>(buffers[i].Data) + skip;
+#    ifdef _WIN32
+                vectors[numVectors].buf = const_cast<char*>(data);
+                vectors[numVectors].len = static_cast<ULONG>(buffers[i].Size - skip);
+#    else
+                vectors[numVectors].iov_base = const_cast<char*>(data);
+                vectors[numVectors].iov_len = buffers[i].Size - skip;
+#    endif
+                numVectors++;
+            }
+
+#    ifdef _WIN32
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, vectors, static_cast<DWORD>(numVectors), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            msghdr message{};
+            message.msg_iov = vectors;
+            message.msg_iovlen = numVectors;
+            ssize_t sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            totalSent += sentBytes;
+
+            // Move past the buffers that went out.
+            size_t remaining = sentBytes;
+            while (index < count && remaining >= buffers[index].Size - offset)
+            {
+                remaining -= buffers[index].Size - offset;
+                offset = 0;
+                index++;
+            }
+            offset += remaining;
+        }
+        return totalSent;
+    }
+
     NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SocketStatus::Connected)
@@ -623,6 +693,11 @@ public:
         return _ipAddress;
     }
 
+    SOCKET GetHandle() const
+    {
+        return _socket;
+    }
+
 private:
     explicit TcpSocket(SOCKET socket, const std::string& hostName, const std::string& ipAddress)
         : _status(SocketStatus::Connected)
@@ -887,6 +962,126 @@ std::unique_ptr<IUdpSocket> CreateUdpSocket()
     return std::make_unique<UdpSocket>();
 }
 
+#    if defined(__linux__)
+class EpollSocketPoller final : public ISocketPoller
+{
+private:
+    int _epoll = -1;
+    int _wakeEvent = -1;
+
+public:
+    EpollSocketPoller()
+    {
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        if (_epoll == -1)
+        {
+            throw SocketException("epoll_create1 failed with error: " + std::to_string(LAST_SOCKET_ERROR()));
+        }
+        _wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_wakeEvent == -1)
+        {
+            close(_epoll);
+            throw SocketException("eventfd failed with error: " + std::to_string(LAST_SOCKET_ERROR()));
+        }
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeEvent, &event);
+    }
+
+    ~EpollSocketPoller() override
+    {
+        close(_wakeEvent);
+        close(_epoll);
+    }
+
+    void Add(ITcpSocket& socket, void* tag, bool writable) override
+    {
+        Control(EPOLL_CTL_ADD, socket, tag, writable);
+    }
+
+    void Modify(ITcpSocket& socket, void* tag, bool writable) override
+    {
+        Control(EPOLL_CTL_MOD, socket, tag, writable);
+    }
+
+    void Remove(ITcpSocket& socket) override
+    {
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, GetHandle(socket), nullptr);
+    }
+
+    void Wake() override
+    {
+        uint64_t value = 1;
+        [[maybe_unused]] auto written = write(_wakeEvent, &value, sizeof(value));
+    }
+
+    size_t Wait(SocketPollEvent* events, size_t maxEvents, int32_t timeoutMs) override
+    {
+        epoll_event epollEvents[64];
+        int numEvents = epoll_wait(
+            _epoll, epollEvents, static_cast<int>(std::min(maxEvents, std::size(epollEvents))), timeoutMs);
+        if (numEvents <= 0)
+        {
+            // Timed out or interrupted by a signal.
+            return 0;
+        }
+
+        for (int i = 0; i < numEvents; i++)
+        {
+            const auto& epollEvent = epollEvents[i];
+            if (epollEvent.data.ptr == nullptr)
+            {
+                uint64_t value;
+                [[maybe_unused]] auto read = ::read(_wakeEvent, &value, sizeof(value));
+            }
+            events[i].Tag = epollEvent.data.ptr;
+            events[i].Readable = (epollEvent.events & EPOLLIN) != 0;
+            events[i].Writable = (epollEvent.events & EPOLLOUT) != 0;
+            events[i].Error = (epollEvent.events & (EPOLLERR | EPOLLHUP)) != 0;
+        }
+        return static_cast<size_t>(numEvents);
+    }
+
+private:
+    static SOCKET GetHandle(ITcpSocket& socket)
+    {
+        auto tcpSocket = dynamic_cast<TcpSocket*>(&socket);
+        if (tcpSocket == nullptr)
+        {
+            throw std::runtime_error("Only TCP sockets can be polled.");
+        }
+        return tcpSocket->GetHandle();
+    }
+
+    void Control(int operation, ITcpSocket& socket, void* tag, bool writable)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        if (writable)
+        {
+            event.events |= EPOLLOUT;
+        }
+        event.data.ptr = tag;
+        if (epoll_ctl(_epoll, operation, GetHandle(socket), &event) != 0)
+        {
+            throw SocketException("epoll_ctl failed with error: " + std::to_string(LAST_SOCKET_ERROR()));
+        }
+    }
+};
+
+std::unique_ptr<ISocketPoller> CreateSocketPoller()
+{
+    return std::make_unique<EpollSocketPoller>();
+}
+#    else
+std::unique_ptr<ISocketPoller> CreateSocketPoller()
+{
+    return nullptr;
+}
+#    endif // defined(__linux__)
+
 #    ifdef _WIN32
 static std::vector<INTERFACE_INFO> GetNetworkInterfaces()
 {
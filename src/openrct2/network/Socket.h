@@ -45,6 +45,15 @@ struct INetworkEndpoint
     virtual std::string GetHostname() const abstract;
 };
 
+/**
+ * A piece of memory to send, several are sent with a single call.
+ */
+struct SocketSendBuffer
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents a TCP socket / connection or listener.
  */
@@ -66,6 +75,7 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    virtual size_t SendData(const SocketSendBuffer* buffers, size_t count) abstract;
     virtual NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void SetNoDelay(bool noDelay) abstract;
@@ -98,10 +108,39 @@ public:
     virtual void Close() abstract;
 };
 
+struct SocketPollEvent
+{
+    // Tag the socket was added with, nullptr when the poller was woken up.
+    void* Tag;
+    bool Readable;
+    bool Writable;
+    bool Error;
+};
+
+/**
+ * Waits for any of a set of TCP sockets to become readable or writable.
+ */
+struct ISocketPoller
+{
+public:
+    virtual ~ISocketPoller() = default;
+
+    virtual void Add(ITcpSocket& socket, void* tag, bool writable) abstract;
+    virtual void Modify(ITcpSocket& socket, void* tag, bool writable) abstract;
+    virtual void Remove(ITcpSocket& socket) abstract;
+
+    // Wakes up a thread in Wait from any other thread.
+    virtual void Wake() abstract;
+    virtual size_t Wait(SocketPollEvent* events, size_t maxEvents, int32_t timeoutMs) abstract;
+};
+
 [[nodiscard]] std::unique_ptr<ITcpSocket> CreateTcpSocket();
 [[nodiscard]] std::unique_ptr<IUdpSocket> CreateUdpSocket();
 [[nodiscard]] std::vector<std::unique_ptr<INetworkEndpoint>> GetBroadcastAddresses();
 
+// Only available on Linux (epoll), returns nullptr elsewhere.
+[[nodiscard]] std::unique_ptr<ISocketPoller> CreateSocketPoller();
+
 namespace Convert
 {
     uint16_t HostToNetwork(uint16_t value);
@@ -45,6 +45,9 @@ int32_t network_begin_server(int32_t port, const std::string& address);
 [[nodiscard]] int32_t network_get_status();
 bool network_is_desynchronised();
 bool network_check_desynchronisation();
+bool network_resync_enabled();
+bool network_request_resync();
+bool network_is_resynchronising();
 void network_request_gamestate_snapshot();
 void network_send_tick();
 bool network_gamestate_snapshots_enabled();
@@ -13,6 +13,7 @@
 #include "../ParkImporter.h"
 #include "../core/Console.hpp"
 #include "../core/Memory.hpp"
+#include "../core/TaskScheduler.h"
 #include "../localisation/StringIds.h"
 #include "../util/Util.h"
 #include "FootpathItemObject.h"
@@ -29,7 +30,6 @@
 #include <array>
 #include <memory>
 #include <mutex>
-#include <thread>
 #include <unordered_set>
 
 class ObjectManager final : public IObjectManager
@@ -582,26 +582,7 @@ private:
 
     template<typename T, typename TFunc> static void ParallelFor(const std::vector<T>& items, TFunc func)
     {
-        auto partitions = std::thread::hardware_concurrency();
-        auto partitionSize = (items.size() + (partitions - 1)) / partitions;
-        std::vector<std::thread> threads;
-        for (size_t n = 0; n < partitions; n++)
-        {
-            auto begin = n * partitionSize;
-            auto end = std::min(items.size(), begin + partitionSize);
-            threads.emplace_back(
-                [func](size_t pbegin, size_t pend) {
-                    for (size_t i = pbegin; i < pend; i++)
-                    {
-                        func(i);
-                    }
-                },
-                begin, end);
-        }
-        for (auto& t : threads)
-        {
-            t.join();
-        }
+        OpenRCT2::GetTaskScheduler().ParallelFor(items.size(), func);
     }
 
     void LoadObjects(std::vector<const ObjectRepositoryItem*>& requiredObjects)
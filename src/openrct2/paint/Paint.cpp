@@ -18,12 +18,20 @@
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
 #include "../util/Math.hpp"
+#include "../util/Util.h"
+#include "PaintTileCache.h"
 #include "sprite/Paint.Sprite.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define PAINT_SORT_SSE2
+#    include <emmintrin.h>
+#endif
 
 using namespace OpenRCT2;
 
@@ -51,8 +59,9 @@ static constexpr const uint8_t BoundBoxDebugColours[] = {
 bool gShowDirtyVisuals;
 bool gPaintBoundingBoxes;
 bool gPaintBlockedTiles;
+bool gShowPaintSessionStats;
 
-static void PaintAttachedPS(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t viewFlags);
+static void PaintAttachedPS(paint_session* session, paint_struct* ps);
 static void PaintPSImageWithBoundingBoxes(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t imageId, int32_t x, int32_t y);
 static void PaintPSImage(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t imageId, int32_t x, int32_t y);
 static uint32_t PaintPSColourifyImage(uint32_t imageId, ViewportInteractionItem spriteType, uint32_t viewFlags);
@@ -83,7 +92,7 @@ static int32_t RemapPositionToQuadrant(const paint_struct& ps, uint8_t rotation)
     return 0;
 }
 
-static void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps)
+void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps)
 {
     const auto positionHash = RemapPositionToQuadrant(*ps, session->CurrentRotation);
 
@@ -162,7 +171,8 @@ static paint_struct* CreateNormalPaintStruct(
 
     const auto imagePos = translate_3d_to_2d_with_z(session->CurrentRotation, swappedRotCoord);
 
-    if (!ImageWithinDPI(imagePos, *g1, session->DPI))
+    // Recordings are culled when they are replayed.
+    if (session->TileRecorder == nullptr && !ImageWithinDPI(imagePos, *g1, session->DPI))
     {
         return nullptr;
     }
@@ -244,6 +254,7 @@ template<uint8_t direction> void PaintSessionGenerateRotate(paint_session* sessi
  */
 void PaintSessionGenerate(paint_session* session)
 {
+    PaintTileCacheBeginSession();
     session->CurrentRotation = get_current_rotation();
     switch (DirectionFlipXAxis(session->CurrentRotation))
     {
@@ -424,7 +435,7 @@ static paint_struct* PaintArrangeStructsHelperRotation(paint_struct* ps_next, ui
     }
 }
 
-template<int TRotation> static void PaintSessionArrange(PaintSessionCore* session, bool)
+template<int TRotation> static void PaintSessionArrangeLegacy(PaintSessionCore* session)
 {
     paint_struct* psHead = &session->PaintHead;
 
@@ -460,6 +471,317 @@ template<int TRotation> static void PaintSessionArrange(PaintSessionCore* sessio
     }
 }
 
+void PaintSessionArrangeLegacy(PaintSessionCore* session)
+{
+    switch (session->CurrentRotation)
+    {
+        case 0:
+            return PaintSessionArrangeLegacy<0>(session);
+        case 1:
+            return PaintSessionArrangeLegacy<1>(session);
+        case 2:
+            return PaintSessionArrangeLegacy<2>(session);
+        case 3:
+            return PaintSessionArrangeLegacy<3>(session);
+    }
+    Guard::Assert(false);
+}
+
+namespace
+{
+    /**
+     * Single paint struct with its sort state, used to hold entries while the arrange buffer is being reordered.
+     */
+    struct PaintArrangeEntry
+    {
+        paint_struct* Struct;
+        paint_struct_bound_box Bounds;
+        uint16_t QuadrantIndex;
+        uint8_t SortFlags;
+    };
+
+    /**
+     * The paint structs of a session laid out in draw order. The bounding box components are kept in separate arrays
+     * so the overlap tests of one struct against the ones that follow it run over consecutive memory.
+     */
+    struct PaintArrangeBuffer
+    {
+        std::vector<paint_struct*> Structs;
+        std::vector<int32_t> X;
+        std::vector<int32_t> Y;
+        std::vector<int32_t> Z;
+        std::vector<int32_t> XEnd;
+        std::vector<int32_t> YEnd;
+        std::vector<int32_t> ZEnd;
+        std::vector<uint16_t> QuadrantIndices;
+        std::vector<uint8_t> SortFlags;
+        std::vector<size_t> Matches;
+        std::vector<PaintArrangeEntry> MatchEntries;
+
+        size_t Size() const
+        {
+            return Structs.size();
+        }
+
+        void Clear()
+        {
+            Structs.clear();
+            X.clear();
+            Y.clear();
+            Z.clear();
+            XEnd.clear();
+            YEnd.clear();
+            ZEnd.clear();
+            QuadrantIndices.clear();
+            SortFlags.clear();
+        }
+
+        void Push(paint_struct* ps)
+        {
+            Structs.push_back(ps);
+            X.push_back(ps->bounds.x);
+            Y.push_back(ps->bounds.y);
+            Z.push_back(ps->bounds.z);
+            XEnd.push_back(ps->bounds.x_end);
+            YEnd.push_back(ps->bounds.y_end);
+            ZEnd.push_back(ps->bounds.z_end);
+            QuadrantIndices.push_back(ps->quadrant_index);
+            SortFlags.push_back(ps->SortFlags);
+        }
+
+        PaintArrangeEntry Get(size_t index) const
+        {
+            return { Structs[index],
+                     { X[index], Y[index], Z[index], XEnd[index], YEnd[index], ZEnd[index] },
+                     QuadrantIndices[index],
+                     SortFlags[index] };
+        }
+
+        void Set(size_t index, const PaintArrangeEntry& entry)
+        {
+            Structs[index] = entry.Struct;
+            X[index] = entry.Bounds.x;
+            Y[index] = entry.Bounds.y;
+            Z[index] = entry.Bounds.z;
+            XEnd[index] = entry.Bounds.x_end;
+            YEnd[index] = entry.Bounds.y_end;
+            ZEnd[index] = entry.Bounds.z_end;
+            QuadrantIndices[index] = entry.QuadrantIndex;
+            SortFlags[index] = entry.SortFlags;
+        }
+
+        void Copy(size_t dst, size_t src)
+        {
+            Set(dst, Get(src));
+        }
+    };
+} // namespace
+
+// Rotations 1 and 2 compare the x axis the other way round, rotations 2 and 3 the y axis, see CheckBoundingBox.
+template<uint8_t TRotation> static constexpr bool PaintSortFlipX = TRotation == 1 || TRotation == 2;
+template<uint8_t TRotation> static constexpr bool PaintSortFlipY = TRotation == 2 || TRotation == 3;
+
+/**
+ * Same test as CheckBoundingBox<TRotation>, reading the current bounding box from the arrange buffer.
+ */
+template<uint8_t TRotation>
+static bool CheckBoundingBoxAt(const paint_struct_bound_box& initialBBox, const PaintArrangeBuffer& buffer, size_t index)
+{
+    const bool xBehind = PaintSortFlipX<TRotation> ? initialBBox.x_end < buffer.X[index]
+                                                    : initialBBox.x_end >= buffer.X[index];
+    const bool yBehind = PaintSortFlipY<TRotation> ? initialBBox.y_end < buffer.Y[index]
+                                                    : initialBBox.y_end >= buffer.Y[index];
+    const bool xOverlap = PaintSortFlipX<TRotation> ? initialBBox.x >= buffer.XEnd[index]
+                                                     : initialBBox.x < buffer.XEnd[index];
+    const bool yOverlap = PaintSortFlipY<TRotation> ? initialBBox.y >= buffer.YEnd[index]
+                                                     : initialBBox.y < buffer.YEnd[index];
+    return initialBBox.z_end >= buffer.Z[index] && yBehind && xBehind
+        && !(initialBBox.z < buffer.ZEnd[index] && yOverlap && xOverlap);
+}
+
+/**
+ * Collects the indices in [begin, end) whose paint struct has to be drawn before the one with initialBBox.
+ */
+template<uint8_t TRotation>
+static void PaintArrangeFindMatches(
+    PaintArrangeBuffer& buffer, const paint_struct_bound_box& initialBBox, size_t begin, size_t end)
+{
+    buffer.Matches.clear();
+    size_t index = begin;
+#ifdef PAINT_SORT_SSE2
+    // Four bounding boxes per step. Every test is built from a greater than comparison and inverted where needed, which
+    // depends on whether the axis is flipped in this rotation.
+    const __m128i allSet = _mm_set1_epi32(-1);
+    const __m128i behindInvertX = PaintSortFlipX<TRotation> ? _mm_setzero_si128() : allSet;
+    const __m128i behindInvertY = PaintSortFlipY<TRotation> ? _mm_setzero_si128() : allSet;
+    const __m128i overlapInvertX = PaintSortFlipX<TRotation> ? allSet : _mm_setzero_si128();
+    const __m128i overlapInvertY = PaintSortFlipY<TRotation> ? allSet : _mm_setzero_si128();
+    const __m128i initialX = _mm_set1_epi32(initialBBox.x);
+    const __m128i initialY = _mm_set1_epi32(initialBBox.y);
+    const __m128i initialZ = _mm_set1_epi32(initialBBox.z);
+    const __m128i initialXEnd = _mm_set1_epi32(initialBBox.x_end);
+    const __m128i initialYEnd = _mm_set1_epi32(initialBBox.y_end);
+    const __m128i initialZEnd = _mm_set1_epi32(initialBBox.z_end);
+    for (; index + 4 <= end; index += 4)
+    {
+        const auto load = [index](const std::vector<int32_t>& values) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data() + index));
+        };
+
+        // initial.end >= current.start, or initial.end < current.start for a flipped axis.
+        const __m128i zBehind = _mm_xor_si128(_mm_cmpgt_epi32(load(buffer.Z), initialZEnd), allSet);
+        const __m128i yBehind = _mm_xor_si128(_mm_cmpgt_epi32(load(buffer.Y), initialYEnd), behindInvertY);
+        const __m128i xBehind = _mm_xor_si128(_mm_cmpgt_epi32(load(buffer.X), initialXEnd), behindInvertX);
+
+        // initial.start < current.end, or initial.start >= current.end for a flipped axis.
+        const __m128i zOverlap = _mm_cmpgt_epi32(load(buffer.ZEnd), initialZ);
+        const __m128i yOverlap = _mm_xor_si128(_mm_cmpgt_epi32(load(buffer.YEnd), initialY), overlapInvertY);
+        const __m128i xOverlap = _mm_xor_si128(_mm_cmpgt_epi32(load(buffer.XEnd), initialX), overlapInvertX);
+
+        const __m128i behind = _mm_and_si128(zBehind, _mm_and_si128(yBehind, xBehind));
+        const __m128i overlap = _mm_and_si128(zOverlap, _mm_and_si128(yOverlap, xOverlap));
+        int32_t mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(overlap, behind)));
+        while (mask != 0)
+        {
+            const size_t match = index + bitscanforward(mask);
+            if (buffer.SortFlags[match] & PaintSortFlags::Neighbour)
+            {
+                buffer.Matches.push_back(match);
+            }
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; index < end; index++)
+    {
+        if ((buffer.SortFlags[index] & PaintSortFlags::Neighbour) && CheckBoundingBoxAt<TRotation>(initialBBox, buffer, index))
+        {
+            buffer.Matches.push_back(index);
+        }
+    }
+}
+
+/**
+ * Arranges the structs of one quadrant against the ones of the next quadrant, reordering them exactly like
+ * PaintArrangeStructsHelperRotation does with the linked list. start is the first entry the previous call looked at
+ * and is advanced to the first entry of this quadrant.
+ */
+template<uint8_t TRotation>
+static void PaintArrangeQuadrant(PaintArrangeBuffer& buffer, size_t& start, uint16_t quadrantIndex, uint8_t flag)
+{
+    const size_t count = buffer.Size();
+    while (start < count && buffer.QuadrantIndices[start] < quadrantIndex)
+    {
+        start++;
+    }
+
+    // Determine the sorting relevancy of all entries up to and including the first one past the next quadrant.
+    for (size_t i = start; i < count; i++)
+    {
+        const auto entryQuadrant = buffer.QuadrantIndices[i];
+        if (entryQuadrant > quadrantIndex + 1)
+        {
+            buffer.SortFlags[i] = PaintSortFlags::OutsideQuadrant;
+            break;
+        }
+        if (entryQuadrant == quadrantIndex + 1)
+        {
+            buffer.SortFlags[i] = PaintSortFlags::Neighbour | PaintSortFlags::PendingVisit;
+        }
+        else if (entryQuadrant == quadrantIndex)
+        {
+            buffer.SortFlags[i] = flag | PaintSortFlags::PendingVisit;
+        }
+    }
+
+    size_t end = start;
+    while (end < count && !(buffer.SortFlags[end] & PaintSortFlags::OutsideQuadrant))
+    {
+        end++;
+    }
+
+    size_t cursor = start;
+    while (true)
+    {
+        while (cursor < end && !(buffer.SortFlags[cursor] & PaintSortFlags::PendingVisit))
+        {
+            cursor++;
+        }
+        if (cursor == end)
+            return;
+
+        buffer.SortFlags[cursor] &= ~PaintSortFlags::PendingVisit;
+
+        const paint_struct_bound_box initialBBox = { buffer.X[cursor],    buffer.Y[cursor],    buffer.Z[cursor],
+                                                     buffer.XEnd[cursor], buffer.YEnd[cursor], buffer.ZEnd[cursor] };
+        PaintArrangeFindMatches<TRotation>(buffer, initialBBox, cursor + 1, end);
+        if (buffer.Matches.empty())
+            continue;
+
+        // The linked list moves every match in front of the visited entry, the last one found ends up first. The
+        // other entries keep their order, everything past the last match stays in place.
+        auto& matchEntries = buffer.MatchEntries;
+        matchEntries.clear();
+        for (auto match : buffer.Matches)
+        {
+            matchEntries.push_back(buffer.Get(match));
+        }
+
+        size_t write = buffer.Matches.back();
+        size_t nextMatch = buffer.Matches.size();
+        for (size_t read = buffer.Matches.back(); read > cursor; read--)
+        {
+            if (nextMatch > 0 && buffer.Matches[nextMatch - 1] == read)
+            {
+                nextMatch--;
+                continue;
+            }
+            buffer.Copy(write--, read);
+        }
+        buffer.Copy(write, cursor);
+        for (size_t i = 0; i < matchEntries.size(); i++)
+        {
+            buffer.Set(cursor + i, matchEntries[matchEntries.size() - 1 - i]);
+        }
+    }
+}
+
+template<uint8_t TRotation> static void PaintSessionArrange(PaintSessionCore* session)
+{
+    thread_local PaintArrangeBuffer buffer;
+
+    paint_struct* psHead = &session->PaintHead;
+    psHead->next_quadrant_ps = nullptr;
+    if (session->QuadrantBackIndex == UINT32_MAX)
+        return;
+
+    buffer.Clear();
+    for (uint32_t quadrantIndex = session->QuadrantBackIndex; quadrantIndex <= session->QuadrantFrontIndex; quadrantIndex++)
+    {
+        for (auto* ps = session->Quadrants[quadrantIndex]; ps != nullptr; ps = ps->next_quadrant_ps)
+        {
+            buffer.Push(ps);
+        }
+    }
+
+    size_t start = 0;
+    PaintArrangeQuadrant<TRotation>(buffer, start, session->QuadrantBackIndex & 0xFFFF, PaintSortFlags::Neighbour);
+    for (uint32_t quadrantIndex = session->QuadrantBackIndex + 1; quadrantIndex < session->QuadrantFrontIndex; quadrantIndex++)
+    {
+        PaintArrangeQuadrant<TRotation>(buffer, start, quadrantIndex & 0xFFFF, PaintSortFlags::None);
+    }
+
+    // Relink the structs in their final order for PaintDrawStructs.
+    paint_struct* ps = psHead;
+    for (size_t i = 0; i < buffer.Size(); i++)
+    {
+        ps->next_quadrant_ps = buffer.Structs[i];
+        ps = ps->next_quadrant_ps;
+        ps->SortFlags = buffer.SortFlags[i];
+    }
+    ps->next_quadrant_ps = nullptr;
+}
+
 /**
  *
  *  rct2: 0x00688217
@@ -469,13 +791,13 @@ void PaintSessionArrange(PaintSessionCore* session)
     switch (session->CurrentRotation)
     {
         case 0:
-            return PaintSessionArrange<0>(session, true);
+            return PaintSessionArrange<0>(session);
         case 1:
-            return PaintSessionArrange<1>(session, true);
+            return PaintSessionArrange<1>(session);
         case 2:
-            return PaintSessionArrange<2>(session, true);
+            return PaintSessionArrange<2>(session);
         case 3:
-            return PaintSessionArrange<3>(session, true);
+            return PaintSessionArrange<3>(session);
     }
     Guard::Assert(false);
 }
@@ -511,13 +833,18 @@ static void PaintDrawStruct(paint_session* session, paint_struct* ps)
         PaintPSImage(dpi, ps, imageId, x, y);
     }
 
+    if (session->PickBits != nullptr)
+    {
+        viewport_pick_buffer_add_sprite(session, ps->image_id, { ps->x, ps->y }, ps);
+    }
+
     if (ps->children != nullptr)
     {
         PaintDrawStruct(session, ps->children);
     }
     else
     {
-        PaintAttachedPS(dpi, ps, session->ViewFlags);
+        PaintAttachedPS(session, ps);
     }
 }
 
@@ -542,14 +869,15 @@ void PaintDrawStructs(paint_session* session)
  *  rct2: 0x00688596
  *  Part of 0x688485
  */
-static void PaintAttachedPS(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t viewFlags)
+static void PaintAttachedPS(paint_session* session, paint_struct* ps)
 {
+    rct_drawpixelinfo* dpi = &session->DPI;
     attached_paint_struct* attached_ps = ps->attached_ps;
     for (; attached_ps != nullptr; attached_ps = attached_ps->next)
     {
         auto screenCoords = ScreenCoordsXY{ attached_ps->x + ps->x, attached_ps->y + ps->y };
 
-        uint32_t imageId = PaintPSColourifyImage(attached_ps->image_id, ps->sprite_type, viewFlags);
+        uint32_t imageId = PaintPSColourifyImage(attached_ps->image_id, ps->sprite_type, session->ViewFlags);
         if (attached_ps->flags & PAINT_STRUCT_FLAG_IS_MASKED)
         {
             gfx_draw_sprite_raw_masked(dpi, screenCoords, imageId, attached_ps->colour_image_id);
@@ -558,6 +886,11 @@ static void PaintAttachedPS(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t v
         {
             gfx_draw_sprite(dpi, imageId, screenCoords, ps->tertiary_colour);
         }
+
+        if (session->PickBits != nullptr)
+        {
+            viewport_pick_buffer_add_sprite(session, attached_ps->image_id, screenCoords, ps);
+        }
     }
 }
 
@@ -762,6 +1095,11 @@ paint_struct* PaintAddImageAsParent(
     session->LastAttachedPS = nullptr;
 
     auto* ps = CreateNormalPaintStruct(session, image_id, offset, boundBoxSize, boundBoxOffset);
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->AddStruct(PaintTileRecorder::CommandType::Parent, ps);
+        return ps;
+    }
     if (ps == nullptr)
     {
         return nullptr;
@@ -796,6 +1134,11 @@ paint_struct* PaintAddImageAsParent(
 {
     session->LastPS = nullptr;
     session->LastAttachedPS = nullptr;
+    if (session->TileRecorder != nullptr)
+    {
+        // Orphans are linked up by the caller, which a replay can not follow.
+        session->TileRecorder->Failed = true;
+    }
 
     CoordsXYZ offset = { x_offset, y_offset, z_offset };
     CoordsXYZ boundBoxSize = { bound_box_length_x, bound_box_length_y, bound_box_length_z };
@@ -831,6 +1174,11 @@ paint_struct* PaintAddImageAsChild(
     paint_session* session, uint32_t image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxLength,
     const CoordsXYZ& boundBoxOffset)
 {
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->CheckHasParent();
+    }
+
     paint_struct* parentPS = session->LastPS;
     if (parentPS == nullptr)
     {
@@ -838,6 +1186,10 @@ paint_struct* PaintAddImageAsChild(
     }
 
     auto* ps = CreateNormalPaintStruct(session, image_id, offset, boundBoxLength, boundBoxOffset);
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->AddStruct(PaintTileRecorder::CommandType::Child, ps);
+    }
     if (ps == nullptr)
     {
         return nullptr;
@@ -868,6 +1220,11 @@ paint_struct* PaintAddImageAsChild(
  */
 bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int32_t x, int32_t y)
 {
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->CheckHasParent();
+    }
+
     auto* previousAttachedPS = session->LastAttachedPS;
     if (previousAttachedPS == nullptr)
     {
@@ -875,6 +1232,10 @@ bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int3
     }
 
     auto* ps = session->AllocateAttachedPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->AddAttached(PaintTileRecorder::CommandType::AttachToAttach, ps);
+    }
     if (ps == nullptr)
     {
         return false;
@@ -901,6 +1262,11 @@ bool PaintAttachToPreviousAttach(paint_session* session, uint32_t image_id, int3
  */
 bool PaintAttachToPreviousPS(paint_session* session, uint32_t image_id, int32_t x, int32_t y)
 {
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->CheckHasParent();
+    }
+
     auto* masterPs = session->LastPS;
     if (masterPs == nullptr)
     {
@@ -908,6 +1274,10 @@ bool PaintAttachToPreviousPS(paint_session* session, uint32_t image_id, int32_t
     }
 
     auto* ps = session->AllocateAttachedPaintEntry();
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->AddAttached(PaintTileRecorder::CommandType::AttachToPS, ps);
+    }
     if (ps == nullptr)
     {
         return false;
@@ -939,6 +1309,11 @@ void PaintFloatingMoneyEffect(
     paint_session* session, money64 amount, rct_string_id string_id, int32_t y, int32_t z, int8_t y_offsets[], int32_t offset_x,
     uint32_t rotation)
 {
+    if (session->TileRecorder != nullptr)
+    {
+        session->TileRecorder->Failed = true;
+    }
+
     auto* ps = session->AllocateStringPaintEntry();
     if (ps == nullptr)
     {
@@ -1033,12 +1408,15 @@ paint_entry* PaintEntryPool::Chain::Allocate()
     }
     else if (Current->Count >= NodeSize)
     {
-        // We need another node
-        Current->Next = Pool->AllocateNode();
+        // We need another node, the ones kept by Reset come first
         if (Current->Next == nullptr)
         {
-            // Unable to allocate any more nodes
-            return nullptr;
+            Current->Next = Pool->AllocateNode();
+            if (Current->Next == nullptr)
+            {
+                // Unable to allocate any more nodes
+                return nullptr;
+            }
         }
         Current = Current->Next;
     }
@@ -1059,6 +1437,30 @@ void PaintEntryPool::Chain::Clear()
     assert(Current == nullptr);
 }
 
+void PaintEntryPool::Chain::Reset()
+{
+    if (Head == nullptr)
+        return;
+
+    // Nodes are filled in order, the first empty one is where the last use stopped.
+    Node* lastUsed = Head;
+    while (lastUsed->Next != nullptr && lastUsed->Next->Count != 0)
+    {
+        lastUsed = lastUsed->Next;
+    }
+    if (lastUsed->Next != nullptr)
+    {
+        Pool->FreeNodes(lastUsed->Next);
+        lastUsed->Next = nullptr;
+    }
+
+    for (auto* node = Head; node != nullptr; node = node->Next)
+    {
+        node->Count = 0;
+    }
+    Current = Head;
+}
+
 size_t PaintEntryPool::Chain::GetCount() const
 {
     size_t count = 0;
@@ -1089,10 +1491,19 @@ PaintEntryPool::Node* PaintEntryPool::AllocateNode()
     {
         result = _available.back();
         _available.pop_back();
+        _minAvailable = std::min(_minAvailable, _available.size());
+        _nodeRequests++;
     }
     else
     {
         result = new (std::nothrow) PaintEntryPool::Node();
+        if (result != nullptr)
+        {
+            _minAvailable = 0;
+            _nodeCount++;
+            _peakNodeCount = std::max(_peakNodeCount, _nodeCount);
+            _nodeAllocations++;
+        }
     }
     return result;
 }
@@ -1116,3 +1527,30 @@ void PaintEntryPool::FreeNodes(PaintEntryPool::Node* head)
         node = next;
     }
 }
+
+PaintEntryPool::Stats PaintEntryPool::GetStats()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return { _nodeCount, _peakNodeCount, _nodeAllocations, _nodeRequests };
+}
+
+void PaintEntryPool::EndFrame()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _nodeAllocations = 0;
+    _nodeRequests = 0;
+}
+
+void PaintEntryPool::Trim()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    const auto unused = std::min(_minAvailable, _available.size());
+    for (size_t i = 0; i < unused; i++)
+    {
+        delete _available.back();
+        _available.pop_back();
+    }
+    _nodeCount -= unused;
+    _minAvailable = _available.size();
+}
@@ -19,6 +19,7 @@
 #include <mutex>
 #include <thread>
 
+struct PaintTileRecorder;
 struct TileElement;
 enum class RailingEntrySupportType : uint8_t;
 enum class ViewportInteractionItem : uint8_t;
@@ -155,12 +156,30 @@ public:
 
         paint_entry* Allocate();
         void Clear();
+        /**
+         * Empties the chain for the next use. The nodes that held entries are kept, the ones past them go back
+         * to the pool, so the chain keeps the size the last use needed.
+         */
+        void Reset();
         size_t GetCount() const;
     };
 
+    struct Stats
+    {
+        size_t NodeCount;       // Nodes owned by the pool and its chains
+        size_t PeakNodeCount;   // Highest NodeCount so far
+        size_t NodeAllocations; // Nodes created since the last EndFrame
+        size_t NodeRequests;    // Nodes reused from the pool since the last EndFrame
+    };
+
 private:
     std::vector<Node*> _available;
     std::mutex _mutex;
+    size_t _nodeCount{};
+    size_t _peakNodeCount{};
+    size_t _nodeAllocations{};
+    size_t _nodeRequests{};
+    size_t _minAvailable{};
 
     Node* AllocateNode();
 
@@ -169,6 +188,16 @@ public:
 
     Chain Create();
     void FreeNodes(Node* head);
+    Stats GetStats();
+
+    // Resets the per frame counters of the statistics.
+    void EndFrame();
+
+    /**
+     * Deletes the free nodes that were not needed at any point since the last call, so the pool shrinks back
+     * after a while of needing fewer entries than before.
+     */
+    void Trim();
 };
 
 struct PaintSessionCore
@@ -209,6 +238,14 @@ struct paint_session : public PaintSessionCore
     rct_drawpixelinfo DPI;
     PaintEntryPool::Chain PaintEntryChain;
 
+    // Interaction records of the pixels covered by DPI, written alongside drawing when the viewport keeps a pick
+    // buffer. PickPitch is the distance between rows.
+    uint64_t* PickBits;
+    int32_t PickPitch;
+
+    // Set while the paint calls of a tile are recorded for the tile cache.
+    PaintTileRecorder* TileRecorder;
+
     paint_struct* AllocateNormalPaintEntry() noexcept
     {
         auto* entry = PaintEntryChain.Allocate();
@@ -283,6 +320,7 @@ extern bool gShowDirtyVisuals;
 extern bool gPaintBoundingBoxes;
 extern bool gPaintBlockedTiles;
 extern bool gPaintWidePathsAsGhost;
+extern bool gShowPaintSessionStats;
 
 paint_struct* PaintAddImageAsParent(
     paint_session* session, uint32_t image_id, const CoordsXYZ& offset, const CoordsXYZ& boundBoxSize);
@@ -333,7 +371,11 @@ void PaintFloatingMoneyEffect(
 paint_session* PaintSessionAlloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void PaintSessionFree(paint_session* session);
 void PaintSessionGenerate(paint_session* session);
+void PaintSessionAddPSToQuadrant(paint_session* session, paint_struct* ps);
 void PaintSessionArrange(PaintSessionCore* session);
+// Arranges the session by walking the quadrant lists like RCT2 does. Gives the same order as PaintSessionArrange,
+// kept as a reference for tests and benchmarks.
+void PaintSessionArrangeLegacy(PaintSessionCore* session);
 void PaintDrawStructs(paint_session* session);
 void PaintDrawMoneyStructs(rct_drawpixelinfo* dpi, paint_string_struct* ps);
 
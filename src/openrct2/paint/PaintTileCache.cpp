@@ -0,0 +1,586 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintTileCache.h"
+
+#include "../Cheats.h"
+#include "../Diagnostic.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/Drawing.h"
+#include "../peep/Staff.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Banner.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "../world/Scenery.h"
+#include "../world/SmallScenery.h"
+#include "../world/TileInspector.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+static_assert(MAXIMUM_MAP_SIZE_TECHNICAL <= 256, "Tile coordinates must fit the 8 bits they get in the cache key");
+
+bool gPaintTileCacheVerify;
+
+struct PaintTileStruct
+{
+    // Copy of the struct with its links cleared, the tile element is replaced by ElementIndex.
+    paint_struct Struct;
+    ScreenRect ImageBounds;
+    int16_t ElementIndex;
+};
+
+struct PaintTileRecording
+{
+    uint32_t Generation{};
+    uint32_t Version{};
+    // Tiles with animated or otherwise changing elements are remembered as such, so they are not checked every frame.
+    bool Cacheable{};
+    // The wooden supports of paths and scenery join the struct set by the last ride, the recording assumes none.
+    bool NeedsNoSupportsPrepend{};
+    bool Completed{};
+    int16_t SurfaceIndex = -1;
+    std::vector<PaintTileRecorder::Command> Commands;
+    std::vector<PaintTileStruct> Structs;
+    std::vector<attached_paint_struct> Attached;
+};
+
+struct PaintTileCacheEntry
+{
+    std::shared_ptr<const PaintTileRecording> Recording;
+    std::list<uint64_t>::iterator LruPosition;
+};
+
+// State outside of the tile elements that changes what the elements paint.
+struct PaintTileGlobalState
+{
+    uint8_t ClipHeight;
+    CoordsXY ClipSelectionA;
+    CoordsXY ClipSelectionB;
+    uint8_t ScreenFlags;
+    bool CheatsSandboxMode;
+    int32_t MapBaseZ;
+    bool PaintWidePathsAsGhost;
+    bool LandscapeSmoothing;
+    bool TransparentWater;
+    const TileElement* InspectorSelection;
+    std::vector<PeepSpawn> PeepSpawns;
+};
+
+// Bytes per recording on top of its vectors, for the list and map nodes.
+static constexpr size_t EntryOverhead = sizeof(PaintTileRecording) + 96;
+
+// Bumped when tiles change and read by the paint workers, so the counters are atomic. Relaxed ordering is enough as
+// the tile elements themselves are not changed while a frame is painted.
+static std::array<std::atomic<uint32_t>, MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL> _tileVersions;
+
+static std::mutex _mutex;
+static std::unordered_map<uint64_t, PaintTileCacheEntry> _entries;
+// Most recently used first.
+static std::list<uint64_t> _lru;
+static size_t _usedBytes;
+static uint32_t _generation;
+static PaintTileGlobalState _globalState;
+
+void PaintTileRecorder::AddStruct(CommandType type, paint_struct* ps)
+{
+    HasParent = true;
+    int16_t index = -1;
+    if (ps != nullptr)
+    {
+        index = static_cast<int16_t>(Structs.size());
+        const auto* g1 = gfx_get_g1_element(ps->image_id & 0x7FFFF);
+        const auto left = ps->x + g1->x_offset;
+        const auto top = ps->y + g1->y_offset;
+        Structs.push_back(ps);
+        ImageBounds.push_back({ { left, top }, { left + g1->width, top + g1->height } });
+    }
+    Commands.push_back({ type, index });
+}
+
+void PaintTileRecorder::AddAttached(CommandType type, attached_paint_struct* attached)
+{
+    if (attached == nullptr)
+    {
+        Failed = true;
+        return;
+    }
+    Commands.push_back({ type, static_cast<int16_t>(Attached.size()) });
+    Attached.push_back(attached);
+}
+
+void PaintTileRecorder::CheckHasParent()
+{
+    if (!HasParent)
+    {
+        Failed = true;
+    }
+}
+
+static size_t GetTileOffset(const TileCoordsXY& tilePos)
+{
+    return static_cast<size_t>(tilePos.x) * MAXIMUM_MAP_SIZE_TECHNICAL + tilePos.y;
+}
+
+static uint64_t GetKey(const paint_session& session, const TileCoordsXY& tilePos)
+{
+    const uint64_t zoom = static_cast<uint8_t>(static_cast<int8_t>(session.DPI.zoom_level));
+    return (static_cast<uint64_t>(session.ViewFlags) << 32) | (zoom << 24)
+        | (static_cast<uint64_t>(session.CurrentRotation) << 16) | (tilePos.x << 8) | tilePos.y;
+}
+
+static size_t GetEntrySize(const PaintTileRecording& recording)
+{
+    return recording.Commands.capacity() * sizeof(PaintTileRecorder::Command)
+        + recording.Structs.capacity() * sizeof(PaintTileStruct)
+        + recording.Attached.capacity() * sizeof(attached_paint_struct) + EntryOverhead;
+}
+
+static size_t GetBudget()
+{
+    return static_cast<size_t>(std::max(0, gConfigGeneral.paint_tile_cache_size)) * 1024 * 1024;
+}
+
+static void RemoveEntry(std::unordered_map<uint64_t, PaintTileCacheEntry>::iterator it)
+{
+    _usedBytes -= GetEntrySize(*it->second.Recording);
+    _lru.erase(it->second.LruPosition);
+    _entries.erase(it);
+}
+
+static void ClearEntries()
+{
+    _entries.clear();
+    _lru.clear();
+    _usedBytes = 0;
+}
+
+static bool IsGlobalStateCurrent()
+{
+    const auto& state = _globalState;
+    return state.ClipHeight == gClipHeight && state.ClipSelectionA == gClipSelectionA
+        && state.ClipSelectionB == gClipSelectionB && state.ScreenFlags == gScreenFlags
+        && state.CheatsSandboxMode == gCheatsSandboxMode && state.MapBaseZ == gMapBaseZ
+        && state.PaintWidePathsAsGhost == gPaintWidePathsAsGhost
+        && state.LandscapeSmoothing == gConfigGeneral.landscape_smoothing
+        && state.TransparentWater == gConfigGeneral.transparent_water
+        && state.InspectorSelection == OpenRCT2::TileInspector::GetSelectedElement() && state.PeepSpawns == gPeepSpawns;
+}
+
+void PaintTileCacheBeginSession()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (IsGlobalStateCurrent())
+        return;
+
+    _globalState = { gClipHeight,
+                     gClipSelectionA,
+                     gClipSelectionB,
+                     gScreenFlags,
+                     gCheatsSandboxMode,
+                     gMapBaseZ,
+                     gPaintWidePathsAsGhost,
+                     gConfigGeneral.landscape_smoothing,
+                     gConfigGeneral.transparent_water,
+                     OpenRCT2::TileInspector::GetSelectedElement(),
+                     gPeepSpawns };
+    _generation++;
+    ClearEntries();
+}
+
+/**
+ * Checks the state that only concerns some tiles or is expected to change while it is shown, such tiles are painted
+ * the regular way.
+ */
+static bool IsTileCacheable(const paint_session& session)
+{
+    if (session.TileRecorder != nullptr || (session.Unk141E9DB & PaintSessionFlags::IsTrackPiecePreview))
+        return false;
+
+    // The support heights overlay reads the support state the paint calls leave behind.
+    if (gShowSupportSegmentHeights || gPaintBlockedTiles || gTrackDesignSaveMode
+        || gStaffDrawPatrolAreas != SPRITE_INDEX_NULL)
+        return false;
+
+    if (gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_CONSTRUCT)
+        return false;
+    if (gMapSelectFlags & MAP_SELECT_FLAG_ENABLE)
+    {
+        const auto& pos = session.MapPosition;
+        if (pos.x >= gMapSelectPositionA.x && pos.x <= gMapSelectPositionB.x && pos.y >= gMapSelectPositionA.y
+            && pos.y <= gMapSelectPositionB.y)
+            return false;
+    }
+    return true;
+}
+
+bool PaintTileCacheIsEntryCacheable(const SmallSceneryEntry& entry)
+{
+    return !entry.HasFlag(SMALL_SCENERY_FLAG_ANIMATED);
+}
+
+bool PaintTileCacheIsEntryCacheable(const LargeSceneryEntry& entry)
+{
+    return !(entry.flags & (LARGE_SCENERY_FLAG_ANIMATED | LARGE_SCENERY_FLAG_3D_TEXT))
+        && entry.scrolling_mode == SCROLLING_MODE_NONE;
+}
+
+bool PaintTileCacheIsEntryCacheable(const WallSceneryEntry& entry)
+{
+    // Doors open and close without a change to the element.
+    return !(entry.flags & WALL_SCENERY_IS_DOOR) && !(entry.flags2 & WALL_SCENERY_2_ANIMATED)
+        && entry.scrolling_mode == SCROLLING_MODE_NONE;
+}
+
+template<typename TEntry> static bool IsEntryCacheable(const TEntry* entry)
+{
+    return entry == nullptr || PaintTileCacheIsEntryCacheable(*entry);
+}
+
+bool PaintTileCacheIsElementCacheable(const TileElement& element)
+{
+    switch (element.GetType())
+    {
+        case TILE_ELEMENT_TYPE_SURFACE:
+            return true;
+        case TILE_ELEMENT_TYPE_PATH:
+        {
+            // Queue banners scroll the name of the ride.
+            const auto* path = element.AsPath();
+            return !path->IsQueue() || !path->HasQueueBanner();
+        }
+        case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+            return IsEntryCacheable(element.AsSmallScenery()->GetEntry());
+        case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+            return IsEntryCacheable(element.AsLargeScenery()->GetEntry());
+        case TILE_ELEMENT_TYPE_WALL:
+            return IsEntryCacheable(element.AsWall()->GetEntry());
+        default:
+            // Track, entrances and banners are animated or show text, corrupt elements change what follows them.
+            return false;
+    }
+}
+
+static int16_t GetElementIndex(const TileElement* firstElement, const void* element)
+{
+    if (element == nullptr)
+        return -1;
+    return static_cast<int16_t>(static_cast<const TileElement*>(element) - firstElement);
+}
+
+static std::shared_ptr<const PaintTileRecording> Record(
+    paint_session* session, const TileElement* tileElement, PaintTileElementsFunc paintElements, uint32_t generation,
+    uint32_t version)
+{
+    auto recording = std::make_shared<PaintTileRecording>();
+    recording->Generation = generation;
+    recording->Version = version;
+
+    const auto* element = tileElement;
+    do
+    {
+        if (!PaintTileCacheIsElementCacheable(*element))
+            return recording;
+        auto type = element->GetType();
+        if (type == TILE_ELEMENT_TYPE_PATH || type == TILE_ELEMENT_TYPE_SMALL_SCENERY
+            || type == TILE_ELEMENT_TYPE_LARGE_SCENERY)
+        {
+            recording->NeedsNoSupportsPrepend = true;
+        }
+    } while (!(element++)->IsLastForTile());
+
+    // The recording pass runs on the session the tile is painted on afterwards, its state is put back once done. The
+    // structs it allocates stay unused until the session is reset.
+    const PaintSessionCore savedState = *session;
+    PaintTileRecorder recorder;
+    recorder.FirstElement = tileElement;
+    session->TileRecorder = &recorder;
+    session->LastPS = nullptr;
+    session->LastAttachedPS = nullptr;
+    session->SurfaceElement = nullptr;
+    session->WoodenSupportsPrependTo = nullptr;
+    recording->Completed = paintElements(session, tileElement);
+    recording->SurfaceIndex = GetElementIndex(tileElement, session->SurfaceElement);
+    session->TileRecorder = nullptr;
+    static_cast<PaintSessionCore&>(*session) = savedState;
+
+    if (recorder.Failed)
+        return recording;
+
+    recording->Commands = std::move(recorder.Commands);
+    recording->Structs.reserve(recorder.Structs.size());
+    for (size_t i = 0; i < recorder.Structs.size(); i++)
+    {
+        auto ps = *recorder.Structs[i];
+        ps.attached_ps = nullptr;
+        ps.children = nullptr;
+        ps.next_quadrant_ps = nullptr;
+        ps.tileElement = nullptr;
+        auto elementIndex = GetElementIndex(tileElement, recorder.Structs[i]->tileElement);
+        recording->Structs.push_back({ ps, recorder.ImageBounds[i], elementIndex });
+    }
+    recording->Attached.reserve(recorder.Attached.size());
+    for (auto* attached : recorder.Attached)
+    {
+        auto& copy = recording->Attached.emplace_back(*attached);
+        copy.next = nullptr;
+    }
+    recording->Cacheable = true;
+    return recording;
+}
+
+static bool IsWithinDPI(const ScreenRect& bounds, const rct_drawpixelinfo& dpi)
+{
+    return bounds.GetRight() > dpi.x && bounds.GetBottom() > dpi.y && bounds.GetLeft() < dpi.x + dpi.width
+        && bounds.GetTop() < dpi.y + dpi.height;
+}
+
+static TileElement* GetElement(const TileElement* firstElement, int16_t index)
+{
+    return index < 0 ? nullptr : const_cast<TileElement*>(firstElement + index);
+}
+
+/**
+ * Replays the paint calls with the same rules PaintAddImageAsParent, PaintAddImageAsChild and the attach functions
+ * follow, so images outside the DPI are dropped and what follows them is attached the same way as when painting.
+ */
+static void Replay(paint_session* session, const PaintTileRecording& recording, const TileElement* firstElement)
+{
+    using CommandType = PaintTileRecorder::CommandType;
+
+    for (const auto& command : recording.Commands)
+    {
+        switch (command.Type)
+        {
+            case CommandType::Parent:
+            case CommandType::Child:
+            {
+                auto* parentPS = session->LastPS;
+                const bool isParent = command.Type == CommandType::Parent || parentPS == nullptr;
+                if (isParent)
+                {
+                    session->LastPS = nullptr;
+                    session->LastAttachedPS = nullptr;
+                }
+                if (command.Index < 0)
+                    break;
+
+                const auto& recorded = recording.Structs[command.Index];
+                if (!IsWithinDPI(recorded.ImageBounds, session->DPI))
+                    break;
+
+                auto* ps = session->AllocateNormalPaintEntry();
+                if (ps == nullptr)
+                    break;
+
+                *ps = recorded.Struct;
+                ps->tileElement = GetElement(firstElement, recorded.ElementIndex);
+                if (isParent)
+                {
+                    PaintSessionAddPSToQuadrant(session, ps);
+                }
+                else
+                {
+                    parentPS->children = ps;
+                }
+                break;
+            }
+            case CommandType::AttachToPS:
+            case CommandType::AttachToAttach:
+            {
+                auto* previousAttachedPS = session->LastAttachedPS;
+                auto* masterPS = session->LastPS;
+                const bool toPS = command.Type == CommandType::AttachToPS || previousAttachedPS == nullptr;
+                if (toPS && masterPS == nullptr)
+                    break;
+
+                auto* attached = session->AllocateAttachedPaintEntry();
+                if (attached == nullptr)
+                    break;
+
+                *attached = recording.Attached[command.Index];
+                if (toPS)
+                {
+                    attached->next = masterPS->attached_ps;
+                    masterPS->attached_ps = attached;
+                }
+                else
+                {
+                    previousAttachedPS->next = attached;
+                }
+                break;
+            }
+        }
+    }
+
+    if (recording.SurfaceIndex >= 0)
+    {
+        session->SurfaceElement = firstElement + recording.SurfaceIndex;
+    }
+}
+
+static bool StructsMatch(const PaintTileStruct& a, const PaintTileStruct& b)
+{
+    const auto& psA = a.Struct;
+    const auto& psB = b.Struct;
+    return a.ElementIndex == b.ElementIndex && a.ImageBounds.GetLeft() == b.ImageBounds.GetLeft()
+        && a.ImageBounds.GetTop() == b.ImageBounds.GetTop() && a.ImageBounds.GetRight() == b.ImageBounds.GetRight()
+        && a.ImageBounds.GetBottom() == b.ImageBounds.GetBottom() && psA.image_id == psB.image_id
+        && psA.colour_image_id == psB.colour_image_id && psA.x == psB.x && psA.y == psB.y && psA.map_x == psB.map_x
+        && psA.map_y == psB.map_y && psA.flags == psB.flags && psA.sprite_type == psB.sprite_type
+        && psA.bounds.x == psB.bounds.x && psA.bounds.y == psB.bounds.y && psA.bounds.z == psB.bounds.z
+        && psA.bounds.x_end == psB.bounds.x_end && psA.bounds.y_end == psB.bounds.y_end
+        && psA.bounds.z_end == psB.bounds.z_end;
+}
+
+static bool AttachedMatch(const attached_paint_struct& a, const attached_paint_struct& b)
+{
+    return a.image_id == b.image_id && a.colour_image_id == b.colour_image_id && a.x == b.x && a.y == b.y
+        && a.flags == b.flags;
+}
+
+static bool RecordingsMatch(const PaintTileRecording& a, const PaintTileRecording& b)
+{
+    if (a.Cacheable != b.Cacheable || a.Completed != b.Completed || a.SurfaceIndex != b.SurfaceIndex
+        || a.Commands.size() != b.Commands.size() || a.Structs.size() != b.Structs.size()
+        || a.Attached.size() != b.Attached.size())
+        return false;
+
+    for (size_t i = 0; i < a.Commands.size(); i++)
+    {
+        if (a.Commands[i].Type != b.Commands[i].Type || a.Commands[i].Index != b.Commands[i].Index)
+            return false;
+    }
+    for (size_t i = 0; i < a.Structs.size(); i++)
+    {
+        if (!StructsMatch(a.Structs[i], b.Structs[i]))
+            return false;
+    }
+    for (size_t i = 0; i < a.Attached.size(); i++)
+    {
+        if (!AttachedMatch(a.Attached[i], b.Attached[i]))
+            return false;
+    }
+    return true;
+}
+
+// Also returns the generation new recordings of the tile are made for.
+static std::shared_ptr<const PaintTileRecording> Find(uint64_t key, uint32_t version, uint32_t& generation)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    generation = _generation;
+    auto it = _entries.find(key);
+    if (it == _entries.end())
+        return nullptr;
+
+    const auto& recording = it->second.Recording;
+    if (recording->Version != version || recording->Generation != _generation)
+    {
+        RemoveEntry(it);
+        return nullptr;
+    }
+    _lru.splice(_lru.begin(), _lru, it->second.LruPosition);
+    return recording;
+}
+
+static void Store(uint64_t key, const std::shared_ptr<const PaintTileRecording>& recording, size_t budget)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    // The cache may have been cleared while the tile was recorded.
+    if (recording->Generation != _generation)
+        return;
+
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+    {
+        RemoveEntry(it);
+    }
+    _lru.push_front(key);
+    _entries.emplace(key, PaintTileCacheEntry{ recording, _lru.begin() });
+    _usedBytes += GetEntrySize(*recording);
+    while (_usedBytes > budget && !_lru.empty())
+    {
+        RemoveEntry(_entries.find(_lru.back()));
+    }
+}
+
+bool PaintTileCachePaintElements(paint_session* session, const TileElement* tileElement, PaintTileElementsFunc paintElements)
+{
+    const auto budget = GetBudget();
+    if (budget == 0 || !IsTileCacheable(*session))
+        return paintElements(session, tileElement);
+
+    const auto tilePos = TileCoordsXY(session->MapPosition);
+    const auto key = GetKey(*session, tilePos);
+    const auto version = _tileVersions[GetTileOffset(tilePos)].load(std::memory_order_relaxed);
+
+    uint32_t generation;
+    auto recording = Find(key, version, generation);
+    if (recording == nullptr)
+    {
+        recording = Record(session, tileElement, paintElements, generation, version);
+        Store(key, recording, budget);
+    }
+    else if (gPaintTileCacheVerify && recording->Cacheable)
+    {
+        auto fresh = Record(session, tileElement, paintElements, generation, version);
+        if (!RecordingsMatch(*recording, *fresh))
+        {
+            log_warning("Paint tile cache: recording of tile %d, %d is out of date", tilePos.x, tilePos.y);
+            Store(key, fresh, budget);
+        }
+        recording = fresh;
+    }
+
+    if (!recording->Cacheable || (recording->NeedsNoSupportsPrepend && session->WoodenSupportsPrependTo != nullptr))
+        return paintElements(session, tileElement);
+
+    Replay(session, *recording, tileElement);
+    return recording->Completed;
+}
+
+void PaintTileCacheInvalidateTile(const CoordsXY& loc)
+{
+    if (!map_is_location_valid(loc))
+        return;
+    _tileVersions[GetTileOffset(TileCoordsXY(loc))].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PaintTileCacheInvalidateRange(const CoordsXY& mins, const CoordsXY& maxs)
+{
+    const auto tileMin = TileCoordsXY(mins);
+    const auto tileMax = TileCoordsXY(maxs);
+    for (int32_t x = std::max(0, tileMin.x); x <= std::min(tileMax.x, MAXIMUM_MAP_SIZE_TECHNICAL - 1); x++)
+    {
+        for (int32_t y = std::max(0, tileMin.y); y <= std::min(tileMax.y, MAXIMUM_MAP_SIZE_TECHNICAL - 1); y++)
+        {
+            _tileVersions[GetTileOffset({ x, y })].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void PaintTileCacheReset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _generation++;
+    ClearEntries();
+}
+
+size_t PaintTileCacheGetUsedBytes()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usedBytes;
+}
@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "Paint.h"
+
+#include <vector>
+
+struct LargeSceneryEntry;
+struct SmallSceneryEntry;
+struct TileElement;
+struct WallSceneryEntry;
+
+/**
+ * Collects the paint calls made while painting the elements of one tile. Images are not culled against the DPI
+ * while recording, the cull happens when the recording is replayed, so one recording serves every DPI of the
+ * viewport that shows the tile.
+ */
+struct PaintTileRecorder
+{
+    enum class CommandType : uint8_t
+    {
+        Parent,
+        Child,
+        AttachToPS,
+        AttachToAttach,
+    };
+
+    struct Command
+    {
+        CommandType Type;
+        // Index into Structs or Attached, -1 for a parent or child whose image does not exist.
+        int16_t Index;
+    };
+
+    const TileElement* FirstElement{};
+    std::vector<Command> Commands;
+    std::vector<paint_struct*> Structs;
+    // Screen area of the image of each struct, taken before the caller can change the image.
+    std::vector<ScreenRect> ImageBounds;
+    std::vector<attached_paint_struct*> Attached;
+    bool HasParent{};
+    // Set for paint calls the replay cannot reproduce, the recording is dropped.
+    bool Failed{};
+
+    void AddStruct(CommandType type, paint_struct* ps);
+    void AddAttached(CommandType type, attached_paint_struct* attached);
+    // Children and attachments made before the first parent of the tile would hang off whatever was painted before.
+    void CheckHasParent();
+};
+
+// Paints the elements of a tile starting at tileElement, returns false if a corrupt element stopped the painting.
+using PaintTileElementsFunc = bool (*)(paint_session* session, const TileElement* tileElement);
+
+/**
+ * Paints the elements of the tile at session->MapPosition. Tiles that only hold static terrain, paths and scenery
+ * are replayed from the recording of an earlier frame if nothing on or next to the tile has changed since, anything
+ * else is painted by paintElements.
+ */
+bool PaintTileCachePaintElements(paint_session* session, const TileElement* tileElement, PaintTileElementsFunc paintElements);
+
+/**
+ * Checks the global state tile painting depends on and drops all recordings when it changed. Called at the start
+ * of each paint session.
+ */
+void PaintTileCacheBeginSession();
+
+/**
+ * Marks the recordings of the tile as stale. Recordings of neighbouring tiles also read the tile, e.g. for surface
+ * edges, use PaintTileCacheInvalidateRange for changes they can see.
+ */
+void PaintTileCacheInvalidateTile(const CoordsXY& loc);
+void PaintTileCacheInvalidateRange(const CoordsXY& mins, const CoordsXY& maxs);
+
+// Whether tiles holding the element can be replayed, the entry overloads decide for the scenery elements.
+bool PaintTileCacheIsElementCacheable(const TileElement& element);
+bool PaintTileCacheIsEntryCacheable(const SmallSceneryEntry& entry);
+bool PaintTileCacheIsEntryCacheable(const LargeSceneryEntry& entry);
+bool PaintTileCacheIsEntryCacheable(const WallSceneryEntry& entry);
+
+// Drops all recordings, needed when the tile elements are replaced wholesale.
+void PaintTileCacheReset();
+size_t PaintTileCacheGetUsedBytes();
+
+// Paints every tile that has a recording afresh as well and reports the tiles where the two differ.
+extern bool gPaintTileCacheVerify;
@@ -25,11 +25,17 @@
 #include "../title/TitleScreen.h"
 #include "../ui/UiContext.h"
 
+#include <algorithm>
+#include <cstdio>
+
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Paint;
 using namespace OpenRCT2::Ui;
 
+// Frames between releasing the paint sessions and entry nodes that were not needed in the meantime.
+static constexpr uint32_t TrimInterval = 256;
+
 Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
     : _uiContext(uiContext)
 {
@@ -77,7 +83,13 @@ void Painter::Paint(IDrawingEngine& de)
     {
         PaintFPS(dpi);
     }
+    if (gShowPaintSessionStats)
+    {
+        PaintSessionStats(dpi);
+    }
     gCurrentDrawCount++;
+
+    EndFrame();
 }
 
 void Painter::PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text)
@@ -115,6 +127,76 @@ void Painter::PaintFPS(rct_drawpixelinfo* dpi)
     gfx_set_dirty_blocks({ { screenCoords - ScreenCoordsXY{ 16, 4 } }, { dpi->lastStringPos.x + 16, 16 } });
 }
 
+void Painter::PaintSessionStats(rct_drawpixelinfo* dpi)
+{
+    const auto poolStats = _paintStructPool.GetStats();
+    const auto memoryUsage = GetMemoryUsage(poolStats);
+    _peakMemory = std::max(_peakMemory, memoryUsage);
+
+    char lines[3][128]{};
+    snprintf(
+        lines[0], sizeof(lines[0]), "Paint sessions: %zu (peak in use %zu)", _paintSessionPool.size(), _peakSessionsInUse);
+    snprintf(
+        lines[1], sizeof(lines[1]), "Paint memory: %zu KiB (peak %zu KiB)", memoryUsage / 1024, _peakMemory / 1024);
+    snprintf(
+        lines[2], sizeof(lines[2]), "Allocations this frame: %zu sessions, %zu nodes (%zu nodes reused)",
+        _sessionAllocations, poolStats.NodeAllocations, poolStats.NodeRequests);
+
+    ScreenCoordsXY screenCoords(8, 20);
+    int32_t maxWidth = 0;
+    for (const auto* line : lines)
+    {
+        char buffer[160]{};
+        FormatStringToBuffer(buffer, sizeof(buffer), "{OUTLINE}{WHITE}{STRING}", line);
+        gfx_draw_string(dpi, screenCoords, buffer);
+        maxWidth = std::max(maxWidth, gfx_get_string_width(buffer, FontSpriteBase::MEDIUM));
+        screenCoords.y += 12;
+    }
+
+    // Make area dirty so the text doesn't get drawn over the last
+    gfx_set_dirty_blocks({ { 8, 20 }, { 8 + maxWidth, screenCoords.y } });
+}
+
+size_t Painter::GetMemoryUsage(const PaintEntryPool::Stats& poolStats) const
+{
+    return _paintSessionPool.size() * sizeof(paint_session) + poolStats.NodeCount * sizeof(PaintEntryPool::Node);
+}
+
+void Painter::EndFrame()
+{
+    _peakMemory = std::max(_peakMemory, GetMemoryUsage(_paintStructPool.GetStats()));
+    _trimPeakSessionsInUse = std::max(_trimPeakSessionsInUse, _peakSessionsInUse);
+    if (++_framesSinceTrim >= TrimInterval)
+    {
+        Trim();
+    }
+
+    _paintStructPool.EndFrame();
+    _peakSessionsInUse = _sessionsInUse;
+    _sessionAllocations = 0;
+}
+
+void Painter::Trim()
+{
+    // Keep as many sessions as were needed at once since the last trim, they are reused with their entry nodes.
+    while (_paintSessionPool.size() > _trimPeakSessionsInUse && !_freePaintSessions.empty())
+    {
+        auto* session = _freePaintSessions.back();
+        _freePaintSessions.pop_back();
+        auto it = std::find_if(
+            _paintSessionPool.begin(), _paintSessionPool.end(), [session](const auto& s) { return s.get() == session; });
+        if (it != _paintSessionPool.end())
+        {
+            (*it)->PaintEntryChain.Clear();
+            _paintSessionPool.erase(it);
+        }
+    }
+    _paintStructPool.Trim();
+
+    _trimPeakSessionsInUse = _sessionsInUse;
+    _framesSinceTrim = 0;
+}
+
 void Painter::MeasureFPS()
 {
     _frames++;
@@ -145,15 +227,25 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
         // Create new one in pool.
         _paintSessionPool.emplace_back(std::make_unique<paint_session>());
         session = _paintSessionPool.back().get();
+        session->PaintEntryChain = _paintStructPool.Create();
+        _sessionAllocations++;
+    }
+    _sessionsInUse++;
+    _peakSessionsInUse = std::max(_peakSessionsInUse, _sessionsInUse);
+
+    // Only the quadrants the last use of the session filled need clearing, new sessions start out zeroed.
+    if (session->QuadrantBackIndex != std::numeric_limits<uint32_t>::max())
+    {
+        std::fill(
+            std::begin(session->Quadrants) + session->QuadrantBackIndex,
+            std::begin(session->Quadrants) + session->QuadrantFrontIndex + 1, nullptr);
     }
 
     session->DPI = *dpi;
     session->ViewFlags = viewFlags;
     session->QuadrantBackIndex = std::numeric_limits<uint32_t>::max();
     session->QuadrantFrontIndex = 0;
-    session->PaintEntryChain = _paintStructPool.Create();
 
-    std::fill(std::begin(session->Quadrants), std::end(session->Quadrants), nullptr);
     session->LastPS = nullptr;
     session->LastAttachedPS = nullptr;
     session->PSStringHead = nullptr;
@@ -161,21 +253,24 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->PickBits = nullptr;
+    session->TileRecorder = nullptr;
 
     return session;
 }
 
 void Painter::ReleaseSession(paint_session* session)
 {
-    session->PaintEntryChain.Clear();
+    session->PaintEntryChain.Reset();
     _freePaintSessions.push_back(session);
+    _sessionsInUse--;
 }
 
 Painter::~Painter()
 {
     for (auto&& session : _paintSessionPool)
     {
-        ReleaseSession(session.get());
+        session->PaintEntryChain.Clear();
     }
     _paintSessionPool.clear();
 }
@@ -39,6 +39,12 @@ namespace OpenRCT2
             std::vector<std::unique_ptr<paint_session>> _paintSessionPool;
             std::vector<paint_session*> _freePaintSessions;
             PaintEntryPool _paintStructPool;
+            size_t _sessionsInUse = 0;
+            size_t _peakSessionsInUse = 0;
+            size_t _trimPeakSessionsInUse = 0;
+            uint32_t _framesSinceTrim = 0;
+            size_t _sessionAllocations = 0;
+            size_t _peakMemory = 0;
             time_t _lastSecond = 0;
             int32_t _currentFPS = 0;
             int32_t _frames = 0;
@@ -54,7 +60,11 @@ namespace OpenRCT2
         private:
             void PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text);
             void PaintFPS(rct_drawpixelinfo* dpi);
+            void PaintSessionStats(rct_drawpixelinfo* dpi);
             void MeasureFPS();
+            size_t GetMemoryUsage(const PaintEntryPool::Stats& poolStats) const;
+            void EndFrame();
+            void Trim();
         };
     } // namespace Paint
 } // namespace OpenRCT2
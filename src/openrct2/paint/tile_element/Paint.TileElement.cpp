@@ -27,6 +27,7 @@
 #include "../../world/Scenery.h"
 #include "../../world/Surface.h"
 #include "../Paint.h"
+#include "../PaintTileCache.h"
 #include "../Supports.h"
 #include "../VirtualFloor.h"
 #include "Paint.Surface.h"
@@ -110,6 +111,100 @@ static void blank_tiles_paint(paint_session* session, int32_t x, int32_t y)
 
 bool gShowSupportSegmentHeights = false;
 
+// Paints the elements of the tile, returns false if painting stopped at a corrupt element.
+static bool PaintTileElements(paint_session* session, const TileElement* tile_element)
+{
+    const uint8_t rotation = session->CurrentRotation;
+    int32_t previousBaseZ = 0;
+    do
+    {
+        // Only paint tile_elements below the clip height.
+        if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (tile_element->GetBaseZ() > gClipHeight * COORDS_Z_STEP))
+            continue;
+
+        Direction direction = tile_element->GetDirectionWithOffset(rotation);
+        int32_t baseZ = tile_element->GetBaseZ();
+
+        // If we are on a new baseZ level, look through elements on the
+        //  same baseZ and store any types might be relevant to others
+        if (baseZ != previousBaseZ)
+        {
+            previousBaseZ = baseZ;
+            session->PathElementOnSameHeight = nullptr;
+            session->TrackElementOnSameHeight = nullptr;
+            const TileElement* tile_element_sub_iterator = tile_element;
+            while (!(tile_element_sub_iterator++)->IsLastForTile())
+            {
+                if (tile_element_sub_iterator->GetBaseZ() != tile_element->GetBaseZ())
+                {
+                    break;
+                }
+                switch (tile_element_sub_iterator->GetType())
+                {
+                    case TILE_ELEMENT_TYPE_PATH:
+                        session->PathElementOnSameHeight = tile_element_sub_iterator;
+                        break;
+                    case TILE_ELEMENT_TYPE_TRACK:
+                        session->TrackElementOnSameHeight = tile_element_sub_iterator;
+                        break;
+                    case TILE_ELEMENT_TYPE_CORRUPT:
+                        // To preserve regular behaviour, make an element hidden by
+                        //  corruption also invisible to this method.
+                        if (tile_element->IsLastForTile())
+                        {
+                            break;
+                        }
+                        tile_element_sub_iterator++;
+                        break;
+                }
+            }
+        }
+
+        CoordsXY mapPosition = session->MapPosition;
+        session->CurrentlyDrawnItem = tile_element;
+        // Setup the painting of for example: the underground, signs, rides, scenery, etc.
+        switch (tile_element->GetType())
+        {
+            case TILE_ELEMENT_TYPE_SURFACE:
+                PaintSurface(session, direction, baseZ, *(tile_element->AsSurface()));
+                break;
+            case TILE_ELEMENT_TYPE_PATH:
+                PaintPath(session, baseZ, *(tile_element->AsPath()));
+                break;
+            case TILE_ELEMENT_TYPE_TRACK:
+                PaintTrack(session, direction, baseZ, *(tile_element->AsTrack()));
+                break;
+            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+                PaintSmallScenery(session, direction, baseZ, *(tile_element->AsSmallScenery()));
+                break;
+            case TILE_ELEMENT_TYPE_ENTRANCE:
+                PaintEntrance(session, direction, baseZ, *(tile_element->AsEntrance()));
+                break;
+            case TILE_ELEMENT_TYPE_WALL:
+                PaintWall(session, direction, baseZ, *(tile_element->AsWall()));
+                break;
+            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+                PaintLargeScenery(session, direction, baseZ, *(tile_element->AsLargeScenery()));
+                break;
+            case TILE_ELEMENT_TYPE_BANNER:
+                PaintBanner(session, direction, baseZ, *(tile_element->AsBanner()));
+                break;
+            // A corrupt element inserted by OpenRCT2 itself, which skips the drawing of the next element only.
+            case TILE_ELEMENT_TYPE_CORRUPT:
+                if (tile_element->IsLastForTile())
+                    return false;
+                tile_element++;
+                break;
+            default:
+                // An undefined map element is most likely a corrupt element inserted by 8 cars' MOM feature to skip drawing of
+                // all elements after it.
+                return false;
+        }
+        session->MapPosition = mapPosition;
+    } while (!(tile_element++)->IsLastForTile());
+    return true;
+}
+
 /**
  *
  *  rct2: 0x0068B3FB
@@ -213,93 +308,13 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
     session->SpritePosition.x = x;
     session->SpritePosition.y = y;
     session->DidPassSurface = false;
-    int32_t previousBaseZ = 0;
-    do
-    {
-        // Only paint tile_elements below the clip height.
-        if ((session->ViewFlags & VIEWPORT_FLAG_CLIP_VIEW) && (tile_element->GetBaseZ() > gClipHeight * COORDS_Z_STEP))
-            continue;
-
-        Direction direction = tile_element->GetDirectionWithOffset(rotation);
-        int32_t baseZ = tile_element->GetBaseZ();
-
-        // If we are on a new baseZ level, look through elements on the
-        //  same baseZ and store any types might be relevant to others
-        if (baseZ != previousBaseZ)
-        {
-            previousBaseZ = baseZ;
-            session->PathElementOnSameHeight = nullptr;
-            session->TrackElementOnSameHeight = nullptr;
-            const TileElement* tile_element_sub_iterator = tile_element;
-            while (!(tile_element_sub_iterator++)->IsLastForTile())
-            {
-                if (tile_element_sub_iterator->GetBaseZ() != tile_element->GetBaseZ())
-                {
-                    break;
-                }
-                switch (tile_element_sub_iterator->GetType())
-                {
-                    case TILE_ELEMENT_TYPE_PATH:
-                        session->PathElementOnSameHeight = tile_element_sub_iterator;
-                        break;
-                    case TILE_ELEMENT_TYPE_TRACK:
-                        session->TrackElementOnSameHeight = tile_element_sub_iterator;
-                        break;
-                    case TILE_ELEMENT_TYPE_CORRUPT:
-                        // To preserve regular behaviour, make an element hidden by
-                        //  corruption also invisible to this method.
-                        if (tile_element->IsLastForTile())
-                        {
-                            break;
-                        }
-                        tile_element_sub_iterator++;
-                        break;
-                }
-            }
-        }
-
-        CoordsXY mapPosition = session->MapPosition;
-        session->CurrentlyDrawnItem = tile_element;
-        // Setup the painting of for example: the underground, signs, rides, scenery, etc.
-        switch (tile_element->GetType())
-        {
-            case TILE_ELEMENT_TYPE_SURFACE:
-                PaintSurface(session, direction, baseZ, *(tile_element->AsSurface()));
-                break;
-            case TILE_ELEMENT_TYPE_PATH:
-                PaintPath(session, baseZ, *(tile_element->AsPath()));
-                break;
-            case TILE_ELEMENT_TYPE_TRACK:
-                PaintTrack(session, direction, baseZ, *(tile_element->AsTrack()));
-                break;
-            case TILE_ELEMENT_TYPE_SMALL_SCENERY:
-                PaintSmallScenery(session, direction, baseZ, *(tile_element->AsSmallScenery()));
-                break;
-            case TILE_ELEMENT_TYPE_ENTRANCE:
-                PaintEntrance(session, direction, baseZ, *(tile_element->AsEntrance()));
-                break;
-            case TILE_ELEMENT_TYPE_WALL:
-                PaintWall(session, direction, baseZ, *(tile_element->AsWall()));
-                break;
-            case TILE_ELEMENT_TYPE_LARGE_SCENERY:
-                PaintLargeScenery(session, direction, baseZ, *(tile_element->AsLargeScenery()));
-                break;
-            case TILE_ELEMENT_TYPE_BANNER:
-                PaintBanner(session, direction, baseZ, *(tile_element->AsBanner()));
-                break;
-            // A corrupt element inserted by OpenRCT2 itself, which skips the drawing of the next element only.
-            case TILE_ELEMENT_TYPE_CORRUPT:
-                if (tile_element->IsLastForTile())
-                    return;
-                tile_element++;
-                break;
-            default:
-                // An undefined map element is most likely a corrupt element inserted by 8 cars' MOM feature to skip drawing of
-                // all elements after it.
-                return;
-        }
-        session->MapPosition = mapPosition;
-    } while (!(tile_element++)->IsLastForTile());
+#ifdef __TESTPAINT__
+    if (!PaintTileElements(session, tile_element))
+        return;
+#else
+    if (!PaintTileCachePaintElements(session, tile_element, PaintTileElements))
+        return;
+#endif // __TESTPAINT__
 
 #ifndef __TESTPAINT__
     if (gConfigGeneral.virtual_floor_style != VirtualFloorStyles::Off && partOfVirtualFloor)
@@ -313,7 +328,7 @@ static void sub_68B3FB(paint_session* session, int32_t x, int32_t y)
         return;
     }
 
-    if ((tile_element - 1)->GetType() == TILE_ELEMENT_TYPE_SURFACE)
+    if (element->GetType() == TILE_ELEMENT_TYPE_SURFACE)
     {
         return;
     }
@@ -25,6 +25,7 @@
 #include "../rct2/RCT2.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/RideProximityIndex.h"
 #include "../ride/ShopItem.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1877,21 +1878,7 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
         constexpr auto radius = 10 * 32;
         int32_t cx = floor2(x, 32);
         int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                auto location = CoordsXY{ tileX, tileY };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    rideConsideration[EnumValue(rideIndex)] = true;
-                }
-            }
-        }
+        rideConsideration = GetRidesNearLocation({ cx, cy }, radius);
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
         for (auto& ride : GetRideManager())
@@ -2968,15 +2955,7 @@ static PeepThoughtType peep_assess_surroundings(int16_t centre_x, int16_t centre
         }
     }
 
-    for (auto litter : EntityList<Litter>())
-    {
-        int16_t dist_x = abs(litter->x - centre_x);
-        int16_t dist_y = abs(litter->y - centre_y);
-        if (std::max(dist_x, dist_y) <= 160)
-        {
-            num_rubbish++;
-        }
-    }
+    num_rubbish += CountInBox<Litter>({ centre_x, centre_y }, 160);
 
     if (num_fountains >= 5 && num_rubbish < 20)
         return PeepThoughtType::Fountains;
@@ -3129,26 +3108,12 @@ template<typename T> static void peep_head_for_nearest_ride(Guest* peep, bool co
         constexpr auto searchRadius = 10 * 32;
         int32_t cx = floor2(peep->x, 32);
         int32_t cy = floor2(peep->y, 32);
-        for (auto x = cx - searchRadius; x <= cx + searchRadius; x += COORDS_XY_STEP)
+        const auto nearbyRides = GetRidesNearLocation({ cx, cy }, searchRadius);
+        for (auto& ride : GetRideManager())
         {
-            for (auto y = cy - searchRadius; y <= cy + searchRadius; y += COORDS_XY_STEP)
+            if (nearbyRides[EnumValue(ride.id)] && predicate(ride))
             {
-                auto location = CoordsXY{ x, y };
-                if (!map_is_location_valid(location))
-                    continue;
-
-                for (auto* trackElement : TileElementsView<TrackElement>(location))
-                {
-                    auto rideIndex = trackElement->GetRideIndex();
-                    auto ride = get_ride(rideIndex);
-                    if (ride == nullptr)
-                        continue;
-
-                    if (!predicate(*ride))
-                        continue;
-
-                    rideConsideration[EnumValue(ride->id)] = true;
-                }
+                rideConsideration[EnumValue(ride.id)] = true;
             }
         }
     }
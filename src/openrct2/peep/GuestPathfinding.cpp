@@ -17,11 +17,22 @@
 #include "../util/Util.h"
 #include "../world/Entrance.h"
 #include "../world/Footpath.h"
+#include "../world/Park.h"
+#include "../world/TileElementsView.h"
 #include "Guest.h"
 #include "Staff.h"
 
+#include <algorithm>
+#include <array>
 #include <bitset>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 static bool _peepPathFindIsStaff;
 static int8_t _peepPathFindNumJunctions;
@@ -52,6 +63,202 @@ static struct
     Direction direction;
 } _peepPathFindHistory[16];
 
+/* Cache of the edge chosen by the heuristic search for guests, keyed by everything the search depends on apart
+ * from the map and the peep's PathfindHistory. The map is covered by the version, which is bumped by
+ * PathfindingCacheInvalidate(). The history is only read at the thin junctions the search passes through, those
+ * are remembered in a filter so a hit can check that the two peeps' histories agree at all of them. */
+struct PathfindingCacheKey
+{
+    TileCoordsXYZ Location;
+    TileCoordsXYZ Goal;
+    ride_id_t QueueRideIndex;
+    uint8_t Edges;
+    int8_t MaxJunctions;
+    bool IgnoreForeignQueues;
+
+    bool operator==(const PathfindingCacheKey& other) const
+    {
+        return Location == other.Location && Goal == other.Goal && QueueRideIndex == other.QueueRideIndex
+            && Edges == other.Edges && MaxJunctions == other.MaxJunctions && IgnoreForeignQueues == other.IgnoreForeignQueues;
+    }
+};
+
+struct PathfindingCacheKeyHash
+{
+    size_t operator()(const PathfindingCacheKey& key) const
+    {
+        size_t hash = static_cast<uint32_t>(key.Location.x) | (static_cast<uint32_t>(key.Location.y) << 8)
+            | (static_cast<uint32_t>(key.Location.z) << 16);
+        hash = hash * 31 + (static_cast<uint32_t>(key.Goal.x) | (static_cast<uint32_t>(key.Goal.y) << 8));
+        hash = hash * 31 + static_cast<uint32_t>(key.Goal.z);
+        hash = hash * 31 + static_cast<uint32_t>(EnumValue(key.QueueRideIndex));
+        hash = hash * 31 + (key.Edges | (key.MaxJunctions << 4) | (key.IgnoreForeignQueues << 12));
+        return hash;
+    }
+};
+
+static constexpr size_t PathfindingCacheMaxEntries = 16384;
+static constexpr size_t PathfindingCacheFilterBits = 2048;
+
+struct PathfindingCacheEntry
+{
+    std::array<TileCoordsXYZD, 4> History;
+    std::bitset<PathfindingCacheFilterBits> CheckedJunctions;
+    Direction Result;
+};
+
+static std::unordered_map<PathfindingCacheKey, PathfindingCacheEntry, PathfindingCacheKeyHash> _pathfindingCache;
+static uint32_t _pathfindingCacheVersion;
+static uint32_t _pathfindingMapVersion = 1;
+static PathfindingCacheStats _pathfindingCacheStats;
+// Thin junctions at which the search currently running looked at the peep's PathfindHistory.
+static std::bitset<PathfindingCacheFilterBits> _pathfindingCacheCheckedJunctions;
+
+static size_t PathfindingCacheGetFilterBit(const TileCoordsXYZ& loc)
+{
+    const uint32_t hash = (static_cast<uint32_t>(loc.x) * 0x9E3779B1u) ^ (static_cast<uint32_t>(loc.y) * 0x85EBCA77u)
+        ^ (static_cast<uint32_t>(loc.z) * 0xC2B2AE3Du);
+    return (hash >> 16) % PathfindingCacheFilterBits;
+}
+
+/**
+ * Returns the untried directions the history holds for loc the way the search reads them, -1 if the junction is not
+ * remembered.
+ */
+static int32_t PathfindingCacheGetHistoryDirections(const std::array<TileCoordsXYZD, 4>& history, const TileCoordsXYZ& loc)
+{
+    for (const auto& pathfindHistory : history)
+    {
+        if (pathfindHistory == loc)
+            return pathfindHistory.direction;
+    }
+    return -1;
+}
+
+static bool PathfindingCacheFind(
+    const PathfindingCacheKey& key, const std::array<TileCoordsXYZD, 4>& history, Direction& outDirection)
+{
+    if (_pathfindingCacheVersion != _pathfindingMapVersion)
+    {
+        _pathfindingCache.clear();
+        _pathfindingCacheVersion = _pathfindingMapVersion;
+    }
+
+    auto it = _pathfindingCache.find(key);
+    if (it != _pathfindingCache.end())
+    {
+        const auto& entry = it->second;
+        bool historyMatches = true;
+        for (const auto* junctions : { &entry.History, &history })
+        {
+            for (const auto& junction : *junctions)
+            {
+                if (junction.IsNull() || !entry.CheckedJunctions[PathfindingCacheGetFilterBit(junction)])
+                    continue;
+
+                if (PathfindingCacheGetHistoryDirections(entry.History, junction)
+                    != PathfindingCacheGetHistoryDirections(history, junction))
+                {
+                    historyMatches = false;
+                }
+            }
+        }
+
+        if (historyMatches)
+        {
+            _pathfindingCacheStats.Hits++;
+            outDirection = entry.Result;
+            return true;
+        }
+    }
+    _pathfindingCacheStats.Misses++;
+    return false;
+}
+
+static void PathfindingCacheStore(
+    const PathfindingCacheKey& key, const std::array<TileCoordsXYZD, 4>& history, Direction direction)
+{
+    if (_pathfindingCache.size() >= PathfindingCacheMaxEntries)
+    {
+        _pathfindingCache.clear();
+    }
+    _pathfindingCache[key] = { history, _pathfindingCacheCheckedJunctions, direction };
+}
+
+static void PathFlowFieldInvalidate();
+static void PathFlowFieldInvalidateArea(const CoordsXY& loc, int32_t radius);
+
+static PathfindingCacheArea* _pathfindingCacheArea;
+static int32_t _pathfindingCacheGhostScopes;
+
+void PathfindingCacheInvalidate(bool footpathsChanged)
+{
+    if (_pathfindingCacheGhostScopes > 0)
+        return;
+
+    _pathfindingMapVersion++;
+    if (!footpathsChanged)
+        return;
+
+    if (_pathfindingCacheArea == nullptr)
+    {
+        PathFlowFieldInvalidate();
+    }
+    else if (!_pathfindingCacheArea->Invalidated)
+    {
+        // Flow fields are not used until the action is done, so the area only has to be noted once.
+        _pathfindingCacheArea->Invalidated = true;
+        PathFlowFieldInvalidateArea(_pathfindingCacheArea->Location, _pathfindingCacheArea->Radius);
+    }
+}
+
+void PathfindingCacheInvalidateArea(const CoordsXY& loc, int32_t radius)
+{
+    if (_pathfindingCacheGhostScopes > 0)
+        return;
+
+    _pathfindingMapVersion++;
+    PathFlowFieldInvalidateArea(loc, radius);
+}
+
+PathfindingCacheArea::PathfindingCacheArea(const CoordsXY& loc, int32_t radius)
+    : Location(loc)
+    , Radius(radius)
+    , Previous(_pathfindingCacheArea)
+{
+    _pathfindingCacheArea = this;
+}
+
+PathfindingCacheArea::~PathfindingCacheArea()
+{
+    _pathfindingCacheArea = Previous;
+}
+
+PathfindingCacheGhostScope::PathfindingCacheGhostScope(bool active)
+    : Active(active)
+{
+    if (Active)
+        _pathfindingCacheGhostScopes++;
+}
+
+PathfindingCacheGhostScope::~PathfindingCacheGhostScope()
+{
+    if (Active)
+        _pathfindingCacheGhostScopes--;
+}
+
+PathfindingCacheStats PathfindingCacheGetStats()
+{
+    auto stats = _pathfindingCacheStats;
+    stats.Entries = _pathfindingCacheVersion == _pathfindingMapVersion ? _pathfindingCache.size() : 0;
+    return stats;
+}
+
+void PathfindingCacheResetStats()
+{
+    _pathfindingCacheStats = {};
+}
+
 enum
 {
     PATH_SEARCH_DEAD_END,
@@ -1074,6 +1281,7 @@ static void peep_pathfind_heuristic_search(
                 bool pathLoop = false;
                 /* Check the peep->PathfindHistory to see if this junction has
                  * already been visited by the peep while heading for this goal. */
+                _pathfindingCacheCheckedJunctions[PathfindingCacheGetFilterBit(loc)] = true;
                 for (auto& pathfindHistory : peep->PathfindHistory)
                 {
                     if (pathfindHistory == loc)
@@ -1246,6 +1454,173 @@ static void peep_pathfind_heuristic_search(
     }
 }
 
+/**
+ * Runs the heuristic search along each of the edges and returns the one that gives the best score, or
+ * INVALID_DIRECTION if none of them leads to the goal.
+ */
+static Direction peep_pathfind_search_edges(
+    const TileCoordsXYZ& loc, const TileCoordsXYZ& goal, Peep* peep, TileElement* first_tile_element, uint8_t edges,
+    int32_t maxTilesChecked)
+{
+    int32_t chosen_edge = bitscanforward(edges);
+    uint16_t best_score = 0xFFFF;
+    uint8_t best_sub = 0xFF;
+
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    uint8_t bestJunctions = 0;
+    TileCoordsXYZ bestJunctionList[16];
+    uint8_t bestDirectionList[16];
+    TileCoordsXYZ bestXYZ;
+
+    if (_pathFindDebug)
+    {
+        log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    /* Call the search heuristic on each edge, keeping track of the
+     * edge that gives the best (i.e. smallest) value (best_score)
+     * or for different edges with equal value, the edge with the
+     * least steps (best_sub). */
+    int32_t numEdges = bitcount(edges);
+    for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
+    {
+        edges &= ~(1 << test_edge);
+        uint8_t height = loc.z;
+
+        if (first_tile_element->AsPath()->IsSloped() && first_tile_element->AsPath()->GetSlopeDirection() == test_edge)
+        {
+            height += 0x2;
+        }
+
+        _peepPathFindFewestNumSteps = 255;
+        /* Divide the maxTilesChecked global search limit
+         * between the remaining edges to ensure the search
+         * covers all of the remaining edges. */
+        _peepPathFindTilesChecked = maxTilesChecked / numEdges;
+        _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
+
+        // Initialise _peepPathFindHistory.
+
+        for (auto& entry : _peepPathFindHistory)
+        {
+            entry.location.SetNull();
+            entry.direction = INVALID_DIRECTION;
+        }
+
+        /* The pathfinding will only use elements
+         * 1.._peepPathFindMaxJunctions, so the starting point
+         * is placed in element 0 */
+        _peepPathFindHistory[0].location = loc;
+        _peepPathFindHistory[0].direction = 0xF;
+
+        uint16_t score = 0xFFFF;
+        /* Variable endXYZ contains the end location of the
+         * search path. */
+        TileCoordsXYZ endXYZ;
+        endXYZ.x = 0;
+        endXYZ.y = 0;
+        endXYZ.z = 0;
+
+        uint8_t endSteps = 255;
+
+        /* Variable endJunctions is the number of junctions
+         * passed through in the search path.
+         * Variables endJunctionList and endDirectionList
+         * contain the junctions and corresponding directions
+         * of the search path.
+         * In the future these could be used to visualise the
+         * pathfinding on the map. */
+        uint8_t endJunctions = 0;
+        TileCoordsXYZ endJunctionList[16];
+        uint8_t endDirectionList[16] = { 0 };
+
+        bool inPatrolArea = false;
+        auto* staff = peep->As<Staff>();
+        if (staff != nullptr && staff->IsMechanic())
+        {
+            /* Mechanics are the only staff type that
+             * pathfind to a destination. Determine if the
+             * mechanic is in their patrol area. */
+            inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
+        }
+
+#if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
+        if (gPathFindDebug)
+        {
+            log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
+        }
+#endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
+
+        peep_pathfind_heuristic_search(
+            { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
+            endJunctionList, endDirectionList, &endXYZ, &endSteps);
+
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        if (_pathFindDebug)
+        {
+            log_verbose(
+                "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
+                endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
+            for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
+            {
+                log_info(
+                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
+                    endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
+            }
+        }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+        if (score < best_score || (score == best_score && endSteps < best_sub))
+        {
+            chosen_edge = test_edge;
+            best_score = score;
+            best_sub = endSteps;
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+            bestJunctions = endJunctions;
+            for (uint8_t index = 0; index < endJunctions; index++)
+            {
+                bestJunctionList[index].x = endJunctionList[index].x;
+                bestJunctionList[index].y = endJunctionList[index].y;
+                bestJunctionList[index].z = endJunctionList[index].z;
+                bestDirectionList[index] = endDirectionList[index];
+            }
+            bestXYZ.x = endXYZ.x;
+            bestXYZ.y = endXYZ.y;
+            bestXYZ.z = endXYZ.z;
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        }
+    }
+
+    /* Check if the heuristic search failed. e.g. all connected
+     * paths are within the search limits and none reaches the
+     * goal. */
+    if (best_score == 0xFFFF)
+    {
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        if (_pathFindDebug)
+        {
+            log_verbose("Pathfind heuristic search failed.");
+        }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        return INVALID_DIRECTION;
+    }
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    if (_pathFindDebug)
+    {
+        log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
+        for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
+        {
+            log_verbose(
+                "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
+                bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
+        }
+        log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
+    }
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    return static_cast<Direction>(chosen_edge);
+}
+
 /**
  * Returns:
  *   -1   - no direction chosen
@@ -1421,161 +1796,28 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
     // Peep has multiple edges still to try.
     if (edges & ~(1 << chosen_edge))
     {
-        uint16_t best_score = 0xFFFF;
-        uint8_t best_sub = 0xFF;
-
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-        uint8_t bestJunctions = 0;
-        TileCoordsXYZ bestJunctionList[16];
-        uint8_t bestDirectionList[16];
-        TileCoordsXYZ bestXYZ;
-
-        if (_pathFindDebug)
+        Direction direction;
+        if (_peepPathFindIsStaff)
         {
-            log_verbose("Pathfind start for goal %d,%d,%d from %d,%d,%d", goal.x, goal.y, goal.z, loc.x, loc.y, loc.z);
+            // Mechanics search relative to their patrol area, only the searches of guests are cached.
+            direction = peep_pathfind_search_edges(loc, goal, peep, first_tile_element, edges, maxTilesChecked);
         }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-
-        /* Call the search heuristic on each edge, keeping track of the
-         * edge that gives the best (i.e. smallest) value (best_score)
-         * or for different edges with equal value, the edge with the
-         * least steps (best_sub). */
-        int32_t numEdges = bitcount(edges);
-        for (int32_t test_edge = chosen_edge; test_edge != -1; test_edge = bitscanforward(edges))
+        else
         {
-            edges &= ~(1 << test_edge);
-            uint8_t height = loc.z;
-
-            if (first_tile_element->AsPath()->IsSloped() && first_tile_element->AsPath()->GetSlopeDirection() == test_edge)
-            {
-                height += 0x2;
-            }
-
-            _peepPathFindFewestNumSteps = 255;
-            /* Divide the maxTilesChecked global search limit
-             * between the remaining edges to ensure the search
-             * covers all of the remaining edges. */
-            _peepPathFindTilesChecked = maxTilesChecked / numEdges;
-            _peepPathFindNumJunctions = _peepPathFindMaxJunctions;
-
-            // Initialise _peepPathFindHistory.
-
-            for (auto& entry : _peepPathFindHistory)
-            {
-                entry.location.SetNull();
-                entry.direction = INVALID_DIRECTION;
-            }
-
-            /* The pathfinding will only use elements
-             * 1.._peepPathFindMaxJunctions, so the starting point
-             * is placed in element 0 */
-            _peepPathFindHistory[0].location = loc;
-            _peepPathFindHistory[0].direction = 0xF;
-
-            uint16_t score = 0xFFFF;
-            /* Variable endXYZ contains the end location of the
-             * search path. */
-            TileCoordsXYZ endXYZ;
-            endXYZ.x = 0;
-            endXYZ.y = 0;
-            endXYZ.z = 0;
-
-            uint8_t endSteps = 255;
-
-            /* Variable endJunctions is the number of junctions
-             * passed through in the search path.
-             * Variables endJunctionList and endDirectionList
-             * contain the junctions and corresponding directions
-             * of the search path.
-             * In the future these could be used to visualise the
-             * pathfinding on the map. */
-            uint8_t endJunctions = 0;
-            TileCoordsXYZ endJunctionList[16];
-            uint8_t endDirectionList[16] = { 0 };
-
-            bool inPatrolArea = false;
-            auto* staff = peep->As<Staff>();
-            if (staff != nullptr && staff->IsMechanic())
+            const PathfindingCacheKey cacheKey = {
+                loc, goal, gPeepPathFindQueueRideIndex, edges, _peepPathFindMaxJunctions, gPeepPathFindIgnoreForeignQueues,
+            };
+            if (!PathfindingCacheFind(cacheKey, peep->PathfindHistory, direction))
             {
-                /* Mechanics are the only staff type that
-                 * pathfind to a destination. Determine if the
-                 * mechanic is in their patrol area. */
-                inPatrolArea = staff->IsLocationInPatrol(peep->NextLoc);
-            }
-
-#if defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
-            if (gPathFindDebug)
-            {
-                log_verbose("Pathfind searching in direction: %d from %d,%d,%d", test_edge, loc.x >> 5, loc.y >> 5, loc.z);
-            }
-#endif // defined(DEBUG_LEVEL_2) && DEBUG_LEVEL_2
-
-            peep_pathfind_heuristic_search(
-                { loc.x, loc.y, height }, peep, first_tile_element, inPatrolArea, 0, &score, test_edge, &endJunctions,
-                endJunctionList, endDirectionList, &endXYZ, &endSteps);
-
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
-            {
-                log_verbose(
-                    "Pathfind test edge: %d score: %d steps: %d end: %d,%d,%d junctions: %d", test_edge, score, endSteps,
-                    endXYZ.x, endXYZ.y, endXYZ.z, endJunctions);
-                for (uint8_t listIdx = 0; listIdx < endJunctions; listIdx++)
-                {
-                    log_info(
-                        "Junction#%d %d,%d,%d Direction %d", listIdx + 1, endJunctionList[listIdx].x,
-                        endJunctionList[listIdx].y, endJunctionList[listIdx].z, endDirectionList[listIdx]);
-                }
-            }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-
-            if (score < best_score || (score == best_score && endSteps < best_sub))
-            {
-                chosen_edge = test_edge;
-                best_score = score;
-                best_sub = endSteps;
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-                bestJunctions = endJunctions;
-                for (uint8_t index = 0; index < endJunctions; index++)
-                {
-                    bestJunctionList[index].x = endJunctionList[index].x;
-                    bestJunctionList[index].y = endJunctionList[index].y;
-                    bestJunctionList[index].z = endJunctionList[index].z;
-                    bestDirectionList[index] = endDirectionList[index];
-                }
-                bestXYZ.x = endXYZ.x;
-                bestXYZ.y = endXYZ.y;
-                bestXYZ.z = endXYZ.z;
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+                _pathfindingCacheCheckedJunctions.reset();
+                direction = peep_pathfind_search_edges(loc, goal, peep, first_tile_element, edges, maxTilesChecked);
+                PathfindingCacheStore(cacheKey, peep->PathfindHistory, direction);
             }
         }
 
-        /* Check if the heuristic search failed. e.g. all connected
-         * paths are within the search limits and none reaches the
-         * goal. */
-        if (best_score == 0xFFFF)
-        {
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-            if (_pathFindDebug)
-            {
-                log_verbose("Pathfind heuristic search failed.");
-            }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        if (direction == INVALID_DIRECTION)
             return INVALID_DIRECTION;
-        }
-#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
-        if (_pathFindDebug)
-        {
-            log_verbose("Pathfind best edge %d with score %d steps %d", chosen_edge, best_score, best_sub);
-            for (uint8_t listIdx = 0; listIdx < bestJunctions; listIdx++)
-            {
-                log_verbose(
-                    "Junction#%d %d,%d,%d Direction %d", listIdx + 1, bestJunctionList[listIdx].x, bestJunctionList[listIdx].y,
-                    bestJunctionList[listIdx].z, bestDirectionList[listIdx]);
-            }
-            log_verbose("End at %d,%d,%d", bestXYZ.x, bestXYZ.y, bestXYZ.z);
-        }
-#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+        chosen_edge = direction;
     }
 
     if (isThin)
@@ -1625,6 +1867,539 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
     return chosen_edge;
 }
 
+/* Flow fields for guests entering or leaving the park. Each one holds the number of tiles a guest has to walk to
+ * get from a path tile to its goal, a park entrance or peep spawn, filled in by a breadth first search outwards
+ * from the goal. A field is built when it is first needed. After PathfindingCacheInvalidateArea() it is repaired
+ * around the changed tiles on its next use, giving the same distances a new search would, any other change to the
+ * paths has it built again. Guests walk the same footpaths as for the heuristic search: no ghosts, no wide paths,
+ * no queues of rides other than at their ends or junctions and no edges blocked by a no entry banner. Guests on a
+ * path the field does not reach fall back to the heuristic search. */
+struct PathFlowField
+{
+    TileCoordsXYZ Goal;
+    uint32_t Version;
+    // Number of _pathFlowFieldChangedTiles the distances already include.
+    size_t ChangedTiles;
+    std::unordered_map<uint32_t, uint16_t> Distances;
+};
+
+static constexpr size_t PathFlowFieldMaxCount = 64;
+static constexpr size_t PathFlowFieldMaxChangedTiles = 2048;
+
+static std::vector<PathFlowField> _pathFlowFields;
+static uint32_t _pathFlowFieldVersion = 1;
+// Tiles with changed footpaths since the fields were last invalidated, oldest first.
+static std::vector<TileCoordsXY> _pathFlowFieldChangedTiles;
+
+static void PathFlowFieldInvalidate()
+{
+    _pathFlowFieldVersion++;
+    _pathFlowFieldChangedTiles.clear();
+}
+
+static void PathFlowFieldInvalidateArea(const CoordsXY& loc, int32_t radius)
+{
+    if (_pathFlowFieldChangedTiles.size() >= PathFlowFieldMaxChangedTiles)
+    {
+        // Forget the older half, fields that have not caught up with it yet are built again.
+        const size_t forgotten = _pathFlowFieldChangedTiles.size() / 2;
+        _pathFlowFieldChangedTiles.erase(_pathFlowFieldChangedTiles.begin(), _pathFlowFieldChangedTiles.begin() + forgotten);
+        for (auto& field : _pathFlowFields)
+        {
+            if (field.ChangedTiles < forgotten)
+            {
+                field.Version = 0;
+            }
+            else
+            {
+                field.ChangedTiles -= forgotten;
+            }
+        }
+    }
+
+    const TileCoordsXY centre(loc);
+    for (int32_t y = centre.y - radius; y <= centre.y + radius; y++)
+    {
+        for (int32_t x = centre.x - radius; x <= centre.x + radius; x++)
+        {
+            if (x >= 0 && y >= 0 && x < MAXIMUM_MAP_SIZE_TECHNICAL && y < MAXIMUM_MAP_SIZE_TECHNICAL)
+            {
+                _pathFlowFieldChangedTiles.push_back({ x, y });
+            }
+        }
+    }
+}
+
+static uint32_t PathFlowFieldGetKey(const TileCoordsXYZ& loc)
+{
+    return (static_cast<uint32_t>(loc.x) << 16) | (static_cast<uint32_t>(loc.y) << 8) | static_cast<uint32_t>(loc.z);
+}
+
+static TileCoordsXYZ PathFlowFieldGetLocation(uint32_t key)
+{
+    return { static_cast<int32_t>(key >> 16), static_cast<int32_t>((key >> 8) & 0xFF), static_cast<int32_t>(key & 0xFF) };
+}
+
+static bool PathFlowFieldIsWalkable(const PathElement* pathElement)
+{
+    if (pathElement->IsGhost() || pathElement->IsWide())
+        return false;
+
+    // Like peep_pathfind_heuristic_search(), a queue of a ride only ends the search where it has exactly two edges.
+    if (pathElement->IsQueue() && pathElement->GetRideIndex() != RIDE_ID_NULL)
+        return bitcount(pathElement->GetEdges()) != 2;
+
+    return true;
+}
+
+/**
+ * Returns the walkable path element with its base at loc, nullptr if there is none.
+ */
+static PathElement* PathFlowFieldGetPath(const TileCoordsXYZ& loc)
+{
+    for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(loc.ToCoordsXY()))
+    {
+        if (PathFlowFieldIsWalkable(pathElement) && pathElement->base_height == loc.z)
+            return pathElement;
+    }
+    return nullptr;
+}
+
+/**
+ * Returns the location a guest leaving the path element at loc in direction arrives at, at the height it leaves the
+ * path.
+ */
+static TileCoordsXYZ PathFlowFieldGetNextLocation(const TileCoordsXYZ& loc, const PathElement* pathElement, Direction direction)
+{
+    TileCoordsXYZ nextLoc = { loc.x + TileDirectionDelta[direction].x, loc.y + TileDirectionDelta[direction].y, loc.z };
+    if (pathElement->IsSloped() && pathElement->GetSlopeDirection() == direction)
+    {
+        nextLoc.z += 2;
+    }
+    return nextLoc;
+}
+
+/**
+ * Returns the walkable path element a guest moving in direction steps onto at nextLoc, nullptr if there is none.
+ * nextLoc is updated to the base height of the path.
+ */
+static PathElement* PathFlowFieldGetNextPath(TileCoordsXYZ& nextLoc, Direction direction)
+{
+    for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(nextLoc.ToCoordsXY()))
+    {
+        if (!PathFlowFieldIsWalkable(pathElement))
+            continue;
+        if (!IsValidPathZAndDirection(pathElement->as<TileElement>(), nextLoc.z, direction))
+            continue;
+
+        nextLoc.z = pathElement->base_height;
+        return pathElement;
+    }
+    return nullptr;
+}
+
+/**
+ * Calls func with the location of each path a guest on the path element at loc can walk onto.
+ */
+template<typename TFunc> static void PathFlowFieldForEachNext(const TileCoordsXYZ& loc, PathElement* pathElement, TFunc func)
+{
+    const auto edges = path_get_permitted_edges(pathElement);
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(edges & (1 << direction)))
+            continue;
+
+        auto nextLoc = PathFlowFieldGetNextLocation(loc, pathElement, direction);
+        if (PathFlowFieldGetNextPath(nextLoc, direction) != nullptr)
+        {
+            func(nextLoc);
+        }
+    }
+}
+
+/**
+ * Calls func with the location of each path a guest can walk onto loc from.
+ */
+template<typename TFunc> static void PathFlowFieldForEachPrevious(const TileCoordsXYZ& loc, TFunc func)
+{
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        const TileCoordsXY neighbour = { loc.x + TileDirectionDelta[direction].x, loc.y + TileDirectionDelta[direction].y };
+        const auto towardsLoc = direction_reverse(direction);
+        for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(neighbour.ToCoordsXY()))
+        {
+            if (!PathFlowFieldIsWalkable(pathElement) || !(path_get_permitted_edges(pathElement) & (1 << towardsLoc)))
+                continue;
+
+            const TileCoordsXYZ pathLoc = { neighbour, pathElement->base_height };
+            auto nextLoc = PathFlowFieldGetNextLocation(pathLoc, pathElement, towardsLoc);
+            if (PathFlowFieldGetNextPath(nextLoc, towardsLoc) != nullptr && nextLoc == loc)
+            {
+                func(pathLoc);
+            }
+        }
+    }
+}
+
+/**
+ * Returns 0 for a path on the goal itself, 1 for a path leading onto the goal tile at the goal's height and
+ * PATH_FLOW_FIELD_UNREACHABLE for any other.
+ */
+static uint16_t PathFlowFieldGetGoalDistance(const PathFlowField& field, const TileCoordsXYZ& loc, PathElement* pathElement)
+{
+    const auto& goal = field.Goal;
+    if (loc == goal)
+        return 0;
+
+    const auto edges = path_get_permitted_edges(pathElement);
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(edges & (1 << direction)))
+            continue;
+
+        const auto nextLoc = PathFlowFieldGetNextLocation(loc, pathElement, direction);
+        if (nextLoc == goal)
+            return 1;
+    }
+    return PATH_FLOW_FIELD_UNREACHABLE;
+}
+
+static void PathFlowFieldBuild(PathFlowField& field)
+{
+    field.Distances.clear();
+    _peepPathFindIsStaff = false;
+
+    std::deque<TileCoordsXYZ> queue;
+    auto visit = [&](const TileCoordsXYZ& loc, uint16_t distance) {
+        if (field.Distances.emplace(PathFlowFieldGetKey(loc), distance).second)
+        {
+            queue.push_back(loc);
+        }
+    };
+
+    // A path on the goal tile itself (peep spawns) is distance 0, paths leading onto the goal tile at the goal's
+    // height (park entrances) are distance 1.
+    const auto& goal = field.Goal;
+    for (const auto* pathElement : OpenRCT2::TileElementsView<PathElement>(goal.ToCoordsXY()))
+    {
+        if (PathFlowFieldIsWalkable(pathElement) && pathElement->base_height == goal.z)
+        {
+            visit(goal, 0);
+            break;
+        }
+    }
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        const TileCoordsXY neighbour = { goal.x + TileDirectionDelta[direction].x, goal.y + TileDirectionDelta[direction].y };
+        for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(neighbour.ToCoordsXY()))
+        {
+            const TileCoordsXYZ pathLoc = { neighbour, pathElement->base_height };
+            if (PathFlowFieldIsWalkable(pathElement) && PathFlowFieldGetGoalDistance(field, pathLoc, pathElement) == 1)
+            {
+                visit(pathLoc, 1);
+            }
+        }
+    }
+
+    // Walk outwards, a path is one step further from the goal than the path it leads onto.
+    while (!queue.empty())
+    {
+        const auto loc = queue.front();
+        queue.pop_front();
+        const auto distance = field.Distances[PathFlowFieldGetKey(loc)];
+        if (distance == PATH_FLOW_FIELD_UNREACHABLE - 1)
+            continue;
+
+        PathFlowFieldForEachPrevious(loc, [&](const TileCoordsXYZ& pathLoc) { visit(pathLoc, distance + 1); });
+    }
+    field.Version = _pathFlowFieldVersion;
+    field.ChangedTiles = _pathFlowFieldChangedTiles.size();
+}
+
+/**
+ * Brings the distances of field up to date with the paths changed since it was built or last repaired. Only paths
+ * whose shortest way to the goal went through a changed tile can now be further away, those are found level by level
+ * and worked out again from their neighbours. Paths that got closer are then found by spreading the new distances
+ * outwards like the search in PathFlowFieldBuild(), in order of distance.
+ */
+static void PathFlowFieldRepair(PathFlowField& field)
+{
+    using QueueEntry = std::pair<uint16_t, uint32_t>;
+    using Queue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+    auto& distances = field.Distances;
+    _peepPathFindIsStaff = false;
+
+    // The changed tiles and their neighbours, whose edges lead onto them.
+    std::unordered_set<uint32_t> tiles;
+    auto addTile = [&tiles](int32_t x, int32_t y) {
+        if (x >= 0 && y >= 0 && x < MAXIMUM_MAP_SIZE_TECHNICAL && y < MAXIMUM_MAP_SIZE_TECHNICAL)
+        {
+            tiles.insert((static_cast<uint32_t>(x) << 8) | static_cast<uint32_t>(y));
+        }
+    };
+    for (size_t i = field.ChangedTiles; i < _pathFlowFieldChangedTiles.size(); i++)
+    {
+        const auto& tile = _pathFlowFieldChangedTiles[i];
+        addTile(tile.x, tile.y);
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            addTile(tile.x + TileDirectionDelta[direction].x, tile.y + TileDirectionDelta[direction].y);
+        }
+    }
+    field.ChangedTiles = _pathFlowFieldChangedTiles.size();
+
+    // All paths on the tiles might be further away now, and so might any path that was one step further from the goal
+    // than one of those unless it has another way that is as short.
+    std::unordered_set<uint32_t> raised;
+    Queue candidates;
+    auto raise = [&](uint32_t key, uint16_t distance) {
+        raised.insert(key);
+        PathFlowFieldForEachPrevious(PathFlowFieldGetLocation(key), [&](const TileCoordsXYZ& pathLoc) {
+            auto it = distances.find(PathFlowFieldGetKey(pathLoc));
+            if (it != distances.end() && it->second == distance + 1)
+            {
+                candidates.emplace(it->second, it->first);
+            }
+        });
+    };
+    if (tiles.size() * 256 < distances.size())
+    {
+        for (auto tile : tiles)
+        {
+            for (uint32_t z = 0; z < 256; z++)
+            {
+                auto it = distances.find((tile << 8) | z);
+                if (it != distances.end())
+                {
+                    raise(it->first, it->second);
+                }
+            }
+        }
+    }
+    else
+    {
+        for (const auto& [key, distance] : distances)
+        {
+            if (tiles.count(key >> 8) != 0)
+            {
+                raise(key, distance);
+            }
+        }
+    }
+    while (!candidates.empty())
+    {
+        const auto distance = candidates.top().first;
+        const auto key = candidates.top().second;
+        candidates.pop();
+        if (raised.count(key) != 0)
+            continue;
+
+        // The tile of the candidate did not change, so neither did its path and the paths it leads onto.
+        const auto loc = PathFlowFieldGetLocation(key);
+        auto* pathElement = PathFlowFieldGetPath(loc);
+        bool keepsDistance = pathElement != nullptr && PathFlowFieldGetGoalDistance(field, loc, pathElement) == distance;
+        if (pathElement != nullptr)
+        {
+            PathFlowFieldForEachNext(loc, pathElement, [&](const TileCoordsXYZ& nextLoc) {
+                const auto nextKey = PathFlowFieldGetKey(nextLoc);
+                auto it = distances.find(nextKey);
+                if (it != distances.end() && it->second + 1 == distance && raised.count(nextKey) == 0)
+                {
+                    keepsDistance = true;
+                }
+            });
+        }
+        if (!keepsDistance)
+        {
+            raise(key, distance);
+        }
+    }
+    for (auto key : raised)
+    {
+        distances.erase(key);
+    }
+
+    // Start from the best distance each of those paths, and any new path on the tiles, gets from the paths that kept
+    // theirs.
+    Queue queue;
+    auto start = [&](const TileCoordsXYZ& loc, PathElement* pathElement) {
+        auto distance = PathFlowFieldGetGoalDistance(field, loc, pathElement);
+        PathFlowFieldForEachNext(loc, pathElement, [&](const TileCoordsXYZ& nextLoc) {
+            auto it = distances.find(PathFlowFieldGetKey(nextLoc));
+            if (it != distances.end() && it->second < PATH_FLOW_FIELD_UNREACHABLE - 1)
+            {
+                distance = std::min(distance, static_cast<uint16_t>(it->second + 1));
+            }
+        });
+        if (distance != PATH_FLOW_FIELD_UNREACHABLE)
+        {
+            queue.emplace(distance, PathFlowFieldGetKey(loc));
+        }
+    };
+    for (auto key : raised)
+    {
+        const auto loc = PathFlowFieldGetLocation(key);
+        auto* pathElement = PathFlowFieldGetPath(loc);
+        if (pathElement != nullptr)
+        {
+            start(loc, pathElement);
+        }
+    }
+    for (auto tile : tiles)
+    {
+        const TileCoordsXY tileLoc = { static_cast<int32_t>(tile >> 8), static_cast<int32_t>(tile & 0xFF) };
+        for (auto* pathElement : OpenRCT2::TileElementsView<PathElement>(tileLoc.ToCoordsXY()))
+        {
+            if (PathFlowFieldIsWalkable(pathElement))
+            {
+                start({ tileLoc, pathElement->base_height }, pathElement);
+            }
+        }
+    }
+
+    while (!queue.empty())
+    {
+        const auto distance = queue.top().first;
+        const auto key = queue.top().second;
+        queue.pop();
+        auto it = distances.find(key);
+        if (it != distances.end() && it->second <= distance)
+            continue;
+
+        distances[key] = distance;
+        if (distance == PATH_FLOW_FIELD_UNREACHABLE - 1)
+            continue;
+
+        PathFlowFieldForEachPrevious(PathFlowFieldGetLocation(key), [&](const TileCoordsXYZ& pathLoc) {
+            const auto pathKey = PathFlowFieldGetKey(pathLoc);
+            auto pathIt = distances.find(pathKey);
+            if (pathIt == distances.end() || pathIt->second > distance + 1)
+            {
+                queue.emplace(static_cast<uint16_t>(distance + 1), pathKey);
+            }
+        });
+    }
+}
+
+static const PathFlowField& PathFlowFieldGet(const TileCoordsXYZ& goal)
+{
+    auto it = std::find_if(
+        _pathFlowFields.begin(), _pathFlowFields.end(), [&goal](const PathFlowField& field) { return field.Goal == goal; });
+    if (it == _pathFlowFields.end())
+    {
+        // Goals of removed entrances and spawns are never asked for again, start over once too many piled up.
+        if (_pathFlowFields.size() >= PathFlowFieldMaxCount)
+        {
+            _pathFlowFields.clear();
+        }
+        it = _pathFlowFields.insert(_pathFlowFields.end(), PathFlowField{ goal, 0, 0, {} });
+    }
+
+    if (it->Version != _pathFlowFieldVersion)
+    {
+        PathFlowFieldBuild(*it);
+    }
+    else if (it->ChangedTiles != _pathFlowFieldChangedTiles.size())
+    {
+        PathFlowFieldRepair(*it);
+    }
+    return *it;
+}
+
+static uint16_t PathFlowFieldGetDistance(const PathFlowField& field, const TileCoordsXYZ& loc)
+{
+    auto it = field.Distances.find(PathFlowFieldGetKey(loc));
+    return it != field.Distances.end() ? it->second : PATH_FLOW_FIELD_UNREACHABLE;
+}
+
+uint16_t PathFlowFieldGetDistance(const TileCoordsXYZ& goal, const TileCoordsXYZ& loc)
+{
+    return PathFlowFieldGetDistance(PathFlowFieldGet(goal), loc);
+}
+
+/**
+ * Returns the edge out of edges that leads closest to the goal of the flow field, INVALID_DIRECTION if none of them
+ * lead to it.
+ */
+static Direction PathFlowFieldChooseDirection(const PathFlowField& field, const TileCoordsXYZ& loc, uint8_t edges)
+{
+    auto* pathElement = map_get_path_element_at(loc);
+    if (pathElement == nullptr)
+        return INVALID_DIRECTION;
+
+    Direction bestDirection = INVALID_DIRECTION;
+    uint16_t bestDistance = PATH_FLOW_FIELD_UNREACHABLE;
+    for (Direction direction : ALL_DIRECTIONS)
+    {
+        if (!(edges & (1 << direction)))
+            continue;
+
+        auto nextLoc = PathFlowFieldGetNextLocation(loc, pathElement, direction);
+        uint16_t distance = PATH_FLOW_FIELD_UNREACHABLE;
+        if (nextLoc == field.Goal)
+        {
+            distance = 0;
+        }
+        else if (PathFlowFieldGetNextPath(nextLoc, direction) != nullptr)
+        {
+            distance = PathFlowFieldGetDistance(field, nextLoc);
+        }
+
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            bestDirection = direction;
+        }
+    }
+    return bestDirection;
+}
+
+Direction PathFlowFieldChooseDirection(const TileCoordsXYZ& goal, const TileCoordsXYZ& loc, uint8_t edges)
+{
+    return PathFlowFieldChooseDirection(PathFlowFieldGet(goal), loc, edges);
+}
+
+static bool guest_path_find_use_flow_fields()
+{
+    return (gParkFlags & PARK_FLAGS_FLOW_FIELD_PATHFINDING) != 0;
+}
+
+/**
+ * Gets the goal the guest at loc can reach in the fewest steps, using the flow fields.
+ * @return Index into goals, or 0xFF if none of them can be reached.
+ */
+static uint8_t get_nearest_flow_field_goal_index(const TileCoordsXYZ& loc, const std::vector<CoordsXYZD>& goals)
+{
+    uint8_t chosenGoal = 0xFF;
+    uint16_t nearestDist = PATH_FLOW_FIELD_UNREACHABLE;
+    uint8_t i = 0;
+    for (const auto& goal : goals)
+    {
+        auto dist = PathFlowFieldGetDistance(TileCoordsXYZ(goal.ToTileStart()), loc);
+        if (dist < nearestDist)
+        {
+            nearestDist = dist;
+            chosenGoal = i;
+        }
+        i++;
+    }
+    return chosenGoal;
+}
+
+/**
+ * Moves the guest one tile towards goal using its flow field.
+ * @return std::nullopt if no edge leads towards the goal and the heuristic search has to be used instead.
+ */
+static std::optional<int32_t> guest_path_find_flow_field(Peep* peep, uint8_t edges, const TileCoordsXYZ& goal)
+{
+    const auto direction = PathFlowFieldChooseDirection(PathFlowFieldGet(goal), TileCoordsXYZ{ peep->NextLoc }, edges);
+    if (direction == INVALID_DIRECTION)
+        return std::nullopt;
+
+    return peep_move_one_tile(direction, peep);
+}
+
 /**
  * Gets the nearest park entrance relative to point, by using Manhattan distance.
  * @param x x coordinate of location
@@ -1655,6 +2430,18 @@ static uint8_t get_nearest_park_entrance_index(uint16_t x, uint16_t y)
  */
 static int32_t guest_path_find_entering_park(Peep* peep, uint8_t edges)
 {
+    if (guest_path_find_use_flow_fields())
+    {
+        // Send peeps to the park entrance they can walk to in the fewest steps.
+        uint8_t chosenEntrance = get_nearest_flow_field_goal_index(TileCoordsXYZ{ peep->NextLoc }, gParkEntrances);
+        if (chosenEntrance != 0xFF)
+        {
+            auto result = guest_path_find_flow_field(peep, edges, TileCoordsXYZ(gParkEntrances[chosenEntrance]));
+            if (result.has_value())
+                return *result;
+        }
+    }
+
     // Send peeps to the nearest park entrance.
     uint8_t chosenEntrance = get_nearest_park_entrance_index(peep->NextLoc.x, peep->NextLoc.y);
 
@@ -1704,6 +2491,24 @@ static uint8_t get_nearest_peep_spawn_index(uint16_t x, uint16_t y)
  */
 static int32_t guest_path_find_leaving_park(Peep* peep, uint8_t edges)
 {
+    if (guest_path_find_use_flow_fields())
+    {
+        // Send peeps to the spawn point they can walk to in the fewest steps.
+        uint8_t chosenSpawn = get_nearest_flow_field_goal_index(TileCoordsXYZ{ peep->NextLoc }, gPeepSpawns);
+        if (chosenSpawn != 0xFF)
+        {
+            const auto peepSpawnLoc = gPeepSpawns[chosenSpawn].ToTileStart();
+            if (peepSpawnLoc.x == peep->NextLoc.x && peepSpawnLoc.y == peep->NextLoc.y)
+            {
+                return peep_move_one_tile(peepSpawnLoc.direction, peep);
+            }
+
+            auto result = guest_path_find_flow_field(peep, edges, TileCoordsXYZ(peepSpawnLoc));
+            if (result.has_value())
+                return *result;
+        }
+    }
+
     // Send peeps to the nearest spawn point.
     uint8_t chosenSpawn = get_nearest_peep_spawn_index(peep->NextLoc.x, peep->NextLoc.y);
 
@@ -1745,17 +2550,25 @@ static int32_t guest_path_find_park_entrance(Peep* peep, uint8_t edges)
     if (!(peep->PeepFlags & PEEP_FLAGS_PARK_ENTRANCE_CHOSEN))
     {
         uint8_t chosenEntrance = PARK_ENTRANCE_INDEX_NULL;
-        uint16_t nearestDist = 0xFFFF;
-        uint8_t entranceNum = 0;
-        for (const auto& entrance : gParkEntrances)
+        if (guest_path_find_use_flow_fields())
         {
-            uint16_t dist = abs(entrance.x - peep->NextLoc.x) + abs(entrance.y - peep->NextLoc.y);
-            if (dist < nearestDist)
+            chosenEntrance = get_nearest_flow_field_goal_index(TileCoordsXYZ{ peep->NextLoc }, gParkEntrances);
+        }
+
+        if (chosenEntrance == PARK_ENTRANCE_INDEX_NULL)
+        {
+            uint16_t nearestDist = 0xFFFF;
+            uint8_t entranceNum = 0;
+            for (const auto& entrance : gParkEntrances)
             {
-                nearestDist = dist;
-                chosenEntrance = entranceNum;
+                uint16_t dist = abs(entrance.x - peep->NextLoc.x) + abs(entrance.y - peep->NextLoc.y);
+                if (dist < nearestDist)
+                {
+                    nearestDist = dist;
+                    chosenEntrance = entranceNum;
+                }
+                entranceNum++;
             }
-            entranceNum++;
         }
 
         if (chosenEntrance == 0xFF)
@@ -1767,6 +2580,13 @@ static int32_t guest_path_find_park_entrance(Peep* peep, uint8_t edges)
 
     const auto& entrance = gParkEntrances[peep->ChosenParkEntrance];
 
+    if (guest_path_find_use_flow_fields())
+    {
+        auto result = guest_path_find_flow_field(peep, edges, TileCoordsXYZ(entrance));
+        if (result.has_value())
+            return *result;
+    }
+
     gPeepPathFindGoalPosition = TileCoordsXYZ(entrance);
     gPeepPathFindIgnoreForeignQueues = true;
     gPeepPathFindQueueRideIndex = RIDE_ID_NULL;
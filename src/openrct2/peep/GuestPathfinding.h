@@ -41,6 +41,61 @@ extern bool gPeepPathFindIgnoreForeignQueues;
 // the direction the peep should walk in from the current tile.
 Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep);
 
+struct PathfindingCacheStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    size_t Entries;
+};
+
+// Guests that choose between several edges at the same junction for the same goal reuse the result of an earlier
+// search, so anything that changes paths, entrances, track or banners needs to call PathfindingCacheInvalidate().
+// Cached results are only used if they are exactly what the search would return. footpathsChanged can be false if
+// no footpath or banner changed, the flow fields below only look at those.
+void PathfindingCacheInvalidate(bool footpathsChanged = true);
+// Same as PathfindingCacheInvalidate() for changes to the footpaths within radius tiles of loc, the flow fields are
+// then only worked out again around there.
+void PathfindingCacheInvalidateArea(const CoordsXY& loc, int32_t radius);
+PathfindingCacheStats PathfindingCacheGetStats();
+void PathfindingCacheResetStats();
+
+// Actions that change the footpaths around a known location keep one of these alive while they do, so the
+// PathfindingCacheInvalidate() calls of the code they use only invalidate the area within radius tiles of loc.
+struct PathfindingCacheArea
+{
+    CoordsXY Location;
+    int32_t Radius;
+    bool Invalidated = false;
+    PathfindingCacheArea* Previous;
+
+    PathfindingCacheArea(const CoordsXY& loc, int32_t radius);
+    PathfindingCacheArea(const PathfindingCacheArea&) = delete;
+    PathfindingCacheArea& operator=(const PathfindingCacheArea&) = delete;
+    ~PathfindingCacheArea();
+};
+
+// Ghosts only exist on the client that places them and guests never walk on them, game actions with
+// GAME_COMMAND_FLAG_GHOST keep one of these alive while they execute so that the caches are left alone.
+struct PathfindingCacheGhostScope
+{
+    bool Active;
+
+    explicit PathfindingCacheGhostScope(bool active);
+    PathfindingCacheGhostScope(const PathfindingCacheGhostScope&) = delete;
+    PathfindingCacheGhostScope& operator=(const PathfindingCacheGhostScope&) = delete;
+    ~PathfindingCacheGhostScope();
+};
+
+// Number of tiles a guest at loc has to walk along the footpaths to reach goal, a park entrance or peep spawn. The
+// distances come from a flow field per goal that is built on first use and repaired after the paths change. Guests
+// entering or leaving the park follow these instead of the heuristic search if the park has
+// PARK_FLAGS_FLOW_FIELD_PATHFINDING set.
+constexpr uint16_t PATH_FLOW_FIELD_UNREACHABLE = 0xFFFF;
+uint16_t PathFlowFieldGetDistance(const TileCoordsXYZ& goal, const TileCoordsXYZ& loc);
+// The edge out of edges of the path at loc that leads closest to goal, INVALID_DIRECTION if none of them lead there and
+// the guest falls back to the heuristic search.
+Direction PathFlowFieldChooseDirection(const TileCoordsXYZ& goal, const TileCoordsXYZ& loc, uint8_t edges);
+
 // Test whether the given tile can be walked onto, if the peep is currently at height currentZ and
 // moving in direction currentDirection.
 bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_t currentDirection);
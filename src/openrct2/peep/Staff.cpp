@@ -439,20 +439,11 @@ bool Staff::HasPatrolArea() const
  */
 Direction Staff::HandymanDirectionToNearestLitter() const
 {
-    uint16_t nearestLitterDist = 0xFFFF;
-    Litter* nearestLitter = nullptr;
-    for (auto litter : EntityList<Litter>())
-    {
-        uint16_t distance = abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4;
-
-        if (distance < nearestLitterDist)
-        {
-            nearestLitterDist = distance;
-            nearestLitter = litter;
-        }
-    }
+    auto* nearestLitter = FindNearest<Litter>({ x, y }, MAX_LITTER_DISTANCE, [this](const Litter* litter) -> int32_t {
+        return static_cast<uint16_t>(abs(litter->x - x) + abs(litter->y - y) + abs(litter->z - z) * 4);
+    });
 
-    if (nearestLitterDist > MAX_LITTER_DISTANCE)
+    if (nearestLitter == nullptr)
     {
         return INVALID_DIRECTION;
     }
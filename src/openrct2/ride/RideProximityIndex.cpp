@@ -0,0 +1,194 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RideProximityIndex.h"
+
+#include "../core/Guard.hpp"
+#include "../world/Map.h"
+#include "../world/TileElementsView.h"
+
+#include <algorithm>
+#include <array>
+
+using namespace OpenRCT2;
+
+static constexpr int32_t BlocksPerAxis = MAXIMUM_MAP_SIZE_TECHNICAL / RIDE_PROXIMITY_BLOCK_SIZE;
+static constexpr int32_t BlockCount = BlocksPerAxis * BlocksPerAxis;
+
+static std::array<std::bitset<MAX_RIDES>, BlockCount> _blockRides;
+static std::bitset<BlockCount> _dirtyBlocks = std::bitset<BlockCount>().set();
+// Lets the tile by tile scan of border blocks skip tiles without track, valid for blocks that are not dirty.
+static std::bitset<MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL> _tilesWithTrack;
+
+static size_t GetBlockOffset(int32_t blockX, int32_t blockY)
+{
+    return static_cast<size_t>(blockX) * BlocksPerAxis + blockY;
+}
+
+static size_t GetTileOffset(int32_t tileX, int32_t tileY)
+{
+    return static_cast<size_t>(tileX) * MAXIMUM_MAP_SIZE_TECHNICAL + tileY;
+}
+
+static bool AddRidesOnTile(std::bitset<MAX_RIDES>& rides, int32_t tileX, int32_t tileY)
+{
+    bool hasTrack = false;
+    for (auto* trackElement : TileElementsView<TrackElement>(TileCoordsXY{ tileX, tileY }.ToCoordsXY()))
+    {
+        const auto rideIndex = EnumValue(trackElement->GetRideIndex());
+        if (rideIndex < MAX_RIDES)
+        {
+            rides[rideIndex] = true;
+            hasTrack = true;
+        }
+    }
+    return hasTrack;
+}
+
+static const std::bitset<MAX_RIDES>& GetBlockRides(int32_t blockX, int32_t blockY)
+{
+    const auto offset = GetBlockOffset(blockX, blockY);
+    auto& rides = _blockRides[offset];
+    if (_dirtyBlocks[offset])
+    {
+        rides.reset();
+        for (int32_t tileX = blockX * RIDE_PROXIMITY_BLOCK_SIZE; tileX < (blockX + 1) * RIDE_PROXIMITY_BLOCK_SIZE; tileX++)
+        {
+            for (int32_t tileY = blockY * RIDE_PROXIMITY_BLOCK_SIZE; tileY < (blockY + 1) * RIDE_PROXIMITY_BLOCK_SIZE;
+                 tileY++)
+            {
+                _tilesWithTrack[GetTileOffset(tileX, tileY)] = AddRidesOnTile(rides, tileX, tileY);
+            }
+        }
+        _dirtyBlocks[offset] = false;
+    }
+    return rides;
+}
+
+void RideProximityIndexReset()
+{
+    _dirtyBlocks.set();
+}
+
+void RideProximityIndexInvalidateTile(const CoordsXY& loc)
+{
+    if (!map_is_location_valid(loc))
+        return;
+
+    const auto tileLoc = TileCoordsXY(loc);
+    _dirtyBlocks[GetBlockOffset(tileLoc.x / RIDE_PROXIMITY_BLOCK_SIZE, tileLoc.y / RIDE_PROXIMITY_BLOCK_SIZE)] = true;
+}
+
+void RideProximityIndexInvalidateRide(ride_id_t rideIndex)
+{
+    const auto index = EnumValue(rideIndex);
+    if (index >= MAX_RIDES)
+        return;
+
+    // Blocks that are not dirty list exactly the rides they hold, dirty ones are rescanned anyway.
+    for (size_t offset = 0; offset < _blockRides.size(); offset++)
+    {
+        if (_blockRides[offset][index])
+        {
+            _dirtyBlocks[offset] = true;
+        }
+    }
+}
+
+void RideProximityIndexUpdate()
+{
+    if (_dirtyBlocks.none())
+        return;
+
+    for (int32_t blockX = 0; blockX < BlocksPerAxis; blockX++)
+    {
+        for (int32_t blockY = 0; blockY < BlocksPerAxis; blockY++)
+        {
+            GetBlockRides(blockX, blockY);
+        }
+    }
+}
+
+std::bitset<MAX_RIDES> GetRidesNearLocation(const CoordsXY& centre, int32_t radius)
+{
+    Guard::Assert(centre.x % COORDS_XY_STEP == 0 && centre.y % COORDS_XY_STEP == 0 && radius % COORDS_XY_STEP == 0);
+
+    std::bitset<MAX_RIDES> result;
+
+    // Square of tiles to look at, anything outside of the map is skipped.
+    const int32_t minTileX = std::max(0, (centre.x - radius) / COORDS_XY_STEP);
+    const int32_t minTileY = std::max(0, (centre.y - radius) / COORDS_XY_STEP);
+    const int32_t maxTileX = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (centre.x + radius) / COORDS_XY_STEP);
+    const int32_t maxTileY = std::min(MAXIMUM_MAP_SIZE_TECHNICAL - 1, (centre.y + radius) / COORDS_XY_STEP);
+    if (minTileX > maxTileX || minTileY > maxTileY)
+        return result;
+
+    // Blocks entirely inside the square contribute all of their rides. The ones on the border are only scanned
+    // tile by tile if they hold a ride that has not been found yet.
+    std::array<TileCoordsXY, 64> borderBlocks;
+    size_t numBorderBlocks = 0;
+    for (int32_t blockX = minTileX / RIDE_PROXIMITY_BLOCK_SIZE; blockX <= maxTileX / RIDE_PROXIMITY_BLOCK_SIZE; blockX++)
+    {
+        for (int32_t blockY = minTileY / RIDE_PROXIMITY_BLOCK_SIZE; blockY <= maxTileY / RIDE_PROXIMITY_BLOCK_SIZE;
+             blockY++)
+        {
+            const auto& blockRides = GetBlockRides(blockX, blockY);
+            if (blockRides.none())
+                continue;
+
+            const bool isInside = blockX * RIDE_PROXIMITY_BLOCK_SIZE >= minTileX
+                && (blockX + 1) * RIDE_PROXIMITY_BLOCK_SIZE - 1 <= maxTileX && blockY * RIDE_PROXIMITY_BLOCK_SIZE >= minTileY
+                && (blockY + 1) * RIDE_PROXIMITY_BLOCK_SIZE - 1 <= maxTileY;
+            if (isInside)
+            {
+                result |= blockRides;
+            }
+            else if (numBorderBlocks < borderBlocks.size())
+            {
+                borderBlocks[numBorderBlocks++] = { blockX, blockY };
+            }
+            else
+            {
+                // Radius too large for the border list, fall back to scanning the whole square.
+                result.reset();
+                for (int32_t tileX = minTileX; tileX <= maxTileX; tileX++)
+                {
+                    for (int32_t tileY = minTileY; tileY <= maxTileY; tileY++)
+                    {
+                        AddRidesOnTile(result, tileX, tileY);
+                    }
+                }
+                return result;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < numBorderBlocks; i++)
+    {
+        const auto& block = borderBlocks[i];
+        if ((GetBlockRides(block.x, block.y) & ~result).none())
+            continue;
+
+        const int32_t startX = std::max(minTileX, block.x * RIDE_PROXIMITY_BLOCK_SIZE);
+        const int32_t startY = std::max(minTileY, block.y * RIDE_PROXIMITY_BLOCK_SIZE);
+        const int32_t endX = std::min(maxTileX, (block.x + 1) * RIDE_PROXIMITY_BLOCK_SIZE - 1);
+        const int32_t endY = std::min(maxTileY, (block.y + 1) * RIDE_PROXIMITY_BLOCK_SIZE - 1);
+        for (int32_t tileX = startX; tileX <= endX; tileX++)
+        {
+            for (int32_t tileY = startY; tileY <= endY; tileY++)
+            {
+                if (_tilesWithTrack[GetTileOffset(tileX, tileY)])
+                {
+                    AddRidesOnTile(result, tileX, tileY);
+                }
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,40 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../world/Location.hpp"
+#include "Ride.h"
+
+#include <bitset>
+
+/**
+ * Index of the rides that have track in each block of RIDE_PROXIMITY_BLOCK_SIZE x RIDE_PROXIMITY_BLOCK_SIZE tiles.
+ * tile_element_insert invalidates the tile it inserts into and tile_element_remove invalidates every block of the
+ * ride whose track it removes, blocks are rescanned the next time they are queried. Code that rewrites elements in
+ * place instead, like scripts, invalidates the tile itself.
+ */
+constexpr int32_t RIDE_PROXIMITY_BLOCK_SIZE = 4;
+
+void RideProximityIndexReset();
+void RideProximityIndexInvalidateTile(const CoordsXY& loc);
+void RideProximityIndexInvalidateRide(ride_id_t rideIndex);
+
+/**
+ * Rescans all invalidated blocks. Queries only touch blocks that are up to date afterwards, which makes them safe
+ * to run concurrently as long as the map is not modified.
+ */
+void RideProximityIndexUpdate();
+
+/**
+ * Returns the rides that have a track element on any tile within radius of centre, the same set a scan over every
+ * tile of the square would give. centre and radius must be tile aligned.
+ */
+std::bitset<MAX_RIDES> GetRidesNearLocation(const CoordsXY& centre, int32_t radius);
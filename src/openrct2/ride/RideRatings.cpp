@@ -12,11 +12,13 @@
 #include "../Cheats.h"
 #include "../Context.h"
 #include "../OpenRCT2.h"
+#include "../core/TaskScheduler.h"
 #include "../interface/Window.h"
 #include "../localisation/Date.h"
 #include "../scripting/ScriptEngine.h"
 #include "../world/Footpath.h"
 #include "../world/Map.h"
+#include "../world/Park.h"
 #include "../world/Surface.h"
 #include "Ride.h"
 #include "RideData.h"
@@ -25,6 +27,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <vector>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
@@ -78,6 +81,9 @@ struct ShelteredEights
 
 RideRatingUpdateState gRideRatingUpdateState;
 
+// Guards the loops that run the state machine to completion against track that never leads back to the station.
+static constexpr int32_t MaxRatingStepsPerRide = 0x10000;
+
 static void ride_ratings_update_state(RideRatingUpdateState& state);
 static void ride_ratings_update_state_0(RideRatingUpdateState& state);
 static void ride_ratings_update_state_1(RideRatingUpdateState& state);
@@ -92,6 +98,25 @@ static void ride_ratings_score_close_proximity(RideRatingUpdateState& state, Til
 
 static void ride_ratings_add(RatingTuple* rating, int32_t excitement, int32_t intensity, int32_t nausea);
 
+/**
+ * Runs the track walk and proximity scoring of a ride in one go, leaving the state at RIDE_RATINGS_STATE_CALCULATE if
+ * the ride can be rated. Only the map and the ride are read, so several rides can be measured at the same time as
+ * long as nothing modifies the map meanwhile.
+ */
+static void ride_ratings_measure(RideRatingUpdateState& state, ride_id_t rideIndex)
+{
+    state.CurrentRide = rideIndex;
+    state.State = RIDE_RATINGS_STATE_INITIALISE;
+    for (int32_t i = 0; i < MaxRatingStepsPerRide; i++)
+    {
+        if (state.State == RIDE_RATINGS_STATE_FIND_NEXT_RIDE || state.State == RIDE_RATINGS_STATE_CALCULATE)
+            return;
+
+        ride_ratings_update_state(state);
+    }
+    state.State = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
+}
+
 /**
  * This is a small hack function to keep calling the ride rating processor until
  * the given ride's ratings have been calculated. What ever is currently being
@@ -100,12 +125,35 @@ static void ride_ratings_add(RatingTuple* rating, int32_t excitement, int32_t in
  */
 void ride_ratings_update_ride(const Ride& ride)
 {
-    RideRatingUpdateState state;
+    RideRatingUpdateState state{};
     if (ride.status != RideStatus::Closed)
     {
-        state.CurrentRide = ride.id;
-        state.State = RIDE_RATINGS_STATE_INITIALISE;
-        while (state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+        ride_ratings_measure(state, ride.id);
+        if (state.State == RIDE_RATINGS_STATE_CALCULATE)
+        {
+            ride_ratings_update_state(state);
+        }
+    }
+}
+
+void ride_ratings_update_all_rides()
+{
+    std::vector<ride_id_t> rides;
+    for (const auto& ride : GetRideManager())
+    {
+        if (ride.status != RideStatus::Closed)
+        {
+            rides.push_back(ride.id);
+        }
+    }
+
+    // The measuring only reads the map, the results are applied in ride order afterwards as the calculation
+    // functions and plugin hooks modify the rides.
+    std::vector<RideRatingUpdateState> states(rides.size());
+    GetTaskScheduler().ParallelFor(rides.size(), [&rides, &states](size_t i) { ride_ratings_measure(states[i], rides[i]); });
+    for (auto& state : states)
+    {
+        if (state.State == RIDE_RATINGS_STATE_CALCULATE)
         {
             ride_ratings_update_state(state);
         }
@@ -123,7 +171,26 @@ void ride_ratings_update_all()
 
     // NOTE: Until the new save format only one ride can be updated at once.
     // The SV6 format can store only a single state.
-    ride_ratings_update_state(gRideRatingUpdateState);
+    auto& state = gRideRatingUpdateState;
+    if (!(gParkFlags & PARK_FLAGS_WHOLE_RIDE_RATINGS))
+    {
+        ride_ratings_update_state(state);
+        return;
+    }
+
+    // Rate a whole ride per tick instead of a single track piece. The state is back at RIDE_RATINGS_STATE_FIND_NEXT_RIDE
+    // at the end of the tick, which is all the SV6 format has to store.
+    if (state.State == RIDE_RATINGS_STATE_FIND_NEXT_RIDE)
+    {
+        for (int32_t i = 0; i < MAX_RIDES && state.State == RIDE_RATINGS_STATE_FIND_NEXT_RIDE; i++)
+        {
+            ride_ratings_update_state(state);
+        }
+    }
+    for (int32_t i = 0; i < MaxRatingStepsPerRide && state.State != RIDE_RATINGS_STATE_FIND_NEXT_RIDE; i++)
+    {
+        ride_ratings_update_state(state);
+    }
 }
 
 static void ride_ratings_update_state(RideRatingUpdateState& state)
@@ -59,6 +59,12 @@ extern RideRatingUpdateState gRideRatingUpdateState;
 void ride_ratings_update_ride(const Ride& ride);
 void ride_ratings_update_all();
 
+/**
+ * Rates all rides that are not closed right away. The track of each ride is walked on the task scheduler, the ratings
+ * are applied on the calling thread in ride order so the outcome does not depend on the number of threads.
+ */
+void ride_ratings_update_all_rides();
+
 using ride_ratings_calculation = void (*)(Ride* ride, RideRatingUpdateState& state);
 ride_ratings_calculation ride_ratings_get_calculate_func(uint8_t rideType);
 
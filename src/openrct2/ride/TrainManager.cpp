@@ -15,13 +15,22 @@
 
 namespace TrainManager
 {
+    View::Iterator::Iterator(const EntityIndexSet& _set, size_t start)
+        : set(&_set)
+        , nextIndex(_set.FindNext(start))
+    {
+        ++(*this);
+    }
+
     View::Iterator& View::Iterator::operator++()
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (nextIndex < MAX_ENTITIES && Entity == nullptr)
         {
-            Entity = GetEntity<Vehicle>(*iter++);
+            const auto index = nextIndex;
+            nextIndex = set->FindNext(index + 1);
+            Entity = GetEntity<Vehicle>(index);
             if (Entity != nullptr && !Entity->IsHead())
             {
                 Entity = nullptr;
@@ -34,4 +43,14 @@ namespace TrainManager
     {
         vec = &GetEntityList(EntityType::Vehicle);
     }
+
+    View::Iterator View::begin()
+    {
+        return Iterator(*vec, 0);
+    }
+
+    View::Iterator View::end()
+    {
+        return Iterator(*vec, MAX_ENTITIES);
+    }
 } // namespace TrainManager
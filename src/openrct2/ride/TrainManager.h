@@ -7,9 +7,11 @@
  * OpenRCT2 is licensed under the GNU General Public License version 3.
  *****************************************************************************/
 #pragma once
+#include <cstddef>
 #include <cstdint>
-#include <list>
+#include <iterator>
 
+class EntityIndexSet;
 struct Vehicle;
 
 namespace TrainManager
@@ -18,22 +20,17 @@ namespace TrainManager
     class View
     {
     private:
-        const std::list<uint16_t>* vec;
+        const EntityIndexSet* vec;
 
         class Iterator
         {
         private:
-            std::list<uint16_t>::const_iterator iter;
-            std::list<uint16_t>::const_iterator end;
+            const EntityIndexSet* set;
+            uint16_t nextIndex;
             Vehicle* Entity = nullptr;
 
         public:
-            Iterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-                : iter(_iter)
-                , end(_end)
-            {
-                ++(*this);
-            }
+            Iterator(const EntityIndexSet& _set, size_t start);
             Iterator& operator++();
 
             Iterator operator++(int)
@@ -65,13 +62,7 @@ namespace TrainManager
     public:
         View();
 
-        Iterator begin()
-        {
-            return Iterator(std::cbegin(*vec), std::cend(*vec));
-        }
-        Iterator end()
-        {
-            return Iterator(std::cend(*vec), std::cend(*vec));
-        }
+        Iterator begin();
+        Iterator end();
     };
 } // namespace TrainManager
@@ -37,6 +37,7 @@
 #include "../rct1/RCT1.h"
 #include "../rct12/RCT12.h"
 #include "../ride/Ride.h"
+#include "../ride/RideRatings.h"
 #include "../ride/Track.h"
 #include "../util/SawyerCoding.h"
 #include "../util/Util.h"
@@ -167,6 +168,21 @@ void scenario_begin()
 
     gParkFlags |= PARK_FLAGS_SPRITES_INITIALISED;
 
+    // Guests only walk to the park entrances and peep spawns by flow fields in new parks if asked to. Saved games keep
+    // the pathfinding they were started with, so they play back the same way.
+    if (gConfigGeneral.flow_field_pathfinding)
+    {
+        gParkFlags |= PARK_FLAGS_FLOW_FIELD_PATHFINDING;
+    }
+
+    // Rides are only rated a whole ride per tick in new parks if asked to, which rates the rides already built right
+    // away. Saved games keep the rating behaviour they were started with, so they play back the same way.
+    if (gConfigGeneral.whole_ride_ratings)
+    {
+        gParkFlags |= PARK_FLAGS_WHOLE_RIDE_RATINGS;
+        ride_ratings_update_all_rides();
+    }
+
     gScreenAge = 0;
 }
 
@@ -14,6 +14,8 @@
 #    include "../../../Context.h"
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
+#    include "../../../peep/GuestPathfinding.h"
+#    include "../../../ride/RideProximityIndex.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
 #    include "../../../world/Scenery.h"
@@ -126,6 +128,8 @@ namespace OpenRCT2::Scripting
                 }
             }
             map_invalidate_tile_full(_coords);
+            RideProximityIndexInvalidateTile(_coords);
+            PathfindingCacheInvalidate();
         }
     }
 
@@ -178,6 +182,7 @@ namespace OpenRCT2::Scripting
                 }
                 first[origNumElements].SetLastForTile(true);
                 map_invalidate_tile_full(_coords);
+                PathfindingCacheInvalidate();
                 result = std::make_shared<ScTileElement>(_coords, &first[index]);
             }
         }
@@ -197,6 +202,7 @@ namespace OpenRCT2::Scripting
         {
             tile_element_remove(&first[index]);
             map_invalidate_tile_full(_coords);
+            PathfindingCacheInvalidate();
         }
     }
 
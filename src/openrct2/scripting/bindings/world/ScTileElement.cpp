@@ -14,6 +14,8 @@
 #    include "../../../Context.h"
 #    include "../../../common.h"
 #    include "../../../core/Guard.hpp"
+#    include "../../../peep/GuestPathfinding.h"
+#    include "../../../ride/RideProximityIndex.h"
 #    include "../../../ride/Track.h"
 #    include "../../../world/Footpath.h"
 #    include "../../../world/Scenery.h"
@@ -1464,6 +1466,8 @@ namespace OpenRCT2::Scripting
     void ScTileElement::Invalidate()
     {
         map_invalidate_tile_full(_coords);
+        RideProximityIndexInvalidateTile(_coords);
+        PathfindingCacheInvalidate();
     }
 
     void ScTileElement::Register(duk_context* ctx)
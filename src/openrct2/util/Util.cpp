@@ -11,6 +11,7 @@
 
 #include "../common.h"
 #include "../core/Guard.hpp"
+#include "../core/TaskScheduler.h"
 #include "../interface/Window.h"
 #include "../localisation/Localisation.h"
 #include "../platform/platform.h"
@@ -18,9 +19,12 @@
 #include "zlib.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cmath>
+#include <condition_variable>
 #include <ctime>
+#include <mutex>
 #include <random>
 
 int32_t squaredmetres_to_squaredfeet(int32_t squaredMetres)
@@ -634,6 +638,155 @@ std::optional<std::vector<uint8_t>> util_zlib_deflate(const uint8_t* data, size_
     return buffer;
 }
 
+// Input per block of util_zlib_deflate_parallel, each block is primed with the window of input before it so the
+// ratio stays close to compressing everything in one go.
+constexpr size_t ZLIB_PARALLEL_BLOCK = 256 * 1024;
+constexpr size_t ZLIB_WINDOW = 32 * 1024;
+
+struct ZlibParallelBlock
+{
+    std::vector<uint8_t> Output;
+    uLong Adler = 0;
+    bool Failed = false;
+    bool Done = false;
+    std::atomic_bool Claimed = { false };
+};
+
+static bool util_zlib_deflate_block(const uint8_t* data, size_t begin, size_t end, bool last, ZlibParallelBlock& block)
+{
+    z_stream strm{};
+    // Raw deflate, the zlib header and checksum are written once for all blocks.
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return false;
+    }
+    if (begin > 0)
+    {
+        const size_t dictionaryBegin = begin - std::min(begin, ZLIB_WINDOW);
+        deflateSetDictionary(&strm, data + dictionaryBegin, static_cast<uInt>(begin - dictionaryBegin));
+    }
+
+    block.Output.resize(deflateBound(&strm, static_cast<uLong>(end - begin)) + 16);
+    strm.next_in = const_cast<Bytef*>(data + begin);
+    strm.avail_in = static_cast<uInt>(end - begin);
+    strm.next_out = block.Output.data();
+    strm.avail_out = static_cast<uInt>(block.Output.size());
+
+    // All but the last block end on a byte aligned sync flush, so the blocks can simply be concatenated.
+    const int32_t flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    int32_t ret;
+    do
+    {
+        if (strm.avail_out == 0)
+        {
+            const size_t used = block.Output.size();
+            block.Output.resize(used * 2);
+            strm.next_out = block.Output.data() + used;
+            strm.avail_out = static_cast<uInt>(used);
+        }
+        ret = deflate(&strm, flush);
+    } while (ret == Z_OK && (last || strm.avail_out == 0));
+    block.Output.resize(strm.total_out);
+    deflateEnd(&strm);
+
+    block.Adler = adler32(adler32(0L, Z_NULL, 0), data + begin, static_cast<uInt>(end - begin));
+    return ret == (last ? Z_STREAM_END : Z_OK);
+}
+
+/**
+ * @brief Deflates input into a single zlib stream like util_zlib_deflate, but compresses blocks of the input in parallel
+ * @param data Data to be compressed
+ * @param data_in_size Size of data to be compressed
+ * @param output Receives the stream in order, a block at a time as soon as it has been compressed
+ * @return Returns false when deflate has failed, output may have received part of the stream by then
+ */
+bool util_zlib_deflate_parallel(
+    const uint8_t* data, size_t data_in_size, const std::function<void(const uint8_t*, size_t)>& output)
+{
+    const size_t numBlocks = std::max<size_t>(1, (data_in_size + ZLIB_PARALLEL_BLOCK - 1) / ZLIB_PARALLEL_BLOCK);
+    std::vector<ZlibParallelBlock> blocks(numBlocks);
+    std::mutex mutex;
+    std::condition_variable blockDone;
+
+    auto compressBlock = [&](size_t index) {
+        auto& block = blocks[index];
+        if (block.Claimed.exchange(true))
+        {
+            return;
+        }
+        const size_t begin = index * ZLIB_PARALLEL_BLOCK;
+        const size_t end = std::min(data_in_size, begin + ZLIB_PARALLEL_BLOCK);
+        const bool failed = !util_zlib_deflate_block(data, begin, end, index == numBlocks - 1, block);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            block.Failed = failed;
+            block.Done = true;
+        }
+        blockDone.notify_all();
+    };
+
+    OpenRCT2::TaskGroup group;
+    for (size_t i = 1; i < numBlocks; i++)
+    {
+        group.Run([&compressBlock, i]() { compressBlock(i); });
+    }
+
+    static constexpr uint8_t header[] = { 0x78, 0x9C };
+    output(header, sizeof(header));
+
+    uLong adler = adler32(0L, Z_NULL, 0);
+    bool result = true;
+    for (size_t i = 0; i < numBlocks; i++)
+    {
+        // Blocks no worker has started yet are compressed right here, the others are already under way.
+        compressBlock(i);
+        auto& block = blocks[i];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            blockDone.wait(lock, [&block]() { return block.Done; });
+        }
+        if (block.Failed)
+        {
+            log_error("Error compressing data.");
+            group.Cancel();
+            result = false;
+            break;
+        }
+
+        output(block.Output.data(), block.Output.size());
+        const size_t blockSize = std::min(data_in_size - i * ZLIB_PARALLEL_BLOCK, ZLIB_PARALLEL_BLOCK);
+        adler = adler32_combine(adler, block.Adler, static_cast<z_off_t>(blockSize));
+        block.Output = {};
+    }
+    group.Wait();
+
+    if (result)
+    {
+        const uint8_t trailer[] = {
+            static_cast<uint8_t>(adler >> 24),
+            static_cast<uint8_t>(adler >> 16),
+            static_cast<uint8_t>(adler >> 8),
+            static_cast<uint8_t>(adler),
+        };
+        output(trailer, sizeof(trailer));
+    }
+    return result;
+}
+
+/**
+ * @brief Returns the most util_zlib_deflate_parallel can output for the given size of input
+ */
+size_t util_zlib_deflate_parallel_bound(size_t data_in_size)
+{
+    // zlib header and checksum, then each block with room for its sync flush marker.
+    size_t bound = 6;
+    for (size_t begin = 0; begin < data_in_size || begin == 0; begin += ZLIB_PARALLEL_BLOCK)
+    {
+        bound += compressBound(static_cast<uLong>(std::min(data_in_size - begin, ZLIB_PARALLEL_BLOCK))) + 5;
+    }
+    return bound;
+}
+
 // Compress the source to gzip-compatible stream, write to dest.
 // Mainly used for compressing the crashdumps
 bool util_gzip_compress(FILE* source, FILE* dest)
@@ -13,6 +13,7 @@
 
 #include <cstdio>
 #include <ctime>
+#include <functional>
 #include <optional>
 #include <type_traits>
 #include <vector>
@@ -57,6 +58,9 @@ uint32_t util_rand();
 
 std::optional<std::vector<uint8_t>> util_zlib_deflate(const uint8_t* data, size_t data_in_size);
 uint8_t* util_zlib_inflate(const uint8_t* data, size_t data_in_size, size_t* data_out_size);
+bool util_zlib_deflate_parallel(
+    const uint8_t* data, size_t data_in_size, const std::function<void(const uint8_t*, size_t)>& output);
+size_t util_zlib_deflate_parallel_bound(size_t data_in_size);
 bool util_gzip_compress(FILE* source, FILE* dest);
 std::vector<uint8_t> Gzip(const void* data, const size_t dataLen);
 std::vector<uint8_t> Ungzip(const void* data, const size_t dataLen);
@@ -11,11 +11,14 @@
 
 #include "../common.h"
 #include "../rct12/RCT12.h"
+#include "../util/Util.h"
 #include "Entity.h"
 #include "EntityBase.h"
 #include "Location.hpp"
 
-#include <list>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <vector>
 
 enum class EntityListId : uint8_t
@@ -23,13 +26,189 @@ enum class EntityListId : uint8_t
     Count = 6,
 };
 
-const std::list<uint16_t>& GetEntityList(const EntityType id);
+/**
+ * Set of entity indices stored as a flat bitmap over all entity slots. Insertion and removal are O(1) and iteration
+ * always visits indices in ascending order, which the game logic relies on to stay deterministic.
+ */
+class EntityIndexSet
+{
+private:
+    static constexpr size_t BitsPerWord = 64;
+    static constexpr size_t WordCount = (MAX_ENTITIES + BitsPerWord - 1) / BitsPerWord;
+
+    std::array<uint64_t, WordCount> _words{};
+    uint16_t _count = 0;
+
+public:
+    bool Contains(uint16_t index) const
+    {
+        return (_words[index / BitsPerWord] & (1ULL << (index % BitsPerWord))) != 0;
+    }
+
+    void Insert(uint16_t index)
+    {
+        if (!Contains(index))
+        {
+            _words[index / BitsPerWord] |= 1ULL << (index % BitsPerWord);
+            _count++;
+        }
+    }
+
+    void Erase(uint16_t index)
+    {
+        if (Contains(index))
+        {
+            _words[index / BitsPerWord] &= ~(1ULL << (index % BitsPerWord));
+            _count--;
+        }
+    }
+
+    void Clear()
+    {
+        _words.fill(0);
+        _count = 0;
+    }
+
+    uint16_t Size() const
+    {
+        return _count;
+    }
+
+    bool Empty() const
+    {
+        return _count == 0;
+    }
+
+    /**
+     * Returns the lowest index in the set that is not less than from, or MAX_ENTITIES if there is none.
+     */
+    uint16_t FindNext(size_t from) const
+    {
+        if (from >= MAX_ENTITIES)
+            return MAX_ENTITIES;
+
+        size_t word = from / BitsPerWord;
+        uint64_t bits = _words[word] & (~0ULL << (from % BitsPerWord));
+        while (bits == 0)
+        {
+            if (++word == WordCount)
+                return MAX_ENTITIES;
+            bits = _words[word];
+        }
+        return static_cast<uint16_t>(word * BitsPerWord + bitscanforward(static_cast<int64_t>(bits)));
+    }
+};
+
+const EntityIndexSet& GetEntityList(const EntityType id);
 
 uint16_t GetEntityListCount(EntityType list);
 uint16_t GetMiscEntityCount();
 uint16_t GetNumFreeEntities();
 const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos);
 
+/**
+ * Besides the per-tile index, entities are bucketed per type in blocks of ENTITY_BLOCK_SIZE map units. Queries over an
+ * area larger than a few tiles only need to look at the entities of one type in the blocks the area overlaps.
+ */
+constexpr const int32_t ENTITY_BLOCK_SIZE = 8 * COORDS_XY_STEP;
+constexpr const int32_t ENTITY_BLOCKS_PER_AXIS = 32;
+
+const std::vector<uint16_t>& GetEntityBlockList(EntityType type, int32_t blockX, int32_t blockY);
+const std::vector<uint16_t>& GetEntityBlockListNull(EntityType type);
+
+/**
+ * Calls func for every entity of type T in the blocks overlapping the square of the given range around centre. This
+ * visits a superset of the entities in range, in no particular order; func is responsible for the exact test. Entities
+ * without a valid location are always visited. Entities must not be created, moved or removed from within func.
+ */
+template<typename T, typename TFunc> void ForEachEntityInRange(const CoordsXY& centre, int32_t range, TFunc&& func)
+{
+    const auto toBlock = [](int32_t coord) { return std::clamp(coord / ENTITY_BLOCK_SIZE, 0, ENTITY_BLOCKS_PER_AXIS - 1); };
+    const auto minBlockX = toBlock(centre.x - range);
+    const auto minBlockY = toBlock(centre.y - range);
+    const auto maxBlockX = toBlock(centre.x + range);
+    const auto maxBlockY = toBlock(centre.y + range);
+    for (int32_t blockY = minBlockY; blockY <= maxBlockY; blockY++)
+    {
+        for (int32_t blockX = minBlockX; blockX <= maxBlockX; blockX++)
+        {
+            for (auto index : GetEntityBlockList(T::cEntityType, blockX, blockY))
+            {
+                if (auto* entity = GetEntity<T>(index); entity != nullptr)
+                {
+                    func(entity);
+                }
+            }
+        }
+    }
+    for (auto index : GetEntityBlockListNull(T::cEntityType))
+    {
+        if (auto* entity = GetEntity<T>(index); entity != nullptr)
+        {
+            func(entity);
+        }
+    }
+}
+
+/**
+ * Returns all entities of type T within radius of centre on the x/y plane, in sprite_index order.
+ */
+template<typename T> std::vector<T*> QueryRadius(const CoordsXY& centre, int32_t radius)
+{
+    std::vector<T*> result;
+    const int64_t radiusSquared = static_cast<int64_t>(radius) * radius;
+    ForEachEntityInRange<T>(centre, radius, [&](T* entity) {
+        const int64_t dx = entity->x - centre.x;
+        const int64_t dy = entity->y - centre.y;
+        if (dx * dx + dy * dy <= radiusSquared)
+        {
+            result.push_back(entity);
+        }
+    });
+    std::sort(result.begin(), result.end(), [](const T* a, const T* b) { return a->sprite_index < b->sprite_index; });
+    return result;
+}
+
+/**
+ * Counts the entities of type T whose x and y are both within halfSize of centre.
+ */
+template<typename T> uint32_t CountInBox(const CoordsXY& centre, int32_t halfSize)
+{
+    uint32_t count = 0;
+    ForEachEntityInRange<T>(centre, halfSize, [&](const T* entity) {
+        if (std::abs(entity->x - centre.x) <= halfSize && std::abs(entity->y - centre.y) <= halfSize)
+        {
+            count++;
+        }
+    });
+    return count;
+}
+
+/**
+ * Returns the entity of type T with the smallest distanceFn(entity) that is not greater than maxDistance, or nullptr.
+ * Ties go to the lowest sprite_index, like a linear scan over EntityList<T> would. distanceFn must never be less than
+ * the x or y offset from centre, otherwise entities outside of the searched blocks could have been nearer.
+ */
+template<typename T, typename TDistanceFn>
+T* FindNearest(const CoordsXY& centre, int32_t maxDistance, TDistanceFn&& distanceFn)
+{
+    T* nearest = nullptr;
+    int32_t nearestDistance = 0;
+    ForEachEntityInRange<T>(centre, maxDistance, [&](T* entity) {
+        const int32_t distance = distanceFn(entity);
+        if (distance > maxDistance)
+            return;
+
+        if (nearest == nullptr || distance < nearestDistance
+            || (distance == nearestDistance && entity->sprite_index < nearest->sprite_index))
+        {
+            nearest = entity;
+            nearestDistance = distance;
+        }
+    });
+    return nearest;
+}
+
 template<typename T> class EntityTileIterator
 {
 private:
@@ -105,14 +284,15 @@ public:
 template<typename T> class EntityListIterator
 {
 private:
-    std::list<uint16_t>::const_iterator iter;
-    std::list<uint16_t>::const_iterator end;
+    // The next index is looked up ahead of time so the current entity can be removed while iterating.
+    const EntityIndexSet* set;
+    uint16_t nextIndex;
     T* Entity = nullptr;
 
 public:
-    EntityListIterator(std::list<uint16_t>::const_iterator _iter, std::list<uint16_t>::const_iterator _end)
-        : iter(_iter)
-        , end(_end)
+    EntityListIterator(const EntityIndexSet& _set, size_t start)
+        : set(&_set)
+        , nextIndex(_set.FindNext(start))
     {
         ++(*this);
     }
@@ -120,9 +300,11 @@ public:
     {
         Entity = nullptr;
 
-        while (iter != end && Entity == nullptr)
+        while (nextIndex < MAX_ENTITIES && Entity == nullptr)
         {
-            Entity = GetEntity<T>(*iter++);
+            const auto index = nextIndex;
+            nextIndex = set->FindNext(index + 1);
+            Entity = GetEntity<T>(index);
         }
         return *this;
     }
@@ -131,7 +313,7 @@ public:
     {
         EntityListIterator retval = *this;
         ++(*this);
-        return *iter;
+        return retval;
     }
     bool operator==(EntityListIterator other) const
     {
@@ -157,7 +339,7 @@ template<typename T = EntityBase> class EntityList
 {
 private:
     using EntityListIterator_t = EntityListIterator<T>;
-    const std::list<uint16_t>& vec;
+    const EntityIndexSet& vec;
 
 public:
     EntityList()
@@ -167,10 +349,10 @@ public:
 
     EntityListIterator_t begin() const
     {
-        return EntityListIterator_t(std::cbegin(vec), std::cend(vec));
+        return EntityListIterator_t(vec, 0);
     }
     EntityListIterator_t end() const
     {
-        return EntityListIterator_t(std::cend(vec), std::cend(vec));
+        return EntityListIterator_t(vec, MAX_ENTITIES);
     }
 };
@@ -25,6 +25,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -36,12 +37,16 @@
 #include "Park.h"
 #include "Sprite.h"
 #include "Surface.h"
+#include "TileElementsView.h"
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
 
+using namespace OpenRCT2;
 using namespace OpenRCT2::TrackMetaData;
 void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElement* tileElement);
+static void footpath_update_path_wide_flags_on_tile(const CoordsXY& footpathPos);
 
 FootpathSelection gFootpathSelection;
 ProvisionalFootpath gProvisionalFootpath;
@@ -1159,6 +1164,7 @@ void footpath_chain_ride_queue(
 
             curQueuePos = targetQueuePos;
             map_invalidate_element(targetQueuePos, tileElement);
+            PathfindingCacheInvalidateArea(targetQueuePos, 0);
 
             if (lastQueuePathElement == nullptr)
             {
@@ -1796,6 +1802,25 @@ static void footpath_clear_wide(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+/**
+ * Returns the wide flags of the path elements on the tile as a bit mask, or std::nullopt if there are more path
+ * elements than fit in it.
+ */
+static std::optional<uint64_t> footpath_get_wide_flags(const CoordsXY& footpathPos)
+{
+    uint64_t wideFlags = 0;
+    uint32_t index = 0;
+    for (const auto* pathElement : TileElementsView<PathElement>(footpathPos))
+    {
+        if (index >= 64)
+            return std::nullopt;
+        if (pathElement->IsWide())
+            wideFlags |= 1ULL << index;
+        index++;
+    }
+    return wideFlags;
+}
+
 /**
  *
  *  rct2: 0x006A8ACF
@@ -1832,6 +1857,17 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     if (map_is_location_at_edge(footpathPos))
         return;
 
+    // The flags are recomputed every time, only an actual change affects the pathfinding.
+    const auto oldWideFlags = footpath_get_wide_flags(footpathPos);
+    footpath_update_path_wide_flags_on_tile(footpathPos);
+    if (!oldWideFlags.has_value() || footpath_get_wide_flags(footpathPos) != oldWideFlags)
+    {
+        PathfindingCacheInvalidateArea(footpathPos, 0);
+    }
+}
+
+static void footpath_update_path_wide_flags_on_tile(const CoordsXY& footpathPos)
+{
     footpath_clear_wide(footpathPos);
     /* Rather than clearing the wide flag of the following tiles and
      * checking the state of them later, leave them intact and assume
@@ -2269,6 +2305,9 @@ static void footpath_fix_corners_around(const TileCoordsXY& footpathPos, TileEle
  */
 void footpath_remove_edges_at(const CoordsXY& footpathPos, TileElement* tileElement)
 {
+    // Disconnecting a queue from a neighbouring path can reconnect it to the path on the other side.
+    PathfindingCacheInvalidateArea(footpathPos, 2);
+
     if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
     {
         auto rideIndex = tileElement->AsTrack()->GetRideIndex();
@@ -36,7 +36,10 @@
 #include "../network/network.h"
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
+#include "../paint/PaintTileCache.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/RideData.h"
+#include "../ride/RideProximityIndex.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../ride/TrackDesign.h"
@@ -127,6 +130,7 @@ void StashMap()
     _mapSizeStash = gMapSize;
     _currentRotationStash = gCurrentRotation;
     _tileElementsInUseStash = _tileElementsInUse;
+    PaintTileCacheReset();
 }
 
 void UnstashMap()
@@ -136,6 +140,7 @@ void UnstashMap()
     gMapSize = _mapSizeStash;
     gCurrentRotation = _currentRotationStash;
     _tileElementsInUse = _tileElementsInUseStash;
+    PaintTileCacheReset();
 }
 
 const std::vector<TileElement>& GetTileElements()
@@ -148,6 +153,9 @@ void SetTileElements(std::vector<TileElement>&& tileElements)
     _tileElements = std::move(tileElements);
     _tileIndex = TilePointerIndex<TileElement>(MAXIMUM_MAP_SIZE_TECHNICAL, _tileElements.data());
     _tileElementsInUse = _tileElements.size();
+    RideProximityIndexReset();
+    PathfindingCacheInvalidate();
+    PaintTileCacheReset();
 }
 
 static void ReorganiseTileElements(size_t capacity)
@@ -1039,6 +1047,13 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  */
 void tile_element_remove(TileElement* tileElement)
 {
+    const auto type = tileElement->GetType();
+    PathfindingCacheInvalidate(type == TILE_ELEMENT_TYPE_PATH || type == TILE_ELEMENT_TYPE_BANNER);
+    if (type == TILE_ELEMENT_TYPE_TRACK)
+    {
+        RideProximityIndexInvalidateRide(tileElement->AsTrack()->GetRideIndex());
+    }
+
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
     // after copy it to it's new position
@@ -1092,6 +1107,9 @@ void map_remove_all_rides()
                 break;
         }
     } while (tile_element_iterator_next(&it));
+
+    // The queues no longer belong to a ride, guests can walk along them now.
+    PathfindingCacheInvalidate();
 }
 
 /**
@@ -1203,6 +1221,9 @@ TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants
 
     // Set tile index pointer to point to new element block
     _tileIndex.SetTile(tileLoc, newTileElement);
+    RideProximityIndexInvalidateTile(loc);
+    PaintTileCacheInvalidateTile(loc);
+    PathfindingCacheInvalidateArea(loc, 0);
 
     bool isLastForTile = false;
     if (originalTileElement == nullptr)
@@ -1795,6 +1816,7 @@ ScreenCoordsXY translate_3d_to_2d_with_z(int32_t rotation, const CoordsXYZ& pos)
 
 static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int32_t z1, int32_t maxZoom)
 {
+    PaintTileCacheInvalidateTile({ x, y });
     if (gOpenRCT2Headless)
         return;
 
@@ -1845,6 +1867,9 @@ void map_invalidate_tile_zoom0(const CoordsXYRangedZ& tilePos)
  */
 void map_invalidate_tile_full(const CoordsXY& tilePos)
 {
+    // Surface edges and supports of the neighbouring tiles depend on the tile as well.
+    PaintTileCacheInvalidateRange(
+        tilePos - CoordsXY{ COORDS_XY_STEP, COORDS_XY_STEP }, tilePos + CoordsXY{ COORDS_XY_STEP, COORDS_XY_STEP });
     map_invalidate_tile({ tilePos, 0, 2080 });
 }
 
@@ -1857,6 +1882,9 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    PaintTileCacheInvalidateRange(
+        mins - CoordsXY{ COORDS_XY_STEP, COORDS_XY_STEP }, maxs + CoordsXY{ COORDS_XY_STEP, COORDS_XY_STEP });
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
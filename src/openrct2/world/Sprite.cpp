@@ -10,11 +10,13 @@
 #include "Sprite.h"
 
 #include "../Game.h"
+#include "../config/Config.h"
 #include "../core/ChecksumStream.h"
 #include "../core/Crypt.h"
 #include "../core/DataSerialiser.h"
 #include "../core/Guard.hpp"
 #include "../core/MemoryStream.h"
+#include "../core/TaskScheduler.h"
 #include "../interface/Viewport.h"
 #include "../peep/Peep.h"
 #include "../peep/RideUseSystem.h"
@@ -30,12 +32,13 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iterator>
 #include <numeric>
 #include <vector>
 
 static rct_sprite _spriteList[MAX_ENTITIES];
-static std::array<std::list<uint16_t>, EnumValue(EntityType::Count)> gEntityLists;
+static std::array<EntityIndexSet, EnumValue(EntityType::Count)> gEntityLists;
 static std::vector<uint16_t> _freeIdList;
 
 static bool _spriteFlashingList[MAX_ENTITIES];
@@ -45,6 +48,12 @@ constexpr const uint32_t SPATIAL_INDEX_LOCATION_NULL = SPATIAL_INDEX_SIZE - 1;
 
 static std::array<std::vector<uint16_t>, SPATIAL_INDEX_SIZE> gSpriteSpatialIndex;
 
+static_assert(ENTITY_BLOCK_SIZE * ENTITY_BLOCKS_PER_AXIS == MAXIMUM_MAP_SIZE_BIG);
+constexpr const uint32_t ENTITY_BLOCK_INDEX_SIZE = (ENTITY_BLOCKS_PER_AXIS * ENTITY_BLOCKS_PER_AXIS) + 1;
+constexpr const uint32_t ENTITY_BLOCK_INDEX_NULL = ENTITY_BLOCK_INDEX_SIZE - 1;
+
+static std::array<std::array<std::vector<uint16_t>, ENTITY_BLOCK_INDEX_SIZE>, EnumValue(EntityType::Count)> gEntityBlockIndex;
+
 static void FreeEntity(EntityBase& entity);
 
 static constexpr size_t GetSpatialIndexOffset(const CoordsXY& loc)
@@ -62,6 +71,14 @@ static constexpr size_t GetSpatialIndexOffset(const CoordsXY& loc)
     return tileX * MAXIMUM_MAP_SIZE_TECHNICAL + tileY;
 }
 
+static constexpr size_t GetEntityBlockIndexOffset(const CoordsXY& loc)
+{
+    if (loc.IsNull() || loc.x < 0 || loc.y < 0 || loc.x >= MAXIMUM_MAP_SIZE_BIG || loc.y >= MAXIMUM_MAP_SIZE_BIG)
+        return ENTITY_BLOCK_INDEX_NULL;
+
+    return (loc.y / ENTITY_BLOCK_SIZE) * ENTITY_BLOCKS_PER_AXIS + (loc.x / ENTITY_BLOCK_SIZE);
+}
+
 // Required for GetEntity to return a default
 template<> bool EntityBase::Is<EntityBase>() const
 {
@@ -114,7 +131,7 @@ template<> bool EntityBase::Is<ExplosionCloud>() const
 
 uint16_t GetEntityListCount(EntityType type)
 {
-    return static_cast<uint16_t>(gEntityLists[EnumValue(type)].size());
+    return gEntityLists[EnumValue(type)].Size();
 }
 
 uint16_t GetNumFreeEntities()
@@ -157,6 +174,27 @@ const std::vector<uint16_t>& GetEntityTileList(const CoordsXY& spritePos)
     return gSpriteSpatialIndex[GetSpatialIndexOffset(spritePos)];
 }
 
+const std::vector<uint16_t>& GetEntityBlockList(EntityType type, int32_t blockX, int32_t blockY)
+{
+    static const std::vector<uint16_t> empty;
+    if (type >= EntityType::Count || blockX < 0 || blockY < 0 || blockX >= ENTITY_BLOCKS_PER_AXIS
+        || blockY >= ENTITY_BLOCKS_PER_AXIS)
+    {
+        return empty;
+    }
+    return gEntityBlockIndex[EnumValue(type)][blockY * ENTITY_BLOCKS_PER_AXIS + blockX];
+}
+
+const std::vector<uint16_t>& GetEntityBlockListNull(EntityType type)
+{
+    static const std::vector<uint16_t> empty;
+    if (type >= EntityType::Count)
+    {
+        return empty;
+    }
+    return gEntityBlockIndex[EnumValue(type)][ENTITY_BLOCK_INDEX_NULL];
+}
+
 void EntityBase::Invalidate()
 {
     if (x == LOCATION_NULL)
@@ -199,7 +237,7 @@ static void ResetEntityLists()
 {
     for (auto& list : gEntityLists)
     {
-        list.clear();
+        list.Clear();
     }
 }
 
@@ -212,7 +250,7 @@ static void ResetFreeIds()
     std::iota(std::rbegin(_freeIdList), std::rend(_freeIdList), 0);
 }
 
-const std::list<uint16_t>& GetEntityList(const EntityType id)
+const EntityIndexSet& GetEntityList(const EntityType id)
 {
     return gEntityLists[EnumValue(id)];
 }
@@ -270,6 +308,13 @@ void reset_sprite_spatial_index()
     {
         vec.clear();
     }
+    for (auto& blocks : gEntityBlockIndex)
+    {
+        for (auto& vec : blocks)
+        {
+            vec.clear();
+        }
+    }
     for (size_t i = 0; i < MAX_ENTITIES; i++)
     {
         auto* spr = GetEntity(i);
@@ -295,7 +340,7 @@ template<typename... T> void NetworkSerialiseEntityTypes(DataSerialiser& ds)
     (NetworkSerialseEntityType<T>(ds), ...);
 }
 
-rct_sprite_checksum sprite_checksum()
+static rct_sprite_checksum SpriteChecksumLegacy()
 {
     rct_sprite_checksum checksum{};
 
@@ -305,6 +350,155 @@ rct_sprite_checksum sprite_checksum()
 
     return checksum;
 }
+
+/**
+ * Hash of an entity as last computed along with the bytes it was computed from. Serialise only reads the entity
+ * itself, so while those bytes stay the same so does the hash. Entity fields are written directly all over the game,
+ * there is no single place to mark an entity dirty, so the copies (about 5 MiB for all slots) are compared instead.
+ */
+struct EntityChecksum
+{
+    rct_sprite Sprite;
+    uint64_t Hash = 0;
+    bool Valid = false;
+};
+
+static std::vector<EntityChecksum> _entityChecksums;
+
+static bool IsChecksummedEntity(const rct_sprite& sprite)
+{
+    switch (sprite.base.Type)
+    {
+        case EntityType::Guest:
+        case EntityType::Staff:
+        case EntityType::Vehicle:
+        case EntityType::Litter:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint64_t ComputeEntityHash(rct_sprite& sprite)
+{
+    std::array<std::byte, 20> raw{};
+    OpenRCT2::ChecksumStream ms(raw);
+    DataSerialiser ds(true, ms);
+    switch (sprite.base.Type)
+    {
+        case EntityType::Guest:
+            reinterpret_cast<Guest&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Staff:
+            reinterpret_cast<Staff&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Vehicle:
+            reinterpret_cast<Vehicle&>(sprite).Serialise(ds);
+            break;
+        case EntityType::Litter:
+            reinterpret_cast<Litter&>(sprite).Serialise(ds);
+            break;
+        default:
+            break;
+    }
+
+    uint64_t hash;
+    std::memcpy(&hash, raw.data(), sizeof(hash));
+    return hash;
+}
+
+// Combines the entity hashes in slot order, the serialised entities include their index so slots can not swap.
+template<typename TFunc> static rct_sprite_checksum CombineEntityHashes(TFunc&& getHash)
+{
+    rct_sprite_checksum checksum{};
+
+    OpenRCT2::ChecksumStream ms(checksum.raw);
+    for (size_t i = 0; i < MAX_ENTITIES; i++)
+    {
+        if (IsChecksummedEntity(_spriteList[i]))
+        {
+            const uint64_t hash = getHash(i);
+            ms.Write(&hash, sizeof(hash));
+        }
+    }
+
+    return checksum;
+}
+
+static rct_sprite_checksum SpriteChecksumIncremental()
+{
+    _entityChecksums.resize(MAX_ENTITIES);
+
+    OpenRCT2::GetTaskScheduler().ParallelForRange(MAX_ENTITIES, [](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            auto& sprite = _spriteList[i];
+            auto& entry = _entityChecksums[i];
+            if (!IsChecksummedEntity(sprite))
+            {
+                entry.Valid = false;
+            }
+            else if (!entry.Valid || std::memcmp(&entry.Sprite, &sprite, sizeof(sprite)) != 0)
+            {
+                entry.Hash = ComputeEntityHash(sprite);
+                std::memcpy(&entry.Sprite, &sprite, sizeof(sprite));
+                entry.Valid = true;
+            }
+        }
+    });
+
+    return CombineEntityHashes([](size_t i) { return _entityChecksums[i].Hash; });
+}
+
+static rct_sprite_checksum SpriteChecksumFull()
+{
+    std::vector<uint64_t> hashes(MAX_ENTITIES);
+    OpenRCT2::GetTaskScheduler().ParallelForRange(MAX_ENTITIES, [&hashes](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (IsChecksummedEntity(_spriteList[i]))
+            {
+                hashes[i] = ComputeEntityHash(_spriteList[i]);
+            }
+        }
+    });
+
+    return CombineEntityHashes([&hashes](size_t i) { return hashes[i]; });
+}
+
+rct_sprite_checksum sprite_checksum()
+{
+    const auto mode = gConfigNetwork.verify_sprite_checksums ? SpriteChecksumMode::Verify : SpriteChecksumMode::Incremental;
+    return sprite_checksum(mode);
+}
+
+rct_sprite_checksum sprite_checksum(SpriteChecksumMode mode)
+{
+    switch (mode)
+    {
+        case SpriteChecksumMode::Incremental:
+            return SpriteChecksumIncremental();
+        case SpriteChecksumMode::Full:
+            return SpriteChecksumFull();
+        case SpriteChecksumMode::Verify:
+        {
+            auto checksum = SpriteChecksumIncremental();
+            auto fullChecksum = SpriteChecksumFull();
+            if (checksum.raw != fullChecksum.raw)
+            {
+                log_error(
+                    "Incremental sprite checksum %s does not match the full checksum %s", checksum.ToString().c_str(),
+                    fullChecksum.ToString().c_str());
+                _entityChecksums.clear();
+                return fullChecksum;
+            }
+            return checksum;
+        }
+        case SpriteChecksumMode::Legacy:
+            return SpriteChecksumLegacy();
+    }
+    return rct_sprite_checksum{};
+}
 #else
 
 rct_sprite_checksum sprite_checksum()
@@ -312,6 +506,11 @@ rct_sprite_checksum sprite_checksum()
     return rct_sprite_checksum{};
 }
 
+rct_sprite_checksum sprite_checksum(SpriteChecksumMode mode)
+{
+    return rct_sprite_checksum{};
+}
+
 #endif // DISABLE_NETWORK
 
 static void sprite_reset(EntityBase* sprite)
@@ -330,9 +529,8 @@ static void sprite_reset(EntityBase* sprite)
 static constexpr uint16_t MAX_MISC_SPRITES = 300;
 static void AddToEntityList(EntityBase* entity)
 {
-    auto& list = gEntityLists[EnumValue(entity->Type)];
-    // Entity list must be in sprite_index order to prevent desync issues
-    list.insert(std::lower_bound(std::begin(list), std::end(list), entity->sprite_index), entity->sprite_index);
+    // Entity lists are iterated in sprite_index order to prevent desync issues
+    gEntityLists[EnumValue(entity->Type)].Insert(entity->sprite_index);
 }
 
 static void AddToFreeList(uint16_t index)
@@ -343,12 +541,7 @@ static void AddToFreeList(uint16_t index)
 
 static void RemoveFromEntityList(EntityBase* entity)
 {
-    auto& list = gEntityLists[EnumValue(entity->Type)];
-    auto ptr = std::lower_bound(std::begin(list), std::end(list), entity->sprite_index);
-    if (ptr != std::end(list) && *ptr == entity->sprite_index)
-    {
-        list.erase(ptr);
-    }
+    gEntityLists[EnumValue(entity->Type)].Erase(entity->sprite_index);
 }
 
 uint16_t GetMiscEntityCount()
@@ -466,6 +659,27 @@ static void SpriteSpatialInsert(EntityBase* sprite, const CoordsXY& newLoc)
     auto& spatialVector = gSpriteSpatialIndex[newIndex];
     auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), sprite->sprite_index);
     spatialVector.insert(index, sprite->sprite_index);
+
+    // Block lists are unordered, queries on them must not depend on the order.
+    if (sprite->Type < EntityType::Count)
+    {
+        gEntityBlockIndex[EnumValue(sprite->Type)][GetEntityBlockIndexOffset(newLoc)].push_back(sprite->sprite_index);
+    }
+}
+
+static bool EntityBlockRemove(EntityBase* sprite)
+{
+    if (sprite->Type >= EntityType::Count)
+        return true;
+
+    auto& blockVector = gEntityBlockIndex[EnumValue(sprite->Type)][GetEntityBlockIndexOffset({ sprite->x, sprite->y })];
+    auto index = std::find(std::begin(blockVector), std::end(blockVector), sprite->sprite_index);
+    if (index == std::end(blockVector))
+        return false;
+
+    *index = blockVector.back();
+    blockVector.pop_back();
+    return true;
 }
 
 static void SpriteSpatialRemove(EntityBase* sprite)
@@ -473,7 +687,7 @@ static void SpriteSpatialRemove(EntityBase* sprite)
     size_t currentIndex = GetSpatialIndexOffset({ sprite->x, sprite->y });
     auto& spatialVector = gSpriteSpatialIndex[currentIndex];
     auto index = std::lower_bound(std::begin(spatialVector), std::end(spatialVector), sprite->sprite_index);
-    if (index != std::end(spatialVector) && *index == sprite->sprite_index)
+    if (index != std::end(spatialVector) && *index == sprite->sprite_index && EntityBlockRemove(sprite))
     {
         spatialVector.erase(index, index + 1);
     }
@@ -488,7 +702,8 @@ static void SpriteSpatialMove(EntityBase* sprite, const CoordsXY& newLoc)
 {
     size_t newIndex = GetSpatialIndexOffset(newLoc);
     size_t currentIndex = GetSpatialIndexOffset({ sprite->x, sprite->y });
-    if (newIndex == currentIndex)
+    if (newIndex == currentIndex
+        && GetEntityBlockIndexOffset(newLoc) == GetEntityBlockIndexOffset({ sprite->x, sprite->y }))
         return;
 
     SpriteSpatialRemove(sprite);
@@ -40,6 +40,18 @@ struct rct_sprite_checksum
 
 #pragma pack(pop)
 
+enum class SpriteChecksumMode : uint8_t
+{
+    // Hashes only the entities that changed since the last checksum, spread over the task scheduler.
+    Incremental,
+    // Hashes every entity again, the reference the incremental checksum has to match.
+    Full,
+    // Incremental, checked against Full. A mismatch is logged and the full checksum returned.
+    Verify,
+    // One hash over all entities in list order, as recorded by replays up to version 4.
+    Legacy,
+};
+
 void reset_sprite_list();
 void reset_sprite_spatial_index();
 void sprite_misc_update_all();
@@ -48,6 +60,7 @@ void sprite_remove(EntityBase* sprite);
 uint16_t remove_floating_sprites();
 
 rct_sprite_checksum sprite_checksum();
+rct_sprite_checksum sprite_checksum(SpriteChecksumMode mode);
 
 void sprite_set_flashing(EntityBase* sprite, bool flashing);
 bool sprite_get_flashing(EntityBase* sprite);
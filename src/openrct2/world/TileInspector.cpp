@@ -1125,4 +1125,9 @@ namespace OpenRCT2::TileInspector
         return _highlightedElement == elem;
     }
 
+    const TileElement* GetSelectedElement()
+    {
+        return _highlightedElement;
+    }
+
 } // namespace OpenRCT2::TileInspector
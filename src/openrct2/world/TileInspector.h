@@ -23,6 +23,7 @@ namespace OpenRCT2::TileInspector
 
     void SetSelectedElement(const TileElement* elem);
     bool IsElementSelected(const TileElement* elem);
+    const TileElement* GetSelectedElement();
 
     GameActionResultPtr InsertCorruptElementAt(const CoordsXY& loc, int16_t elementIndex, bool isExecuting);
     GameActionResultPtr RemoveElementAt(const CoordsXY& loc, int16_t elementIndex, bool isExecuting);
@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/world/EntityList.h>
+#include <set>
+#include <vector>
+
+static std::vector<uint16_t> CollectIndices(const EntityIndexSet& set)
+{
+    std::vector<uint16_t> result;
+    for (auto index = set.FindNext(0); index < MAX_ENTITIES; index = set.FindNext(index + 1))
+    {
+        result.push_back(index);
+    }
+    return result;
+}
+
+TEST(EntityIndexSetTest, IteratesInAscendingOrder)
+{
+    EntityIndexSet set;
+    std::set<uint16_t> expected;
+    for (uint16_t index : { 9999, 0, 63, 64, 65, 127, 128, 5000, 1 })
+    {
+        set.Insert(index);
+        expected.insert(index);
+    }
+
+    ASSERT_EQ(set.Size(), expected.size());
+    ASSERT_EQ(CollectIndices(set), std::vector<uint16_t>(expected.begin(), expected.end()));
+}
+
+TEST(EntityIndexSetTest, InsertAndEraseAreIdempotent)
+{
+    EntityIndexSet set;
+    set.Insert(42);
+    set.Insert(42);
+    ASSERT_EQ(set.Size(), 1);
+    ASSERT_TRUE(set.Contains(42));
+
+    set.Erase(42);
+    set.Erase(42);
+    ASSERT_EQ(set.Size(), 0);
+    ASSERT_TRUE(set.Empty());
+    ASSERT_EQ(set.FindNext(0), MAX_ENTITIES);
+}
+
+TEST(EntityIndexSetTest, MatchesSortedReference)
+{
+    EntityIndexSet set;
+    std::set<uint16_t> expected;
+
+    // Deterministic pseudo random inserts and removals.
+    uint32_t seed = 12345;
+    for (int32_t i = 0; i < 20000; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        const auto index = static_cast<uint16_t>((seed >> 8) % MAX_ENTITIES);
+        if ((seed >> 4) & 1)
+        {
+            set.Insert(index);
+            expected.insert(index);
+        }
+        else
+        {
+            set.Erase(index);
+            expected.erase(index);
+        }
+    }
+
+    ASSERT_EQ(set.Size(), expected.size());
+    ASSERT_EQ(CollectIndices(set), std::vector<uint16_t>(expected.begin(), expected.end()));
+
+    set.Clear();
+    ASSERT_TRUE(set.Empty());
+    ASSERT_EQ(set.FindNext(0), MAX_ENTITIES);
+}
@@ -0,0 +1,165 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <openrct2/world/Duck.h>
+#include <openrct2/world/Entity.h>
+#include <openrct2/world/EntityList.h>
+#include <openrct2/world/Litter.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <random>
+#include <vector>
+
+class EntitySpatialQueryTest : public testing::Test
+{
+protected:
+    std::mt19937 _random{ 1234 };
+    std::vector<Litter*> _litter;
+
+    void SetUp() override
+    {
+        reset_sprite_list();
+        for (int32_t i = 0; i < 2000; i++)
+        {
+            auto* litter = CreateEntity<Litter>();
+            ASSERT_NE(litter, nullptr);
+            litter->MoveTo(RandomLocation());
+            _litter.push_back(litter);
+        }
+    }
+
+    void TearDown() override
+    {
+        reset_sprite_list();
+    }
+
+    int32_t RandomCoord(int32_t max = MAXIMUM_MAP_SIZE_BIG - 1)
+    {
+        return std::uniform_int_distribution<int32_t>(0, max)(_random);
+    }
+
+    CoordsXYZ RandomLocation()
+    {
+        return { RandomCoord(), RandomCoord(), 16 };
+    }
+
+    static int32_t ManhattanDistance(const Litter* litter, const CoordsXY& centre)
+    {
+        return std::abs(litter->x - centre.x) + std::abs(litter->y - centre.y);
+    }
+
+    // Runs every query on random areas and compares it against a scan over all litter.
+    void ExpectQueriesMatchBruteForce()
+    {
+        for (int32_t i = 0; i < 300; i++)
+        {
+            const CoordsXY centre = { RandomCoord(), RandomCoord() };
+            const int32_t range = RandomCoord(24 * COORDS_XY_STEP);
+
+            std::vector<uint16_t> expectedRadius;
+            uint32_t expectedCount = 0;
+            const Litter* expectedNearest = nullptr;
+            for (auto* litter : EntityList<Litter>())
+            {
+                const int64_t dx = litter->x - centre.x;
+                const int64_t dy = litter->y - centre.y;
+                if (dx * dx + dy * dy <= static_cast<int64_t>(range) * range)
+                {
+                    expectedRadius.push_back(litter->sprite_index);
+                }
+                if (std::abs(dx) <= range && std::abs(dy) <= range)
+                {
+                    expectedCount++;
+                }
+                const auto distance = ManhattanDistance(litter, centre);
+                if (distance <= range
+                    && (expectedNearest == nullptr || distance < ManhattanDistance(expectedNearest, centre)))
+                {
+                    expectedNearest = litter;
+                }
+            }
+
+            std::vector<uint16_t> radius;
+            for (auto* litter : QueryRadius<Litter>(centre, range))
+            {
+                radius.push_back(litter->sprite_index);
+            }
+            EXPECT_EQ(radius, expectedRadius) << centre.x << ", " << centre.y << " range " << range;
+            EXPECT_EQ(CountInBox<Litter>(centre, range), expectedCount);
+            const auto distanceFn = [&centre](const Litter* litter) { return ManhattanDistance(litter, centre); };
+            EXPECT_EQ(FindNearest<Litter>(centre, range, distanceFn), expectedNearest);
+        }
+    }
+};
+
+TEST_F(EntitySpatialQueryTest, QueriesMatchBruteForce)
+{
+    ExpectQueriesMatchBruteForce();
+}
+
+TEST_F(EntitySpatialQueryTest, MovedEntitiesAreFoundInTheirNewBlock)
+{
+    // Step every litter back and forth over a block edge, then scatter them again.
+    for (auto* litter : _litter)
+    {
+        const auto edge = (litter->x / ENTITY_BLOCK_SIZE) * ENTITY_BLOCK_SIZE;
+        litter->MoveTo({ edge > 0 ? edge - 1 : ENTITY_BLOCK_SIZE, litter->y, litter->z });
+    }
+    ExpectQueriesMatchBruteForce();
+
+    for (size_t i = 0; i < _litter.size(); i += 3)
+    {
+        _litter[i]->MoveTo(RandomLocation());
+    }
+    ExpectQueriesMatchBruteForce();
+
+    // Entities without a location are visited, but never match.
+    const CoordsXY centre = { _litter[7]->x, _litter[7]->y };
+    _litter[7]->MoveTo({ LOCATION_NULL, 0, 0 });
+    bool visited = false;
+    ForEachEntityInRange<Litter>(centre, 0, [&](const Litter* litter) { visited |= litter == _litter[7]; });
+    EXPECT_TRUE(visited);
+    ExpectQueriesMatchBruteForce();
+
+    _litter[7]->MoveTo({ centre, 16 });
+    EXPECT_EQ(FindNearest<Litter>(centre, 0, [&centre](const Litter* litter) { return ManhattanDistance(litter, centre); }),
+              _litter[7]);
+}
+
+TEST_F(EntitySpatialQueryTest, RemovedEntitiesAreNotFound)
+{
+    std::vector<CoordsXYZ> removed;
+    for (size_t i = 0; i < _litter.size(); i += 5)
+    {
+        removed.push_back({ _litter[i]->x, _litter[i]->y, _litter[i]->z });
+        sprite_remove(_litter[i]);
+    }
+    ExpectQueriesMatchBruteForce();
+
+    // Other entity types take over some of the free slots in the same places, they are not litter.
+    removed.resize(100);
+    for (const auto& location : removed)
+    {
+        auto* duck = CreateEntity<Duck>();
+        ASSERT_NE(duck, nullptr);
+        duck->MoveTo(location);
+    }
+    ExpectQueriesMatchBruteForce();
+    for (const auto& location : removed)
+    {
+        const auto ducks = QueryRadius<Duck>(location, 0);
+        ASSERT_FALSE(ducks.empty());
+        for (auto* litter : QueryRadius<Litter>(location, 0))
+        {
+            EXPECT_NE(litter->sprite_index, ducks.front()->sprite_index);
+        }
+    }
+}
@@ -0,0 +1,195 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include <algorithm>
+#    include <gtest/gtest.h>
+#    include <openrct2/GameStateSnapshots.h>
+#    include <openrct2/core/DataSerialiser.h>
+#    include <openrct2/peep/Guest.h>
+#    include <openrct2/world/Balloon.h>
+#    include <openrct2/world/Duck.h>
+#    include <openrct2/world/Entity.h>
+#    include <openrct2/world/EntityList.h>
+#    include <openrct2/world/Litter.h>
+#    include <openrct2/world/Sprite.h>
+#    include <string>
+#    include <vector>
+
+class GameStateSnapshotsTest : public testing::Test
+{
+protected:
+    std::unique_ptr<IGameStateSnapshots> _snapshots;
+    std::vector<Litter*> _litter;
+
+    void SetUp() override
+    {
+        _snapshots = CreateGameStateSnapshots();
+        reset_sprite_list();
+        for (int32_t i = 0; i < 300; i++)
+        {
+            auto* litter = CreateEntity<Litter>();
+            ASSERT_NE(litter, nullptr);
+            litter->SubType = Litter::Type::EmptyCan;
+            litter->creationTick = i;
+            litter->MoveTo({ 32 + i * 16, 64, 16 });
+            _litter.push_back(litter);
+        }
+    }
+
+    void TearDown() override
+    {
+        reset_sprite_list();
+    }
+
+    GameStateSnapshot_t& Capture()
+    {
+        auto& snapshot = _snapshots->CreateSnapshot();
+        _snapshots->Capture(snapshot);
+        return snapshot;
+    }
+
+    // Sends the blocks of the current state that differ from the given one, as the server does for a desynced client.
+    bool ApplyDelta(const GameStateSnapshot_t& target)
+    {
+        const auto targetHashes = _snapshots->GetEntityBlockHashes(target);
+        const auto currentHashes = _snapshots->GetEntityBlockHashes(Capture());
+
+        std::vector<uint32_t> blocks;
+        for (uint32_t i = 0; i < targetHashes.size(); i++)
+        {
+            if (targetHashes[i] != currentHashes[i])
+            {
+                blocks.push_back(i);
+            }
+        }
+
+        OpenRCT2::MemoryStream delta;
+        DataSerialiser saveDs(true, delta);
+        _snapshots->SerialiseDelta(target, blocks, saveDs);
+
+        delta.SetPosition(0);
+        DataSerialiser loadDs(false, delta);
+        return _snapshots->ApplyDelta(loadDs);
+    }
+};
+
+TEST_F(GameStateSnapshotsTest, DeltaRestoresState)
+{
+    auto& target = Capture();
+    const auto targetChecksum = sprite_checksum(SpriteChecksumMode::Full);
+
+    // Delete, create, retype and move entities, leaving most of them alone.
+    for (size_t i = 0; i < _litter.size(); i += 40)
+    {
+        sprite_remove(_litter[i]);
+    }
+    for (int32_t i = 0; i < 5; i++)
+    {
+        auto* duck = CreateEntity<Duck>();
+        ASSERT_NE(duck, nullptr);
+        duck->MoveTo({ 64, 32 + i * 16, 16 });
+    }
+    const uint16_t retypedIndex = _litter[17]->sprite_index;
+    sprite_remove(_litter[17]);
+    auto* balloon = CreateEntityAt<Balloon>(retypedIndex);
+    ASSERT_NE(balloon, nullptr);
+    balloon->MoveTo({ 96, 96, 32 });
+    for (size_t i = 5; i < _litter.size(); i += 60)
+    {
+        _litter[i]->MoveTo({ 256, 32 + static_cast<int32_t>(i) * 16, 48 });
+    }
+    ASSERT_NE(targetChecksum.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+
+    ASSERT_TRUE(ApplyDelta(target));
+    EXPECT_EQ(targetChecksum.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+    EXPECT_EQ(targetChecksum.raw, sprite_checksum(SpriteChecksumMode::Incremental).raw);
+    EXPECT_EQ(_snapshots->GetEntityBlockHashes(target), _snapshots->GetEntityBlockHashes(Capture()));
+
+    // Created entities get the bounds they are created with in game.
+    auto* litter = GetEntity<Litter>(retypedIndex);
+    ASSERT_NE(litter, nullptr);
+    EXPECT_EQ(litter->sprite_width, 6);
+    EXPECT_EQ(litter->sprite_height_negative, 6);
+    EXPECT_EQ(litter->sprite_height_positive, 3);
+
+    // Entities move through the spatial index to their restored locations.
+    const auto& tileList = GetEntityTileList({ litter->x, litter->y });
+    EXPECT_NE(std::find(tileList.begin(), tileList.end(), retypedIndex), tileList.end());
+}
+
+TEST_F(GameStateSnapshotsTest, DeltaKeepsPeepNames)
+{
+    auto* guest = CreateEntity<Guest>();
+    ASSERT_NE(guest, nullptr);
+    guest->MoveTo({ 128, 128, 16 });
+    guest->Energy = 100;
+    auto& target = Capture();
+    const auto targetChecksum = sprite_checksum(SpriteChecksumMode::Full);
+
+    guest->Energy = 50;
+    guest->SetName("Guest name");
+
+    ASSERT_TRUE(ApplyDelta(target));
+    EXPECT_EQ(guest->Energy, 100);
+    ASSERT_NE(guest->Name, nullptr);
+    EXPECT_EQ(std::string(guest->Name), "Guest name");
+    EXPECT_EQ(targetChecksum.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+}
+
+TEST_F(GameStateSnapshotsTest, DeltaCreatingPeepLeavesStateAlone)
+{
+    sprite_remove(_litter[3]);
+    auto* guest = CreateEntity<Guest>();
+    ASSERT_NE(guest, nullptr);
+    guest->MoveTo({ 128, 128, 16 });
+    auto& target = Capture();
+
+    // The client is missing the guest and has a moved litter, it needs the map rather than the delta.
+    sprite_remove(guest);
+    _litter[100]->MoveTo({ 256, 256, 48 });
+    const auto before = sprite_checksum(SpriteChecksumMode::Full);
+
+    ASSERT_FALSE(ApplyDelta(target));
+    EXPECT_EQ(before.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+}
+
+TEST_F(GameStateSnapshotsTest, DeltaRemovingPeepLeavesStateAlone)
+{
+    // The server has litter where the client has a guest, then nothing where the client has a guest.
+    const uint16_t retypedIndex = _litter[3]->sprite_index;
+    auto& target = Capture();
+
+    sprite_remove(_litter[3]);
+    auto* retypedGuest = CreateEntityAt<Guest>(retypedIndex);
+    ASSERT_NE(retypedGuest, nullptr);
+    retypedGuest->MoveTo({ 128, 128, 16 });
+    _litter[100]->MoveTo({ 256, 256, 48 });
+    const auto before = sprite_checksum(SpriteChecksumMode::Full);
+
+    ASSERT_FALSE(ApplyDelta(target));
+    EXPECT_EQ(before.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+    EXPECT_EQ(GetEntity<Guest>(retypedIndex), retypedGuest);
+
+    sprite_remove(retypedGuest);
+    auto* litter = CreateEntityAt<Litter>(retypedIndex);
+    ASSERT_NE(litter, nullptr);
+    litter->MoveTo({ 64, 64, 16 });
+    auto* extraGuest = CreateEntity<Guest>();
+    ASSERT_NE(extraGuest, nullptr);
+    extraGuest->MoveTo({ 160, 160, 16 });
+    const auto beforeExtra = sprite_checksum(SpriteChecksumMode::Full);
+
+    ASSERT_FALSE(ApplyDelta(target));
+    EXPECT_EQ(beforeExtra.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+    EXPECT_EQ(GetEntity<Guest>(extraGuest->sprite_index), extraGuest);
+}
+
+#endif // DISABLE_NETWORK
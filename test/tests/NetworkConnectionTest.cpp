@@ -0,0 +1,241 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include <algorithm>
+#    include <cstdint>
+#    include <deque>
+#    include <gtest/gtest.h>
+#    include <openrct2/network/NetworkConnection.h>
+#    include <openrct2/network/NetworkPacket.h>
+#    include <openrct2/network/Socket.h>
+#    include <random>
+#    include <vector>
+
+/**
+ * A connected socket that takes at most Limit bytes per write and keeps what it was given.
+ */
+class FakeSocket final : public ITcpSocket
+{
+public:
+    size_t Limit = SIZE_MAX;
+    size_t NumWrites = 0;
+    std::vector<uint8_t> Written;
+
+    SocketStatus GetStatus() const override
+    {
+        return SocketStatus::Connected;
+    }
+    const char* GetError() const override
+    {
+        return nullptr;
+    }
+    const char* GetHostName() const override
+    {
+        return "localhost";
+    }
+    std::string GetIpAddress() const override
+    {
+        return "127.0.0.1";
+    }
+
+    void Listen(uint16_t port) override
+    {
+    }
+    void Listen(const std::string& address, uint16_t port) override
+    {
+    }
+    std::unique_ptr<ITcpSocket> Accept() override
+    {
+        return nullptr;
+    }
+
+    void Connect(const std::string& address, uint16_t port) override
+    {
+    }
+    void ConnectAsync(const std::string& address, uint16_t port) override
+    {
+    }
+
+    size_t SendData(const void* buffer, size_t size) override
+    {
+        SocketSendBuffer sendBuffer = { buffer, size };
+        return SendData(&sendBuffer, 1);
+    }
+    size_t SendData(const SocketSendBuffer* buffers, size_t count) override
+    {
+        NumWrites++;
+        size_t sent = 0;
+        for (size_t i = 0; i < count && sent < Limit; i++)
+        {
+            const auto* data = static_cast<const uint8_t*>(buffers[i].Data);
+            const size_t size = std::min(buffers[i].Size, Limit - sent);
+            Written.insert(Written.end(), data, data + size);
+            sent += size;
+        }
+        return sent;
+    }
+    NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
+    {
+        *sizeReceived = 0;
+        return NetworkReadPacket::NoData;
+    }
+
+    void SetNoDelay(bool noDelay) override
+    {
+    }
+
+    void Finish() override
+    {
+    }
+    void Disconnect() override
+    {
+    }
+    void Close() override
+    {
+    }
+};
+
+class NetworkConnectionTest : public testing::Test
+{
+protected:
+    FakeSocket _socket;
+    std::deque<NetworkOutboundPacket> _packets;
+    std::vector<NetworkPacketBufferPtr> _queued;
+    std::vector<const NetworkPacketBuffer*> _sent;
+
+    void Queue(size_t payloadSize, bool front = false)
+    {
+        NetworkPacket packet(NetworkCommand::Tick);
+        for (size_t i = 0; i < payloadSize; i++)
+        {
+            packet << static_cast<uint8_t>(_queued.size() + i);
+        }
+        auto buffer = std::move(packet).ToBuffer();
+        NetworkConnection::InsertOutboundPacket(_packets, buffer, front);
+        _queued.push_back(buffer);
+    }
+
+    void Send(size_t limit)
+    {
+        _socket.Limit = limit;
+        NetworkConnection::SendPackets(_socket, _packets, [this](const NetworkPacketBuffer& buffer) {
+            // A packet is only done once all of its bytes are on the wire.
+            size_t size = 0;
+            for (const auto* sent : _sent)
+            {
+                size += sent->GetSize();
+            }
+            EXPECT_GE(_socket.Written.size(), size + buffer.GetSize());
+            _sent.push_back(&buffer);
+        });
+    }
+
+    static std::vector<uint8_t> GetWireBytes(const std::vector<const NetworkPacketBuffer*>& buffers)
+    {
+        std::vector<uint8_t> bytes;
+        for (const auto* buffer : buffers)
+        {
+            bytes.insert(bytes.end(), std::begin(buffer->Header), std::end(buffer->Header));
+            bytes.insert(bytes.end(), buffer->Data.begin(), buffer->Data.end());
+        }
+        return bytes;
+    }
+
+    std::vector<const NetworkPacketBuffer*> GetQueued() const
+    {
+        std::vector<const NetworkPacketBuffer*> queued;
+        for (const auto& buffer : _queued)
+        {
+            queued.push_back(buffer.get());
+        }
+        return queued;
+    }
+};
+
+TEST_F(NetworkConnectionTest, PartialWritesKeepTheFraming)
+{
+    for (size_t payloadSize : { 0, 1, 10, 300, 4096, 2, 0, 77 })
+    {
+        Queue(payloadSize);
+    }
+
+    std::mt19937 random(4321);
+    for (int32_t i = 0; i < 10000 && !_packets.empty(); i++)
+    {
+        Send(std::uniform_int_distribution<size_t>(0, 64)(random));
+    }
+    ASSERT_TRUE(_packets.empty());
+    EXPECT_EQ(_sent, GetQueued());
+    EXPECT_EQ(_socket.Written, GetWireBytes(_sent));
+}
+
+TEST_F(NetworkConnectionTest, RetiresOnlyCompletePackets)
+{
+    Queue(10);
+    Queue(20);
+    const size_t firstSize = _queued[0]->GetSize();
+
+    // Nothing taken, then part of the header.
+    Send(0);
+    EXPECT_EQ(_packets.size(), 2u);
+    EXPECT_EQ(_packets.front().BytesTransferred, 0u);
+    Send(3);
+    EXPECT_EQ(_packets.size(), 2u);
+    EXPECT_EQ(_packets.front().BytesTransferred, 3u);
+    EXPECT_TRUE(_sent.empty());
+
+    // Packets queued at the front go behind the one that is part way out.
+    Queue(5, true);
+    ASSERT_EQ(_packets.size(), 3u);
+    EXPECT_EQ(_packets[1].Buffer, _queued[2]);
+
+    // The rest of the first packet and two bytes of the next.
+    Send(firstSize - 3 + 2);
+    ASSERT_EQ(_packets.size(), 2u);
+    EXPECT_EQ(_packets.front().Buffer, _queued[2]);
+    EXPECT_EQ(_packets.front().BytesTransferred, 2u);
+    ASSERT_EQ(_sent.size(), 1u);
+    EXPECT_EQ(_sent[0], _queued[0].get());
+
+    // Exactly the end of the packet.
+    Send(_queued[2]->GetSize() - 2);
+    ASSERT_EQ(_packets.size(), 1u);
+    EXPECT_EQ(_packets.front().BytesTransferred, 0u);
+
+    Send(SIZE_MAX);
+    EXPECT_TRUE(_packets.empty());
+    EXPECT_EQ(_sent, std::vector<const NetworkPacketBuffer*>({ _queued[0].get(), _queued[2].get(), _queued[1].get() }));
+    EXPECT_EQ(_socket.Written, GetWireBytes(_sent));
+}
+
+TEST_F(NetworkConnectionTest, SendsLongQueuesInSeveralWrites)
+{
+    for (size_t i = 0; i < 100; i++)
+    {
+        Queue(i % 7);
+    }
+
+    // Every packet is gathered, even though one write only takes some of them.
+    Send(SIZE_MAX);
+    EXPECT_TRUE(_packets.empty());
+    EXPECT_GT(_socket.NumWrites, 1u);
+    EXPECT_EQ(_sent, GetQueued());
+    EXPECT_EQ(_socket.Written, GetWireBytes(_sent));
+
+    // A full socket stops sending until next time.
+    Queue(10);
+    _socket.NumWrites = 0;
+    Send(0);
+    EXPECT_EQ(_socket.NumWrites, 1u);
+    EXPECT_EQ(_packets.size(), 1u);
+}
+
+#endif // DISABLE_NETWORK
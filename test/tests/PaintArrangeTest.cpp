@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/paint/Paint.h>
+#include <vector>
+
+// Builds a session the way PaintSessionAddPSToQuadrant does, with deterministic pseudo random bounding boxes. The
+// boxes are small compared to the covered area so a good share of them overlap.
+static std::unique_ptr<RecordedPaintSession> CreateSession(
+    uint32_t seed, size_t count, uint8_t rotation, int32_t numQuadrants, int32_t range)
+{
+    auto recorded = std::make_unique<RecordedPaintSession>();
+    auto& session = recorded->Session;
+    std::fill(std::begin(session.Quadrants), std::end(session.Quadrants), nullptr);
+    session.PaintHead = {};
+    session.QuadrantBackIndex = UINT32_MAX;
+    session.QuadrantFrontIndex = 0;
+    session.CurrentRotation = rotation;
+
+    const auto next = [&seed](int32_t max) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int32_t>((seed >> 8) % max);
+    };
+
+    recorded->Entries.resize(count);
+    for (auto& entry : recorded->Entries)
+    {
+        entry = {};
+        auto& ps = entry.basic;
+        ps.bounds.x = next(range);
+        ps.bounds.y = next(range);
+        ps.bounds.z = next(range);
+        ps.bounds.x_end = ps.bounds.x + next(48);
+        ps.bounds.y_end = ps.bounds.y + next(48);
+        ps.bounds.z_end = ps.bounds.z + next(48);
+        ps.SortFlags = static_cast<uint8_t>(next(256));
+
+        const auto quadrantIndex = static_cast<uint32_t>(100 + next(numQuadrants));
+        ps.quadrant_index = quadrantIndex;
+        ps.next_quadrant_ps = session.Quadrants[quadrantIndex];
+        session.Quadrants[quadrantIndex] = &ps;
+        session.QuadrantBackIndex = std::min(session.QuadrantBackIndex, quadrantIndex);
+        session.QuadrantFrontIndex = std::max(session.QuadrantFrontIndex, quadrantIndex);
+    }
+    return recorded;
+}
+
+static std::vector<size_t> GetDrawOrder(const RecordedPaintSession& recorded)
+{
+    std::vector<size_t> result;
+    for (auto* ps = recorded.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        result.push_back(reinterpret_cast<const paint_entry*>(ps) - recorded.Entries.data());
+    }
+    return result;
+}
+
+TEST(PaintArrangeTest, MatchesLegacyOrder)
+{
+    uint32_t seed = 1;
+    for (int32_t i = 0; i < 200; i++)
+    {
+        for (uint8_t rotation = 0; rotation < 4; rotation++)
+        {
+            const size_t count = 1 + (i * 37) % 700;
+            const int32_t numQuadrants = 1 + i % 40;
+            const int32_t range = 16 + (i * 53) % 400;
+
+            auto recorded = CreateSession(seed, count, rotation, numQuadrants, range);
+            auto legacy = CreateSession(seed, count, rotation, numQuadrants, range);
+            seed += 7919;
+
+            PaintSessionArrange(&recorded->Session);
+            PaintSessionArrangeLegacy(&legacy->Session);
+
+            auto order = GetDrawOrder(*recorded);
+            ASSERT_EQ(order.size(), count);
+            ASSERT_EQ(order, GetDrawOrder(*legacy)) << "i = " << i << ", rotation = " << static_cast<int32_t>(rotation);
+        }
+    }
+}
+
+TEST(PaintArrangeTest, EmptySession)
+{
+    auto recorded = CreateSession(1, 0, 0, 1, 16);
+    PaintSessionArrange(&recorded->Session);
+    ASSERT_EQ(recorded->Session.PaintHead.next_quadrant_ps, nullptr);
+}
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/paint/PaintTileCache.h>
+#include <openrct2/peep/Staff.h>
+#include <openrct2/world/Banner.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Scenery.h>
+#include <openrct2/world/SmallScenery.h>
+#include <openrct2/world/Sprite.h>
+
+class PaintTileCacheTest : public testing::Test
+{
+protected:
+    static int32_t _paintCalls;
+
+    std::unique_ptr<paint_session> _session;
+    TileElement _surface{};
+
+    void SetUp() override
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        gStaffDrawPatrolAreas = SPRITE_INDEX_NULL;
+        gConfigGeneral.paint_tile_cache_size = 1;
+
+        _session = std::make_unique<paint_session>();
+        _surface.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+        _surface.SetLastForTile(true);
+
+        PaintTileCacheReset();
+        PaintTileCacheBeginSession();
+    }
+
+    static bool CountPaint(paint_session* session, const TileElement* tileElement)
+    {
+        _paintCalls++;
+        return true;
+    }
+
+    // Returns whether the tile was replayed from its recording rather than painted.
+    bool IsReplayed(const TileCoordsXY& tile, const TileElement* tileElement = nullptr)
+    {
+        _paintCalls = 0;
+        _session->MapPosition = tile.ToCoordsXY();
+        PaintTileCachePaintElements(_session.get(), tileElement != nullptr ? tileElement : &_surface, CountPaint);
+        return _paintCalls == 0;
+    }
+};
+
+int32_t PaintTileCacheTest::_paintCalls;
+
+TEST_F(PaintTileCacheTest, ReplaysUnchangedTile)
+{
+    ASSERT_FALSE(IsReplayed({ 10, 10 }));
+    ASSERT_TRUE(IsReplayed({ 10, 10 }));
+}
+
+TEST_F(PaintTileCacheTest, InvalidateTileRepaintsOnlyThatTile)
+{
+    IsReplayed({ 10, 10 });
+    IsReplayed({ 11, 10 });
+
+    map_invalidate_tile({ CoordsXY{ 10 * COORDS_XY_STEP, 10 * COORDS_XY_STEP }, 0, 64 });
+    EXPECT_FALSE(IsReplayed({ 10, 10 }));
+    EXPECT_TRUE(IsReplayed({ 11, 10 }));
+
+    map_invalidate_tile_zoom0({ CoordsXY{ 11 * COORDS_XY_STEP, 10 * COORDS_XY_STEP }, 0, 64 });
+    EXPECT_FALSE(IsReplayed({ 11, 10 }));
+    EXPECT_TRUE(IsReplayed({ 10, 10 }));
+
+    map_invalidate_tile_zoom1({ CoordsXY{ 10 * COORDS_XY_STEP, 10 * COORDS_XY_STEP }, 0, 64 });
+    EXPECT_FALSE(IsReplayed({ 10, 10 }));
+    EXPECT_TRUE(IsReplayed({ 11, 10 }));
+}
+
+TEST_F(PaintTileCacheTest, InvalidateTileFullRepaintsNeighbours)
+{
+    for (int32_t x = 8; x <= 12; x++)
+    {
+        IsReplayed({ x, 10 });
+        IsReplayed({ 10, x });
+    }
+
+    // Neighbouring tiles paint surface edges and supports from the tile.
+    map_invalidate_tile_full({ 10 * COORDS_XY_STEP, 10 * COORDS_XY_STEP });
+    EXPECT_FALSE(IsReplayed({ 10, 10 }));
+    EXPECT_FALSE(IsReplayed({ 9, 10 }));
+    EXPECT_FALSE(IsReplayed({ 11, 10 }));
+    EXPECT_FALSE(IsReplayed({ 10, 9 }));
+    EXPECT_FALSE(IsReplayed({ 10, 11 }));
+    EXPECT_TRUE(IsReplayed({ 8, 10 }));
+    EXPECT_TRUE(IsReplayed({ 12, 10 }));
+    EXPECT_TRUE(IsReplayed({ 10, 8 }));
+    EXPECT_TRUE(IsReplayed({ 10, 12 }));
+}
+
+TEST_F(PaintTileCacheTest, InvalidateRegionRepaintsRegionAndBorder)
+{
+    for (int32_t x = 3; x <= 10; x++)
+    {
+        for (int32_t y = 3; y <= 10; y++)
+        {
+            IsReplayed({ x, y });
+        }
+    }
+
+    map_invalidate_region({ 5 * COORDS_XY_STEP, 5 * COORDS_XY_STEP }, { 7 * COORDS_XY_STEP, 8 * COORDS_XY_STEP });
+    for (int32_t x = 3; x <= 10; x++)
+    {
+        for (int32_t y = 3; y <= 10; y++)
+        {
+            const bool invalidated = x >= 4 && x <= 8 && y >= 4 && y <= 9;
+            EXPECT_EQ(IsReplayed({ x, y }), !invalidated) << x << ", " << y;
+        }
+    }
+}
+
+TEST_F(PaintTileCacheTest, GlobalStateChangeRepaintsAll)
+{
+    IsReplayed({ 10, 10 });
+    IsReplayed({ 20, 20 });
+
+    // The state is only checked when a session begins.
+    const auto clipHeight = gClipHeight;
+    gClipHeight = clipHeight - 1;
+    EXPECT_TRUE(IsReplayed({ 10, 10 }));
+    PaintTileCacheBeginSession();
+    EXPECT_FALSE(IsReplayed({ 10, 10 }));
+    EXPECT_FALSE(IsReplayed({ 20, 20 }));
+    gClipHeight = clipHeight;
+    PaintTileCacheBeginSession();
+
+    IsReplayed({ 10, 10 });
+    PaintTileCacheReset();
+    EXPECT_FALSE(IsReplayed({ 10, 10 }));
+}
+
+TEST_F(PaintTileCacheTest, EvictsLeastRecentlyUsed)
+{
+    const TileCoordsXY first = { 0, 0 };
+    const TileCoordsXY used = { 0, 1 };
+    IsReplayed(first);
+    IsReplayed(used);
+
+    // Far more tiles than 1 MiB of recordings holds, with one of the tiles painted again all along.
+    for (int32_t x = 1; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+    {
+        for (int32_t y = 0; y < 64; y++)
+        {
+            IsReplayed({ x, y });
+        }
+        ASSERT_TRUE(IsReplayed(used));
+    }
+    EXPECT_LE(PaintTileCacheGetUsedBytes(), 1024u * 1024u);
+    EXPECT_GT(PaintTileCacheGetUsedBytes(), 512u * 1024u);
+    EXPECT_FALSE(IsReplayed(first));
+    EXPECT_TRUE(IsReplayed(used));
+
+    // Without a budget nothing is recorded.
+    gConfigGeneral.paint_tile_cache_size = 0;
+    EXPECT_FALSE(IsReplayed(used));
+    EXPECT_FALSE(IsReplayed(used));
+}
+
+TEST_F(PaintTileCacheTest, RejectsQueueBanners)
+{
+    TileElement elements[2]{};
+    elements[0].ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+    elements[1].ClearAs(TILE_ELEMENT_TYPE_PATH);
+    elements[1].SetLastForTile(true);
+    auto* path = elements[1].AsPath();
+
+    EXPECT_TRUE(PaintTileCacheIsElementCacheable(elements[0]));
+    EXPECT_TRUE(PaintTileCacheIsElementCacheable(elements[1]));
+    path->SetIsQueue(true);
+    EXPECT_TRUE(PaintTileCacheIsElementCacheable(elements[1]));
+
+    // Banners scroll the name of the ride, the tile is painted every time.
+    path->SetHasQueueBanner(true);
+    EXPECT_FALSE(PaintTileCacheIsElementCacheable(elements[1]));
+    EXPECT_FALSE(IsReplayed({ 10, 10 }, elements));
+    EXPECT_FALSE(IsReplayed({ 10, 10 }, elements));
+
+    TileElement track{};
+    track.ClearAs(TILE_ELEMENT_TYPE_TRACK);
+    EXPECT_FALSE(PaintTileCacheIsElementCacheable(track));
+}
+
+TEST_F(PaintTileCacheTest, RejectsAnimatedAndDoorEntries)
+{
+    SmallSceneryEntry smallScenery{};
+    EXPECT_TRUE(PaintTileCacheIsEntryCacheable(smallScenery));
+    smallScenery.flags = SMALL_SCENERY_FLAG_ANIMATED;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(smallScenery));
+
+    LargeSceneryEntry largeScenery{};
+    largeScenery.scrolling_mode = SCROLLING_MODE_NONE;
+    EXPECT_TRUE(PaintTileCacheIsEntryCacheable(largeScenery));
+    largeScenery.flags = LARGE_SCENERY_FLAG_ANIMATED;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(largeScenery));
+    largeScenery.flags = LARGE_SCENERY_FLAG_3D_TEXT;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(largeScenery));
+    largeScenery.flags = 0;
+    largeScenery.scrolling_mode = 0;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(largeScenery));
+
+    WallSceneryEntry wall{};
+    wall.scrolling_mode = SCROLLING_MODE_NONE;
+    EXPECT_TRUE(PaintTileCacheIsEntryCacheable(wall));
+    wall.flags = WALL_SCENERY_IS_DOOR;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(wall));
+    wall.flags = 0;
+    wall.flags2 = WALL_SCENERY_2_ANIMATED;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(wall));
+    wall.flags2 = 0;
+    wall.scrolling_mode = 0;
+    EXPECT_FALSE(PaintTileCacheIsEntryCacheable(wall));
+}
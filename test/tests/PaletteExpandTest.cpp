@@ -0,0 +1,96 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+// Sizes around the vector widths, so every kernel runs its scalar tail as well.
+static constexpr size_t Counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 31, 1003 };
+
+class PaletteExpandTest : public testing::Test
+{
+protected:
+    std::vector<uint8_t> _bits;
+    std::vector<uint8_t> _lightIntensity;
+    uint32_t _palette[256]{};
+    uint32_t _lightPalette[256]{};
+
+    void SetUp() override
+    {
+        std::mt19937 random(42);
+        _bits.resize(1024);
+        _lightIntensity.resize(1024);
+        for (size_t i = 0; i < _bits.size(); i++)
+        {
+            _bits[i] = static_cast<uint8_t>(random());
+            // Include unlit pixels and full intensity, where the light saturates.
+            _lightIntensity[i] = i % 5 == 0 ? 0 : (i % 7 == 0 ? 255 : static_cast<uint8_t>(random()));
+        }
+        for (int32_t i = 0; i < 256; i++)
+        {
+            _palette[i] = static_cast<uint32_t>(random());
+            _lightPalette[i] = static_cast<uint32_t>(random());
+        }
+    }
+
+    // The pixel after the converted ones has to be left alone.
+    static constexpr uint32_t Guard = 0xDEADBEEF;
+
+    std::vector<uint32_t> Expand(PaletteExpandFunc expand, size_t count)
+    {
+        std::vector<uint32_t> dst(count + 1, Guard);
+        expand(_bits.data(), dst.data(), count, _palette);
+        return dst;
+    }
+
+    std::vector<uint32_t> Blend(LightBlendFunc blend, size_t count)
+    {
+        std::vector<uint32_t> dst(count + 1, Guard);
+        blend(_bits.data(), _lightIntensity.data(), dst.data(), count, _palette, _lightPalette);
+        return dst;
+    }
+};
+
+TEST_F(PaletteExpandTest, ScalarUsesPalette)
+{
+    auto dst = Expand(palette_expand_scalar, 9);
+    for (size_t i = 0; i < 9; i++)
+    {
+        ASSERT_EQ(dst[i], _palette[_bits[i]]);
+    }
+    ASSERT_EQ(dst[9], Guard);
+}
+
+TEST_F(PaletteExpandTest, AVX2MatchesScalar)
+{
+    if (!avx2_available())
+    {
+        return;
+    }
+    for (auto count : Counts)
+    {
+        ASSERT_EQ(Expand(palette_expand_scalar, count), Expand(palette_expand_avx2, count)) << "count = " << count;
+        ASSERT_EQ(Blend(light_blend_scalar, count), Blend(light_blend_avx2, count)) << "count = " << count;
+    }
+}
+
+TEST_F(PaletteExpandTest, SSE41MatchesScalar)
+{
+    if (!sse41_available())
+    {
+        return;
+    }
+    for (auto count : Counts)
+    {
+        ASSERT_EQ(Blend(light_blend_scalar, count), Blend(light_blend_sse4_1, count)) << "count = " << count;
+    }
+}
@@ -0,0 +1,279 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/peep/GuestPathfinding.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementsView.h>
+#include <random>
+#include <vector>
+
+using namespace OpenRCT2;
+
+class PathFlowFieldTest : public testing::Test
+{
+protected:
+    static constexpr int32_t GridStart = 2;
+    static constexpr int32_t GridEnd = 18;
+
+    static void SetUpTestCase()
+    {
+        core_init();
+
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+    }
+
+    static void TearDownTestCase()
+    {
+        _context = nullptr;
+    }
+
+    void SetUp() override
+    {
+        // A flat map without any objects, the flow fields only look at the path elements.
+        std::vector<TileElement> tileElements(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+        for (auto& element : tileElements)
+        {
+            element.ClearAs(TILE_ELEMENT_TYPE_SURFACE);
+            element.SetLastForTile(true);
+            element.base_height = 14;
+            element.clearance_height = 14;
+        }
+        SetTileElements(std::move(tileElements));
+        gMapSize = 32;
+    }
+
+    static PathElement* GetPath(const TileCoordsXYZ& loc)
+    {
+        for (auto* pathElement : TileElementsView<PathElement>(loc.ToCoordsXY()))
+        {
+            if (pathElement->base_height == loc.z)
+                return pathElement;
+        }
+        return nullptr;
+    }
+
+    static PathElement* AddPath(const TileCoordsXYZ& loc, uint8_t edges)
+    {
+        auto* pathElement = TileElementInsert<PathElement>(loc.ToCoordsXYZ(), 0b1111);
+        pathElement->SetClearanceZ(loc.ToCoordsXYZ().z + 4 * COORDS_Z_STEP);
+        pathElement->SetEdges(edges);
+        return pathElement;
+    }
+
+    static void ConnectPaths(const TileCoordsXYZ& a, const TileCoordsXYZ& b)
+    {
+        for (Direction direction : ALL_DIRECTIONS)
+        {
+            if (a.x + TileDirectionDelta[direction].x == b.x && a.y + TileDirectionDelta[direction].y == b.y)
+            {
+                auto* pathA = GetPath(a);
+                pathA->SetEdges(pathA->GetEdges() | (1 << direction));
+                auto* pathB = GetPath(b);
+                pathB->SetEdges(pathB->GetEdges() | (1 << direction_reverse(direction)));
+            }
+        }
+    }
+
+    static void RemovePath(const TileCoordsXYZ& loc)
+    {
+        PathfindingCacheArea pathfindingArea(loc.ToCoordsXY(), 0);
+        PathfindingCacheInvalidate();
+        tile_element_remove(GetPath(loc)->as<TileElement>());
+    }
+
+    static std::vector<uint16_t> GetDistances(const TileCoordsXYZ& goal)
+    {
+        std::vector<uint16_t> distances;
+        for (int32_t y = GridStart; y < GridEnd; y++)
+        {
+            for (int32_t x = GridStart; x < GridEnd; x++)
+            {
+                for (int32_t z : { 14, 16 })
+                {
+                    distances.push_back(PathFlowFieldGetDistance(goal, { x, y, z }));
+                }
+            }
+        }
+        return distances;
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> PathFlowFieldTest::_context;
+
+TEST_F(PathFlowFieldTest, RepairMatchesRebuild)
+{
+    // A peep spawn on a path and a park entrance next to the grid.
+    const TileCoordsXYZ spawn = { GridStart, GridStart, 14 };
+    const TileCoordsXYZ entrance = { GridStart - 1, GridEnd / 2, 14 };
+
+    std::mt19937 random(0x12345678);
+    auto randomInt = [&random](int32_t max) { return std::uniform_int_distribution<int32_t>(0, max - 1)(random); };
+
+    for (int32_t y = GridStart; y < GridEnd; y++)
+    {
+        for (int32_t x = GridStart; x < GridEnd; x++)
+        {
+            AddPath({ x, y, 14 }, 0b1111);
+        }
+    }
+    PathfindingCacheInvalidate();
+
+    for (int32_t batch = 0; batch < 300; batch++)
+    {
+        const int32_t numChanges = 1 + randomInt(4);
+        for (int32_t i = 0; i < numChanges; i++)
+        {
+            const TileCoordsXYZ loc = { GridStart + randomInt(GridEnd - GridStart), GridStart + randomInt(GridEnd - GridStart),
+                                        randomInt(4) == 0 ? 16 : 14 };
+            auto* pathElement = GetPath(loc);
+            if (pathElement == nullptr)
+            {
+                AddPath(loc, static_cast<uint8_t>(randomInt(16)));
+            }
+            else
+            {
+                PathfindingCacheArea pathfindingArea(loc.ToCoordsXY(), 0);
+                PathfindingCacheInvalidate();
+                switch (randomInt(7))
+                {
+                    case 0:
+                        tile_element_remove(pathElement->as<TileElement>());
+                        break;
+                    case 1:
+                        pathElement->SetEdges(pathElement->GetEdges() ^ (1 << randomInt(4)));
+                        break;
+                    case 2:
+                        pathElement->SetGhost(!pathElement->IsGhost());
+                        break;
+                    case 3:
+                        pathElement->SetIsQueue(!pathElement->IsQueue());
+                        pathElement->SetRideIndex(pathElement->IsQueue() ? static_cast<ride_id_t>(0) : RIDE_ID_NULL);
+                        break;
+                    case 4:
+                        pathElement->SetSloped(!pathElement->IsSloped());
+                        pathElement->SetSlopeDirection(static_cast<Direction>(randomInt(4)));
+                        break;
+                    case 5:
+                        pathElement->SetWide(!pathElement->IsWide());
+                        break;
+                    default:
+                        pathElement->SetEdges(static_cast<uint8_t>(randomInt(16)));
+                        break;
+                }
+            }
+
+            // Sometimes let the changes pile up before the fields are repaired.
+            if (randomInt(2) == 0)
+            {
+                GetDistances(spawn);
+                GetDistances(entrance);
+            }
+        }
+
+        const auto repairedSpawn = GetDistances(spawn);
+        const auto repairedEntrance = GetDistances(entrance);
+        PathfindingCacheInvalidate();
+        ASSERT_EQ(repairedSpawn, GetDistances(spawn)) << "batch " << batch;
+        ASSERT_EQ(repairedEntrance, GetDistances(entrance)) << "batch " << batch;
+    }
+}
+
+TEST_F(PathFlowFieldTest, ChoosesShortestEdgeAndFallsBack)
+{
+    // Two routes from a junction to a park entrance, four tiles west or eight tiles north and round.
+    const TileCoordsXYZ entrance = { 2, 5, 14 };
+    const TileCoordsXYZ junction = { 6, 5, 14 };
+    const std::vector<TileCoordsXYZ> shortRoute = { { 3, 5, 14 }, { 4, 5, 14 }, { 5, 5, 14 }, junction };
+    const std::vector<TileCoordsXYZ> longRoute = { { 3, 5, 14 }, { 3, 4, 14 }, { 3, 3, 14 }, { 4, 3, 14 },
+                                                   { 5, 3, 14 }, { 6, 3, 14 }, { 6, 4, 14 }, junction };
+    for (const auto* route : { &shortRoute, &longRoute })
+    {
+        for (size_t i = 0; i < route->size(); i++)
+        {
+            if (GetPath((*route)[i]) == nullptr)
+            {
+                AddPath((*route)[i], 0);
+            }
+            if (i > 0)
+            {
+                ConnectPaths((*route)[i - 1], (*route)[i]);
+            }
+        }
+    }
+    constexpr Direction West = 0;
+    constexpr Direction North = 3;
+    auto* entrancePath = GetPath(shortRoute.front());
+    entrancePath->SetEdges(entrancePath->GetEdges() | (1 << West));
+    PathfindingCacheInvalidate();
+
+    const uint8_t junctionEdges = GetPath(junction)->GetEdges();
+    ASSERT_EQ(junctionEdges, (1 << West) | (1 << North));
+
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, junction), 4);
+    EXPECT_EQ(PathFlowFieldChooseDirection(entrance, junction, junctionEdges), West);
+
+    // Once the short route is cut guests take the long way round.
+    RemovePath({ 4, 5, 14 });
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, junction), 8);
+    EXPECT_EQ(PathFlowFieldChooseDirection(entrance, junction, junctionEdges), North);
+
+    // With both cut there is no edge to choose, guests fall back to the heuristic search.
+    RemovePath({ 4, 3, 14 });
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, junction), PATH_FLOW_FIELD_UNREACHABLE);
+    EXPECT_EQ(PathFlowFieldChooseDirection(entrance, junction, junctionEdges), INVALID_DIRECTION);
+}
+
+TEST_F(PathFlowFieldTest, StopsAtWidePathsAndRideQueues)
+{
+    // A straight path east from a park entrance, with a ride queue half way along.
+    const TileCoordsXYZ entrance = { 2, 5, 14 };
+    const TileCoordsXYZ queue = { 5, 5, 14 };
+    const TileCoordsXYZ end = { 8, 5, 14 };
+    for (int32_t x = 3; x <= end.x; x++)
+    {
+        AddPath({ x, 5, 14 }, 0);
+        if (x > 3)
+        {
+            ConnectPaths({ x - 1, 5, 14 }, { x, 5, 14 });
+        }
+    }
+    constexpr Direction West = 0;
+    GetPath({ 3, 5, 14 })->SetEdges(GetPath({ 3, 5, 14 })->GetEdges() | (1 << West));
+    PathfindingCacheInvalidate();
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, end), 6);
+
+    // Like the heuristic search, the middle of a queue of a ride ends the way.
+    auto* queuePath = GetPath(queue);
+    queuePath->SetIsQueue(true);
+    queuePath->SetRideIndex(static_cast<ride_id_t>(0));
+    PathfindingCacheInvalidateArea(queue.ToCoordsXY(), 0);
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, end), PATH_FLOW_FIELD_UNREACHABLE);
+
+    // A queue path with a junction does not.
+    AddPath({ 5, 6, 14 }, 0);
+    ConnectPaths(queue, { 5, 6, 14 });
+    PathfindingCacheInvalidateArea(queue.ToCoordsXY(), 1);
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, end), 6);
+
+    // Guests stop at wide paths, a guest on one falls back to the heuristic search.
+    GetPath({ 4, 5, 14 })->SetWide(true);
+    PathfindingCacheInvalidateArea({ 4 * COORDS_XY_STEP, 5 * COORDS_XY_STEP }, 0);
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, end), PATH_FLOW_FIELD_UNREACHABLE);
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, { 4, 5, 14 }), PATH_FLOW_FIELD_UNREACHABLE);
+    EXPECT_EQ(PathFlowFieldGetDistance(entrance, { 3, 5, 14 }), 1);
+}
@@ -211,6 +211,22 @@ TEST_P(SimplePathfindingTest, CanFindPathFromStartToGoal)
     EXPECT_TRUE(succeeded);
 }
 
+TEST_P(SimplePathfindingTest, FlowFieldReachesGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    EXPECT_EQ(PathFlowFieldGetDistance(goal, goal), 0);
+    EXPECT_NE(PathFlowFieldGetDistance(goal, scenario.start), PATH_FLOW_FIELD_UNREACHABLE);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ForScenario, SimplePathfindingTest,
     ::testing::Values(
@@ -251,3 +267,31 @@ INSTANTIATE_TEST_CASE_P(
         SimplePathfindingScenario("PathWithFences", { 11, 6, 14 }, 10000),
         SimplePathfindingScenario("PathWithCliff", { 7, 17, 14 }, 10000)),
     SimplePathfindingScenario::ToName);
+
+class PathfindingCacheTest : public PathfindingTestBase
+{
+};
+
+TEST_F(PathfindingCacheTest, RepeatedSearchGivesSamePath)
+{
+    auto ride = FindRideByName("TwoEqualRoutes");
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    // The first guest fills the cache, the second one has to walk the exact same way using it.
+    PathfindingCacheInvalidate();
+    PathfindingCacheResetStats();
+    TileCoordsXYZ pos = { 9, 13, 14 };
+    EXPECT_TRUE(FindPath(&pos, goal, 89, ride->id));
+    const auto firstStats = PathfindingCacheGetStats();
+    EXPECT_GT(firstStats.Misses, 0u);
+
+    pos = { 9, 13, 14 };
+    EXPECT_TRUE(FindPath(&pos, goal, 89, ride->id));
+    const auto secondStats = PathfindingCacheGetStats();
+    EXPECT_GT(secondStats.Hits, firstStats.Hits);
+}
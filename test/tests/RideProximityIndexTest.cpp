@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/ParkImporter.h>
+#include <openrct2/ride/RideProximityIndex.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/TileElementsView.h>
+
+using namespace OpenRCT2;
+
+class RideProximityIndexTests : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::string parkPath = TestData::GetParkPath("bpb.sv6");
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+    void TearDown() override
+    {
+        _context.reset();
+    }
+
+private:
+    std::shared_ptr<IContext> _context;
+};
+
+static std::bitset<MAX_RIDES> ScanRidesNearLocation(const CoordsXY& centre, int32_t radius)
+{
+    std::bitset<MAX_RIDES> rides;
+    for (int32_t x = centre.x - radius; x <= centre.x + radius; x += COORDS_XY_STEP)
+    {
+        for (int32_t y = centre.y - radius; y <= centre.y + radius; y += COORDS_XY_STEP)
+        {
+            auto location = CoordsXY{ x, y };
+            if (!map_is_location_valid(location))
+                continue;
+
+            for (auto* trackElement : TileElementsView<TrackElement>(location))
+            {
+                rides[EnumValue(trackElement->GetRideIndex())] = true;
+            }
+        }
+    }
+    return rides;
+}
+
+static void CheckMapTiles(int32_t radius)
+{
+    // Include a border outside of the map to cover the clipping.
+    for (int32_t x = -2; x < MAXIMUM_MAP_SIZE_TECHNICAL + 2; x++)
+    {
+        for (int32_t y = -2; y < MAXIMUM_MAP_SIZE_TECHNICAL + 2; y++)
+        {
+            auto centre = TileCoordsXY(x, y).ToCoordsXY();
+            ASSERT_EQ(GetRidesNearLocation(centre, radius), ScanRidesNearLocation(centre, radius))
+                << "x = " << x << ", y = " << y << ", radius = " << radius;
+        }
+    }
+}
+
+TEST_F(RideProximityIndexTests, MatchesTileScan)
+{
+    ASSERT_TRUE(ScanRidesNearLocation({ 128 * COORDS_XY_STEP, 128 * COORDS_XY_STEP }, 128 * COORDS_XY_STEP).any());
+
+    CheckMapTiles(0);
+    CheckMapTiles(10 * COORDS_XY_STEP);
+}
+
+TEST_F(RideProximityIndexTests, UpdatesAfterTrackRemoval)
+{
+    CheckMapTiles(10 * COORDS_XY_STEP);
+
+    map_remove_all_rides();
+    CheckMapTiles(10 * COORDS_XY_STEP);
+    ASSERT_TRUE(GetRidesNearLocation({ 128 * COORDS_XY_STEP, 128 * COORDS_XY_STEP }, 128 * COORDS_XY_STEP).none());
+}
+
+TEST_F(RideProximityIndexTests, UpdatesAfterTileElementRemoval)
+{
+    CheckMapTiles(10 * COORDS_XY_STEP);
+
+    // Elements removed without going through an action, like the tile inspector does, update the index as well.
+    int32_t numRemoved = 0;
+    for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x += 3)
+    {
+        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y += 3)
+        {
+            auto* tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+
+            do
+            {
+                if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
+                {
+                    tile_element_remove(tileElement);
+                    numRemoved++;
+                    break;
+                }
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    ASSERT_GT(numRemoved, 0);
+    CheckMapTiles(10 * COORDS_XY_STEP);
+}
@@ -88,3 +88,35 @@ TEST_F(RideRatings, all)
         expI++;
     }
 }
+
+TEST_F(RideRatings, allAtOnce)
+{
+    std::string path = TestData::GetParkPath("bpb.sv6");
+
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+    auto context = CreateContext();
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    load_from_sv6(path.c_str());
+    ASSERT_EQ(ride_get_count(), 134);
+
+    // Measuring the rides in parallel must give the same ratings as rating them one by one.
+    ride_ratings_update_all_rides();
+
+    auto expectedDataPath = Path::Combine(TestData::GetBasePath(), "ratings", "bpb.sv6.txt");
+    auto expectedRatings = File::ReadAllLines(expectedDataPath);
+
+    int expI = 0;
+    for (const auto& ride : GetRideManager())
+    {
+        auto actual = FormatRatings(ride);
+        auto expected = expectedRatings[expI];
+        ASSERT_STREQ(actual.c_str(), expected.c_str());
+
+        expI++;
+    }
+}
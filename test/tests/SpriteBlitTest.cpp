@@ -0,0 +1,209 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <openrct2/config/Config.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/drawing/SpriteMipCache.h>
+#include <openrct2/sprites.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+static constexpr int32_t SpriteWidth = 200;
+static constexpr int32_t SpriteHeight = 90;
+static constexpr int32_t ViewWidth = 256;
+static constexpr int32_t ViewHeight = 128;
+
+class SpriteBlitTest : public testing::Test
+{
+protected:
+    std::mt19937 _random{ 42 };
+    std::vector<uint8_t> _bmpData;
+    std::vector<uint8_t> _rleData;
+    uint8_t _remap[256]{};
+    std::vector<uint8_t> _blendData;
+
+    void SetUp() override
+    {
+        // A few entries map to transparent to exercise the checks on the mapped colour.
+        for (auto& entry : _remap)
+        {
+            entry = RandomPixel();
+        }
+        _blendData.resize(255 * 256);
+        for (auto& entry : _blendData)
+        {
+            entry = RandomPixel();
+        }
+
+        _bmpData.resize(SpriteWidth * SpriteHeight);
+        for (auto& pixel : _bmpData)
+        {
+            pixel = RandomPixel();
+        }
+        EncodeRLE();
+    }
+
+    void TearDown() override
+    {
+        blit_run_init_scalar(blit_run_fns);
+        SpriteMipCacheClear();
+    }
+
+    uint8_t RandomPixel()
+    {
+        return _random() % 8 == 0 ? 0 : static_cast<uint8_t>(1 + _random() % 255);
+    }
+
+    // Random runs of all lengths, including ones that are long enough for the vector paths and end at the right edge.
+    void EncodeRLE()
+    {
+        std::vector<uint8_t> lines;
+        std::vector<uint16_t> offsets;
+        for (int32_t y = 0; y < SpriteHeight; y++)
+        {
+            offsets.push_back(static_cast<uint16_t>(SpriteHeight * 2 + lines.size()));
+            int32_t x = static_cast<int32_t>(_random() % 8);
+            do
+            {
+                auto length = std::min<int32_t>(1 + _random() % 127, SpriteWidth - x);
+                auto next = x + length + static_cast<int32_t>(_random() % 12);
+                auto isLast = next >= SpriteWidth;
+                lines.push_back(static_cast<uint8_t>(length | (isLast ? 0x80 : 0)));
+                lines.push_back(static_cast<uint8_t>(x));
+                for (int32_t i = 0; i < length; i++)
+                {
+                    lines.push_back(RandomPixel());
+                }
+                x = next;
+            } while (x < SpriteWidth);
+        }
+        _rleData.clear();
+        for (auto offset : offsets)
+        {
+            _rleData.push_back(offset & 0xFF);
+            _rleData.push_back(offset >> 8);
+        }
+        _rleData.insert(_rleData.end(), lines.begin(), lines.end());
+    }
+
+    std::vector<uint8_t> Draw(
+        bool rle, uint32_t imageFlags, ZoomLevel zoom, const ScreenCoordsXY& coords, uint32_t imageIndex = SPR_TEMP)
+    {
+        rct_g1_element g1{};
+        g1.offset = rle ? _rleData.data() : _bmpData.data();
+        g1.width = SpriteWidth;
+        g1.height = SpriteHeight;
+        g1.flags = rle ? G1_FLAG_RLE_COMPRESSION : G1_FLAG_BMP;
+        gfx_set_g1_element(imageIndex, &g1);
+
+        rct_drawpixelinfo dpi;
+        dpi.width = ViewWidth;
+        dpi.height = ViewHeight;
+        dpi.pitch = 3;
+        dpi.zoom_level = zoom;
+        std::vector<uint8_t> bits(((ViewWidth / zoom) + dpi.pitch) * (ViewHeight / zoom));
+        std::mt19937 background(7);
+        for (auto& pixel : bits)
+        {
+            pixel = static_cast<uint8_t>(background());
+        }
+        dpi.bits = bits.data();
+
+        auto image = ImageId::FromUInt32(imageIndex | imageFlags);
+        if (image.HasPrimary() && image.IsBlended())
+        {
+            PaletteMap paletteMap(_blendData.data(), 255, 256);
+            gfx_draw_sprite_palette_set_software(&dpi, image, coords, paletteMap);
+        }
+        else
+        {
+            gfx_draw_sprite_palette_set_software(&dpi, image, coords, PaletteMap(_remap));
+        }
+        return bits;
+    }
+
+    static constexpr uint32_t ImageFlags[] = {
+        0,
+        IMAGE_TYPE_REMAP,
+        IMAGE_TYPE_TRANSPARENT,
+        IMAGE_TYPE_REMAP | IMAGE_TYPE_TRANSPARENT,
+    };
+    static constexpr ScreenCoordsXY Positions[] = {
+        { 0, 0 }, { 17, 5 }, { -33, -20 }, { 150, 70 }, { -190, 3 }, { -7, -3 }, { 3, 1 },
+    };
+
+    void CompareWithScalar(void (*initTable)(BlitRunTable&))
+    {
+        for (bool rle : { false, true })
+        {
+            for (auto imageFlags : ImageFlags)
+            {
+                for (int8_t zoom = -2; zoom <= 3; zoom++)
+                {
+                    for (const auto& position : Positions)
+                    {
+                        blit_run_init_scalar(blit_run_fns);
+                        auto expected = Draw(rle, imageFlags, zoom, position);
+                        initTable(blit_run_fns);
+                        auto actual = Draw(rle, imageFlags, zoom, position);
+                        ASSERT_EQ(expected, actual) << "rle = " << rle << ", flags = " << imageFlags
+                                                    << ", zoom = " << static_cast<int32_t>(zoom) << ", x = " << position.x
+                                                    << ", y = " << position.y;
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_F(SpriteBlitTest, SSE41MatchesScalar)
+{
+    if (!sse41_available())
+    {
+        return;
+    }
+    CompareWithScalar(blit_run_init_sse4_1);
+}
+
+TEST_F(SpriteBlitTest, AVX2MatchesScalar)
+{
+    if (!avx2_available())
+    {
+        return;
+    }
+    CompareWithScalar(blit_run_init_avx2);
+}
+
+TEST_F(SpriteBlitTest, MipCacheMatchesMinify)
+{
+    const auto cacheSize = gConfigGeneral.sprite_mip_cache_size;
+    for (auto imageFlags : ImageFlags)
+    {
+        for (int8_t zoom = 1; zoom <= 3; zoom++)
+        {
+            for (const auto& position : Positions)
+            {
+                gConfigGeneral.sprite_mip_cache_size = 0;
+                auto expected = Draw(true, imageFlags, zoom, position, SPR_IMAGE_LIST_BEGIN);
+                gConfigGeneral.sprite_mip_cache_size = 16;
+                auto actual = Draw(true, imageFlags, zoom, position, SPR_IMAGE_LIST_BEGIN);
+                ASSERT_EQ(expected, actual) << "flags = " << imageFlags << ", zoom = " << static_cast<int32_t>(zoom)
+                                            << ", x = " << position.x << ", y = " << position.y;
+            }
+        }
+    }
+    ASSERT_GT(SpriteMipCacheGetUsedBytes(), 0u);
+
+    SpriteMipCacheFreeImages(SPR_IMAGE_LIST_BEGIN, 1);
+    ASSERT_EQ(SpriteMipCacheGetUsedBytes(), 0u);
+    gConfigGeneral.sprite_mip_cache_size = cacheSize;
+}
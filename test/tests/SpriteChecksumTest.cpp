@@ -0,0 +1,140 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include <gtest/gtest.h>
+#    include <openrct2/world/Entity.h>
+#    include <openrct2/world/Litter.h>
+#    include <openrct2/world/Sprite.h>
+#    include <vector>
+
+class SpriteChecksumTest : public testing::Test
+{
+protected:
+    std::vector<Litter*> _litter;
+
+    void SetUp() override
+    {
+        reset_sprite_list();
+        for (int32_t i = 0; i < 500; i++)
+        {
+            auto* litter = CreateEntity<Litter>();
+            ASSERT_NE(litter, nullptr);
+            litter->SubType = Litter::Type::EmptyCan;
+            litter->creationTick = i;
+            litter->MoveTo({ 32 + i * 16, 64, 16 });
+            _litter.push_back(litter);
+        }
+    }
+
+    void TearDown() override
+    {
+        reset_sprite_list();
+    }
+};
+
+TEST_F(SpriteChecksumTest, IncrementalMatchesFull)
+{
+    auto before = sprite_checksum(SpriteChecksumMode::Incremental);
+    ASSERT_EQ(before.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+
+    // Change some entities, remove some and reuse their slots, with most left alone.
+    for (size_t i = 0; i < _litter.size(); i += 7)
+    {
+        _litter[i]->creationTick += 100;
+    }
+    for (size_t i = 3; i < _litter.size(); i += 50)
+    {
+        sprite_remove(_litter[i]);
+    }
+    for (int32_t i = 0; i < 5; i++)
+    {
+        auto* litter = CreateEntity<Litter>();
+        ASSERT_NE(litter, nullptr);
+        litter->SubType = Litter::Type::Vomit;
+        litter->MoveTo({ 64, 32 + i * 16, 16 });
+    }
+
+    auto after = sprite_checksum(SpriteChecksumMode::Incremental);
+    ASSERT_NE(before.raw, after.raw);
+    ASSERT_EQ(after.raw, sprite_checksum(SpriteChecksumMode::Full).raw);
+    ASSERT_EQ(after.raw, sprite_checksum(SpriteChecksumMode::Verify).raw);
+}
+
+TEST_F(SpriteChecksumTest, RevertedEntityRestoresChecksum)
+{
+    auto before = sprite_checksum(SpriteChecksumMode::Incremental);
+
+    _litter[42]->creationTick++;
+    ASSERT_NE(before.raw, sprite_checksum(SpriteChecksumMode::Incremental).raw);
+
+    _litter[42]->creationTick--;
+    ASSERT_EQ(before.raw, sprite_checksum(SpriteChecksumMode::Incremental).raw);
+}
+
+TEST_F(SpriteChecksumTest, AllModesAgreeOnChanges)
+{
+    constexpr SpriteChecksumMode modes[] = { SpriteChecksumMode::Incremental, SpriteChecksumMode::Full,
+                                             SpriteChecksumMode::Legacy };
+    auto checksums = [&modes]() {
+        std::vector<rct_sprite_checksum> result;
+        for (auto mode : modes)
+        {
+            result.push_back(sprite_checksum(mode));
+        }
+        EXPECT_EQ(result[0].raw, result[1].raw);
+        return result;
+    };
+    // Every mode notices the change and comes back to the same checksum once it is undone.
+    auto expectAllChanged = [](const std::vector<rct_sprite_checksum>& a, const std::vector<rct_sprite_checksum>& b) {
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            EXPECT_NE(a[i].raw, b[i].raw) << "mode " << i;
+        }
+    };
+    auto expectAllEqual = [](const std::vector<rct_sprite_checksum>& a, const std::vector<rct_sprite_checksum>& b) {
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            EXPECT_EQ(a[i].raw, b[i].raw) << "mode " << i;
+        }
+    };
+
+    const auto original = checksums();
+
+    // Create.
+    auto* created = CreateEntity<Litter>();
+    ASSERT_NE(created, nullptr);
+    created->SubType = Litter::Type::Vomit;
+    created->MoveTo({ 64, 96, 16 });
+    expectAllChanged(original, checksums());
+    sprite_remove(created);
+    expectAllEqual(original, checksums());
+
+    // Move.
+    const CoordsXYZ location = { _litter[250]->x, _litter[250]->y, _litter[250]->z };
+    _litter[250]->MoveTo({ 128, 128, 32 });
+    expectAllChanged(original, checksums());
+    _litter[250]->MoveTo(location);
+    expectAllEqual(original, checksums());
+
+    // Delete, then create the same entity again in its slot.
+    const uint16_t index = _litter[499]->sprite_index;
+    const auto creationTick = _litter[499]->creationTick;
+    sprite_remove(_litter[499]);
+    expectAllChanged(original, checksums());
+    auto* recreated = CreateEntityAt<Litter>(index);
+    ASSERT_NE(recreated, nullptr);
+    recreated->SubType = Litter::Type::EmptyCan;
+    recreated->creationTick = creationTick;
+    recreated->MoveTo({ 32 + 499 * 16, 64, 16 });
+    expectAllEqual(original, checksums());
+}
+
+#endif // DISABLE_NETWORK
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <openrct2/core/TaskScheduler.h>
+#include <stdexcept>
+#include <vector>
+
+using namespace OpenRCT2;
+
+constexpr size_t TEST_WORKER_COUNT = 4;
+
+TEST(TaskSchedulerTest, ParallelForVisitsEveryIndexOnce)
+{
+    TaskScheduler scheduler(TEST_WORKER_COUNT);
+
+    std::vector<std::atomic<int32_t>> visits(10000);
+    scheduler.ParallelFor(visits.size(), [&visits](size_t i) { visits[i]++; });
+
+    for (const auto& count : visits)
+    {
+        ASSERT_EQ(count.load(), 1);
+    }
+}
+
+TEST(TaskSchedulerTest, ParallelForWithoutWorkers)
+{
+    TaskScheduler scheduler(0);
+
+    std::vector<int32_t> visits(100);
+    scheduler.ParallelFor(visits.size(), [&visits](size_t i) { visits[i]++; });
+
+    for (auto count : visits)
+    {
+        ASSERT_EQ(count, 1);
+    }
+}
+
+TEST(TaskSchedulerTest, NestedGroups)
+{
+    TaskScheduler scheduler(TEST_WORKER_COUNT);
+
+    std::atomic<int32_t> total = 0;
+    TaskGroup outer(scheduler);
+    for (int32_t i = 0; i < 16; i++)
+    {
+        outer.Run([&scheduler, &total]() {
+            TaskGroup inner(scheduler);
+            for (int32_t j = 0; j < 16; j++)
+            {
+                inner.Run([&total]() { total++; });
+            }
+            inner.Wait();
+        });
+    }
+    outer.Wait();
+
+    ASSERT_EQ(total.load(), 16 * 16);
+}
+
+TEST(TaskSchedulerTest, CancelSkipsQueuedTasks)
+{
+    TaskScheduler scheduler(1);
+
+    std::atomic_bool started = false;
+    std::atomic_bool release = false;
+    std::atomic<int32_t> executed = 0;
+    TaskGroup group(scheduler);
+
+    // Keep the only worker busy so the remaining tasks stay queued.
+    group.Run([&started, &release]() {
+        started = true;
+        while (!release)
+        {
+            std::this_thread::yield();
+        }
+    });
+    while (!started)
+    {
+        std::this_thread::yield();
+    }
+    for (int32_t i = 0; i < 100; i++)
+    {
+        group.Run([&executed]() { executed++; });
+    }
+
+    group.Cancel();
+    release = true;
+    group.Wait();
+
+    ASSERT_TRUE(group.IsCancelled());
+    ASSERT_EQ(executed.load(), 0);
+}
+
+TEST(TaskSchedulerTest, WaitRethrowsTaskException)
+{
+    TaskScheduler scheduler(TEST_WORKER_COUNT);
+
+    TaskGroup group(scheduler);
+    group.Run([]() { throw std::runtime_error("task failed"); });
+    ASSERT_THROW(group.Wait(), std::runtime_error);
+}
+
+TEST(TaskSchedulerTest, TaskStorageIsInline)
+{
+    int32_t value = 0;
+    struct Captures
+    {
+        int32_t* Value;
+        uint8_t Padding[Task::StorageSize - sizeof(int32_t*)];
+    } captures{ &value, {} };
+
+    Task task(nullptr, [captures]() { (*captures.Value)++; });
+    Task moved(std::move(task));
+    ASSERT_FALSE(task.IsValid());
+    ASSERT_TRUE(moved.IsValid());
+
+    moved.Invoke();
+    ASSERT_EQ(value, 1);
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2021 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <openrct2/util/Util.h>
+#include <random>
+#include <vector>
+
+// Less than a block, on a block boundary and several blocks with a partial one at the end.
+static constexpr size_t Sizes[] = { 1, 1000, 256 * 1024, 1024 * 1024 + 12345 };
+
+static std::vector<uint8_t> CreateInput(size_t size)
+{
+    // Repetitive with some noise, like a saved park.
+    std::mt19937 random(42);
+    std::vector<uint8_t> input(size);
+    for (size_t i = 0; i < size; i++)
+    {
+        input[i] = random() % 8 == 0 ? static_cast<uint8_t>(random()) : static_cast<uint8_t>(i / 64);
+    }
+    return input;
+}
+
+TEST(ZlibTests, DeflateParallelInflates)
+{
+    for (auto size : Sizes)
+    {
+        auto input = CreateInput(size);
+
+        std::vector<uint8_t> compressed;
+        ASSERT_TRUE(util_zlib_deflate_parallel(input.data(), input.size(), [&compressed](const uint8_t* data, size_t len) {
+            compressed.insert(compressed.end(), data, data + len);
+        }));
+        ASSERT_LE(compressed.size(), util_zlib_deflate_parallel_bound(size)) << "size = " << size;
+
+        size_t outputSize = size;
+        auto output = util_zlib_inflate(compressed.data(), compressed.size(), &outputSize);
+        ASSERT_NE(output, nullptr) << "size = " << size;
+        ASSERT_EQ(outputSize, size);
+        ASSERT_TRUE(std::equal(input.begin(), input.end(), output)) << "size = " << size;
+        free(output);
+    }
+}